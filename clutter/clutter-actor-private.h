@@ -320,6 +320,10 @@ void                            _clutter_actor_queue_redraw_on_clones
 void                            _clutter_actor_queue_relayout_on_clones                 (ClutterActor *actor);
 void                            _clutter_actor_queue_only_relayout                      (ClutterActor *actor);
 
+gboolean                        _clutter_actor_set_animatable_double                    (ClutterActor *actor,
+                                                                                         GParamSpec   *pspec,
+                                                                                         gdouble       value);
+
 CoglFramebuffer *               _clutter_actor_get_active_framebuffer                   (ClutterActor *actor);
 
 G_END_DECLS
@@ -1000,8 +1000,22 @@ typedef struct _TransitionClosure
   gchar *name;
   gulong completed_id;
   guint is_implicit : 1;
+
+  /* whether the transition has been handed out by
+   * clutter_actor_get_transition()
+   */
+  guint is_exposed : 1;
 } TransitionClosure;
 
+/* the implicit transitions are recycled once they are complete, to
+ * avoid allocating new ones every time an animatable property is
+ * changed after the previous transition ended
+ */
+#define MAX_RECYCLED_TRANSITIONS        64
+
+static ClutterTransition *recycled_transitions[MAX_RECYCLED_TRANSITIONS];
+static guint n_recycled_transitions = 0;
+
 static void clutter_container_iface_init  (ClutterContainerIface  *iface);
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
 static void clutter_animatable_iface_init (ClutterAnimatableIface *iface);
@@ -13827,6 +13841,14 @@ clutter_actor_set_reactive (ClutterActor *actor,
   else
     CLUTTER_ACTOR_UNSET_FLAGS (actor, CLUTTER_ACTOR_REACTIVE);
 
+  if (CLUTTER_ACTOR_IS_MAPPED (actor))
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (actor);
+
+      if (stage != NULL)
+        _clutter_stage_invalidate_pick (CLUTTER_STAGE (stage));
+    }
+
   g_object_notify_by_pspec (G_OBJECT (actor), obj_props[PROP_REACTIVE]);
 }
 
@@ -14965,6 +14987,101 @@ clutter_actor_set_final_state (ClutterAnimatable *animatable,
   g_free (p_name);
 }
 
+/*< private >
+ * _clutter_actor_set_animatable_double:
+ * @actor: a #ClutterActor
+ * @pspec: the #GParamSpec of an animatable property
+ * @value: the new value of the property
+ *
+ * Sets the value of a numeric animatable property of #ClutterActor
+ * without boxing it inside a #GValue.
+ *
+ * This function is used by #ClutterPropertyTransition to update the
+ * transformation, opacity and size of an actor at each frame.
+ *
+ * Return value: %TRUE if the property was set, and %FALSE if the
+ *   property is not handled by this function; in that case, the
+ *   caller should use clutter_animatable_set_final_state()
+ */
+gboolean
+_clutter_actor_set_animatable_double (ClutterActor *actor,
+                                      GParamSpec   *pspec,
+                                      gdouble       value)
+{
+  if (pspec->owner_type != CLUTTER_TYPE_ACTOR)
+    return FALSE;
+
+  /* a sub-class might be overriding the way properties are set */
+  if (CLUTTER_ANIMATABLE_GET_IFACE (actor)->set_final_state !=
+      clutter_actor_set_final_state)
+    return FALSE;
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+      clutter_actor_set_x_internal (actor, value);
+      break;
+
+    case PROP_Y:
+      clutter_actor_set_y_internal (actor, value);
+      break;
+
+    case PROP_WIDTH:
+      clutter_actor_set_width_internal (actor, value);
+      break;
+
+    case PROP_HEIGHT:
+      clutter_actor_set_height_internal (actor, value);
+      break;
+
+    case PROP_DEPTH:
+      clutter_actor_set_depth_internal (actor, value);
+      break;
+
+    case PROP_Z_POSITION:
+      clutter_actor_set_z_position_internal (actor, value);
+      break;
+
+    case PROP_OPACITY:
+      clutter_actor_set_opacity_internal (actor, value);
+      break;
+
+    case PROP_PIVOT_POINT_Z:
+      clutter_actor_set_pivot_point_z_internal (actor, value);
+      break;
+
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+      clutter_actor_set_translation_internal (actor, value, pspec);
+      break;
+
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+      clutter_actor_set_scale_factor_internal (actor, value, pspec);
+      break;
+
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle_internal (actor, value, pspec);
+      break;
+
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      clutter_actor_set_margin_internal (actor, value, pspec);
+      break;
+
+    default:
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
 static void
 clutter_animatable_iface_init (ClutterAnimatableIface *iface)
 {
@@ -18813,13 +18930,18 @@ _clutter_actor_get_transition (ClutterActor *actor,
                                GParamSpec   *pspec)
 {
   const ClutterAnimationInfo *info;
+  TransitionClosure *clos;
 
   info = _clutter_actor_get_animation_info_or_defaults (actor);
 
   if (info->transitions == NULL)
     return NULL;
 
-  return g_hash_table_lookup (info->transitions, pspec->name);
+  clos = g_hash_table_lookup (info->transitions, pspec->name);
+  if (clos == NULL)
+    return NULL;
+
+  return clos->transition;
 }
 
 static void
@@ -18850,12 +18972,68 @@ transition_closure_free (gpointer data)
     }
 }
 
+/*< private >
+ * clutter_actor_detach_transition_closure:
+ * @clos: the #TransitionClosure of an implicit transition that has
+ *   been stolen from the actor's transitions
+ *
+ * Releases @clos and returns its transition, which can then be handed
+ * to clutter_actor_recycle_transition(); the reference held by @clos
+ * is transferred to the caller.
+ */
+static ClutterTransition *
+clutter_actor_detach_transition_closure (TransitionClosure *clos)
+{
+  ClutterTransition *res = clos->transition;
+
+  g_signal_handler_disconnect (res, clos->completed_id);
+
+  /* this drops the reference on the actor; it also means that the
+   * class handler of ClutterTransition::stopped won't release the
+   * transition
+   */
+  clutter_transition_set_animatable (res, NULL);
+
+  g_free (clos->name);
+  g_slice_free (TransitionClosure, clos);
+
+  return res;
+}
+
+static void
+clutter_actor_recycle_transition (ClutterTransition *transition)
+{
+  if (n_recycled_transitions < MAX_RECYCLED_TRANSITIONS)
+    recycled_transitions[n_recycled_transitions++] = transition;
+  else
+    g_object_unref (transition);
+}
+
+static ClutterTransition *
+clutter_actor_get_recycled_transition (const char *property_name)
+{
+  ClutterTransition *res;
+
+  if (n_recycled_transitions == 0)
+    return NULL;
+
+  res = recycled_transitions[--n_recycled_transitions];
+  recycled_transitions[n_recycled_transitions] = NULL;
+
+  clutter_property_transition_set_property_name (CLUTTER_PROPERTY_TRANSITION (res),
+                                                 property_name);
+  clutter_timeline_rewind (CLUTTER_TIMELINE (res));
+
+  return res;
+}
+
 static void
 on_transition_stopped (ClutterTransition *transition,
                        gboolean           is_finished,
                        TransitionClosure *clos)
 {
   ClutterActor *actor = clos->actor;
+  ClutterTransition *recycled = NULL;
   ClutterAnimationInfo *info;
   GQuark t_quark;
   gchar *t_name;
@@ -18874,8 +19052,17 @@ on_transition_stopped (ClutterTransition *transition,
   t_quark = g_quark_from_string (clos->name);
   t_name = g_strdup (clos->name);
 
-  if (clos->is_implicit ||
-      clutter_transition_get_remove_on_complete (transition))
+  if (clos->is_implicit && !clos->is_exposed &&
+      n_recycled_transitions < MAX_RECYCLED_TRANSITIONS)
+    {
+      /* nobody else knows about this transition, so we can reuse it
+       * for the next implicit transition
+       */
+      g_hash_table_steal (info->transitions, clos->name);
+      recycled = clutter_actor_detach_transition_closure (clos);
+    }
+  else if (clos->is_implicit ||
+           clutter_transition_get_remove_on_complete (transition))
     {
       /* we take a reference here because removing the closure
        * will release the reference on the transition, and we
@@ -18913,6 +19100,13 @@ on_transition_stopped (ClutterTransition *transition,
 
       g_signal_emit (actor, actor_signals[TRANSITIONS_COMPLETED], 0);
     }
+
+  /* the transition can only be reused once we're done with it, as
+   * the handlers of the signals above might create new transitions
+   * while we're still inside its ::stopped emission
+   */
+  if (recycled != NULL)
+    clutter_actor_recycle_transition (recycled);
 }
 
 static void
@@ -18950,6 +19144,7 @@ clutter_actor_add_transition_internal (ClutterActor *self,
   clos->transition = g_object_ref (transition);
   clos->name = g_strdup (name);
   clos->is_implicit = is_implicit;
+  clos->is_exposed = FALSE;
   clos->completed_id = g_signal_connect (timeline, "stopped",
                                          G_CALLBACK (on_transition_stopped),
                                          clos);
@@ -19106,10 +19301,27 @@ _clutter_actor_create_transition (ClutterActor *actor,
   clos = g_hash_table_lookup (info->transitions, pspec->name);
   if (clos == NULL)
     {
-      res = clutter_property_transition_new (pspec->name);
+      res = clutter_actor_get_recycled_transition (pspec->name);
+      if (res == NULL)
+        {
+          res = clutter_property_transition_new (pspec->name);
 
-      interval = clutter_interval_new_with_values (ptype, &initial, &final);
-      clutter_transition_set_interval (res, interval);
+          /* release the transition once it's done, unless it's recycled */
+          clutter_transition_set_remove_on_complete (res, TRUE);
+        }
+
+      interval = clutter_transition_get_interval (res);
+      if (interval != NULL &&
+          clutter_interval_get_value_type (interval) == ptype)
+        {
+          clutter_interval_set_initial_value (interval, &initial);
+          clutter_interval_set_final_value (interval, &final);
+        }
+      else
+        {
+          interval = clutter_interval_new_with_values (ptype, &initial, &final);
+          clutter_transition_set_interval (res, interval);
+        }
 
       timeline = CLUTTER_TIMELINE (res);
       clutter_timeline_set_delay (timeline, info->cur_state->easing_delay);
@@ -19532,6 +19744,9 @@ clutter_actor_get_transition (ClutterActor *self,
   if (clos == NULL)
     return NULL;
 
+  /* the caller might hold on to the transition, so we cannot recycle it */
+  clos->is_exposed = TRUE;
+
   return clos->transition;
 }
 
@@ -20362,9 +20577,11 @@ void
 _clutter_actor_handle_event (ClutterActor       *self,
                              const ClutterEvent *event)
 {
+  ClutterActor *stage = NULL;
   GPtrArray *event_tree;
   ClutterActor *iter;
   gboolean is_key_event;
+  guint start = 0;
   gint i = 0;
 
   /* XXX - for historical reasons that are now lost in the mists of time,
@@ -20374,8 +20591,25 @@ _clutter_actor_handle_event (ClutterActor       *self,
   is_key_event = event->type == CLUTTER_KEY_PRESS ||
                  event->type == CLUTTER_KEY_RELEASE;
 
-  event_tree = g_ptr_array_sized_new (64);
-  g_ptr_array_set_free_func (event_tree, (GDestroyNotify) g_object_unref);
+  /* the emitters of an event on a mapped actor are stored in the event
+   * chain of the stage, which keeps them alive without referencing each
+   * one of them; only the stage itself needs a reference
+   */
+  if (CLUTTER_ACTOR_IS_MAPPED (self))
+    stage = _clutter_actor_get_stage_internal (self);
+
+  if (stage != NULL)
+    {
+      g_object_ref (stage);
+
+      event_tree = _clutter_stage_get_event_chain (CLUTTER_STAGE (stage));
+      start = event_tree->len;
+    }
+  else
+    {
+      event_tree = g_ptr_array_sized_new (64);
+      g_ptr_array_set_free_func (event_tree, (GDestroyNotify) g_object_unref);
+    }
 
   /* build the list of of emitters for the event */
   iter = self;
@@ -20387,27 +20621,41 @@ _clutter_actor_handle_event (ClutterActor       *self,
           parent == NULL ||                       /* unless it's the stage */
           is_key_event)                          /* or this is a key event */
         {
-          /* keep a reference on the actor, so that it remains valid
-           * for the duration of the signal emission
+          /* unless the actor is in the event chain of the stage, keep
+           * a reference on it, so that it remains valid for the duration
+           * of the signal emission
            */
-          g_ptr_array_add (event_tree, g_object_ref (iter));
+          if (stage != NULL)
+            g_ptr_array_add (event_tree, iter);
+          else
+            g_ptr_array_add (event_tree, g_object_ref (iter));
         }
 
       iter = parent;
     }
 
-  /* Capture: from top-level downwards */
-  for (i = event_tree->len - 1; i >= 0; i--)
+  /* the event chain can be reallocated by the emission of nested
+   * events, so we need to access it through the array every time
+   *
+   * Capture: from top-level downwards
+   */
+  for (i = event_tree->len - 1; i >= (gint) start; i--)
     if (clutter_actor_event (g_ptr_array_index (event_tree, i), event, TRUE))
       goto done;
 
   /* Bubble: from source upwards */
-  for (i = 0; i < event_tree->len; i++)
+  for (i = start; i < event_tree->len; i++)
     if (clutter_actor_event (g_ptr_array_index (event_tree, i), event, FALSE))
       goto done;
 
 done:
-  g_ptr_array_free (event_tree, TRUE);
+  if (stage != NULL)
+    {
+      _clutter_stage_release_event_chain (CLUTTER_STAGE (stage), start);
+      g_object_unref (stage);
+    }
+  else
+    g_ptr_array_free (event_tree, TRUE);
 }
 
 static void
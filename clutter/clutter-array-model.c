@@ -0,0 +1,1690 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-array-model
+ * @short_description: Column-based model implementation
+ *
+ * #ClutterArrayModel is a #ClutterModel implementation that stores the
+ * values of each column inside a typed array, instead of storing each
+ * row as an array of #GValue like #ClutterListModel does. It is meant
+ * for large tables that are mostly appended to and read.
+ *
+ * Integer and floating point values are stored unboxed; strings are
+ * interned inside the model, so that a column with many repeated values
+ * only stores one copy of each value; objects are referenced and boxed
+ * types are copied.
+ *
+ * Retrieving the iterator for a row is a constant time operation; when
+ * a filter is set, the model keeps an index of the rows that are not
+ * filtered out, which is updated as rows are added, removed or changed
+ * instead of calling the filter function on every row.
+ *
+ * The same iterator can be moved to any row using
+ * clutter_array_model_iter_seek(), and the values of a row can be read
+ * without copying them into a #GValue using the typed accessors, like
+ * clutter_array_model_iter_get_int() and
+ * clutter_array_model_iter_get_string().
+ *
+ * Many rows can be added, removed or replaced at once using
+ * clutter_array_model_splice() and clutter_array_model_append_rows();
+ * these functions emit a single #ClutterModel::rows-changed signal
+ * instead of a signal per row.
+ *
+ * #ClutterArrayModel is available since Clutter 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <glib-object.h>
+
+#include "clutter-array-model.h"
+#include "clutter-model.h"
+#include "clutter-model-private.h"
+#include "clutter-private.h"
+#include "clutter-debug.h"
+
+#define CLUTTER_TYPE_ARRAY_MODEL_ITER                 \
+        (clutter_array_model_iter_get_type())
+#define CLUTTER_ARRAY_MODEL_ITER(obj)                 \
+        (G_TYPE_CHECK_INSTANCE_CAST((obj),            \
+         CLUTTER_TYPE_ARRAY_MODEL_ITER,               \
+         ClutterArrayModelIter))
+#define CLUTTER_IS_ARRAY_MODEL_ITER(obj)              \
+        (G_TYPE_CHECK_INSTANCE_TYPE((obj),            \
+         CLUTTER_TYPE_ARRAY_MODEL_ITER))
+
+typedef struct _ClutterArrayModelIter   ClutterArrayModelIter;
+typedef struct _ClutterModelIterClass   ClutterArrayModelIterClass;
+
+typedef enum {
+  COLUMN_STORAGE_INT,           /* gint */
+  COLUMN_STORAGE_INT64,         /* gint64 */
+  COLUMN_STORAGE_DOUBLE,        /* gdouble */
+  COLUMN_STORAGE_STRING,        /* interned const gchar * */
+  COLUMN_STORAGE_POINTER        /* gpointer, GObject or boxed */
+} ColumnStorage;
+
+typedef struct _Column
+{
+  GType gtype;
+  GType fundamental;
+
+  ColumnStorage storage;
+  gsize element_size;
+
+  guint is_object : 1;
+
+  guint8 *data;
+} Column;
+
+#define COLUMN_CELL(col,index)  ((col)->data + (gsize) (index) * (col)->element_size)
+
+struct _ClutterArrayModelPrivate
+{
+  Column *columns;
+  guint n_columns;
+
+  guint n_rows;
+  guint n_allocated;
+
+  /* interned string -> reference count */
+  GHashTable *strings;
+
+  /* the sorted positions of the rows that are not filtered out; the
+   * index is only valid while filter_stamp matches the model's
+   */
+  GArray *visible;
+  guint filter_stamp;
+
+  ClutterModelIter *temp_iter;
+};
+
+struct _ClutterArrayModelIter
+{
+  ClutterModelIter parent_instance;
+
+  /* the position of the row inside the columns, regardless
+   * of the filter set on the model
+   */
+  guint index;
+};
+
+GType clutter_array_model_iter_get_type (void);
+
+G_DEFINE_TYPE (ClutterArrayModelIter,
+               clutter_array_model_iter,
+               CLUTTER_TYPE_MODEL_ITER)
+
+G_DEFINE_TYPE_WITH_PRIVATE (ClutterArrayModel,
+                            clutter_array_model,
+                            CLUTTER_TYPE_MODEL)
+
+/*
+ * Strings
+ */
+
+static const gchar *
+clutter_array_model_ref_string (ClutterArrayModelPrivate *priv,
+                                const gchar              *str)
+{
+  gpointer key, count;
+
+  if (str == NULL)
+    return NULL;
+
+  if (g_hash_table_lookup_extended (priv->strings, str, &key, &count))
+    {
+      /* the table has no key destroy function, so this keeps the
+       * existing key and only updates the count
+       */
+      g_hash_table_insert (priv->strings, key,
+                           GUINT_TO_POINTER (GPOINTER_TO_UINT (count) + 1));
+
+      return key;
+    }
+
+  key = g_strdup (str);
+  g_hash_table_insert (priv->strings, key, GUINT_TO_POINTER (1));
+
+  return key;
+}
+
+static void
+clutter_array_model_unref_string (ClutterArrayModelPrivate *priv,
+                                  const gchar              *str)
+{
+  gpointer key, count;
+
+  if (str == NULL)
+    return;
+
+  if (!g_hash_table_lookup_extended (priv->strings, str, &key, &count))
+    return;
+
+  if (GPOINTER_TO_UINT (count) == 1)
+    {
+      g_hash_table_remove (priv->strings, key);
+      g_free (key);
+    }
+  else
+    g_hash_table_insert (priv->strings, key,
+                         GUINT_TO_POINTER (GPOINTER_TO_UINT (count) - 1));
+}
+
+/*
+ * Columns
+ */
+
+static void
+column_init (Column *column,
+             GType   gtype)
+{
+  column->gtype = gtype;
+  column->fundamental = G_TYPE_FUNDAMENTAL (gtype);
+  column->is_object = g_type_is_a (gtype, G_TYPE_OBJECT);
+  column->data = NULL;
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+      column->storage = COLUMN_STORAGE_INT;
+      column->element_size = sizeof (gint);
+      break;
+
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+      column->storage = COLUMN_STORAGE_INT64;
+      column->element_size = sizeof (gint64);
+      break;
+
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+      column->storage = COLUMN_STORAGE_DOUBLE;
+      column->element_size = sizeof (gdouble);
+      break;
+
+    case G_TYPE_STRING:
+      column->storage = COLUMN_STORAGE_STRING;
+      column->element_size = sizeof (gchar *);
+      break;
+
+    default:
+      column->storage = COLUMN_STORAGE_POINTER;
+      column->element_size = sizeof (gpointer);
+      break;
+    }
+}
+
+static gpointer
+column_copy_pointer (const Column *column,
+                     gpointer      ptr)
+{
+  if (ptr == NULL)
+    return NULL;
+
+  if (column->fundamental == G_TYPE_BOXED)
+    return g_boxed_copy (column->gtype, ptr);
+
+  if (column->is_object)
+    return g_object_ref (ptr);
+
+  return ptr;
+}
+
+static void
+column_free_pointer (const Column *column,
+                     gpointer      ptr)
+{
+  if (ptr == NULL)
+    return;
+
+  if (column->fundamental == G_TYPE_BOXED)
+    g_boxed_free (column->gtype, ptr);
+  else if (column->is_object)
+    g_object_unref (ptr);
+}
+
+static void
+column_get_value (const Column *column,
+                  guint         index,
+                  GValue       *value)
+{
+  gconstpointer cell = COLUMN_CELL (column, index);
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+      g_value_set_boolean (value, *(const gint *) cell);
+      break;
+
+    case G_TYPE_CHAR:
+      g_value_set_schar (value, *(const gint *) cell);
+      break;
+
+    case G_TYPE_UCHAR:
+      g_value_set_uchar (value, *(const gint *) cell);
+      break;
+
+    case G_TYPE_INT:
+      g_value_set_int (value, *(const gint *) cell);
+      break;
+
+    case G_TYPE_UINT:
+      g_value_set_uint (value, *(const guint *) cell);
+      break;
+
+    case G_TYPE_ENUM:
+      g_value_set_enum (value, *(const gint *) cell);
+      break;
+
+    case G_TYPE_FLAGS:
+      g_value_set_flags (value, *(const guint *) cell);
+      break;
+
+    case G_TYPE_LONG:
+      g_value_set_long (value, *(const gint64 *) cell);
+      break;
+
+    case G_TYPE_ULONG:
+      g_value_set_ulong (value, *(const guint64 *) cell);
+      break;
+
+    case G_TYPE_INT64:
+      g_value_set_int64 (value, *(const gint64 *) cell);
+      break;
+
+    case G_TYPE_UINT64:
+      g_value_set_uint64 (value, *(const guint64 *) cell);
+      break;
+
+    case G_TYPE_FLOAT:
+      g_value_set_float (value, *(const gdouble *) cell);
+      break;
+
+    case G_TYPE_DOUBLE:
+      g_value_set_double (value, *(const gdouble *) cell);
+      break;
+
+    case G_TYPE_STRING:
+      g_value_set_string (value, *(const gchar * const *) cell);
+      break;
+
+    case G_TYPE_POINTER:
+      g_value_set_pointer (value, *(gpointer const *) cell);
+      break;
+
+    case G_TYPE_BOXED:
+      g_value_set_boxed (value, *(gpointer const *) cell);
+      break;
+
+    default:
+      g_value_set_object (value, *(gpointer const *) cell);
+      break;
+    }
+}
+
+static void
+column_set_value (ClutterArrayModelPrivate *priv,
+                  Column                   *column,
+                  guint                     index,
+                  const GValue             *value)
+{
+  gpointer cell = COLUMN_CELL (column, index);
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+      *(gint *) cell = g_value_get_boolean (value);
+      break;
+
+    case G_TYPE_CHAR:
+      *(gint *) cell = g_value_get_schar (value);
+      break;
+
+    case G_TYPE_UCHAR:
+      *(gint *) cell = g_value_get_uchar (value);
+      break;
+
+    case G_TYPE_INT:
+      *(gint *) cell = g_value_get_int (value);
+      break;
+
+    case G_TYPE_UINT:
+      *(guint *) cell = g_value_get_uint (value);
+      break;
+
+    case G_TYPE_ENUM:
+      *(gint *) cell = g_value_get_enum (value);
+      break;
+
+    case G_TYPE_FLAGS:
+      *(guint *) cell = g_value_get_flags (value);
+      break;
+
+    case G_TYPE_LONG:
+      *(gint64 *) cell = g_value_get_long (value);
+      break;
+
+    case G_TYPE_ULONG:
+      *(guint64 *) cell = g_value_get_ulong (value);
+      break;
+
+    case G_TYPE_INT64:
+      *(gint64 *) cell = g_value_get_int64 (value);
+      break;
+
+    case G_TYPE_UINT64:
+      *(guint64 *) cell = g_value_get_uint64 (value);
+      break;
+
+    case G_TYPE_FLOAT:
+      *(gdouble *) cell = g_value_get_float (value);
+      break;
+
+    case G_TYPE_DOUBLE:
+      *(gdouble *) cell = g_value_get_double (value);
+      break;
+
+    case G_TYPE_STRING:
+      {
+        const gchar **str = cell;
+        const gchar *old_str = *str;
+
+        *str = clutter_array_model_ref_string (priv, g_value_get_string (value));
+        clutter_array_model_unref_string (priv, old_str);
+      }
+      break;
+
+    default:
+      {
+        gpointer *ptr = cell;
+        gpointer old_ptr = *ptr;
+
+        if (column->fundamental == G_TYPE_POINTER)
+          *ptr = g_value_get_pointer (value);
+        else if (column->fundamental == G_TYPE_BOXED)
+          *ptr = g_value_dup_boxed (value);
+        else
+          *ptr = g_value_dup_object (value);
+
+        column_free_pointer (column, old_ptr);
+      }
+      break;
+    }
+}
+
+/* copies @n_rows values from a C array into rows that have just
+ * been added, and do not hold any value yet
+ */
+static void
+column_store (ClutterArrayModelPrivate *priv,
+              Column                   *column,
+              guint                     index,
+              guint                     n_rows,
+              gconstpointer             data)
+{
+  guint i;
+
+  switch (column->storage)
+    {
+    case COLUMN_STORAGE_INT:
+    case COLUMN_STORAGE_INT64:
+    case COLUMN_STORAGE_DOUBLE:
+      memcpy (COLUMN_CELL (column, index), data, n_rows * column->element_size);
+      break;
+
+    case COLUMN_STORAGE_STRING:
+      {
+        const gchar * const *strings = data;
+        const gchar **cells = (const gchar **) COLUMN_CELL (column, index);
+
+        for (i = 0; i < n_rows; i++)
+          cells[i] = clutter_array_model_ref_string (priv, strings[i]);
+      }
+      break;
+
+    case COLUMN_STORAGE_POINTER:
+      {
+        gpointer const *pointers = data;
+        gpointer *cells = (gpointer *) COLUMN_CELL (column, index);
+
+        for (i = 0; i < n_rows; i++)
+          cells[i] = column_copy_pointer (column, pointers[i]);
+      }
+      break;
+    }
+}
+
+static void
+column_clear (ClutterArrayModelPrivate *priv,
+              Column                   *column,
+              guint                     index,
+              guint                     n_rows)
+{
+  guint i;
+
+  switch (column->storage)
+    {
+    case COLUMN_STORAGE_STRING:
+      {
+        const gchar **cells = (const gchar **) COLUMN_CELL (column, index);
+
+        for (i = 0; i < n_rows; i++)
+          clutter_array_model_unref_string (priv, cells[i]);
+      }
+      break;
+
+    case COLUMN_STORAGE_POINTER:
+      if (column->fundamental != G_TYPE_POINTER)
+        {
+          gpointer *cells = (gpointer *) COLUMN_CELL (column, index);
+
+          for (i = 0; i < n_rows; i++)
+            column_free_pointer (column, cells[i]);
+        }
+      break;
+
+    default:
+      break;
+    }
+}
+
+/*
+ * Filtering
+ */
+
+static gboolean
+clutter_array_model_filter_index (ClutterArrayModel *self,
+                                  guint              index)
+{
+  CLUTTER_ARRAY_MODEL_ITER (self->priv->temp_iter)->index = index;
+
+  return clutter_model_filter_iter (CLUTTER_MODEL (self), self->priv->temp_iter);
+}
+
+/* returns the position inside the index of visible rows of the first
+ * row at or after @index
+ */
+static guint
+visible_lower_bound (GArray *visible,
+                     guint   index)
+{
+  guint lo = 0, hi = visible->len;
+
+  while (lo < hi)
+    {
+      guint mid = lo + (hi - lo) / 2;
+
+      if (g_array_index (visible, guint, mid) < index)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/* returns the index of visible rows, if it is still valid, so that it
+ * can be updated when rows are added, removed or changed
+ */
+static GArray *
+clutter_array_model_get_visible (ClutterArrayModel *self)
+{
+  ClutterArrayModelPrivate *priv = self->priv;
+  ClutterModel *model = CLUTTER_MODEL (self);
+
+  if (priv->visible == NULL)
+    return NULL;
+
+  if (!clutter_model_get_filter_set (model) ||
+      priv->filter_stamp != _clutter_model_get_filter_stamp (model))
+    {
+      g_array_unref (priv->visible);
+      priv->visible = NULL;
+    }
+
+  return priv->visible;
+}
+
+/* returns the index of visible rows, building it if needed, or NULL
+ * if no filter is set on the model
+ */
+static GArray *
+clutter_array_model_ensure_visible (ClutterArrayModel *self)
+{
+  ClutterArrayModelPrivate *priv = self->priv;
+  ClutterModel *model = CLUTTER_MODEL (self);
+  GArray *visible;
+  guint i;
+
+  if (!clutter_model_get_filter_set (model))
+    return NULL;
+
+  if (clutter_array_model_get_visible (self) != NULL)
+    return priv->visible;
+
+  visible = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  for (i = 0; i < priv->n_rows; i++)
+    {
+      if (clutter_array_model_filter_index (self, i))
+        g_array_append_val (visible, i);
+    }
+
+  priv->visible = visible;
+  priv->filter_stamp = _clutter_model_get_filter_stamp (model);
+
+  return priv->visible;
+}
+
+/* adds the rows between @position and @position + @n_rows that are not
+ * filtered out to the index of visible rows; the rows must have been
+ * opened already
+ */
+static void
+clutter_array_model_filter_rows (ClutterArrayModel *self,
+                                 guint              position,
+                                 guint              n_rows)
+{
+  GArray *visible = clutter_array_model_get_visible (self);
+  GArray *added;
+  guint i;
+
+  if (visible == NULL || n_rows == 0)
+    return;
+
+  added = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  for (i = position; i < position + n_rows; i++)
+    {
+      if (clutter_array_model_filter_index (self, i))
+        g_array_append_val (added, i);
+    }
+
+  /* the filter function could have rebuilt the index */
+  visible = clutter_array_model_get_visible (self);
+  if (visible != NULL && added->len > 0)
+    g_array_insert_vals (visible,
+                         visible_lower_bound (visible, position),
+                         added->data,
+                         added->len);
+
+  g_array_unref (added);
+}
+
+/* checks the row at @index again after one of its values changed */
+static void
+clutter_array_model_refilter_row (ClutterArrayModel *self,
+                                  guint              index)
+{
+  GArray *visible = clutter_array_model_get_visible (self);
+  gboolean was_visible, is_visible;
+  guint pos;
+
+  if (visible == NULL)
+    return;
+
+  pos = visible_lower_bound (visible, index);
+  was_visible = pos < visible->len && g_array_index (visible, guint, pos) == index;
+  is_visible = clutter_array_model_filter_index (self, index);
+
+  if (was_visible && !is_visible)
+    g_array_remove_index (visible, pos);
+  else if (!was_visible && is_visible)
+    g_array_insert_val (visible, pos, index);
+}
+
+/*
+ * Rows
+ */
+
+static void
+clutter_array_model_ensure_columns (ClutterArrayModel *self)
+{
+  ClutterArrayModelPrivate *priv = self->priv;
+  ClutterModel *model = CLUTTER_MODEL (self);
+  guint i;
+
+  /* the column types can be set after the instance has been created,
+   * for instance by ClutterScript, so we need to wait until the first
+   * row is added
+   */
+  if (priv->columns != NULL)
+    return;
+
+  priv->n_columns = clutter_model_get_n_columns (model);
+  priv->columns = g_new0 (Column, priv->n_columns);
+
+  for (i = 0; i < priv->n_columns; i++)
+    column_init (&priv->columns[i], clutter_model_get_column_type (model, i));
+}
+
+/* adds @n_rows rows at @position; the new rows are zero-filled, which
+ * is the default value of every type we store
+ */
+static void
+clutter_array_model_open_rows (ClutterArrayModel *self,
+                               guint              position,
+                               guint              n_rows)
+{
+  ClutterArrayModelPrivate *priv = self->priv;
+  guint i;
+
+  clutter_array_model_ensure_columns (self);
+
+  if (priv->n_rows + n_rows > priv->n_allocated)
+    {
+      guint n_allocated = MAX (priv->n_allocated * 2, 16);
+
+      n_allocated = MAX (n_allocated, priv->n_rows + n_rows);
+
+      for (i = 0; i < priv->n_columns; i++)
+        {
+          Column *column = &priv->columns[i];
+
+          column->data = g_realloc (column->data,
+                                    n_allocated * column->element_size);
+        }
+
+      priv->n_allocated = n_allocated;
+    }
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *column = &priv->columns[i];
+
+      memmove (COLUMN_CELL (column, position + n_rows),
+               COLUMN_CELL (column, position),
+               (priv->n_rows - position) * column->element_size);
+      memset (COLUMN_CELL (column, position), 0, n_rows * column->element_size);
+    }
+
+  priv->n_rows += n_rows;
+
+  /* the new rows are added to the index by the caller, once their
+   * values have been set
+   */
+  if (clutter_array_model_get_visible (self) != NULL)
+    {
+      GArray *visible = priv->visible;
+
+      for (i = visible_lower_bound (visible, position); i < visible->len; i++)
+        g_array_index (visible, guint, i) += n_rows;
+    }
+}
+
+static void
+clutter_array_model_close_rows (ClutterArrayModel *self,
+                                guint              position,
+                                guint              n_rows)
+{
+  ClutterArrayModelPrivate *priv = self->priv;
+  guint i;
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *column = &priv->columns[i];
+
+      column_clear (priv, column, position, n_rows);
+
+      memmove (COLUMN_CELL (column, position),
+               COLUMN_CELL (column, position + n_rows),
+               (priv->n_rows - position - n_rows) * column->element_size);
+    }
+
+  priv->n_rows -= n_rows;
+
+  if (clutter_array_model_get_visible (self) != NULL)
+    {
+      GArray *visible = priv->visible;
+      guint first, last;
+
+      first = visible_lower_bound (visible, position);
+      last = visible_lower_bound (visible, position + n_rows);
+
+      if (last > first)
+        g_array_remove_range (visible, first, last - first);
+
+      for (i = first; i < visible->len; i++)
+        g_array_index (visible, guint, i) -= n_rows;
+    }
+}
+
+/* counts the rows between @start and @end that are not filtered out */
+static guint
+clutter_array_model_count_visible (ClutterArrayModel *self,
+                                   guint              start,
+                                   guint              end)
+{
+  GArray *visible = clutter_array_model_ensure_visible (self);
+
+  if (visible == NULL)
+    return end - start;
+
+  return visible_lower_bound (visible, end) - visible_lower_bound (visible, start);
+}
+
+/* returns the position inside the columns of the given row, or
+ * G_MAXUINT if the row does not exist
+ */
+static guint
+clutter_array_model_get_index_at_row (ClutterArrayModel *self,
+                                      guint              row)
+{
+  ClutterArrayModelPrivate *priv = self->priv;
+  GArray *visible;
+
+  if (row >= priv->n_rows)
+    return G_MAXUINT;
+
+  visible = clutter_array_model_ensure_visible (self);
+
+  /* short-circuit in case we don't have a filter in place */
+  if (visible == NULL)
+    return row;
+
+  if (row >= visible->len)
+    return G_MAXUINT;
+
+  return g_array_index (visible, guint, row);
+}
+
+static ClutterModelIter *
+clutter_array_model_create_iter (ClutterArrayModel *self,
+                                 guint              index,
+                                 guint              row)
+{
+  ClutterArrayModelIter *retval;
+
+  retval = g_object_new (CLUTTER_TYPE_ARRAY_MODEL_ITER,
+                         "model", self,
+                         "row", row,
+                         NULL);
+  retval->index = index;
+
+  return CLUTTER_MODEL_ITER (retval);
+}
+
+/*
+ * ClutterArrayModelIter
+ */
+
+static inline ClutterArrayModel *
+clutter_array_model_iter_get_array_model (ClutterModelIter *iter)
+{
+  return CLUTTER_ARRAY_MODEL (clutter_model_iter_get_model (iter));
+}
+
+static void
+clutter_array_model_iter_get_value (ClutterModelIter *iter,
+                                    guint             column,
+                                    GValue           *value)
+{
+  ClutterArrayModelIter *array_iter = CLUTTER_ARRAY_MODEL_ITER (iter);
+  ClutterArrayModelPrivate *priv;
+  GValue real_value = G_VALUE_INIT;
+  Column *col;
+
+  priv = clutter_array_model_iter_get_array_model (iter)->priv;
+  g_assert (array_iter->index < priv->n_rows);
+
+  col = &priv->columns[column];
+
+  if (G_VALUE_TYPE (value) == col->gtype)
+    {
+      column_get_value (col, array_iter->index, value);
+      return;
+    }
+
+  g_value_init (&real_value, col->gtype);
+  column_get_value (col, array_iter->index, &real_value);
+
+  if (!g_value_transform (&real_value, value))
+    g_warning ("%s: Unable to make conversion from %s to %s",
+               G_STRLOC,
+               g_type_name (col->gtype),
+               g_type_name (G_VALUE_TYPE (value)));
+
+  g_value_unset (&real_value);
+}
+
+static void
+clutter_array_model_iter_set_value (ClutterModelIter *iter,
+                                    guint             column,
+                                    const GValue     *value)
+{
+  ClutterArrayModelIter *array_iter = CLUTTER_ARRAY_MODEL_ITER (iter);
+  ClutterArrayModel *model;
+  ClutterArrayModelPrivate *priv;
+  GValue real_value = G_VALUE_INIT;
+  Column *col;
+
+  model = clutter_array_model_iter_get_array_model (iter);
+  priv = model->priv;
+  g_assert (array_iter->index < priv->n_rows);
+
+  col = &priv->columns[column];
+
+  if (G_VALUE_TYPE (value) == col->gtype)
+    column_set_value (priv, col, array_iter->index, value);
+  else
+    {
+      g_value_init (&real_value, col->gtype);
+
+      if (g_value_transform (value, &real_value))
+        column_set_value (priv, col, array_iter->index, &real_value);
+      else
+        g_warning ("%s: Unable to make conversion from %s to %s",
+                   G_STRLOC,
+                   g_type_name (G_VALUE_TYPE (value)),
+                   g_type_name (col->gtype));
+
+      g_value_unset (&real_value);
+    }
+
+  clutter_array_model_refilter_row (model, array_iter->index);
+}
+
+/* the first and last iterators behave like the ones of ClutterListModel,
+ * so that the two models can be used interchangeably
+ */
+static gboolean
+clutter_array_model_iter_is_first (ClutterModelIter *iter)
+{
+  return CLUTTER_ARRAY_MODEL_ITER (iter)->index == 0;
+}
+
+static gboolean
+clutter_array_model_iter_is_last (ClutterModelIter *iter)
+{
+  ClutterArrayModel *model = clutter_array_model_iter_get_array_model (iter);
+  guint index = CLUTTER_ARRAY_MODEL_ITER (iter)->index;
+  GArray *visible;
+
+  /* the iterator is past the last row that is not filtered out */
+  visible = clutter_array_model_ensure_visible (model);
+  if (visible == NULL)
+    return index >= model->priv->n_rows;
+
+  return visible_lower_bound (visible, index) == visible->len;
+}
+
+static ClutterModelIter *
+clutter_array_model_iter_next (ClutterModelIter *iter)
+{
+  ClutterArrayModelIter *array_iter = CLUTTER_ARRAY_MODEL_ITER (iter);
+  ClutterArrayModel *model = clutter_array_model_iter_get_array_model (iter);
+  GArray *visible;
+  guint i;
+
+  i = array_iter->index + 1;
+
+  visible = clutter_array_model_ensure_visible (model);
+  if (visible != NULL)
+    {
+      guint pos = visible_lower_bound (visible, i);
+
+      i = pos < visible->len
+        ? g_array_index (visible, guint, pos)
+        : model->priv->n_rows;
+    }
+
+  array_iter->index = i;
+  _clutter_model_iter_set_row (iter, clutter_model_iter_get_row (iter) + 1);
+
+  return iter;
+}
+
+static ClutterModelIter *
+clutter_array_model_iter_prev (ClutterModelIter *iter)
+{
+  ClutterArrayModelIter *array_iter = CLUTTER_ARRAY_MODEL_ITER (iter);
+  ClutterArrayModel *model = clutter_array_model_iter_get_array_model (iter);
+  GArray *visible;
+  guint i;
+
+  i = array_iter->index > 0 ? array_iter->index - 1 : 0;
+
+  /* if there are no visible rows before this one we stop at the first
+   * row, like ClutterListModel does
+   */
+  visible = clutter_array_model_ensure_visible (model);
+  if (visible != NULL)
+    {
+      guint pos = visible_lower_bound (visible, array_iter->index);
+
+      i = pos > 0 ? g_array_index (visible, guint, pos - 1) : 0;
+    }
+
+  array_iter->index = i;
+  _clutter_model_iter_set_row (iter, clutter_model_iter_get_row (iter) - 1);
+
+  return iter;
+}
+
+static ClutterModelIter *
+clutter_array_model_iter_copy (ClutterModelIter *iter)
+{
+  return clutter_array_model_create_iter (clutter_array_model_iter_get_array_model (iter),
+                                          CLUTTER_ARRAY_MODEL_ITER (iter)->index,
+                                          clutter_model_iter_get_row (iter));
+}
+
+static void
+clutter_array_model_iter_class_init (ClutterArrayModelIterClass *klass)
+{
+  ClutterModelIterClass *iter_class = CLUTTER_MODEL_ITER_CLASS (klass);
+
+  iter_class->get_value = clutter_array_model_iter_get_value;
+  iter_class->set_value = clutter_array_model_iter_set_value;
+  iter_class->is_first  = clutter_array_model_iter_is_first;
+  iter_class->is_last   = clutter_array_model_iter_is_last;
+  iter_class->next      = clutter_array_model_iter_next;
+  iter_class->prev      = clutter_array_model_iter_prev;
+  iter_class->copy      = clutter_array_model_iter_copy;
+}
+
+static void
+clutter_array_model_iter_init (ClutterArrayModelIter *iter)
+{
+  iter->index = 0;
+}
+
+/*
+ * ClutterArrayModel
+ */
+
+static ClutterModelIter *
+clutter_array_model_get_iter_at_row (ClutterModel *model,
+                                     guint         row)
+{
+  ClutterArrayModel *self = CLUTTER_ARRAY_MODEL (model);
+  guint index;
+
+  index = clutter_array_model_get_index_at_row (self, row);
+  if (index == G_MAXUINT)
+    return NULL;
+
+  return clutter_array_model_create_iter (self, index, row);
+}
+
+static ClutterModelIter *
+clutter_array_model_insert_row (ClutterModel *model,
+                                gint          index_)
+{
+  ClutterArrayModel *self = CLUTTER_ARRAY_MODEL (model);
+  guint pos;
+
+  if (index_ < 0 || (guint) index_ > self->priv->n_rows)
+    pos = self->priv->n_rows;
+  else
+    pos = index_;
+
+  clutter_array_model_open_rows (self, pos, 1);
+  clutter_array_model_filter_rows (self, pos, 1);
+
+  return clutter_array_model_create_iter (self, pos, pos);
+}
+
+static void
+clutter_array_model_remove_row (ClutterModel *model,
+                                guint         row)
+{
+  ClutterArrayModel *self = CLUTTER_ARRAY_MODEL (model);
+  ClutterModelIter *iter;
+  guint index;
+
+  index = clutter_array_model_get_index_at_row (self, row);
+  if (index == G_MAXUINT)
+    return;
+
+  iter = clutter_array_model_create_iter (self, index, row);
+
+  /* the row is removed inside the ::row-removed class handler, so that
+   * the handlers connected to the signal still get a valid iterator
+   */
+  _clutter_model_emit_row_removed (model, iter);
+
+  g_object_unref (iter);
+}
+
+typedef struct
+{
+  ClutterModel *model;
+  GValue *values;
+  ClutterModelSortFunc func;
+  gpointer data;
+} SortClosure;
+
+static gint
+sort_rows (gconstpointer a,
+           gconstpointer b,
+           gpointer      data)
+{
+  const SortClosure *clos = data;
+
+  return clos->func (clos->model,
+                     &clos->values[*(const guint *) a],
+                     &clos->values[*(const guint *) b],
+                     clos->data);
+}
+
+static void
+clutter_array_model_resort (ClutterModel         *model,
+                            ClutterModelSortFunc  func,
+                            gpointer              data)
+{
+  ClutterArrayModel *self = CLUTTER_ARRAY_MODEL (model);
+  ClutterArrayModelPrivate *priv = self->priv;
+  SortClosure clos;
+  Column *sort_column;
+  GArray *visible;
+  guint *order;
+  gint column;
+  guint i, j;
+
+  column = clutter_model_get_sorting_column (model);
+  if (func == NULL || column < 0 || priv->n_rows < 2)
+    return;
+
+  sort_column = &priv->columns[column];
+
+  /* the sort function takes GValues, so we compute the permutation
+   * using the values of the sorting column and then we apply it to
+   * every column at once
+   */
+  clos.model = model;
+  clos.values = g_new0 (GValue, priv->n_rows);
+  clos.func = func;
+  clos.data = data;
+
+  order = g_new (guint, priv->n_rows);
+
+  for (i = 0; i < priv->n_rows; i++)
+    {
+      g_value_init (&clos.values[i], sort_column->gtype);
+      column_get_value (sort_column, i, &clos.values[i]);
+      order[i] = i;
+    }
+
+  g_qsort_with_data (order, priv->n_rows, sizeof (guint), sort_rows, &clos);
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *col = &priv->columns[i];
+      guint8 *data;
+
+      data = g_malloc (priv->n_allocated * col->element_size);
+
+      for (j = 0; j < priv->n_rows; j++)
+        memcpy (data + (gsize) j * col->element_size,
+                COLUMN_CELL (col, order[j]),
+                col->element_size);
+
+      g_free (col->data);
+      col->data = data;
+    }
+
+  /* the visible rows did not change, so we can apply the permutation
+   * to the index instead of calling the filter function again
+   */
+  visible = clutter_array_model_get_visible (self);
+  if (visible != NULL)
+    {
+      guint8 *was_visible = g_new0 (guint8, priv->n_rows);
+
+      for (i = 0; i < visible->len; i++)
+        was_visible[g_array_index (visible, guint, i)] = TRUE;
+
+      g_array_set_size (visible, 0);
+
+      for (i = 0; i < priv->n_rows; i++)
+        {
+          if (was_visible[order[i]])
+            g_array_append_val (visible, i);
+        }
+
+      g_free (was_visible);
+    }
+
+  for (i = 0; i < priv->n_rows; i++)
+    g_value_unset (&clos.values[i]);
+
+  g_free (clos.values);
+  g_free (order);
+}
+
+static guint
+clutter_array_model_get_n_rows (ClutterModel *model)
+{
+  ClutterArrayModel *self = CLUTTER_ARRAY_MODEL (model);
+
+  return clutter_array_model_count_visible (self, 0, self->priv->n_rows);
+}
+
+static void
+clutter_array_model_row_removed (ClutterModel     *model,
+                                 ClutterModelIter *iter)
+{
+  ClutterArrayModelIter *array_iter = CLUTTER_ARRAY_MODEL_ITER (iter);
+
+  clutter_array_model_close_rows (CLUTTER_ARRAY_MODEL (model),
+                                  array_iter->index,
+                                  1);
+}
+
+static void
+clutter_array_model_finalize (GObject *gobject)
+{
+  ClutterArrayModelPrivate *priv = CLUTTER_ARRAY_MODEL (gobject)->priv;
+  GHashTableIter iter;
+  gpointer key;
+  guint i;
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      column_clear (priv, &priv->columns[i], 0, priv->n_rows);
+      g_free (priv->columns[i].data);
+    }
+
+  g_free (priv->columns);
+
+  g_hash_table_iter_init (&iter, priv->strings);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    g_free (key);
+
+  g_hash_table_destroy (priv->strings);
+
+  if (priv->visible != NULL)
+    g_array_unref (priv->visible);
+
+  G_OBJECT_CLASS (clutter_array_model_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_array_model_dispose (GObject *gobject)
+{
+  ClutterArrayModelPrivate *priv = CLUTTER_ARRAY_MODEL (gobject)->priv;
+
+  g_clear_object (&priv->temp_iter);
+
+  G_OBJECT_CLASS (clutter_array_model_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_array_model_class_init (ClutterArrayModelClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterModelClass *model_class = CLUTTER_MODEL_CLASS (klass);
+
+  gobject_class->finalize = clutter_array_model_finalize;
+  gobject_class->dispose = clutter_array_model_dispose;
+
+  model_class->get_iter_at_row = clutter_array_model_get_iter_at_row;
+  model_class->insert_row = clutter_array_model_insert_row;
+  model_class->remove_row = clutter_array_model_remove_row;
+  model_class->resort = clutter_array_model_resort;
+  model_class->get_n_rows = clutter_array_model_get_n_rows;
+  model_class->row_removed = clutter_array_model_row_removed;
+}
+
+static void
+clutter_array_model_init (ClutterArrayModel *self)
+{
+  self->priv = clutter_array_model_get_instance_private (self);
+
+  self->priv->strings = g_hash_table_new (g_str_hash, g_str_equal);
+  self->priv->temp_iter = g_object_new (CLUTTER_TYPE_ARRAY_MODEL_ITER,
+                                        "model", self,
+                                        NULL);
+}
+
+/**
+ * clutter_array_model_new:
+ * @n_columns: number of columns in the model
+ * @...: @n_columns number of #GType and string pairs
+ *
+ * Creates a new #ClutterArrayModel with @n_columns columns with the
+ * types and names passed in.
+ *
+ * See clutter_list_model_new() for the format of the arguments.
+ *
+ * Return value: (transfer full): a new #ClutterArrayModel
+ *
+ * Since: 1.22
+ */
+ClutterModel *
+clutter_array_model_new (guint n_columns,
+                         ...)
+{
+  ClutterModel *model;
+  va_list args;
+  gint i;
+
+  g_return_val_if_fail (n_columns > 0, NULL);
+
+  model = g_object_new (CLUTTER_TYPE_ARRAY_MODEL, NULL);
+  _clutter_model_set_n_columns (model, n_columns, TRUE, TRUE);
+
+  va_start (args, n_columns);
+
+  for (i = 0; i < n_columns; i++)
+    {
+      GType type = va_arg (args, GType);
+      const gchar *name = va_arg (args, gchar*);
+
+      if (!_clutter_model_check_type (type))
+        {
+          g_warning ("%s: Invalid type %s\n", G_STRLOC, g_type_name (type));
+          g_object_unref (model);
+          model = NULL;
+          goto out;
+        }
+
+      _clutter_model_set_column_type (model, i, type);
+      _clutter_model_set_column_name (model, i, name);
+    }
+
+ out:
+  va_end (args);
+  return model;
+}
+
+/**
+ * clutter_array_model_newv:
+ * @n_columns: number of columns in the model
+ * @types: (array length=n_columns): an array of #GType types for the columns, from first to last
+ * @names: (array length=n_columns): an array of names for the columns, from first to last
+ *
+ * Non-vararg version of clutter_array_model_new(). This function is
+ * useful for language bindings.
+ *
+ * Return value: (transfer full): a new #ClutterArrayModel
+ *
+ * Since: 1.22
+ */
+ClutterModel *
+clutter_array_model_newv (guint                n_columns,
+                          GType               *types,
+                          const gchar * const  names[])
+{
+  ClutterModel *model;
+  gint i;
+
+  g_return_val_if_fail (n_columns > 0, NULL);
+
+  model = g_object_new (CLUTTER_TYPE_ARRAY_MODEL, NULL);
+  _clutter_model_set_n_columns (model, n_columns, TRUE, TRUE);
+
+  for (i = 0; i < n_columns; i++)
+    {
+      if (!_clutter_model_check_type (types[i]))
+        {
+          g_warning ("%s: Invalid type %s\n", G_STRLOC, g_type_name (types[i]));
+          g_object_unref (model);
+          return NULL;
+        }
+
+      _clutter_model_set_column_type (model, i, types[i]);
+      _clutter_model_set_column_name (model, i, names[i]);
+    }
+
+  return model;
+}
+
+/**
+ * clutter_array_model_splice:
+ * @model: a #ClutterArrayModel
+ * @position: the position of the first row to remove, and of the
+ *   first added row
+ * @n_removals: the number of rows to remove
+ * @n_additions: the number of rows to add
+ * @n_columns: the number of columns in @columns and @data
+ * @columns: (array length=n_columns): the columns to set on the added rows
+ * @data: (array length=n_columns): for each column in @columns, a C
+ *   array holding @n_additions values
+ *
+ * Removes @n_removals rows at @position, and adds @n_additions rows in
+ * their place, using the values in @data. Positions refer to the rows
+ * of @model regardless of the filter set on it.
+ *
+ * The type of the elements of each array in @data depends on the
+ * type of the column:
+ *
+ *  - #gint, for #gboolean, #gchar, #guchar, #gint, #guint, enumeration
+ *    and flags columns
+ *  - #gint64, for #glong, #gulong, #gint64 and #guint64 columns
+ *  - #gdouble, for #gfloat and #gdouble columns
+ *  - a string, for string columns; the strings are copied
+ *  - a pointer, for any other column; objects are referenced, and
+ *    boxed types are copied
+ *
+ * The columns of the added rows that are not in @columns are set to
+ * their default value.
+ *
+ * Unlike the other functions modifying a #ClutterModel, this function
+ * does not emit the #ClutterModel::row-added and #ClutterModel::row-removed
+ * signals for each row; the #ClutterModel::rows-changed signal is emitted
+ * once instead. If @model is sorted, the whole model is reported as
+ * changed.
+ *
+ * Since: 1.22
+ */
+void
+clutter_array_model_splice (ClutterArrayModel  *model,
+                            guint               position,
+                            guint               n_removals,
+                            guint               n_additions,
+                            guint               n_columns,
+                            const guint        *columns,
+                            gconstpointer      *data)
+{
+  ClutterArrayModelPrivate *priv;
+  ClutterModel *base;
+  guint visible_position, n_visible_removed, n_visible_added;
+  gboolean is_sorted;
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_ARRAY_MODEL (model));
+  g_return_if_fail (n_columns == 0 || (columns != NULL && data != NULL));
+
+  priv = model->priv;
+  base = CLUTTER_MODEL (model);
+
+  g_return_if_fail (position <= priv->n_rows);
+  g_return_if_fail (n_removals <= priv->n_rows - position);
+
+  clutter_array_model_ensure_columns (model);
+
+  for (i = 0; i < n_columns; i++)
+    g_return_if_fail (columns[i] < priv->n_columns);
+
+  is_sorted = clutter_model_get_sorting_column (base) >= 0;
+
+  if (is_sorted)
+    {
+      visible_position = 0;
+      n_visible_removed = clutter_model_get_n_rows (base);
+    }
+  else
+    {
+      visible_position =
+        clutter_array_model_count_visible (model, 0, position);
+      n_visible_removed =
+        clutter_array_model_count_visible (model, position, position + n_removals);
+    }
+
+  if (n_removals > 0)
+    clutter_array_model_close_rows (model, position, n_removals);
+
+  if (n_additions > 0)
+    {
+      clutter_array_model_open_rows (model, position, n_additions);
+
+      for (i = 0; i < n_columns; i++)
+        column_store (priv, &priv->columns[columns[i]],
+                      position,
+                      n_additions,
+                      data[i]);
+
+      clutter_array_model_filter_rows (model, position, n_additions);
+    }
+
+  if (is_sorted)
+    {
+      clutter_model_resort (base);
+
+      n_visible_added = clutter_model_get_n_rows (base);
+    }
+  else
+    n_visible_added =
+      clutter_array_model_count_visible (model, position, position + n_additions);
+
+  _clutter_model_emit_rows_changed (base,
+                                    visible_position,
+                                    n_visible_removed,
+                                    n_visible_added);
+}
+
+/**
+ * clutter_array_model_append_rows:
+ * @model: a #ClutterArrayModel
+ * @n_rows: the number of rows to append
+ * @n_columns: the number of columns in @columns and @data
+ * @columns: (array length=n_columns): the columns to set
+ * @data: (array length=n_columns): for each column in @columns, a C
+ *   array holding @n_rows values
+ *
+ * Appends @n_rows rows to @model, using the values in @data.
+ *
+ * See clutter_array_model_splice() for the format of @data.
+ *
+ * Since: 1.22
+ */
+void
+clutter_array_model_append_rows (ClutterArrayModel  *model,
+                                 guint               n_rows,
+                                 guint               n_columns,
+                                 const guint        *columns,
+                                 gconstpointer      *data)
+{
+  g_return_if_fail (CLUTTER_IS_ARRAY_MODEL (model));
+
+  clutter_array_model_splice (model,
+                              model->priv->n_rows, 0,
+                              n_rows,
+                              n_columns, columns,
+                              data);
+}
+
+/**
+ * clutter_array_model_iter_seek:
+ * @iter: a #ClutterModelIter created by a #ClutterArrayModel
+ * @row: the row to move @iter to
+ *
+ * Moves @iter to @row, taking into account the filter set on the
+ * model.
+ *
+ * This function allows using the same iterator to access rows in
+ * any order, instead of creating a new one using
+ * clutter_model_get_iter_at_row().
+ *
+ * Return value: %TRUE if @iter was moved, and %FALSE if @row
+ *   is out of bounds, in which case @iter is left unchanged
+ *
+ * Since: 1.22
+ */
+gboolean
+clutter_array_model_iter_seek (ClutterModelIter *iter,
+                               guint             row)
+{
+  ClutterArrayModel *model;
+  guint index;
+
+  g_return_val_if_fail (CLUTTER_IS_ARRAY_MODEL_ITER (iter), FALSE);
+
+  model = clutter_array_model_iter_get_array_model (iter);
+
+  index = clutter_array_model_get_index_at_row (model, row);
+  if (index == G_MAXUINT)
+    return FALSE;
+
+  CLUTTER_ARRAY_MODEL_ITER (iter)->index = index;
+  _clutter_model_iter_set_row (iter, row);
+
+  return TRUE;
+}
+
+static gconstpointer
+clutter_array_model_iter_get_cell (ClutterModelIter *iter,
+                                   guint             column,
+                                   ColumnStorage     storage)
+{
+  ClutterArrayModelPrivate *priv;
+  guint index;
+
+  g_return_val_if_fail (CLUTTER_IS_ARRAY_MODEL_ITER (iter), NULL);
+
+  priv = clutter_array_model_iter_get_array_model (iter)->priv;
+  index = CLUTTER_ARRAY_MODEL_ITER (iter)->index;
+
+  g_return_val_if_fail (index < priv->n_rows, NULL);
+  g_return_val_if_fail (column < priv->n_columns, NULL);
+  g_return_val_if_fail (priv->columns[column].storage == storage, NULL);
+
+  return COLUMN_CELL (&priv->columns[column], index);
+}
+
+/**
+ * clutter_array_model_iter_get_int:
+ * @iter: a #ClutterModelIter created by a #ClutterArrayModel
+ * @column: the column to read
+ *
+ * Retrieves the value of @column in the row pointed by @iter,
+ * without copying it into a #GValue.
+ *
+ * The @column must hold #gboolean, #gchar, #guchar, #gint, #guint,
+ * enumeration or flags values.
+ *
+ * Return value: the value of the column
+ *
+ * Since: 1.22
+ */
+gint
+clutter_array_model_iter_get_int (ClutterModelIter *iter,
+                                  guint             column)
+{
+  const gint *cell;
+
+  cell = clutter_array_model_iter_get_cell (iter, column, COLUMN_STORAGE_INT);
+
+  return cell != NULL ? *cell : 0;
+}
+
+/**
+ * clutter_array_model_iter_get_int64:
+ * @iter: a #ClutterModelIter created by a #ClutterArrayModel
+ * @column: the column to read
+ *
+ * Retrieves the value of @column in the row pointed by @iter,
+ * without copying it into a #GValue.
+ *
+ * The @column must hold #glong, #gulong, #gint64 or #guint64 values.
+ *
+ * Return value: the value of the column
+ *
+ * Since: 1.22
+ */
+gint64
+clutter_array_model_iter_get_int64 (ClutterModelIter *iter,
+                                    guint             column)
+{
+  const gint64 *cell;
+
+  cell = clutter_array_model_iter_get_cell (iter, column, COLUMN_STORAGE_INT64);
+
+  return cell != NULL ? *cell : 0;
+}
+
+/**
+ * clutter_array_model_iter_get_double:
+ * @iter: a #ClutterModelIter created by a #ClutterArrayModel
+ * @column: the column to read
+ *
+ * Retrieves the value of @column in the row pointed by @iter,
+ * without copying it into a #GValue.
+ *
+ * The @column must hold #gfloat or #gdouble values.
+ *
+ * Return value: the value of the column
+ *
+ * Since: 1.22
+ */
+gdouble
+clutter_array_model_iter_get_double (ClutterModelIter *iter,
+                                     guint             column)
+{
+  const gdouble *cell;
+
+  cell = clutter_array_model_iter_get_cell (iter, column, COLUMN_STORAGE_DOUBLE);
+
+  return cell != NULL ? *cell : 0.0;
+}
+
+/**
+ * clutter_array_model_iter_get_string:
+ * @iter: a #ClutterModelIter created by a #ClutterArrayModel
+ * @column: the column to read
+ *
+ * Retrieves the string in @column in the row pointed by @iter,
+ * without copying it.
+ *
+ * Return value: (transfer none): the string, owned by the model. The
+ *   string is valid until the row is changed or removed
+ *
+ * Since: 1.22
+ */
+const gchar *
+clutter_array_model_iter_get_string (ClutterModelIter *iter,
+                                     guint             column)
+{
+  const gchar * const *cell;
+
+  cell = clutter_array_model_iter_get_cell (iter, column, COLUMN_STORAGE_STRING);
+
+  return cell != NULL ? *cell : NULL;
+}
+
+/**
+ * clutter_array_model_iter_get_pointer:
+ * @iter: a #ClutterModelIter created by a #ClutterArrayModel
+ * @column: the column to read
+ *
+ * Retrieves the pointer, object or boxed value in @column in the
+ * row pointed by @iter, without copying it or acquiring a reference
+ * on it.
+ *
+ * Return value: (transfer none): the value, owned by the model. The
+ *   value is valid until the row is changed or removed
+ *
+ * Since: 1.22
+ */
+gpointer
+clutter_array_model_iter_get_pointer (ClutterModelIter *iter,
+                                      guint             column)
+{
+  gpointer const *cell;
+
+  cell = clutter_array_model_iter_get_cell (iter, column, COLUMN_STORAGE_POINTER);
+
+  return cell != NULL ? *cell : NULL;
+}
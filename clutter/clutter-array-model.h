@@ -0,0 +1,117 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#ifndef __CLUTTER_ARRAY_MODEL_H__
+#define __CLUTTER_ARRAY_MODEL_H__
+
+#include <clutter/clutter-model.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_ARRAY_MODEL                (clutter_array_model_get_type ())
+#define CLUTTER_ARRAY_MODEL(obj)                (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_ARRAY_MODEL, ClutterArrayModel))
+#define CLUTTER_IS_ARRAY_MODEL(obj)             (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_ARRAY_MODEL))
+#define CLUTTER_ARRAY_MODEL_CLASS(klass)        (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_ARRAY_MODEL, ClutterArrayModelClass))
+#define CLUTTER_IS_ARRAY_MODEL_CLASS(klass)     (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_ARRAY_MODEL))
+#define CLUTTER_ARRAY_MODEL_GET_CLASS(obj)      (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_ARRAY_MODEL, ClutterArrayModelClass))
+
+typedef struct _ClutterArrayModel               ClutterArrayModel;
+typedef struct _ClutterArrayModelPrivate        ClutterArrayModelPrivate;
+typedef struct _ClutterArrayModelClass          ClutterArrayModelClass;
+
+/**
+ * ClutterArrayModel:
+ *
+ * The #ClutterArrayModel struct contains only private data.
+ *
+ * Since: 1.22
+ */
+struct _ClutterArrayModel
+{
+  /*< private >*/
+  ClutterModel parent_instance;
+
+  ClutterArrayModelPrivate *priv;
+};
+
+/**
+ * ClutterArrayModelClass:
+ *
+ * The #ClutterArrayModelClass struct contains only private data.
+ *
+ * Since: 1.22
+ */
+struct _ClutterArrayModelClass
+{
+  /*< private >*/
+  ClutterModelClass parent_class;
+};
+
+CLUTTER_AVAILABLE_IN_1_22
+GType         clutter_array_model_get_type      (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_22
+ClutterModel *clutter_array_model_new           (guint                n_columns,
+                                                 ...);
+CLUTTER_AVAILABLE_IN_1_22
+ClutterModel *clutter_array_model_newv          (guint                n_columns,
+                                                 GType               *types,
+                                                 const gchar * const  names[]);
+
+CLUTTER_AVAILABLE_IN_1_22
+void          clutter_array_model_splice        (ClutterArrayModel   *model,
+                                                 guint                position,
+                                                 guint                n_removals,
+                                                 guint                n_additions,
+                                                 guint                n_columns,
+                                                 const guint         *columns,
+                                                 gconstpointer       *data);
+CLUTTER_AVAILABLE_IN_1_22
+void          clutter_array_model_append_rows   (ClutterArrayModel   *model,
+                                                 guint                n_rows,
+                                                 guint                n_columns,
+                                                 const guint         *columns,
+                                                 gconstpointer       *data);
+
+CLUTTER_AVAILABLE_IN_1_22
+gboolean      clutter_array_model_iter_seek     (ClutterModelIter    *iter,
+                                                 guint                row);
+CLUTTER_AVAILABLE_IN_1_22
+gint          clutter_array_model_iter_get_int  (ClutterModelIter    *iter,
+                                                 guint                column);
+CLUTTER_AVAILABLE_IN_1_22
+gint64        clutter_array_model_iter_get_int64 (ClutterModelIter   *iter,
+                                                 guint                column);
+CLUTTER_AVAILABLE_IN_1_22
+gdouble       clutter_array_model_iter_get_double (ClutterModelIter  *iter,
+                                                 guint                column);
+CLUTTER_AVAILABLE_IN_1_22
+const gchar * clutter_array_model_iter_get_string (ClutterModelIter  *iter,
+                                                 guint                column);
+CLUTTER_AVAILABLE_IN_1_22
+gpointer      clutter_array_model_iter_get_pointer (ClutterModelIter *iter,
+                                                 guint                column);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_ARRAY_MODEL_H__ */
@@ -46,6 +46,7 @@
 #include "config.h"
 #endif
 
+#include <gio/gio.h>
 #include <cogl/cogl.h>
 #include <cairo-gobject.h>
 
@@ -66,8 +67,6 @@
 
 struct _ClutterCanvasPrivate
 {
-  cairo_t *cr;
-
   int width;
   int height;
 
@@ -76,8 +75,13 @@ struct _ClutterCanvasPrivate
 
   CoglBitmap *buffer;
 
+  /* the cancellable of the draw currently in flight, if any */
+  GCancellable *draw_cancellable;
+
   int scale_factor;
   guint scale_factor_set : 1;
+  guint async : 1;
+  guint redraw_queued : 1;
 };
 
 enum
@@ -88,6 +92,7 @@ enum
   PROP_HEIGHT,
   PROP_SCALE_FACTOR,
   PROP_SCALE_FACTOR_SET,
+  PROP_ASYNC,
 
   LAST_PROP
 };
@@ -97,6 +102,7 @@ static GParamSpec *obj_props[LAST_PROP] = { NULL, };
 enum
 {
   DRAW,
+  DRAW_FINISHED,
 
   LAST_SIGNAL
 };
@@ -145,6 +151,9 @@ clutter_canvas_finalize (GObject *gobject)
 
   g_clear_pointer (&priv->texture, cogl_object_unref);
 
+  /* an in-flight draw holds a reference on the canvas */
+  g_assert (priv->draw_cancellable == NULL);
+
   G_OBJECT_CLASS (clutter_canvas_parent_class)->finalize (gobject);
 }
 
@@ -189,6 +198,11 @@ clutter_canvas_set_property (GObject      *gobject,
                                        g_value_get_int (value));
       break;
 
+    case PROP_ASYNC:
+      clutter_canvas_set_async (CLUTTER_CANVAS (gobject),
+                                g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -224,6 +238,10 @@ clutter_canvas_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->scale_factor_set);
       break;
 
+    case PROP_ASYNC:
+      g_value_set_boolean (value, priv->async);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -308,6 +326,27 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
                       -1,
                       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClutterCanvas:async:
+   *
+   * Whether the #ClutterCanvas::draw signal should be emitted inside
+   * a worker thread.
+   *
+   * When this property is set, invalidating the canvas will not block
+   * the main loop: the contents are drawn into a separate buffer, and
+   * the canvas will keep painting the previous contents until the new
+   * ones are ready. Once the buffers have been swapped, the
+   * #ClutterCanvas::draw-finished signal is emitted.
+   *
+   * Since: 1.22
+   */
+  obj_props[PROP_ASYNC] =
+    g_param_spec_boolean ("async",
+                          P_("Asynchronous"),
+                          P_("Whether the canvas should be drawn inside a thread"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   /**
    * ClutterCanvas::draw:
    * @canvas: the #ClutterCanvas that emitted the signal
@@ -322,6 +361,10 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
    * handler invocation will be automatically protected by cairo_save()
    * and cairo_restore() pairs.
    *
+   * If the #ClutterCanvas:async property is set, this signal is emitted
+   * inside a worker thread; the signal handlers must only use the
+   * Cairo context, and must not call any Clutter API.
+   *
    * Return value: %TRUE if the signal emission should stop, and
    *   %FALSE otherwise
    *
@@ -339,6 +382,27 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
                   G_TYPE_INT,
                   G_TYPE_INT);
 
+  /**
+   * ClutterCanvas::draw-finished:
+   * @canvas: the #ClutterCanvas that emitted the signal
+   *
+   * The #ClutterCanvas::draw-finished signal is emitted in the main
+   * thread when an asynchronous draw has been completed, and the new
+   * contents of the @canvas have replaced the previous ones.
+   *
+   * See also: #ClutterCanvas:async
+   *
+   * Since: 1.22
+   */
+  canvas_signals[DRAW_FINISHED] =
+    g_signal_new (I_("draw-finished"),
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  _clutter_marshal_VOID__VOID,
+                  G_TYPE_NONE, 0);
+
   gobject_class->set_property = clutter_canvas_set_property;
   gobject_class->get_property = clutter_canvas_get_property;
   gobject_class->finalize = clutter_canvas_finalize;
@@ -421,22 +485,77 @@ clutter_canvas_paint_content (ClutterContent   *content,
   priv->dirty = FALSE;
 }
 
+typedef struct _ClutterCanvasDrawData
+{
+  CoglBitmap *bitmap;
+  CoglBuffer *buffer;
+
+  cairo_surface_t *surface;
+  gboolean mapped_buffer;
+
+  int width;
+  int height;
+  int real_height;
+} ClutterCanvasDrawData;
+
+/* releases the Cogl resources held by the draw data; this must
+ * happen on the main thread
+ */
 static void
-clutter_canvas_emit_draw (ClutterCanvas *self)
+clutter_canvas_draw_data_release (ClutterCanvasDrawData *draw_data)
+{
+  if (draw_data->bitmap == NULL)
+    return;
+
+  if (draw_data->mapped_buffer)
+    cogl_buffer_unmap (draw_data->buffer);
+
+  cogl_object_unref (draw_data->bitmap);
+
+  draw_data->bitmap = NULL;
+  draw_data->buffer = NULL;
+  draw_data->mapped_buffer = FALSE;
+}
+
+static void
+clutter_canvas_draw_data_free (gpointer data)
+{
+  ClutterCanvasDrawData *draw_data = data;
+
+  /* the task data may be freed by a worker thread, so the bitmap
+   * must have been released by the time we get here
+   */
+  g_assert (draw_data->bitmap == NULL);
+
+  if (draw_data->surface != NULL)
+    cairo_surface_destroy (draw_data->surface);
+
+  g_slice_free (ClutterCanvasDrawData, draw_data);
+}
+
+/*< private >
+ * clutter_canvas_begin_draw:
+ * @self: a #ClutterCanvas
+ *
+ * Allocates a new bitmap for the canvas, and wraps its storage with
+ * a Cairo image surface.
+ *
+ * This function must be called from the main thread, as it maps the
+ * Cogl buffer backing the bitmap.
+ *
+ * Return value: the newly allocated draw data, or %NULL on failure
+ */
+static ClutterCanvasDrawData *
+clutter_canvas_begin_draw (ClutterCanvas *self)
 {
   ClutterCanvasPrivate *priv = self->priv;
+  ClutterCanvasDrawData *draw_data;
   int real_width, real_height;
-  cairo_surface_t *surface;
-  gboolean mapped_buffer;
+  CoglContext *ctx;
   unsigned char *data;
-  CoglBuffer *buffer;
   int window_scale = 1;
-  gboolean res;
-  cairo_t *cr;
-
-  g_assert (priv->width > 0 && priv->width > 0);
 
-  priv->dirty = TRUE;
+  g_assert (priv->width > 0 && priv->height > 0);
 
   if (priv->scale_factor_set)
     window_scale = priv->scale_factor;
@@ -453,55 +572,83 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
                 real_width, real_height,
                 window_scale);
 
-  if (priv->buffer == NULL)
-    {
-      CoglContext *ctx;
+  draw_data = g_slice_new0 (ClutterCanvasDrawData);
+  draw_data->width = priv->width;
+  draw_data->height = priv->height;
+  draw_data->real_height = real_height;
 
-      ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
-      priv->buffer = cogl_bitmap_new_with_size (ctx,
-                                                real_width,
-                                                real_height,
-                                                CLUTTER_CAIRO_FORMAT_ARGB32);
-    }
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  draw_data->bitmap = cogl_bitmap_new_with_size (ctx,
+                                                 real_width,
+                                                 real_height,
+                                                 CLUTTER_CAIRO_FORMAT_ARGB32);
 
-  buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
-  if (buffer == NULL)
-    return;
+  draw_data->buffer = COGL_BUFFER (cogl_bitmap_get_buffer (draw_data->bitmap));
+  if (draw_data->buffer == NULL)
+    {
+      clutter_canvas_draw_data_release (draw_data);
+      clutter_canvas_draw_data_free (draw_data);
+      return NULL;
+    }
 
-  cogl_buffer_set_update_hint (buffer, COGL_BUFFER_UPDATE_HINT_DYNAMIC);
+  cogl_buffer_set_update_hint (draw_data->buffer,
+                               COGL_BUFFER_UPDATE_HINT_DYNAMIC);
 
-  data = cogl_buffer_map (buffer,
+  data = cogl_buffer_map (draw_data->buffer,
                           COGL_BUFFER_ACCESS_READ_WRITE,
                           COGL_BUFFER_MAP_HINT_DISCARD);
 
   if (data != NULL)
     {
-      int bitmap_stride = cogl_bitmap_get_rowstride (priv->buffer);
-
-      surface = cairo_image_surface_create_for_data (data,
-                                                     CAIRO_FORMAT_ARGB32,
-                                                     real_width,
-                                                     real_height,
-                                                     bitmap_stride);
-      mapped_buffer = TRUE;
+      int bitmap_stride = cogl_bitmap_get_rowstride (draw_data->bitmap);
+
+      draw_data->surface =
+        cairo_image_surface_create_for_data (data,
+                                             CAIRO_FORMAT_ARGB32,
+                                             real_width,
+                                             real_height,
+                                             bitmap_stride);
+      draw_data->mapped_buffer = TRUE;
     }
   else
     {
-      surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
-                                            real_width,
-                                            real_height);
-
-      mapped_buffer = FALSE;
+      draw_data->surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                                       real_width,
+                                                       real_height);
+      draw_data->mapped_buffer = FALSE;
     }
 
 #ifdef HAVE_CAIRO_SURFACE_SET_DEVICE_SCALE
-  cairo_surface_set_device_scale (surface, window_scale, window_scale);
+  cairo_surface_set_device_scale (draw_data->surface,
+                                  window_scale,
+                                  window_scale);
 #endif
 
-  self->priv->cr = cr = cairo_create (surface);
+  return draw_data;
+}
+
+/*< private >
+ * clutter_canvas_draw_surface:
+ * @self: a #ClutterCanvas
+ * @draw_data: the draw data returned by clutter_canvas_begin_draw()
+ *
+ * Emits the #ClutterCanvas::draw signal using a Cairo context
+ * created for the surface inside @draw_data.
+ *
+ * This function does not call into Cogl, and it is safe to call
+ * it from a worker thread.
+ */
+static void
+clutter_canvas_draw_surface (ClutterCanvas         *self,
+                             ClutterCanvasDrawData *draw_data)
+{
+  gboolean res;
+  cairo_t *cr;
+
+  cr = cairo_create (draw_data->surface);
 
   g_signal_emit (self, canvas_signals[DRAW], 0,
-                 cr, priv->width, priv->height,
+                 cr, draw_data->width, draw_data->height,
                  &res);
 
 #ifdef CLUTTER_ENABLE_DEBUG
@@ -513,21 +660,159 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
     }
 #endif
 
-  self->priv->cr = NULL;
   cairo_destroy (cr);
+}
 
-  if (mapped_buffer)
-    cogl_buffer_unmap (buffer);
+/*< private >
+ * clutter_canvas_end_draw:
+ * @self: a #ClutterCanvas
+ * @draw_data: the draw data returned by clutter_canvas_begin_draw()
+ *
+ * Unmaps the buffer used for drawing and makes the bitmap inside
+ * @draw_data the front buffer of @self. The texture will be updated
+ * on the next paint.
+ *
+ * This function must be called from the main thread.
+ */
+static void
+clutter_canvas_end_draw (ClutterCanvas         *self,
+                         ClutterCanvasDrawData *draw_data)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+
+  if (draw_data->mapped_buffer)
+    {
+      cogl_buffer_unmap (draw_data->buffer);
+      draw_data->mapped_buffer = FALSE;
+    }
   else
     {
-      int size = cairo_image_surface_get_stride (surface) * priv->height;
-      cogl_buffer_set_data (buffer,
+      int size = cairo_image_surface_get_stride (draw_data->surface)
+               * draw_data->real_height;
+
+      cogl_buffer_set_data (draw_data->buffer,
                             0,
-                            cairo_image_surface_get_data (surface),
+                            cairo_image_surface_get_data (draw_data->surface),
                             size);
     }
 
-  cairo_surface_destroy (surface);
+  if (priv->buffer != NULL)
+    cogl_object_unref (priv->buffer);
+
+  /* transfer ownership of the bitmap */
+  priv->buffer = draw_data->bitmap;
+  draw_data->bitmap = NULL;
+  draw_data->buffer = NULL;
+
+  priv->dirty = TRUE;
+}
+
+static void
+clutter_canvas_emit_draw (ClutterCanvas *self)
+{
+  ClutterCanvasDrawData *draw_data;
+
+  draw_data = clutter_canvas_begin_draw (self);
+  if (draw_data == NULL)
+    return;
+
+  clutter_canvas_draw_surface (self, draw_data);
+  clutter_canvas_end_draw (self, draw_data);
+  clutter_canvas_draw_data_free (draw_data);
+}
+
+static void clutter_canvas_emit_draw_async (ClutterCanvas *self);
+
+static void
+clutter_canvas_draw_thread (GTask        *task,
+                            gpointer      source_object,
+                            gpointer      task_data,
+                            GCancellable *cancellable)
+{
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  clutter_canvas_draw_surface (source_object, task_data);
+
+  g_task_return_boolean (task, TRUE);
+}
+
+static void
+clutter_canvas_draw_ready (GObject      *gobject,
+                           GAsyncResult *result,
+                           gpointer      user_data)
+{
+  ClutterCanvas *self = CLUTTER_CANVAS (gobject);
+  ClutterCanvasPrivate *priv = self->priv;
+  GTask *task = G_TASK (result);
+  ClutterCanvasDrawData *draw_data = g_task_get_task_data (task);
+
+  g_clear_object (&priv->draw_cancellable);
+
+  /* if the draw was cancelled we don't swap the buffers */
+  if (g_task_propagate_boolean (task, NULL))
+    {
+      clutter_canvas_end_draw (self, draw_data);
+
+      _clutter_content_queue_redraw (CLUTTER_CONTENT (self));
+
+      g_signal_emit (self, canvas_signals[DRAW_FINISHED], 0);
+    }
+
+  /* the task may be finalized on the worker thread */
+  clutter_canvas_draw_data_release (draw_data);
+
+  if (priv->redraw_queued)
+    {
+      priv->redraw_queued = FALSE;
+
+      if (!priv->async)
+        clutter_content_invalidate (CLUTTER_CONTENT (self));
+      else if (priv->width > 0 && priv->height > 0)
+        clutter_canvas_emit_draw_async (self);
+    }
+}
+
+static void
+clutter_canvas_emit_draw_async (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  ClutterCanvasDrawData *draw_data;
+  GTask *task;
+
+  /* coalesce invalidations while a draw is in flight: the last one
+   * wins, and it will be started once the current one is done
+   */
+  if (priv->draw_cancellable != NULL)
+    {
+      priv->redraw_queued = TRUE;
+      return;
+    }
+
+  draw_data = clutter_canvas_begin_draw (self);
+  if (draw_data == NULL)
+    return;
+
+  priv->draw_cancellable = g_cancellable_new ();
+
+  task = g_task_new (self, priv->draw_cancellable,
+                     clutter_canvas_draw_ready,
+                     NULL);
+  g_task_set_source_tag (task, clutter_canvas_emit_draw_async);
+  g_task_set_task_data (task, draw_data, clutter_canvas_draw_data_free);
+  g_task_run_in_thread (task, clutter_canvas_draw_thread);
+  g_object_unref (task);
+}
+
+static void
+clutter_canvas_cancel_draw (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+
+  priv->redraw_queued = FALSE;
+
+  if (priv->draw_cancellable != NULL)
+    g_cancellable_cancel (priv->draw_cancellable);
 }
 
 static void
@@ -536,6 +821,33 @@ clutter_canvas_invalidate (ClutterContent *content)
   ClutterCanvas *self = CLUTTER_CANVAS (content);
   ClutterCanvasPrivate *priv = self->priv;
 
+  if (priv->async)
+    {
+      /* keep the current buffer around, so that we can keep
+       * painting it until the new contents are ready
+       */
+      if (priv->width <= 0 || priv->height <= 0)
+        {
+          clutter_canvas_cancel_draw (self);
+          g_clear_pointer (&priv->buffer, cogl_object_unref);
+          g_clear_pointer (&priv->texture, cogl_object_unref);
+          return;
+        }
+
+      clutter_canvas_emit_draw_async (self);
+      return;
+    }
+
+  /* a cancelled draw might still be running inside a worker thread,
+   * and the ::draw signal cannot be emitted on the same instance from
+   * two threads at once; we draw as soon as the worker is done
+   */
+  if (priv->draw_cancellable != NULL)
+    {
+      priv->redraw_queued = TRUE;
+      return;
+    }
+
   if (priv->buffer != NULL)
     {
       cogl_object_unref (priv->buffer);
@@ -749,3 +1061,70 @@ clutter_canvas_get_scale_factor (ClutterCanvas *canvas)
 
   return canvas->priv->scale_factor;
 }
+
+/**
+ * clutter_canvas_set_async:
+ * @canvas: a #ClutterCanvas
+ * @async: whether the @canvas should be drawn asynchronously
+ *
+ * Sets whether the #ClutterCanvas::draw signal should be emitted
+ * inside a worker thread when @canvas is invalidated.
+ *
+ * While an asynchronous draw is in progress, @canvas will keep
+ * painting its previous contents; further invalidations are coalesced
+ * into a single draw, which will start once the current one is done.
+ *
+ * Switching back to synchronous drawing will cancel any pending
+ * asynchronous draw, and draw the contents of @canvas synchronously
+ * in its place, as soon as the worker thread is done with it.
+ *
+ * Since: 1.22
+ */
+void
+clutter_canvas_set_async (ClutterCanvas *canvas,
+                          gboolean       async)
+{
+  ClutterCanvasPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+
+  priv = canvas->priv;
+
+  async = !!async;
+
+  if (priv->async == async)
+    return;
+
+  priv->async = async;
+
+  if (!priv->async &&
+      (priv->draw_cancellable != NULL || priv->redraw_queued))
+    {
+      clutter_canvas_cancel_draw (canvas);
+
+      /* the cancelled draw would have replaced the current contents,
+       * so we need to draw them again, this time synchronously
+       */
+      clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (canvas), obj_props[PROP_ASYNC]);
+}
+
+/**
+ * clutter_canvas_get_async:
+ * @canvas: a #ClutterCanvas
+ *
+ * Retrieves the value set using clutter_canvas_set_async().
+ *
+ * Return value: %TRUE if the @canvas is drawn inside a worker thread
+ *
+ * Since: 1.22
+ */
+gboolean
+clutter_canvas_get_async (ClutterCanvas *canvas)
+{
+  g_return_val_if_fail (CLUTTER_IS_CANVAS (canvas), FALSE);
+
+  return canvas->priv->async;
+}
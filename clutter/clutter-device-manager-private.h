@@ -112,8 +112,11 @@ struct _ClutterInputDevice
   gint current_button_number;
   ClutterModifierType current_state;
 
-  /* the current touch points states */
-  GHashTable *touch_sequences_info;
+  /* the current touch points states, indexed by slot; the slots
+   * of the ended sequences have a NULL sequence, and are reused
+   */
+  GArray *touch_slots;
+  guint n_touch_points;
 
   /* the previous state, used for click count generation */
   gint previous_x;
@@ -155,6 +158,8 @@ ClutterBackend *_clutter_device_manager_get_backend             (ClutterDeviceMa
 /* input device */
 gboolean        _clutter_input_device_has_sequence              (ClutterInputDevice   *device,
                                                                  ClutterEventSequence *sequence);
+gint            _clutter_input_device_lookup_touch_slot         (ClutterInputDevice   *device,
+                                                                 ClutterEventSequence *sequence);
 void            _clutter_input_device_add_event_sequence        (ClutterInputDevice   *device,
                                                                  ClutterEvent         *event);
 void            _clutter_input_device_remove_event_sequence     (ClutterInputDevice   *device,
@@ -402,52 +402,162 @@ clutter_ease_steps_end (double t,
   return ease_steps_end ((t / d), n_steps);
 }
 
+/* the cubic bezier curves are evaluated by finding the parameter t for
+ * the given X coordinate, and then computing the Y coordinate for it;
+ * the first step is done using Newton-Raphson, starting from a guess
+ * interpolated from a table of samples computed when the curve is set
+ * up, and falling back to bisection where the curve is too flat
+ */
+#define CUBIC_BEZIER_SAMPLE_STEP        (1.0 / (CLUTTER_CUBIC_BEZIER_N_SAMPLES - 1))
+#define CUBIC_BEZIER_NEWTON_MIN_SLOPE   0.02
+#define CUBIC_BEZIER_NEWTON_ITERATIONS  8
+#define CUBIC_BEZIER_EPSILON            1e-9
+
 static inline double
-x_for_t (double t,
-         double x_1,
-         double x_2)
+cubic_bezier_sample_x (const ClutterCubicBezier *bezier,
+                       double                    t)
 {
-  double omt = 1.0 - t;
+  return ((bezier->ax * t + bezier->bx) * t + bezier->cx) * t;
+}
 
-  return 3.0 * omt * omt * t * x_1
-       + 3.0 * omt * t * t * x_2
-       + t * t * t;
+static inline double
+cubic_bezier_sample_y (const ClutterCubicBezier *bezier,
+                       double                    t)
+{
+  return ((bezier->ay * t + bezier->by) * t + bezier->cy) * t;
 }
 
 static inline double
-y_for_t (double t,
-         double y_1,
-         double y_2)
+cubic_bezier_sample_dx (const ClutterCubicBezier *bezier,
+                        double                    t)
 {
-  double omt = 1.0 - t;
+  return (3.0 * bezier->ax * t + 2.0 * bezier->bx) * t + bezier->cx;
+}
 
-  return 3.0 * omt * omt * t * y_1
-       + 3.0 * omt * t * t * y_2
-       + t * t * t;
+/*< private >
+ * clutter_cubic_bezier_init:
+ * @bezier: the #ClutterCubicBezier to initialize
+ * @x_1: the X coordinate of the first control point
+ * @y_1: the Y coordinate of the first control point
+ * @x_2: the X coordinate of the second control point
+ * @y_2: the Y coordinate of the second control point
+ *
+ * Computes the polynomial coefficients and the samples used to
+ * evaluate the cubic bezier curve between (0, 0) and (1, 1) with
+ * the given control points.
+ */
+void
+clutter_cubic_bezier_init (ClutterCubicBezier *bezier,
+                           double              x_1,
+                           double              y_1,
+                           double              x_2,
+                           double              y_2)
+{
+  int i;
+
+  bezier->cx = 3.0 * x_1;
+  bezier->bx = 3.0 * (x_2 - x_1) - bezier->cx;
+  bezier->ax = 1.0 - bezier->cx - bezier->bx;
+
+  bezier->cy = 3.0 * y_1;
+  bezier->by = 3.0 * (y_2 - y_1) - bezier->cy;
+  bezier->ay = 1.0 - bezier->cy - bezier->by;
+
+  bezier->is_linear = x_1 == y_1 && x_2 == y_2;
+
+  for (i = 0; i < CLUTTER_CUBIC_BEZIER_N_SAMPLES; i++)
+    bezier->samples[i] = cubic_bezier_sample_x (bezier, i * CUBIC_BEZIER_SAMPLE_STEP);
 }
 
 static inline double
-t_for_x (double x,
-         double x_1,
-         double x_2)
+cubic_bezier_t_for_x (const ClutterCubicBezier *bezier,
+                      double                    x)
 {
-  double min_t = 0, max_t = 1;
+  double min_t, max_t, t, slope;
   int i;
 
-  for (i = 0; i < 30; ++i)
+  /* find the interval of samples containing x; the curve is
+   * monotonic on the X axis, since the control points are
+   * clamped to the [ 0, 1 ] range
+   */
+  for (i = 1; i < CLUTTER_CUBIC_BEZIER_N_SAMPLES - 1; i++)
+    {
+      if (bezier->samples[i] > x)
+        break;
+    }
+
+  i -= 1;
+
+  min_t = i * CUBIC_BEZIER_SAMPLE_STEP;
+  max_t = min_t + CUBIC_BEZIER_SAMPLE_STEP;
+
+  t = min_t;
+  if (bezier->samples[i + 1] > bezier->samples[i])
+    t += (x - bezier->samples[i])
+       / (bezier->samples[i + 1] - bezier->samples[i])
+       * CUBIC_BEZIER_SAMPLE_STEP;
+
+  slope = cubic_bezier_sample_dx (bezier, t);
+  if (slope >= CUBIC_BEZIER_NEWTON_MIN_SLOPE)
     {
-      double guess_t = (min_t + max_t) / 2.0;
-      double guess_x = x_for_t (guess_t, x_1, x_2);
+      for (i = 0; i < CUBIC_BEZIER_NEWTON_ITERATIONS; i++)
+        {
+          double delta = cubic_bezier_sample_x (bezier, t) - x;
 
-      if (x < guess_x)
-        max_t = guess_t;
+          if (fabs (delta) < CUBIC_BEZIER_EPSILON)
+            return t;
+
+          slope = cubic_bezier_sample_dx (bezier, t);
+          if (slope == 0.0)
+            break;
+
+          t -= delta / slope;
+        }
+
+      if (t >= min_t && t <= max_t &&
+          fabs (cubic_bezier_sample_x (bezier, t) - x) < CUBIC_BEZIER_EPSILON)
+        return t;
+    }
+
+  /* the curve is too flat for Newton-Raphson to converge */
+  while (max_t - min_t > CUBIC_BEZIER_EPSILON)
+    {
+      t = (min_t + max_t) / 2.0;
+
+      if (x < cubic_bezier_sample_x (bezier, t))
+        max_t = t;
       else
-        min_t = guess_t;
+        min_t = t;
     }
 
   return (min_t + max_t) / 2.0;
 }
 
+/*< private >
+ * clutter_cubic_bezier_evaluate:
+ * @bezier: an initialized #ClutterCubicBezier
+ * @p: the progress, between 0.0 and 1.0
+ *
+ * Evaluates the cubic bezier curve for the given progress.
+ *
+ * Return value: the eased progress
+ */
+double
+clutter_cubic_bezier_evaluate (const ClutterCubicBezier *bezier,
+                               double                    p)
+{
+  if (p <= 0.0)
+    return 0.0;
+
+  if (p >= 1.0)
+    return 1.0;
+
+  if (bezier->is_linear)
+    return p;
+
+  return cubic_bezier_sample_y (bezier, cubic_bezier_t_for_x (bezier, p));
+}
+
 double
 clutter_ease_cubic_bezier (double t,
                            double d,
@@ -456,6 +566,7 @@ clutter_ease_cubic_bezier (double t,
                            double x_2,
                            double y_2)
 {
+  ClutterCubicBezier bezier;
   double p = t / d;
 
   if (p == 0.0)
@@ -464,7 +575,9 @@ clutter_ease_cubic_bezier (double t,
   if (p == 1.0)
     return 1.0;
 
-  return y_for_t (t_for_x (p, x_1, x_2), y_1, y_2);
+  clutter_cubic_bezier_init (&bezier, x_1, y_1, x_2, y_2);
+
+  return clutter_cubic_bezier_evaluate (&bezier, p);
 }
 
 /*< private >
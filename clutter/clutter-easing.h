@@ -16,6 +16,25 @@ G_BEGIN_DECLS
  */
 typedef double (* ClutterEasingFunc) (double t, double d);
 
+#define CLUTTER_CUBIC_BEZIER_N_SAMPLES  11
+
+/*< private >
+ * ClutterCubicBezier:
+ *
+ * The precomputed state of a cubic bezier easing curve.
+ */
+typedef struct _ClutterCubicBezier
+{
+  /* polynomial coefficients */
+  double ax, bx, cx;
+  double ay, by, cy;
+
+  /* the X coordinate of the curve at uniformly spaced values of t */
+  double samples[CLUTTER_CUBIC_BEZIER_N_SAMPLES];
+
+  guint is_linear : 1;
+} ClutterCubicBezier;
+
 G_GNUC_INTERNAL
 ClutterEasingFunc       clutter_get_easing_func_for_mode        (ClutterAnimationMode mode);
 
@@ -27,6 +46,16 @@ double                  clutter_easing_for_mode                 (ClutterAnimatio
                                                                  double               t,
                                                                  double               d);
 
+G_GNUC_INTERNAL
+void                    clutter_cubic_bezier_init               (ClutterCubicBezier       *bezier,
+                                                                 double                    x_1,
+                                                                 double                    y_1,
+                                                                 double                    x_2,
+                                                                 double                    y_2);
+G_GNUC_INTERNAL
+double                  clutter_cubic_bezier_evaluate           (const ClutterCubicBezier *bezier,
+                                                                 double                    p);
+
 G_GNUC_INTERNAL
 double  clutter_linear                  (double t,
                                          double d);
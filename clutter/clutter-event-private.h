@@ -8,6 +8,14 @@ G_BEGIN_DECLS
 void            _clutter_event_set_pointer_emulated     (ClutterEvent       *event,
                                                          gboolean            is_emulated);
 
+void            _clutter_event_set_time_usec            (ClutterEvent       *event,
+                                                         gint64              time_usec);
+gint64          _clutter_event_get_time_usec            (const ClutterEvent *event);
+
+void            _clutter_event_set_touch_slot           (ClutterEvent       *event,
+                                                         gint                slot);
+gint            _clutter_event_get_touch_slot           (const ClutterEvent *event);
+
 /* Reinjecting queued events for processing */
 void            _clutter_process_event                  (ClutterEvent       *event);
 
@@ -0,0 +1,376 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterEventResampler: per-device history of pointer and touch
+ * positions, used to resample motion events at the frame time.
+ *
+ * When motion events are throttled, the stage only delivers the last
+ * motion or touch update event of each device for every frame; on input
+ * devices reporting at a higher rate than the display refresh rate this
+ * means that the delivered position depends on when the last event
+ * happened to arrive, which results in uneven movement.
+ *
+ * The resampler keeps the last few positions of each pointer and touch
+ * sequence, and moves the delivered event to a fixed point in time
+ * relative to the frame, interpolating between the last two samples or,
+ * if the frame time is past the last sample, extrapolating from them by
+ * a bounded amount.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-event-resampler.h"
+
+#include "clutter-debug.h"
+#include "clutter-event-private.h"
+#include "clutter-private.h"
+
+/* the number of samples kept for each pointer or touch sequence */
+#define N_SAMPLES               4
+
+/* the delay between the frame time and the time at which the events
+ * are resampled, so that most of the time we interpolate between two
+ * real samples instead of extrapolating
+ */
+#define RESAMPLE_LATENCY        5000
+
+/* samples that are too close are not reliable for extrapolation, and
+ * samples that are too far apart likely don't belong to the same motion
+ */
+#define RESAMPLE_MIN_DELTA      2000
+#define RESAMPLE_MAX_DELTA      20000
+
+/* the maximum amount of time we predict past the last sample */
+#define RESAMPLE_MAX_PREDICTION 8000
+
+typedef struct _Sample
+{
+  gint64 time;            /* the event time, in microseconds */
+  gint64 receive_time;    /* the monotonic time the event was queued */
+
+  gfloat x;
+  gfloat y;
+} Sample;
+
+typedef struct _Stream
+{
+  /* not referenced; see _clutter_event_resampler_remove_device() */
+  ClutterInputDevice *device;
+  ClutterEventSequence *sequence;
+
+  /* the last event queued for the device or sequence; only this event
+   * can be resampled, as any event after it would be out of order
+   */
+  const ClutterEvent *last_event;
+
+  /* the time of the last resampled event */
+  gint64 last_resample_time;
+
+  Sample samples[N_SAMPLES];
+  guint n_samples;
+  guint head;
+} Stream;
+
+struct _ClutterEventResampler
+{
+  GArray *streams;
+};
+
+ClutterEventResampler *
+_clutter_event_resampler_new (void)
+{
+  ClutterEventResampler *resampler;
+
+  resampler = g_slice_new (ClutterEventResampler);
+  resampler->streams = g_array_new (FALSE, FALSE, sizeof (Stream));
+
+  return resampler;
+}
+
+void
+_clutter_event_resampler_free (ClutterEventResampler *resampler)
+{
+  g_return_if_fail (resampler != NULL);
+
+  g_array_unref (resampler->streams);
+  g_slice_free (ClutterEventResampler, resampler);
+}
+
+void
+_clutter_event_resampler_reset (ClutterEventResampler *resampler)
+{
+  g_array_set_size (resampler->streams, 0);
+}
+
+/* there is only a handful of pointers and touch points at any given
+ * time, so a linear search is good enough
+ */
+static Stream *
+get_stream (ClutterEventResampler *resampler,
+            ClutterInputDevice    *device,
+            ClutterEventSequence  *sequence,
+            gboolean               create)
+{
+  Stream *stream;
+  guint i;
+
+  for (i = 0; i < resampler->streams->len; i++)
+    {
+      stream = &g_array_index (resampler->streams, Stream, i);
+
+      if (stream->device == device && stream->sequence == sequence)
+        return stream;
+    }
+
+  if (!create)
+    return NULL;
+
+  g_array_set_size (resampler->streams, resampler->streams->len + 1);
+
+  stream = &g_array_index (resampler->streams, Stream,
+                           resampler->streams->len - 1);
+  memset (stream, 0, sizeof (Stream));
+  stream->device = device;
+  stream->sequence = sequence;
+
+  return stream;
+}
+
+static void
+remove_stream (ClutterEventResampler *resampler,
+               ClutterInputDevice    *device,
+               ClutterEventSequence  *sequence)
+{
+  Stream *stream = get_stream (resampler, device, sequence, FALSE);
+
+  if (stream != NULL)
+    g_array_remove_index_fast (resampler->streams,
+                               stream - (Stream *) resampler->streams->data);
+}
+
+/*< private >
+ * _clutter_event_resampler_remove_device:
+ * @resampler: a #ClutterEventResampler
+ * @device: a #ClutterInputDevice
+ *
+ * Forgets the positions of @device and of its touch sequences; the
+ * streams only keep a pointer to the device, so this function must be
+ * called when @device is removed.
+ */
+void
+_clutter_event_resampler_remove_device (ClutterEventResampler *resampler,
+                                        ClutterInputDevice    *device)
+{
+  guint i = 0;
+
+  while (i < resampler->streams->len)
+    {
+      Stream *stream = &g_array_index (resampler->streams, Stream, i);
+
+      if (stream->device == device)
+        g_array_remove_index_fast (resampler->streams, i);
+      else
+        i++;
+    }
+}
+
+static inline const Sample *
+stream_get_sample (const Stream *stream,
+                   guint         age)
+{
+  return &stream->samples[(stream->head + N_SAMPLES - age) % N_SAMPLES];
+}
+
+static void
+stream_add_sample (Stream             *stream,
+                   const ClutterEvent *event,
+                   gint64              receive_time)
+{
+  gint64 time = _clutter_event_get_time_usec (event);
+  Sample *sample;
+
+  if (stream->n_samples > 0)
+    {
+      const Sample *last = stream_get_sample (stream, 0);
+
+      /* the event clock went backwards, or wrapped around */
+      if (time < last->time)
+        {
+          stream->n_samples = 0;
+          stream->last_resample_time = 0;
+        }
+      else if (time > last->time)
+        stream->head = (stream->head + 1) % N_SAMPLES;
+      else
+        {
+          /* same time: the newer position replaces the older one */
+          stream->n_samples -= 1;
+        }
+    }
+
+  sample = &stream->samples[stream->head];
+  sample->time = time;
+  sample->receive_time = receive_time;
+  clutter_event_get_coords (event, &sample->x, &sample->y);
+
+  stream->n_samples = MIN (stream->n_samples + 1, N_SAMPLES);
+}
+
+/*< private >
+ * _clutter_event_resampler_add_event:
+ * @resampler: a #ClutterEventResampler
+ * @event: a queued event
+ * @receive_time: the monotonic time at which @event was queued
+ *
+ * Records the position of @event, if it is a pointer motion or a touch
+ * event. Every event queued on the stage should be passed to this
+ * function, so that only the last event of a device can be resampled.
+ */
+void
+_clutter_event_resampler_add_event (ClutterEventResampler *resampler,
+                                    const ClutterEvent    *event,
+                                    gint64                 receive_time)
+{
+  ClutterInputDevice *device;
+  ClutterEventSequence *sequence;
+  Stream *stream;
+
+  device = clutter_event_get_device (event);
+  if (device == NULL)
+    return;
+
+  sequence = clutter_event_get_event_sequence (event);
+
+  switch (event->type)
+    {
+    case CLUTTER_MOTION:
+    case CLUTTER_TOUCH_UPDATE:
+      stream = get_stream (resampler, device, sequence, TRUE);
+      stream_add_sample (stream, event, receive_time);
+      stream->last_event = event;
+      break;
+
+    case CLUTTER_TOUCH_BEGIN:
+      stream = get_stream (resampler, device, sequence, TRUE);
+      stream->n_samples = 0;
+      stream->last_resample_time = 0;
+      stream_add_sample (stream, event, receive_time);
+      stream->last_event = event;
+      break;
+
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCH_CANCEL:
+    case CLUTTER_LEAVE:
+      remove_stream (resampler, device, sequence);
+      break;
+
+    default:
+      stream = get_stream (resampler, device, sequence, FALSE);
+      if (stream != NULL)
+        stream->last_event = event;
+      break;
+    }
+}
+
+/*< private >
+ * _clutter_event_resampler_resample:
+ * @resampler: a #ClutterEventResampler
+ * @event: a motion or touch update event passed to
+ *   _clutter_event_resampler_add_event()
+ * @frame_time: the monotonic time of the frame
+ *
+ * Moves @event to the position its device had at @frame_time, minus
+ * a fixed latency, by interpolating or extrapolating the positions of
+ * the last events of the same device or touch sequence.
+ *
+ * The time of the event is expressed in the clock of the windowing
+ * system, so the offset between the two clocks is estimated from the
+ * time at which the recent events have been queued.
+ *
+ * Return value: %TRUE if the coordinates and time of @event changed
+ */
+gboolean
+_clutter_event_resampler_resample (ClutterEventResampler *resampler,
+                                   ClutterEvent          *event,
+                                   gint64                 frame_time)
+{
+  const Sample *a, *b;
+  Stream *stream;
+  gint64 offset, target, delta;
+  gdouble alpha;
+  gfloat x, y;
+  guint i;
+
+  if (event->type != CLUTTER_MOTION && event->type != CLUTTER_TOUCH_UPDATE)
+    return FALSE;
+
+  stream = get_stream (resampler,
+                       clutter_event_get_device (event),
+                       clutter_event_get_event_sequence (event),
+                       FALSE);
+  if (stream == NULL || stream->last_event != event || stream->n_samples < 2)
+    return FALSE;
+
+  b = stream_get_sample (stream, 0);
+  a = stream_get_sample (stream, 1);
+
+  delta = b->time - a->time;
+  if (delta < RESAMPLE_MIN_DELTA || delta > RESAMPLE_MAX_DELTA)
+    return FALSE;
+
+  /* the delivery delay of the fastest event is our best estimate of
+   * the offset between the event clock and the monotonic clock
+   */
+  offset = G_MAXINT64;
+  for (i = 0; i < stream->n_samples; i++)
+    {
+      const Sample *sample = stream_get_sample (stream, i);
+
+      offset = MIN (offset, sample->receive_time - sample->time);
+    }
+
+  target = frame_time - offset - RESAMPLE_LATENCY;
+
+  /* too late to interpolate; resampling would move the event back */
+  if (target <= a->time || target <= stream->last_resample_time)
+    return FALSE;
+
+  if (target > b->time)
+    target = MIN (target, b->time + MIN (delta / 2, RESAMPLE_MAX_PREDICTION));
+
+  alpha = (gdouble) (target - a->time) / delta;
+  x = a->x + (b->x - a->x) * alpha;
+  y = a->y + (b->y - a->y) * alpha;
+
+  CLUTTER_NOTE (EVENT, "Resampling event at %.2f, %.2f to %.2f, %.2f "
+                       "(%+" G_GINT64_FORMAT " us)",
+                b->x, b->y,
+                x, y,
+                target - b->time);
+
+  clutter_event_set_coords (event, x, y);
+  _clutter_event_set_time_usec (event, target);
+
+  stream->last_resample_time = target;
+
+  return TRUE;
+}
@@ -0,0 +1,47 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterEventResampler: per-device history of pointer and touch
+ * positions, used to resample motion events at the frame time.
+ */
+
+#ifndef __CLUTTER_EVENT_RESAMPLER_H__
+#define __CLUTTER_EVENT_RESAMPLER_H__
+
+#include <clutter/clutter-event.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterEventResampler   ClutterEventResampler;
+
+ClutterEventResampler * _clutter_event_resampler_new            (void);
+void                    _clutter_event_resampler_free           (ClutterEventResampler *resampler);
+
+void                    _clutter_event_resampler_add_event      (ClutterEventResampler *resampler,
+                                                                 const ClutterEvent    *event,
+                                                                 gint64                 receive_time);
+gboolean                _clutter_event_resampler_resample       (ClutterEventResampler *resampler,
+                                                                 ClutterEvent          *event,
+                                                                 gint64                 frame_time);
+void                    _clutter_event_resampler_reset          (ClutterEventResampler *resampler);
+void                    _clutter_event_resampler_remove_device  (ClutterEventResampler *resampler,
+                                                                 ClutterInputDevice    *device);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_EVENT_RESAMPLER_H__ */
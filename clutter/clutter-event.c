@@ -29,6 +29,7 @@
 
 #include "clutter-backend-private.h"
 #include "clutter-debug.h"
+#include "clutter-device-manager-private.h"
 #include "clutter-event-private.h"
 #include "clutter-keysyms.h"
 #include "clutter-private.h"
@@ -56,6 +57,12 @@ typedef struct _ClutterEventPrivate {
 
   gpointer platform_data;
 
+  /* the time of the event in microseconds, if the backend has it */
+  gint64 time_usec;
+
+  /* the touch slot of the sequence, plus one; 0 if unknown */
+  gint touch_slot;
+
   ClutterModifierType button_state;
   ClutterModifierType base_state;
   ClutterModifierType latched_state;
@@ -153,6 +160,105 @@ _clutter_event_set_pointer_emulated (ClutterEvent *event,
   ((ClutterEventPrivate *) event)->is_pointer_emulated = !!is_emulated;
 }
 
+/*< private >
+ * _clutter_event_set_time_usec:
+ * @event: a #ClutterEvent
+ * @time_usec: the time of the event, in microseconds
+ *
+ * Sets the time of the event with microsecond precision, for the
+ * backends that have it. The time returned by clutter_event_get_time()
+ * is updated as well.
+ */
+void
+_clutter_event_set_time_usec (ClutterEvent *event,
+                              gint64        time_usec)
+{
+  event->any.time = (guint32) (time_usec / 1000);
+
+  if (!is_event_allocated (event))
+    return;
+
+  ((ClutterEventPrivate *) event)->time_usec = time_usec;
+}
+
+/*< private >
+ * _clutter_event_get_time_usec:
+ * @event: a #ClutterEvent
+ *
+ * Retrieves the time of the event in microseconds. If the backend did
+ * not provide it, or if the time has been changed afterwards using
+ * clutter_event_set_time(), the time in milliseconds is converted.
+ *
+ * Return value: the time of the event, in microseconds
+ */
+gint64
+_clutter_event_get_time_usec (const ClutterEvent *event)
+{
+  if (is_event_allocated (event))
+    {
+      const ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+
+      if (real_event->time_usec != 0 &&
+          (guint32) (real_event->time_usec / 1000) == event->any.time)
+        return real_event->time_usec;
+    }
+
+  return (gint64) event->any.time * 1000;
+}
+
+/*< private >
+ * _clutter_event_set_touch_slot:
+ * @event: a touch #ClutterEvent
+ * @slot: the slot of the event sequence, or -1
+ *
+ * Stores the slot of the sequence of @event in the input device, as
+ * returned by _clutter_input_device_lookup_touch_slot(), so that the
+ * code handling the event does not need to look it up again.
+ */
+void
+_clutter_event_set_touch_slot (ClutterEvent *event,
+                               gint          slot)
+{
+  if (!is_event_allocated (event))
+    return;
+
+  ((ClutterEventPrivate *) event)->touch_slot = slot + 1;
+}
+
+/*< private >
+ * _clutter_event_get_touch_slot:
+ * @event: a #ClutterEvent
+ *
+ * Retrieves the slot of the touch point of @event in its input device.
+ *
+ * Return value: the slot, or -1 if @event is not a touch event or
+ *   its sequence is not tracked by the input device
+ */
+gint
+_clutter_event_get_touch_slot (const ClutterEvent *event)
+{
+  ClutterEventSequence *sequence;
+  ClutterInputDevice *device;
+
+  sequence = clutter_event_get_event_sequence (event);
+  if (sequence == NULL)
+    return -1;
+
+  if (is_event_allocated (event))
+    {
+      const ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+
+      if (real_event->touch_slot > 0)
+        return real_event->touch_slot - 1;
+    }
+
+  device = clutter_event_get_device (event);
+  if (device == NULL)
+    return -1;
+
+  return _clutter_input_device_lookup_touch_slot (device, sequence);
+}
+
 /**
  * clutter_event_type:
  * @event: a #ClutterEvent
@@ -1235,6 +1341,8 @@ clutter_event_copy (const ClutterEvent *event)
       new_real_event->delta_x = real_event->delta_x;
       new_real_event->delta_y = real_event->delta_y;
       new_real_event->is_pointer_emulated = real_event->is_pointer_emulated;
+      new_real_event->time_usec = real_event->time_usec;
+      new_real_event->touch_slot = real_event->touch_slot;
       new_real_event->base_state = real_event->base_state;
       new_real_event->button_state = real_event->button_state;
       new_real_event->latched_state = real_event->latched_state;
@@ -91,6 +91,7 @@
 
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
+#include "clutter-event-private.h"
 #include "clutter-marshal.h"
 #include "clutter-private.h"
 
@@ -103,6 +104,7 @@ typedef struct
 {
   ClutterInputDevice *device;
   ClutterEventSequence *sequence;
+  gint slot;
   ClutterEvent *last_event;
 
   gfloat press_x, press_y;
@@ -120,6 +122,11 @@ struct _ClutterGestureActionPrivate
   gint requested_nb_points;
   GArray *points;
 
+  /* the position inside points of the touch point using each slot
+   * of the input devices, or -1
+   */
+  GArray *slot_points;
+
   guint actor_capture_id;
   gulong stage_capture_id;
 
@@ -127,6 +134,7 @@ struct _ClutterGestureActionPrivate
   float distance_x, distance_y;
 
   guint in_gesture : 1;
+  guint has_unslotted_points : 1;
 };
 
 enum
@@ -156,6 +164,42 @@ static guint gesture_signals[LAST_SIGNAL] = { 0, };
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterGestureAction, clutter_gesture_action, CLUTTER_TYPE_ACTION)
 
+static void
+gesture_update_slots (ClutterGestureAction *action)
+{
+  ClutterGestureActionPrivate *priv = action->priv;
+  guint i;
+
+  for (i = 0; i < priv->slot_points->len; i++)
+    g_array_index (priv->slot_points, gint, i) = -1;
+
+  priv->has_unslotted_points = FALSE;
+
+  for (i = 0; i < priv->points->len; i++)
+    {
+      GesturePoint *point = &g_array_index (priv->points, GesturePoint, i);
+
+      if (point->slot < 0)
+        {
+          if (point->sequence != NULL)
+            priv->has_unslotted_points = TRUE;
+
+          continue;
+        }
+
+      if (point->slot >= priv->slot_points->len)
+        {
+          guint j = priv->slot_points->len;
+
+          g_array_set_size (priv->slot_points, point->slot + 1);
+          for (; j < priv->slot_points->len; j++)
+            g_array_index (priv->slot_points, gint, j) = -1;
+        }
+
+      g_array_index (priv->slot_points, gint, point->slot) = i;
+    }
+}
+
 static GesturePoint *
 gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
 {
@@ -184,6 +228,14 @@ gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
   else
     point->sequence = NULL;
 
+  if (point->sequence != NULL)
+    {
+      point->slot = _clutter_event_get_touch_slot (event);
+      gesture_update_slots (action);
+    }
+  else
+    point->slot = -1;
+
   return point;
 }
 
@@ -204,6 +256,38 @@ gesture_find_point (ClutterGestureAction *action,
       (type != CLUTTER_MOTION))
     sequence = clutter_event_get_event_sequence (event);
 
+  /* touch points are found through the slot of their sequence */
+  if (sequence != NULL)
+    {
+      gint slot = _clutter_event_get_touch_slot (event);
+
+      if (slot >= 0)
+        {
+          i = slot < priv->slot_points->len
+            ? g_array_index (priv->slot_points, gint, slot)
+            : -1;
+
+          if (i >= 0)
+            {
+              point = &g_array_index (priv->points, GesturePoint, i);
+              if (point->device == device && point->sequence == sequence)
+                {
+                  if (position != NULL)
+                    *position = i;
+
+                  return point;
+                }
+
+              /* the slot is also used by a touch point of another
+               * device, so we need to look at all the points
+               */
+              point = NULL;
+            }
+          else if (!priv->has_unslotted_points)
+            return NULL;
+        }
+    }
+
   for (i = 0; i < priv->points->len; i++)
     {
       if ((g_array_index (priv->points, GesturePoint, i).device == device) &&
@@ -228,6 +312,7 @@ gesture_unregister_point (ClutterGestureAction *action, gint position)
     return;
 
   g_array_remove_index (priv->points, position);
+  gesture_update_slots (action);
 }
 
 static void
@@ -320,6 +405,7 @@ cancel_gesture (ClutterGestureAction *action)
   g_signal_emit (action, gesture_signals[GESTURE_CANCEL], 0, actor);
 
   g_array_set_size (action->priv->points, 0);
+  gesture_update_slots (action);
 }
 
 static gboolean
@@ -648,6 +734,7 @@ clutter_gesture_action_finalize (GObject *gobject)
   ClutterGestureActionPrivate *priv = CLUTTER_GESTURE_ACTION (gobject)->priv;
 
   g_array_unref (priv->points);
+  g_array_unref (priv->slot_points);
 
   G_OBJECT_CLASS (clutter_gesture_action_parent_class)->finalize (gobject);
 }
@@ -842,6 +929,7 @@ clutter_gesture_action_init (ClutterGestureAction *self)
 
   self->priv->points = g_array_sized_new (FALSE, TRUE, sizeof (GesturePoint), 3);
   g_array_set_clear_func (self->priv->points, (GDestroyNotify) gesture_point_unset);
+  self->priv->slot_points = g_array_new (FALSE, FALSE, sizeof (gint));
 
   self->priv->requested_nb_points = 1;
   self->priv->edge = CLUTTER_GESTURE_TRIGGER_EDGE_NONE;
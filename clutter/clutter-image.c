@@ -33,6 +33,10 @@
  * See [image.c](https://git.gnome.org/browse/clutter/tree/examples/image-content.c?h=clutter-1.18)
  * for an example of how to use #ClutterImage.
  *
+ * Image files can be loaded without blocking the main loop by using
+ * clutter_image_load_async(); the image data is decoded inside a thread
+ * pool, and uploaded to the GPU over multiple frames.
+ *
  * #ClutterImage is available since Clutter 1.10.
  */
 
@@ -40,6 +44,8 @@
 #include "config.h"
 #endif
 
+#include <gio/gio.h>
+
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
 #include "clutter-image.h"
@@ -47,6 +53,8 @@
 #include "clutter-color.h"
 #include "clutter-content-private.h"
 #include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-master-clock.h"
 #include "clutter-paint-node.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-private.h"
@@ -69,6 +77,44 @@ clutter_image_error_quark (void)
   return g_quark_from_static_string ("clutter-image-error-quark");
 }
 
+static inline CoglTextureFlags
+texture_flags_for_size (guint width,
+                        guint height)
+{
+  CoglTextureFlags flags = COGL_TEXTURE_NONE;
+
+  if (width >= 512 && height >= 512)
+    flags |= COGL_TEXTURE_NO_ATLAS;
+
+  return flags;
+}
+
+/* takes ownership of @texture, and invalidates @image */
+static gboolean
+clutter_image_set_texture_internal (ClutterImage  *image,
+                                    CoglTexture   *texture,
+                                    GError       **error)
+{
+  ClutterImagePrivate *priv = image->priv;
+
+  if (texture == NULL)
+    {
+      g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
+                           CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                           _("Unable to load image data"));
+      return FALSE;
+    }
+
+  if (priv->texture != NULL)
+    cogl_object_unref (priv->texture);
+
+  priv->texture = texture;
+
+  clutter_content_invalidate (CLUTTER_CONTENT (image));
+
+  return TRUE;
+}
+
 static void
 clutter_image_finalize (GObject *gobject)
 {
@@ -462,3 +508,582 @@ clutter_image_get_texture (ClutterImage *image)
 
   return image->priv->texture;
 }
+
+/*
+ * Asynchronous loading
+ *
+ * Image files are decoded inside a thread pool, and the decoded bitmaps
+ * are uploaded to the GPU from the main thread, using a repaint function;
+ * in order to avoid skipping frames, each frame uploads at most
+ * UPLOAD_BUDGET_PER_FRAME bytes of image data.
+ *
+ * Both the decode and the upload queues are sorted by priority; since
+ * the priority of a load can change after it has been queued, we don't
+ * push the jobs into the thread pool: each worker thread picks the job
+ * with the highest priority from the decode queue when it runs.
+ *
+ * The worker threads never call into Clutter: when a job is ready to be
+ * uploaded they add an idle source, which installs the repaint function
+ * and wakes up the master clock from the main thread. Cancelled jobs are
+ * removed from the queues as soon as they are cancelled, and their task
+ * is completed from the main thread as well.
+ */
+
+#define UPLOAD_BUDGET_PER_FRAME (4 * 1024 * 1024)
+#define MAX_DECODE_THREADS      4
+
+typedef struct _ClutterImageLoadJob
+{
+  /* the task owns the job, and a reference on the image */
+  GTask *task;
+
+  /* the file to decode, or the raw image data */
+  char *filename;
+  GBytes *data;
+  CoglPixelFormat pixel_format;
+  guint width;
+  guint height;
+  guint row_stride;
+
+  /* the result of the decode */
+  CoglBitmap *bitmap;
+  GError *error;
+
+  int priority;
+  guint64 serial;
+
+  gulong cancelled_id;
+} ClutterImageLoadJob;
+
+static GMutex load_queue_lock;
+static GList *decode_queue = NULL;
+static GList *upload_queue = NULL;
+static GThreadPool *decode_pool = NULL;
+static gboolean upload_wakeup_pending = FALSE;
+static guint64 load_serial = 0;
+
+/* only accessed from the main thread */
+static guint upload_func_id = 0;
+
+static void
+clutter_image_load_job_free (gpointer data)
+{
+  ClutterImageLoadJob *job = data;
+
+  g_free (job->filename);
+
+  if (job->data != NULL)
+    g_bytes_unref (job->data);
+
+  if (job->bitmap != NULL)
+    cogl_object_unref (job->bitmap);
+
+  g_clear_error (&job->error);
+
+  g_slice_free (ClutterImageLoadJob, job);
+}
+
+/* higher priority first, using the GLib convention that lower values
+ * have higher priority; jobs with the same priority are sorted in the
+ * order in which they have been queued
+ */
+static gint
+clutter_image_load_job_compare (gconstpointer a,
+                                gconstpointer b)
+{
+  const ClutterImageLoadJob *job_a = a;
+  const ClutterImageLoadJob *job_b = b;
+
+  if (job_a->priority != job_b->priority)
+    return job_a->priority < job_b->priority ? -1 : 1;
+
+  if (job_a->serial != job_b->serial)
+    return job_a->serial < job_b->serial ? -1 : 1;
+
+  return 0;
+}
+
+static inline gboolean
+clutter_image_load_job_is_cancelled (ClutterImageLoadJob *job)
+{
+  return g_cancellable_is_cancelled (g_task_get_cancellable (job->task));
+}
+
+/* must not be called from the ::cancelled handler */
+static void
+clutter_image_load_job_disconnect (ClutterImageLoadJob *job)
+{
+  if (job->cancelled_id != 0)
+    {
+      g_cancellable_disconnect (g_task_get_cancellable (job->task),
+                                job->cancelled_id);
+      job->cancelled_id = 0;
+    }
+}
+
+static gboolean
+clutter_image_upload_func (gpointer data G_GNUC_UNUSED)
+{
+  gsize uploaded = 0;
+  gboolean retval;
+
+  while (uploaded < UPLOAD_BUDGET_PER_FRAME)
+    {
+      ClutterImageLoadJob *job;
+      ClutterImage *image;
+      GError *error = NULL;
+      CoglTexture *texture;
+
+      g_mutex_lock (&load_queue_lock);
+
+      if (upload_queue == NULL)
+        {
+          g_mutex_unlock (&load_queue_lock);
+          break;
+        }
+
+      job = upload_queue->data;
+      upload_queue = g_list_delete_link (upload_queue, upload_queue);
+
+      g_mutex_unlock (&load_queue_lock);
+
+      /* the job is not in a queue any more, so cancelling it from now
+       * on is handled by g_task_return_error_if_cancelled() below
+       */
+      clutter_image_load_job_disconnect (job);
+
+      /* we don't hold the lock from here on, as returning the
+       * task may call back into clutter_image_load_async()
+       */
+      image = g_task_get_source_object (job->task);
+
+      if (g_task_return_error_if_cancelled (job->task))
+        {
+          CLUTTER_NOTE (TEXTURE, "[async] load of <ClutterImage>[%p] cancelled",
+                        image);
+        }
+      else if (job->error != NULL)
+        {
+          g_task_return_error (job->task, job->error);
+          job->error = NULL;
+        }
+      else
+        {
+          if (job->bitmap != NULL)
+            {
+              guint width = cogl_bitmap_get_width (job->bitmap);
+              guint height = cogl_bitmap_get_height (job->bitmap);
+
+              texture = cogl_texture_new_from_bitmap (job->bitmap,
+                                                      texture_flags_for_size (width, height),
+                                                      COGL_PIXEL_FORMAT_ANY);
+              uploaded += (gsize) cogl_bitmap_get_rowstride (job->bitmap)
+                        * height;
+            }
+          else
+            {
+              texture = cogl_texture_new_from_data (job->width, job->height,
+                                                    texture_flags_for_size (job->width, job->height),
+                                                    job->pixel_format,
+                                                    COGL_PIXEL_FORMAT_ANY,
+                                                    job->row_stride,
+                                                    g_bytes_get_data (job->data, NULL));
+              uploaded += (gsize) job->row_stride * job->height;
+            }
+
+          if (clutter_image_set_texture_internal (image, texture, &error))
+            g_task_return_boolean (job->task, TRUE);
+          else
+            g_task_return_error (job->task, error);
+        }
+
+      g_object_unref (job->task);
+    }
+
+  g_mutex_lock (&load_queue_lock);
+
+  if (upload_queue != NULL)
+    {
+      /* there are still uploads pending, so we need another frame */
+      _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+      retval = G_SOURCE_CONTINUE;
+    }
+  else
+    {
+      /* any job queued from now on will wake us up again */
+      upload_func_id = 0;
+      retval = G_SOURCE_REMOVE;
+    }
+
+  g_mutex_unlock (&load_queue_lock);
+
+  return retval;
+}
+
+static gboolean
+clutter_image_start_uploads (gpointer data G_GNUC_UNUSED)
+{
+  gboolean has_uploads;
+
+  g_mutex_lock (&load_queue_lock);
+  upload_wakeup_pending = FALSE;
+  has_uploads = upload_queue != NULL;
+  g_mutex_unlock (&load_queue_lock);
+
+  if (!has_uploads)
+    return G_SOURCE_REMOVE;
+
+  if (upload_func_id == 0)
+    upload_func_id =
+      clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT,
+                                             clutter_image_upload_func,
+                                             NULL, NULL);
+
+  _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+
+  return G_SOURCE_REMOVE;
+}
+
+/* must be called with the load_queue_lock held; can be called from
+ * any thread
+ */
+static void
+clutter_image_queue_upload_unlocked (ClutterImageLoadJob *job)
+{
+  upload_queue = g_list_insert_sorted (upload_queue, job,
+                                       clutter_image_load_job_compare);
+
+  if (!upload_wakeup_pending)
+    {
+      upload_wakeup_pending = TRUE;
+      clutter_threads_add_idle (clutter_image_start_uploads, NULL);
+    }
+}
+
+static gboolean
+clutter_image_load_job_drop (gpointer data)
+{
+  ClutterImageLoadJob *job = data;
+
+  clutter_image_load_job_disconnect (job);
+
+  CLUTTER_NOTE (TEXTURE, "[async] load of <ClutterImage>[%p] cancelled",
+                g_task_get_source_object (job->task));
+
+  g_task_return_error_if_cancelled (job->task);
+  g_object_unref (job->task);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* can be called from any thread, by g_cancellable_cancel() */
+static void
+clutter_image_load_job_cancelled (GCancellable *cancellable,
+                                  gpointer      data)
+{
+  ClutterImageLoadJob *job = data;
+  gboolean removed = FALSE;
+  GList *l;
+
+  g_mutex_lock (&load_queue_lock);
+
+  l = g_list_find (decode_queue, job);
+  if (l != NULL)
+    {
+      decode_queue = g_list_delete_link (decode_queue, l);
+      removed = TRUE;
+    }
+  else
+    {
+      l = g_list_find (upload_queue, job);
+      if (l != NULL)
+        {
+          upload_queue = g_list_delete_link (upload_queue, l);
+          removed = TRUE;
+        }
+    }
+
+  g_mutex_unlock (&load_queue_lock);
+
+  /* if the job was not in a queue it is being decoded, and it will be
+   * completed once it reaches the upload queue
+   */
+  if (removed)
+    clutter_threads_add_idle (clutter_image_load_job_drop, job);
+}
+
+static void
+clutter_image_decode_thread (gpointer data G_GNUC_UNUSED,
+                             gpointer pool_data G_GNUC_UNUSED)
+{
+  ClutterImageLoadJob *job;
+
+  g_mutex_lock (&load_queue_lock);
+
+  /* each push into the thread pool matches a job queued for decoding,
+   * but the job we pick is the one with the highest priority; the queue
+   * can also be empty if the jobs have been cancelled in the meantime
+   */
+  if (decode_queue == NULL)
+    {
+      g_mutex_unlock (&load_queue_lock);
+      return;
+    }
+
+  job = decode_queue->data;
+  decode_queue = g_list_delete_link (decode_queue, decode_queue);
+
+  g_mutex_unlock (&load_queue_lock);
+
+  if (!clutter_image_load_job_is_cancelled (job))
+    {
+      CLUTTER_NOTE (TEXTURE, "[async] decoding '%s'", job->filename);
+
+      job->bitmap = cogl_bitmap_new_from_file (job->filename, &job->error);
+    }
+
+  /* the task is always completed inside the main thread */
+  g_mutex_lock (&load_queue_lock);
+  clutter_image_queue_upload_unlocked (job);
+  g_mutex_unlock (&load_queue_lock);
+}
+
+static void
+clutter_image_queue_load (ClutterImage        *image,
+                          ClutterImageLoadJob *job,
+                          GCancellable        *cancellable,
+                          GAsyncReadyCallback  callback,
+                          gpointer             user_data)
+{
+  job->task = g_task_new (image, cancellable, callback, user_data);
+  g_task_set_source_tag (job->task, clutter_image_queue_load);
+  g_task_set_priority (job->task, job->priority);
+  g_task_set_task_data (job->task, job, clutter_image_load_job_free);
+
+  g_mutex_lock (&load_queue_lock);
+
+  job->serial = load_serial++;
+
+  if (job->filename != NULL)
+    {
+      decode_queue = g_list_insert_sorted (decode_queue, job,
+                                           clutter_image_load_job_compare);
+
+      if (G_UNLIKELY (decode_pool == NULL))
+        {
+          /* this cannot fail if exclusive is set to FALSE */
+          decode_pool =
+            g_thread_pool_new (clutter_image_decode_thread, NULL,
+                               CLAMP (g_get_num_processors (), 1, MAX_DECODE_THREADS),
+                               FALSE,
+                               NULL);
+        }
+
+      g_thread_pool_push (decode_pool, GINT_TO_POINTER (1), NULL);
+    }
+  else
+    clutter_image_queue_upload_unlocked (job);
+
+  g_mutex_unlock (&load_queue_lock);
+
+  /* the job cannot be completed before we return, as that only
+   * happens inside the main thread; if the cancellable has already
+   * been cancelled the handler is called right away, and it drops
+   * the job we just queued
+   */
+  if (cancellable != NULL)
+    job->cancelled_id =
+      g_cancellable_connect (cancellable,
+                             G_CALLBACK (clutter_image_load_job_cancelled),
+                             job,
+                             NULL);
+}
+
+/**
+ * clutter_image_load_async:
+ * @image: a #ClutterImage
+ * @filename: the path of the image file to load
+ * @io_priority: the priority of the request; lower values have
+ *   higher priority
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): a callback to call when the image has
+ *   been loaded
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Asynchronously loads the contents of @filename into @image.
+ *
+ * The image file is decoded inside a worker thread, and the image data
+ * is uploaded to the GPU from the main thread when the next frame is
+ * being prepared. In order to keep the frame rate stable, the uploads of
+ * multiple images are spread across frames, and each frame will upload
+ * a limited amount of image data.
+ *
+ * Pending loads are processed according to @io_priority; the priority
+ * can be changed while the load is pending by using
+ * clutter_image_set_load_priority(), for instance to give precedence
+ * to the images that are visible on the stage.
+ *
+ * Starting a new load does not cancel the pending ones; use @cancellable
+ * to stop a pending load.
+ *
+ * When the image has been loaded, @image will be invalidated and
+ * @callback will be called; you should call clutter_image_load_finish()
+ * to retrieve the result of the operation.
+ *
+ * Since: 1.22
+ */
+void
+clutter_image_load_async (ClutterImage        *image,
+                          const char          *filename,
+                          int                  io_priority,
+                          GCancellable        *cancellable,
+                          GAsyncReadyCallback  callback,
+                          gpointer             user_data)
+{
+  ClutterImageLoadJob *job;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (filename != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  job = g_slice_new0 (ClutterImageLoadJob);
+  job->filename = g_strdup (filename);
+  job->priority = io_priority;
+
+  clutter_image_queue_load (image, job, cancellable, callback, user_data);
+}
+
+/**
+ * clutter_image_load_bytes_async:
+ * @image: a #ClutterImage
+ * @data: the image data, as a #GBytes
+ * @pixel_format: the Cogl pixel format of the image data
+ * @width: the width of the image data
+ * @height: the height of the image data
+ * @row_stride: the length of each row inside @data
+ * @io_priority: the priority of the request; lower values have
+ *   higher priority
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): a callback to call when the image has
+ *   been loaded
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Asynchronously sets the image data stored inside a #GBytes to be
+ * displayed by @image.
+ *
+ * This function is the asynchronous version of clutter_image_set_bytes();
+ * the image data does not need to be decoded, but its upload to the GPU
+ * is queued and scheduled like the ones started by
+ * clutter_image_load_async().
+ *
+ * A reference is acquired on @data until the upload is complete.
+ *
+ * Since: 1.22
+ */
+void
+clutter_image_load_bytes_async (ClutterImage        *image,
+                                GBytes              *data,
+                                CoglPixelFormat      pixel_format,
+                                guint                width,
+                                guint                height,
+                                guint                row_stride,
+                                int                  io_priority,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  ClutterImageLoadJob *job;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (data != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  job = g_slice_new0 (ClutterImageLoadJob);
+  job->data = g_bytes_ref (data);
+  job->pixel_format = pixel_format;
+  job->width = width;
+  job->height = height;
+  job->row_stride = row_stride;
+  job->priority = io_priority;
+
+  clutter_image_queue_load (image, job, cancellable, callback, user_data);
+}
+
+/**
+ * clutter_image_load_finish:
+ * @image: a #ClutterImage
+ * @result: the #GAsyncResult passed to the callback
+ * @error: return location for a #GError, or %NULL
+ *
+ * Finishes an asynchronous load started by clutter_image_load_async()
+ * or clutter_image_load_bytes_async().
+ *
+ * Return value: %TRUE if the image data was successfully loaded,
+ *   and %FALSE otherwise
+ *
+ * Since: 1.22
+ */
+gboolean
+clutter_image_load_finish (ClutterImage  *image,
+                           GAsyncResult  *result,
+                           GError       **error)
+{
+  g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, image), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static GList *
+reprioritize_queue (GList        *queue,
+                    ClutterImage *image,
+                    int           io_priority)
+{
+  gboolean changed = FALSE;
+  GList *l;
+
+  for (l = queue; l != NULL; l = l->next)
+    {
+      ClutterImageLoadJob *job = l->data;
+
+      if (g_task_get_source_object (job->task) != (gpointer) image)
+        continue;
+
+      if (job->priority != io_priority)
+        {
+          job->priority = io_priority;
+          changed = TRUE;
+        }
+    }
+
+  if (changed)
+    queue = g_list_sort (queue, clutter_image_load_job_compare);
+
+  return queue;
+}
+
+/**
+ * clutter_image_set_load_priority:
+ * @image: a #ClutterImage
+ * @io_priority: the new priority; lower values have higher priority
+ *
+ * Changes the priority of all the pending asynchronous loads of @image.
+ *
+ * This function can be used to move the loads of the images that are
+ * visible ahead of the ones that have been scrolled off screen.
+ *
+ * Since: 1.22
+ */
+void
+clutter_image_set_load_priority (ClutterImage *image,
+                                 int           io_priority)
+{
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+
+  g_mutex_lock (&load_queue_lock);
+
+  decode_queue = reprioritize_queue (decode_queue, image, io_priority);
+  upload_queue = reprioritize_queue (upload_queue, image, io_priority);
+
+  g_mutex_unlock (&load_queue_lock);
+}
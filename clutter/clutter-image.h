@@ -29,6 +29,7 @@
 #ifndef __CLUTTER_IMAGE_H__
 #define __CLUTTER_IMAGE_H__
 
+#include <gio/gio.h>
 #include <cogl/cogl.h>
 #include <clutter/clutter-types.h>
 
@@ -131,6 +132,32 @@ gboolean                clutter_image_set_bytes         (ClutterImage
                                                          guint                         row_stride,
                                                          GError                      **error);
 
+CLUTTER_AVAILABLE_IN_1_22
+void                    clutter_image_load_async        (ClutterImage                 *image,
+                                                         const char                   *filename,
+                                                         int                           io_priority,
+                                                         GCancellable                 *cancellable,
+                                                         GAsyncReadyCallback           callback,
+                                                         gpointer                      user_data);
+CLUTTER_AVAILABLE_IN_1_22
+void                    clutter_image_load_bytes_async  (ClutterImage                 *image,
+                                                         GBytes                       *data,
+                                                         CoglPixelFormat               pixel_format,
+                                                         guint                         width,
+                                                         guint                         height,
+                                                         guint                         row_stride,
+                                                         int                           io_priority,
+                                                         GCancellable                 *cancellable,
+                                                         GAsyncReadyCallback           callback,
+                                                         gpointer                      user_data);
+CLUTTER_AVAILABLE_IN_1_22
+gboolean                clutter_image_load_finish       (ClutterImage                 *image,
+                                                         GAsyncResult                 *result,
+                                                         GError                      **error);
+CLUTTER_AVAILABLE_IN_1_22
+void                    clutter_image_set_load_priority (ClutterImage                 *image,
+                                                         int                           io_priority);
+
 #if defined(COGL_ENABLE_EXPERIMENTAL_API) && defined(CLUTTER_ENABLE_EXPERIMENTAL_API)
 CLUTTER_AVAILABLE_IN_1_10
 CoglTexture *           clutter_image_get_texture       (ClutterImage                 *image);
@@ -35,6 +35,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "clutter-input-device.h"
 
 #include "clutter-actor-private.h"
@@ -69,7 +71,6 @@ enum
   PROP_LAST
 };
 
-static void _clutter_input_device_free_touch_info (gpointer data);
 
 
 static GParamSpec *obj_props[PROP_LAST] = { NULL, };
@@ -96,7 +97,7 @@ clutter_input_device_dispose (GObject *gobject)
   g_clear_pointer (&device->axes, g_array_unref);
   g_clear_pointer (&device->keys, g_array_unref);
   g_clear_pointer (&device->scroll_info, g_array_unref);
-  g_clear_pointer (&device->touch_sequences_info, g_hash_table_unref);
+  g_clear_pointer (&device->touch_slots, g_array_unref);
 
   if (device->inv_touch_sequence_actors)
     {
@@ -377,28 +378,86 @@ clutter_input_device_init (ClutterInputDevice *self)
   self->current_button_number = self->previous_button_number = -1;
   self->current_state = self->previous_state = 0;
 
-  self->touch_sequences_info =
-    g_hash_table_new_full (NULL, NULL,
-                           NULL, _clutter_input_device_free_touch_info);
+  self->touch_slots = g_array_new (FALSE, TRUE, sizeof (ClutterTouchInfo));
   self->inv_touch_sequence_actors = g_hash_table_new (NULL, NULL);
 }
 
+/*< private >
+ * _clutter_input_device_lookup_touch_slot:
+ * @device: a #ClutterInputDevice
+ * @sequence: a #ClutterEventSequence
+ *
+ * Retrieves the slot of the touch point of @device for @sequence.
+ *
+ * The slots are small integers, assigned when a sequence starts and
+ * kept until it ends, so that the code tracking touch points can use
+ * them to index its own tables instead of hashing the sequence; the
+ * slots of the ended sequences are reused.
+ *
+ * Return value: the slot of @sequence, or -1 if @sequence is not
+ *   tracked by @device
+ */
+gint
+_clutter_input_device_lookup_touch_slot (ClutterInputDevice   *device,
+                                         ClutterEventSequence *sequence)
+{
+  ClutterTouchInfo *slots;
+  guint i;
+
+  if (sequence == NULL || device->touch_slots == NULL)
+    return -1;
+
+  /* there are only as many slots as touch points down at once */
+  slots = (ClutterTouchInfo *) device->touch_slots->data;
+  for (i = 0; i < device->touch_slots->len; i++)
+    {
+      if (slots[i].sequence == sequence)
+        return i;
+    }
+
+  return -1;
+}
+
+static ClutterTouchInfo *
+_clutter_input_device_get_touch_info (ClutterInputDevice   *device,
+                                      ClutterEventSequence *sequence)
+{
+  gint slot = _clutter_input_device_lookup_touch_slot (device, sequence);
+
+  if (slot < 0)
+    return NULL;
+
+  return &g_array_index (device->touch_slots, ClutterTouchInfo, slot);
+}
+
 static ClutterTouchInfo *
 _clutter_input_device_ensure_touch_info (ClutterInputDevice *device,
                                          ClutterEventSequence *sequence,
                                          ClutterStage *stage)
 {
   ClutterTouchInfo *info;
+  guint i;
 
-  info = g_hash_table_lookup (device->touch_sequences_info, sequence);
+  info = _clutter_input_device_get_touch_info (device, sequence);
 
   if (info == NULL)
     {
-      info = g_slice_new0 (ClutterTouchInfo);
+      for (i = 0; i < device->touch_slots->len; i++)
+        {
+          if (g_array_index (device->touch_slots, ClutterTouchInfo, i).sequence == NULL)
+            break;
+        }
+
+      if (i == device->touch_slots->len)
+        g_array_set_size (device->touch_slots, i + 1);
+
+      info = &g_array_index (device->touch_slots, ClutterTouchInfo, i);
+      memset (info, 0, sizeof (ClutterTouchInfo));
       info->sequence = sequence;
-      g_hash_table_insert (device->touch_sequences_info, sequence, info);
 
-      if (g_hash_table_size (device->touch_sequences_info) == 1)
+      device->n_touch_points += 1;
+
+      if (device->n_touch_points == 1)
         _clutter_input_device_set_stage (device, stage);
     }
 
@@ -529,12 +588,6 @@ _clutter_input_device_get_stage (ClutterInputDevice *device)
   return device->stage;
 }
 
-static void
-_clutter_input_device_free_touch_info (gpointer data)
-{
-  g_slice_free (ClutterTouchInfo, data);
-}
-
 static ClutterActor *
 _clutter_input_device_get_actor (ClutterInputDevice   *device,
                                  ClutterEventSequence *sequence)
@@ -544,7 +597,9 @@ _clutter_input_device_get_actor (ClutterInputDevice   *device,
   if (sequence == NULL)
     return device->cursor_actor;
 
-  info = g_hash_table_lookup (device->touch_sequences_info, sequence);
+  info = _clutter_input_device_get_touch_info (device, sequence);
+  if (info == NULL)
+    return NULL;
 
   return info->actor;
 }
@@ -595,7 +650,7 @@ _clutter_input_device_unassociate_actor (ClutterInputDevice   *device,
       for (l = sequences; l != NULL; l = l->next)
         {
           ClutterTouchInfo *info =
-            g_hash_table_lookup (device->touch_sequences_info, l->data);
+            _clutter_input_device_get_touch_info (device, l->data);
 
           if (info)
             info->actor = NULL;
@@ -832,7 +887,7 @@ clutter_input_device_get_coords (ClutterInputDevice   *device,
   else
     {
       ClutterTouchInfo *info =
-        g_hash_table_lookup (device->touch_sequences_info, sequence);
+        _clutter_input_device_get_touch_info (device, sequence);
 
       if (info == NULL)
         return FALSE;
@@ -1515,7 +1570,7 @@ _clutter_input_device_remove_event_sequence (ClutterInputDevice *device,
 {
   ClutterEventSequence *sequence = clutter_event_get_event_sequence (event);
   ClutterTouchInfo *info =
-    g_hash_table_lookup (device->touch_sequences_info, sequence);
+    _clutter_input_device_get_touch_info (device, sequence);
 
   if (info == NULL)
     return;
@@ -1532,7 +1587,14 @@ _clutter_input_device_remove_event_sequence (ClutterInputDevice *device,
       _clutter_input_device_set_actor (device, sequence, NULL, TRUE);
     }
 
-  g_hash_table_remove (device->touch_sequences_info, sequence);
+  /* emitting the crossing events might have moved the slots */
+  info = _clutter_input_device_get_touch_info (device, sequence);
+  if (info == NULL)
+    return;
+
+  info->sequence = NULL;
+  info->actor = NULL;
+  device->n_touch_points -= 1;
 }
 
 /**
@@ -94,6 +94,11 @@ struct _ClutterKeyframeTransitionPrivate
   GArray *frames;
 
   gint current_frame;
+
+  /* whether the frames need to be sorted and linked together again
+   * before the transition starts
+   */
+  guint frames_dirty : 1;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterKeyframeTransition,
@@ -121,7 +126,7 @@ sort_by_key (gconstpointer a,
   if (fabs (k_a->key - k_b->key) < 0.0001)
     return 0;
 
-  if (k_a->key > k_a->key)
+  if (k_a->key > k_b->key)
     return 1;
 
   return -1;
@@ -164,6 +169,8 @@ clutter_keyframe_transition_init_frames (ClutterKeyframeTransition *transition,
 
       g_array_insert_val (priv->frames, i, frame);
     }
+
+  priv->frames_dirty = TRUE;
 }
 
 static inline void
@@ -172,9 +179,11 @@ clutter_keyframe_transition_update_frames (ClutterKeyframeTransition *transition
   ClutterKeyframeTransitionPrivate *priv = transition->priv;
   guint i;
 
-  if (priv->frames == NULL)
+  if (priv->frames == NULL || !priv->frames_dirty)
     return;
 
+  clutter_keyframe_transition_sort_frames (transition);
+
   for (i = 0; i < priv->frames->len; i++)
     {
       KeyFrame *cur_frame = &g_array_index (priv->frames, KeyFrame, i);
@@ -209,6 +218,61 @@ clutter_keyframe_transition_update_frames (ClutterKeyframeTransition *transition
 
       cur_frame->end = cur_frame->key;
     }
+
+  priv->frames_dirty = FALSE;
+}
+
+/*< private >
+ * clutter_keyframe_transition_find_frame:
+ * @priv: the private data of a #ClutterKeyframeTransition
+ * @p: the linear progress of the transition
+ *
+ * Finds the key frame that contains @p.
+ *
+ * While the transition is playing, @p is either inside the current
+ * key frame or inside one of its neighbours, so those are checked
+ * first; if the timeline was moved by clutter_timeline_skip() or
+ * clutter_timeline_advance() we fall back to a binary search on
+ * the end of the key frames, which are sorted.
+ *
+ * Return value: the index of the key frame
+ */
+static gint
+clutter_keyframe_transition_find_frame (ClutterKeyframeTransitionPrivate *priv,
+                                        double                            p)
+{
+  const KeyFrame *frames = (const KeyFrame *) priv->frames->data;
+  gint n_frames = priv->frames->len;
+  gint i = priv->current_frame;
+  gint lo, hi;
+
+  if (i >= 0)
+    {
+      if (p >= frames[i].start && p <= frames[i].end)
+        return i;
+
+      if (i + 1 < n_frames &&
+          p >= frames[i + 1].start && p <= frames[i + 1].end)
+        return i + 1;
+
+      if (i > 0 &&
+          p >= frames[i - 1].start && p <= frames[i - 1].end)
+        return i - 1;
+    }
+
+  lo = 0;
+  hi = n_frames - 1;
+  while (lo < hi)
+    {
+      gint mid = (lo + hi) / 2;
+
+      if (frames[mid].end < p)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
 }
 
 static void
@@ -221,7 +285,6 @@ clutter_keyframe_transition_compute_value (ClutterTransition *transition,
   ClutterTimeline *timeline = CLUTTER_TIMELINE (transition);
   ClutterKeyframeTransitionPrivate *priv = self->priv;
   ClutterTransitionClass *parent_class;
-  ClutterTimelineDirection direction;
   ClutterInterval *real_interval;
   gdouble real_progress;
   double t, d, p;
@@ -234,44 +297,18 @@ clutter_keyframe_transition_compute_value (ClutterTransition *transition,
   if (priv->frames == NULL)
     goto out;
 
-  direction = clutter_timeline_get_direction (timeline);
+  /* the frames might have been changed after the transition started */
+  clutter_keyframe_transition_update_frames (self);
 
   /* we need a normalized linear value */
   t = clutter_timeline_get_elapsed_time (timeline);
   d = clutter_timeline_get_duration (timeline);
-  p = t / d;
+  p = CLAMP (t / d, 0.0, 1.0);
 
-  if (priv->current_frame < 0)
-    {
-      if (direction == CLUTTER_TIMELINE_FORWARD)
-        priv->current_frame = 0;
-      else
-        priv->current_frame = priv->frames->len - 1;
-    }
+  priv->current_frame = clutter_keyframe_transition_find_frame (priv, p);
 
   cur_frame = &g_array_index (priv->frames, KeyFrame, priv->current_frame);
 
-  /* skip to the next key frame, depending on the direction of the timeline */
-  if (direction == CLUTTER_TIMELINE_FORWARD)
-    {
-      if (p > cur_frame->end)
-        {
-          priv->current_frame = MIN (priv->current_frame + 1,
-                                     priv->frames->len - 1);
-
-          cur_frame = &g_array_index (priv->frames, KeyFrame, priv->current_frame);
-       }
-    }
-  else
-    {
-      if (p < cur_frame->start)
-        {
-          priv->current_frame = MAX (priv->current_frame - 1, 0);
-
-          cur_frame = &g_array_index (priv->frames, KeyFrame, priv->current_frame);
-        }
-    }
-
   /* if we are at the boundaries of the transition, use the from and to
    * value from the transition
    */
@@ -295,8 +332,15 @@ clutter_keyframe_transition_compute_value (ClutterTransition *transition,
   /* update the interval to be used to interpolate the property */
   real_interval = cur_frame->interval;
 
-  /* normalize the progress and apply the easing mode */
-  real_progress = clutter_easing_for_mode ( cur_frame->mode, (p - cur_frame->start), (cur_frame->end - cur_frame->start));
+  /* normalize the progress and apply the easing mode; key frames
+   * sharing the same key have no duration, so we jump to their end
+   */
+  if (cur_frame->end > cur_frame->start)
+    real_progress = clutter_easing_for_mode (cur_frame->mode,
+                                             (p - cur_frame->start),
+                                             (cur_frame->end - cur_frame->start));
+  else
+    real_progress = 1.0;
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (CLUTTER_HAS_DEBUG (ANIMATION))
@@ -317,7 +361,9 @@ clutter_keyframe_transition_compute_value (ClutterTransition *transition,
                     cur_frame->key,
                     clutter_get_easing_name_for_mode (cur_frame->mode),
                     from,
-                    direction == CLUTTER_TIMELINE_FORWARD ? "->" : "<-",
+                    clutter_timeline_get_direction (timeline) == CLUTTER_TIMELINE_FORWARD
+                      ? "->"
+                      : "<-",
                     to,
                     p, real_progress);
 
@@ -341,7 +387,6 @@ clutter_keyframe_transition_started (ClutterTimeline *timeline)
 
   transition->priv->current_frame = -1;
 
-  clutter_keyframe_transition_sort_frames (transition);
   clutter_keyframe_transition_update_frames (transition);
 }
 
@@ -449,6 +494,8 @@ clutter_keyframe_transition_set_key_frames (ClutterKeyframeTransition *transitio
 
       frame->key = key_frames[i];
     }
+
+  priv->frames_dirty = TRUE;
 }
 
 /**
@@ -496,6 +543,8 @@ clutter_keyframe_transition_set_values (ClutterKeyframeTransition *transition,
           clutter_interval_new_with_values (G_VALUE_TYPE (&values[i]), NULL,
                                             &values[i]);
     }
+
+  priv->frames_dirty = TRUE;
 }
 
 /**
@@ -538,6 +587,8 @@ clutter_keyframe_transition_set_modes (ClutterKeyframeTransition  *transition,
 
       frame->mode = modes[i];
     }
+
+  priv->frames_dirty = TRUE;
 }
 
 /**
@@ -606,6 +657,8 @@ clutter_keyframe_transition_set (ClutterKeyframeTransition *transition,
     }
 
   va_end (args);
+
+  priv->frames_dirty = TRUE;
 }
 
 /**
@@ -684,6 +737,8 @@ clutter_keyframe_transition_set_key_frame (ClutterKeyframeTransition *transition
   frame->key = key;
   frame->mode = mode;
   clutter_interval_set_final_value (frame->interval, value);
+
+  priv->frames_dirty = TRUE;
 }
 
 /**
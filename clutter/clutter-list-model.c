@@ -34,6 +34,12 @@
  * values for each row, so it's optimized for insertion and look up
  * in sorted lists.
  *
+ * When a filter is set, #ClutterListModel keeps an index of the rows
+ * that are not filtered out, so that looking up a row does not need to
+ * call the filter function on the rows preceding it; rows added or
+ * changed are filtered again, and moved to their sorted position, only
+ * when needed.
+ *
  * #ClutterListModel is available since Clutter 0.6
  */
 
@@ -76,10 +82,37 @@
 typedef struct _ClutterListModelIter    ClutterListModelIter;
 typedef struct _ClutterModelIterClass   ClutterListModelIterClass;
 
+typedef struct _ListModelRow            ListModelRow;
+
+struct _ListModelRow
+{
+  /* the position of the row inside the index of visible rows, or
+   * NULL if the row is filtered out or has not been checked yet
+   */
+  GSequenceIter *visible_iter;
+
+  GValue values[1];
+};
+
 struct _ClutterListModelPrivate
 {
   GSequence *sequence;
 
+  /* the index of the rows that are not filtered out, in the same order
+   * as the rows inside the sequence; each item is the GSequenceIter of
+   * the row. the index only exists while a filter is set
+   */
+  GSequence *visible;
+  guint filter_stamp;
+
+  /* the rows added or changed since the index was updated */
+  GHashTable *filter_pending;
+
+  /* the rows added or changed since the sequence was sorted */
+  GHashTable *sort_pending;
+  guint sort_stamp;
+  guint is_sorted : 1;
+
   ClutterModelIter *temp_iter;
 };
 
@@ -94,6 +127,11 @@ struct _ClutterListModelIter
 
 GType clutter_list_model_iter_get_type (void);
 
+static void clutter_list_model_ensure_visible (ClutterListModel *model);
+static void clutter_list_model_invalidate_row (ClutterListModel *model,
+                                               GSequenceIter    *seq_iter,
+                                               gboolean          resort);
+
 /*
  * ClutterListModel
  */
@@ -108,7 +146,7 @@ clutter_list_model_iter_get_value (ClutterModelIter *iter,
                                    GValue           *value)
 {
   ClutterListModelIter *iter_default;
-  GValue *values;
+  ListModelRow *row;
   GValue *iter_value;
   GValue real_value = G_VALUE_INIT;
   gboolean converted = FALSE;
@@ -116,8 +154,8 @@ clutter_list_model_iter_get_value (ClutterModelIter *iter,
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
-  values = g_sequence_get (iter_default->seq_iter);
-  iter_value = &values[column];
+  row = g_sequence_get (iter_default->seq_iter);
+  iter_value = &row->values[column];
   g_assert (iter_value != NULL);
 
   if (!g_type_is_a (G_VALUE_TYPE (value), G_VALUE_TYPE (iter_value)))
@@ -161,7 +199,8 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
                                    const GValue     *value)
 {
   ClutterListModelIter *iter_default;
-  GValue *values;
+  ClutterModel *model;
+  ListModelRow *row;
   GValue *iter_value;
   GValue real_value = G_VALUE_INIT;
   gboolean converted = FALSE;
@@ -169,8 +208,8 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
-  values = g_sequence_get (iter_default->seq_iter);
-  iter_value = &values[column];
+  row = g_sequence_get (iter_default->seq_iter);
+  iter_value = &row->values[column];
   g_assert (iter_value != NULL);
 
   if (!g_type_is_a (G_VALUE_TYPE (value), G_VALUE_TYPE (iter_value)))
@@ -206,58 +245,63 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
     }
   else
     g_value_copy (value, iter_value);
+
+  /* the row has to be filtered again, and possibly moved */
+  model = clutter_model_iter_get_model (iter);
+  clutter_list_model_invalidate_row (CLUTTER_LIST_MODEL (model),
+                                     iter_default->seq_iter,
+                                     (gint) column == clutter_model_get_sorting_column (model));
 }
 
 static gboolean
 clutter_list_model_iter_is_first (ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
-  ClutterModel *model;
-  ClutterModelIter *temp_iter;
-  GSequence *sequence;
-  GSequenceIter *begin, *end;
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
-  model = clutter_model_iter_get_model (iter);
-
-  sequence = CLUTTER_LIST_MODEL (model)->priv->sequence;
-
-  begin = g_sequence_get_begin_iter (sequence);
-  end   = iter_default->seq_iter;
-
-  temp_iter = CLUTTER_LIST_MODEL (model)->priv->temp_iter;
+  /* the previous visible row of the first row is always the beginning
+   * of the sequence; see clutter_list_model_iter_prev()
+   */
+  return g_sequence_iter_is_begin (iter_default->seq_iter);
+}
 
-  while (!g_sequence_iter_is_begin (begin))
-    {
-      CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = begin;
+static gint
+compare_positions (gconstpointer a,
+                   gconstpointer b,
+                   gpointer      data)
+{
+  return g_sequence_iter_compare ((GSequenceIter *) a, (GSequenceIter *) b);
+}
 
-      if (clutter_model_filter_iter (model, temp_iter))
-        {
-          end = begin;
-          break;
-        }
+/* returns the node of the first visible row at or after @seq_iter
+ * inside the index of the visible rows
+ */
+static GSequenceIter *
+clutter_list_model_search_visible (ClutterListModel *model,
+                                   GSequenceIter    *seq_iter)
+{
+  ListModelRow *row;
 
-      begin = g_sequence_iter_next (begin);
-    }
+  if (g_sequence_iter_is_end (seq_iter))
+    return g_sequence_get_end_iter (model->priv->visible);
 
-  /* This is because the 'begin_iter' is always *before* the last valid
-   * iter, otherwise we'd have endless loops 
-   */
-  end = g_sequence_iter_prev (end);
+  row = g_sequence_get (seq_iter);
+  if (row->visible_iter != NULL)
+    return row->visible_iter;
 
-  return iter_default->seq_iter == end;
+  return g_sequence_search (model->priv->visible, seq_iter,
+                            compare_positions,
+                            NULL);
 }
 
 static gboolean
 clutter_list_model_iter_is_last (ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
-  ClutterModelIter *temp_iter;
   ClutterModel *model;
-  GSequence *sequence;
-  GSequenceIter *begin, *end;
+  GSequenceIter *visible_iter;
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
@@ -267,40 +311,25 @@ clutter_list_model_iter_is_last (ClutterModelIter *iter)
 
   model = clutter_model_iter_get_model (iter);
 
-  sequence = CLUTTER_LIST_MODEL (model)->priv->sequence;
-
-  begin = g_sequence_get_end_iter (sequence);
-  begin = g_sequence_iter_prev (begin);
-  end   = iter_default->seq_iter;
-
-  temp_iter = CLUTTER_LIST_MODEL (model)->priv->temp_iter;
+  if (!clutter_model_get_filter_set (model))
+    return FALSE;
 
-  while (!g_sequence_iter_is_begin (begin))
-    {
-      CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = begin;
+  clutter_list_model_ensure_visible (CLUTTER_LIST_MODEL (model));
 
-      if (clutter_model_filter_iter (model, temp_iter))
-        {
-          end = begin;
-          break;
-        }
-
-      begin = g_sequence_iter_prev (begin);
-    }
-
-  /* This is because the 'end_iter' is always *after* the last valid iter.
-   * Otherwise we'd have endless loops 
+  /* we are past the last valid iter if there are no visible rows
+   * from here to the end of the sequence
    */
-  end = g_sequence_iter_next (end);
+  visible_iter = clutter_list_model_search_visible (CLUTTER_LIST_MODEL (model),
+                                                    iter_default->seq_iter);
 
-  return iter_default->seq_iter == end;
+  return g_sequence_iter_is_end (visible_iter);
 }
 
 static ClutterModelIter *
 clutter_list_model_iter_next (ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
-  ClutterModelIter *temp_iter;
+  ClutterListModel *list_model;
   ClutterModel *model = NULL;
   GSequenceIter *filter_next;
   guint row;
@@ -311,26 +340,33 @@ clutter_list_model_iter_next (ClutterModelIter *iter)
   model = clutter_model_iter_get_model (iter);
   row   = clutter_model_iter_get_row (iter);
 
-  filter_next = g_sequence_iter_next (iter_default->seq_iter);
-  g_assert (filter_next != NULL);
-
-  temp_iter = CLUTTER_LIST_MODEL (model)->priv->temp_iter;
+  list_model = CLUTTER_LIST_MODEL (model);
 
-  while (!g_sequence_iter_is_end (filter_next))
+  if (!clutter_model_get_filter_set (model))
+    filter_next = g_sequence_iter_next (iter_default->seq_iter);
+  else
     {
-      CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = filter_next;
+      GSequenceIter *visible_iter;
 
-      if (clutter_model_filter_iter (model, temp_iter))
-        {
-          row += 1;
-          break;
-        }
+      clutter_list_model_ensure_visible (list_model);
+
+      visible_iter =
+        clutter_list_model_search_visible (list_model, iter_default->seq_iter);
 
-      filter_next = g_sequence_iter_next (filter_next);
+      /* skip the current row, if it is visible */
+      if (!g_sequence_iter_is_end (visible_iter) &&
+          g_sequence_get (visible_iter) == iter_default->seq_iter)
+        visible_iter = g_sequence_iter_next (visible_iter);
+
+      if (g_sequence_iter_is_end (visible_iter))
+        filter_next = g_sequence_get_end_iter (list_model->priv->sequence);
+      else
+        filter_next = g_sequence_get (visible_iter);
     }
 
-  if (g_sequence_iter_is_end (filter_next))
-    row += 1;
+  g_assert (filter_next != NULL);
+
+  row += 1;
 
   /* update the iterator and return it */
   _clutter_model_iter_set_row (CLUTTER_MODEL_ITER (iter_default), row);
@@ -343,7 +379,7 @@ static ClutterModelIter *
 clutter_list_model_iter_prev (ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
-  ClutterModelIter *temp_iter;
+  ClutterListModel *list_model;
   ClutterModel *model;
   GSequenceIter *filter_prev;
   guint row;
@@ -354,26 +390,31 @@ clutter_list_model_iter_prev (ClutterModelIter *iter)
   model = clutter_model_iter_get_model (iter);
   row   = clutter_model_iter_get_row (iter);
 
-  filter_prev = g_sequence_iter_prev (iter_default->seq_iter);
-  g_assert (filter_prev != NULL);
+  list_model = CLUTTER_LIST_MODEL (model);
 
-  temp_iter = CLUTTER_LIST_MODEL (model)->priv->temp_iter;
-
-  while (!g_sequence_iter_is_begin (filter_prev))
+  if (!clutter_model_get_filter_set (model))
+    filter_prev = g_sequence_iter_prev (iter_default->seq_iter);
+  else
     {
-      CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = filter_prev;
+      GSequenceIter *visible_iter;
 
-      if (clutter_model_filter_iter (model, temp_iter))
-        {
-          row -= 1;
-          break;
-        }
+      clutter_list_model_ensure_visible (list_model);
+
+      visible_iter =
+        clutter_list_model_search_visible (list_model, iter_default->seq_iter);
 
-      filter_prev = g_sequence_iter_prev (filter_prev);
+      /* if there are no visible rows before this one we stop at the
+       * beginning of the sequence, like an unfiltered model would
+       */
+      if (g_sequence_iter_is_begin (visible_iter))
+        filter_prev = g_sequence_get_begin_iter (list_model->priv->sequence);
+      else
+        filter_prev = g_sequence_get (g_sequence_iter_prev (visible_iter));
     }
 
-  if (g_sequence_iter_is_begin (filter_prev))
-    row -= 1;
+  g_assert (filter_prev != NULL);
+
+  row -= 1;
 
   /* update the iterator and return it */
   _clutter_model_iter_set_row (CLUTTER_MODEL_ITER (iter_default), row);
@@ -434,56 +475,215 @@ clutter_list_model_iter_init (ClutterListModelIter *iter)
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterListModel, clutter_list_model, CLUTTER_TYPE_MODEL)
 
-static ClutterModelIter *
-clutter_list_model_get_iter_at_row (ClutterModel *model,
-                                    guint         row)
+static ListModelRow *
+list_model_row_new (ClutterModel *model)
 {
-  ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
-  GSequence *sequence = model_default->priv->sequence;
-  GSequenceIter *filter_next;
-  gint seq_length = g_sequence_get_length (sequence);
-  ClutterListModelIter *retval;
-  gint count = -1;
+  ListModelRow *row;
+  guint n_columns, i;
 
-  if (row >= seq_length)
-    return NULL;
+  n_columns = clutter_model_get_n_columns (model);
 
-  retval = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
-                         "model", model,
-                         "row", row,
-                         NULL);
+  row = g_malloc0 (G_STRUCT_OFFSET (ListModelRow, values)
+                   + MAX (n_columns, 1) * sizeof (GValue));
 
-  /* short-circuit in case we don't have a filter in place */
-  if (!clutter_model_get_filter_set (model))
+  for (i = 0; i < n_columns; i++)
+    g_value_init (&row->values[i], clutter_model_get_column_type (model, i));
+
+  return row;
+}
+
+static void
+list_model_row_free (ListModelRow *row,
+                     guint         n_columns)
+{
+  guint i;
+
+  for (i = 0; i < n_columns; i++)
+    g_value_unset (&row->values[i]);
+
+  g_free (row);
+}
+
+static void
+clutter_list_model_clear_visible (ClutterListModel *model)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  GSequenceIter *iter;
+
+  if (priv->visible == NULL)
+    return;
+
+  iter = g_sequence_get_begin_iter (priv->visible);
+  while (!g_sequence_iter_is_end (iter))
     {
-      retval->seq_iter = g_sequence_get_iter_at_pos (sequence, row);
+      ListModelRow *row = g_sequence_get (g_sequence_get (iter));
 
-      return CLUTTER_MODEL_ITER (retval);
+      row->visible_iter = NULL;
+
+      iter = g_sequence_iter_next (iter);
     }
 
-  filter_next = g_sequence_get_begin_iter (sequence);
-  g_assert (filter_next != NULL);
+  g_sequence_free (priv->visible);
+  priv->visible = NULL;
+
+  g_hash_table_remove_all (priv->filter_pending);
+}
+
+static gboolean
+clutter_list_model_filter_seq_iter (ClutterListModel *model,
+                                    GSequenceIter    *seq_iter)
+{
+  ClutterModelIter *temp_iter = model->priv->temp_iter;
+
+  CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = seq_iter;
+
+  return clutter_model_filter_iter (CLUTTER_MODEL (model), temp_iter);
+}
+
+/* marks a row that has been added or changed, so that it gets filtered
+ * again the next time the index of visible rows is used and, if the
+ * sorting column changed, moved to its new position on the next resort
+ */
+static void
+clutter_list_model_invalidate_row (ClutterListModel *model,
+                                   GSequenceIter    *seq_iter,
+                                   gboolean          resort)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  ListModelRow *row = g_sequence_get (seq_iter);
+
+  if (priv->visible != NULL)
+    {
+      if (!clutter_model_get_filter_set (CLUTTER_MODEL (model)))
+        clutter_list_model_clear_visible (model);
+      else
+        {
+          if (row->visible_iter != NULL)
+            {
+              g_sequence_remove (row->visible_iter);
+              row->visible_iter = NULL;
+            }
+
+          g_hash_table_add (priv->filter_pending, seq_iter);
+        }
+    }
+
+  if (resort && priv->is_sorted &&
+      clutter_model_get_sorting_column (CLUTTER_MODEL (model)) >= 0)
+    g_hash_table_add (priv->sort_pending, seq_iter);
+}
 
-  while (!g_sequence_iter_is_end (filter_next))
+/* makes sure that the index of visible rows is up to date; it should
+ * only be called while a filter is set on the model
+ */
+static void
+clutter_list_model_ensure_visible (ClutterListModel *model)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  guint filter_stamp;
+  GHashTable *pending;
+  GHashTableIter iter;
+  gpointer key;
+
+  filter_stamp = _clutter_model_get_filter_stamp (CLUTTER_MODEL (model));
+
+  if (priv->visible == NULL || priv->filter_stamp != filter_stamp)
     {
-      retval->seq_iter = filter_next;
+      GSequenceIter *seq_iter;
 
-      if (clutter_model_filter_iter (model, CLUTTER_MODEL_ITER (retval)))
+      clutter_list_model_clear_visible (model);
+
+      priv->visible = g_sequence_new (NULL);
+      priv->filter_stamp = filter_stamp;
+
+      seq_iter = g_sequence_get_begin_iter (priv->sequence);
+      while (!g_sequence_iter_is_end (seq_iter))
         {
-          /* We've found a row that is valid under the filter */
-          count++;
-          if (count == row)
-            break;
+          if (clutter_list_model_filter_seq_iter (model, seq_iter))
+            {
+              ListModelRow *row = g_sequence_get (seq_iter);
+
+              row->visible_iter = g_sequence_append (priv->visible, seq_iter);
+            }
+
+          seq_iter = g_sequence_iter_next (seq_iter);
         }
 
-      filter_next = g_sequence_iter_next (filter_next);
+      return;
     }
 
-  if (count != row)
+  if (g_hash_table_size (priv->filter_pending) == 0)
+    return;
+
+  /* the filter function might end up calling back into the model,
+   * so we swap the pending set before iterating over it
+   */
+  pending = priv->filter_pending;
+  priv->filter_pending = g_hash_table_new (NULL, NULL);
+
+  g_hash_table_iter_init (&iter, pending);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
     {
-      g_object_unref (retval);
-      return NULL;
+      GSequenceIter *seq_iter = key;
+      ListModelRow *row = g_sequence_get (seq_iter);
+
+      if (row->visible_iter != NULL)
+        continue;
+
+      if (clutter_list_model_filter_seq_iter (model, seq_iter))
+        {
+          row->visible_iter =
+            g_sequence_insert_sorted (priv->visible, seq_iter,
+                                      compare_positions,
+                                      NULL);
+        }
     }
+
+  g_hash_table_destroy (pending);
+}
+
+/* returns the GSequenceIter of the visible @row, or NULL */
+static GSequenceIter *
+clutter_list_model_get_seq_iter_at_row (ClutterListModel *model,
+                                        guint             row)
+{
+  ClutterListModelPrivate *priv = model->priv;
+
+  /* short-circuit in case we don't have a filter in place */
+  if (!clutter_model_get_filter_set (CLUTTER_MODEL (model)))
+    {
+      if (row >= g_sequence_get_length (priv->sequence))
+        return NULL;
+
+      return g_sequence_get_iter_at_pos (priv->sequence, row);
+    }
+
+  clutter_list_model_ensure_visible (model);
+
+  if (row >= g_sequence_get_length (priv->visible))
+    return NULL;
+
+  return g_sequence_get (g_sequence_get_iter_at_pos (priv->visible, row));
+}
+
+static ClutterModelIter *
+clutter_list_model_get_iter_at_row (ClutterModel *model,
+                                    guint         row)
+{
+  ClutterListModelIter *retval;
+  GSequenceIter *seq_iter;
+
+  seq_iter = clutter_list_model_get_seq_iter_at_row (CLUTTER_LIST_MODEL (model),
+                                                     row);
+  if (seq_iter == NULL)
+    return NULL;
+
+  retval = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
+                         "model", model,
+                         "row", row,
+                         NULL);
+  retval->seq_iter = seq_iter;
+
   return CLUTTER_MODEL_ITER (retval);
 }
 
@@ -494,33 +694,31 @@ clutter_list_model_insert_row (ClutterModel *model,
   ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
   GSequence *sequence = model_default->priv->sequence;
   ClutterListModelIter *retval;
-  guint n_columns, i, pos;
-  GValue *values;
+  ListModelRow *row;
   GSequenceIter *seq_iter;
+  guint pos;
 
-  n_columns = clutter_model_get_n_columns (model);
-  values = g_new0 (GValue, n_columns);
-
-  for (i = 0; i < n_columns; i++)
-    g_value_init (&values[i], clutter_model_get_column_type (model, i));
+  row = list_model_row_new (model);
 
   if (index_ < 0)
     {
-      seq_iter = g_sequence_append (sequence, values);
+      seq_iter = g_sequence_append (sequence, row);
       pos = g_sequence_get_length (sequence) - 1;
     }
   else if (index_ == 0)
     {
-      seq_iter = g_sequence_prepend (sequence, values);
+      seq_iter = g_sequence_prepend (sequence, row);
       pos = 0;
     }
   else
     {
       seq_iter = g_sequence_get_iter_at_pos (sequence, index_);
-      seq_iter = g_sequence_insert_before (seq_iter, values);
+      seq_iter = g_sequence_insert_before (seq_iter, row);
       pos = index_;
     }
 
+  clutter_list_model_invalidate_row (model_default, seq_iter, TRUE);
+
   retval = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
                          "model", model,
                          "row", pos,
@@ -534,44 +732,30 @@ static void
 clutter_list_model_remove_row (ClutterModel *model,
                                guint         row)
 {
-  ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
-  GSequence *sequence = model_default->priv->sequence;
+  ClutterModelIter *iter;
   GSequenceIter *seq_iter;
-  guint pos = 0;
 
-  seq_iter = g_sequence_get_begin_iter (sequence);
-  while (!g_sequence_iter_is_end (seq_iter))
-    {
-      if (clutter_model_filter_row (model, pos))
-        {
-          if (pos == row)
-            {  
-              ClutterModelIter *iter;
-
-              iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
-                                   "model", model,
-                                   "row", pos,
-                                   NULL);
-              CLUTTER_LIST_MODEL_ITER (iter)->seq_iter = seq_iter;
-
-              /* the actual row is removed from the sequence inside
-               * the ::row-removed signal class handler, so that every
-               * handler connected to ::row-removed will still get
-               * a valid iterator, and every signal connected to
-               * ::row-removed with the AFTER flag will get an updated
-               * model
-               */
-              g_signal_emit_by_name (model, "row-removed", iter);
-
-              g_object_unref (iter);
-
-              break;
-            }
-        }
+  seq_iter = clutter_list_model_get_seq_iter_at_row (CLUTTER_LIST_MODEL (model),
+                                                     row);
+  if (seq_iter == NULL)
+    return;
+
+  iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
+                       "model", model,
+                       "row", row,
+                       NULL);
+  CLUTTER_LIST_MODEL_ITER (iter)->seq_iter = seq_iter;
+
+  /* the actual row is removed from the sequence inside
+   * the ::row-removed signal class handler, so that every
+   * handler connected to ::row-removed will still get
+   * a valid iterator, and every signal connected to
+   * ::row-removed with the AFTER flag will get an updated
+   * model
+   */
+  _clutter_model_emit_row_removed (model, iter);
 
-      pos += 1;
-      seq_iter = g_sequence_iter_next (seq_iter);
-    }
+  g_object_unref (iter);
 }
 
 typedef struct
@@ -587,31 +771,139 @@ sort_model_default (gconstpointer a,
                     gconstpointer b,
                     gpointer      data)
 {
-  const GValue *row_a = a;
-  const GValue *row_b = b;
+  const ListModelRow *row_a = a;
+  const ListModelRow *row_b = b;
   SortClosure *clos = data;
 
   return clos->func (clos->model,
-                     &row_a[clos->column],
-                     &row_b[clos->column],
+                     &row_a->values[clos->column],
+                     &row_b->values[clos->column],
                      clos->data);
 }
 
+/* moves the rows that changed since the last sort to their position,
+ * assuming that all the other rows are still sorted
+ */
+static void
+clutter_list_model_resort_pending (ClutterListModel *model,
+                                   SortClosure      *clos)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  GSequence *changed;
+  GHashTable *pending;
+  GHashTableIter iter;
+  gpointer key;
+
+  pending = priv->sort_pending;
+  priv->sort_pending = g_hash_table_new (NULL, NULL);
+
+  /* take the changed rows out of the sequence first, so that the
+   * remaining rows are sorted when we search for the new positions
+   */
+  changed = g_sequence_new (NULL);
+
+  g_hash_table_iter_init (&iter, pending);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+      GSequenceIter *seq_iter = key;
+
+      /* the rows are going to move, so they have to be put back
+       * into the index of visible rows
+       */
+      if (priv->visible != NULL)
+        clutter_list_model_invalidate_row (model, seq_iter, FALSE);
+
+      g_sequence_move_range (g_sequence_get_end_iter (changed),
+                             seq_iter,
+                             g_sequence_iter_next (seq_iter));
+    }
+
+  g_hash_table_destroy (pending);
+
+  while (g_sequence_get_length (changed) > 0)
+    {
+      GSequenceIter *seq_iter = g_sequence_get_begin_iter (changed);
+      GSequenceIter *dest;
+
+      dest = g_sequence_search (priv->sequence,
+                                g_sequence_get (seq_iter),
+                                sort_model_default,
+                                clos);
+
+      g_sequence_move_range (dest, seq_iter, g_sequence_iter_next (seq_iter));
+    }
+
+  g_sequence_free (changed);
+}
+
 static void
 clutter_list_model_resort (ClutterModel         *model,
                            ClutterModelSortFunc  func,
                            gpointer              data)
 {
+  ClutterListModel *list_model = CLUTTER_LIST_MODEL (model);
+  ClutterListModelPrivate *priv = list_model->priv;
   SortClosure sort_closure = { NULL, 0, NULL, NULL };
+  gint sort_column;
+  guint sort_stamp;
+
+  sort_column = clutter_model_get_sorting_column (model);
+  if (func == NULL || sort_column < 0)
+    {
+      priv->is_sorted = FALSE;
+      g_hash_table_remove_all (priv->sort_pending);
+      return;
+    }
 
   sort_closure.model  = model;
-  sort_closure.column = clutter_model_get_sorting_column (model);
+  sort_closure.column = sort_column;
   sort_closure.func   = func;
   sort_closure.data   = data;
 
-  g_sequence_sort (CLUTTER_LIST_MODEL (model)->priv->sequence,
+  sort_stamp = _clutter_model_get_sort_stamp (model);
+
+  /* if only some rows changed since the last sort we can just move them
+   * to their new position, instead of sorting the whole sequence
+   */
+  if (priv->is_sorted && priv->sort_stamp == sort_stamp)
+    {
+      if (g_hash_table_size (priv->sort_pending) != 0)
+        clutter_list_model_resort_pending (list_model, &sort_closure);
+
+      return;
+    }
+
+  g_sequence_sort (priv->sequence,
                    sort_model_default,
                    &sort_closure);
+
+  priv->is_sorted = TRUE;
+  priv->sort_stamp = sort_stamp;
+  g_hash_table_remove_all (priv->sort_pending);
+
+  /* the visible rows are still the same, but their order changed, so
+   * we rebuild the index without calling the filter function; the
+   * rows that were in the index still have a non-NULL visible_iter
+   * after we emptied it, which we only use as a flag
+   */
+  if (priv->visible != NULL)
+    {
+      GSequenceIter *seq_iter;
+
+      g_sequence_remove_range (g_sequence_get_begin_iter (priv->visible),
+                               g_sequence_get_end_iter (priv->visible));
+
+      seq_iter = g_sequence_get_begin_iter (priv->sequence);
+      while (!g_sequence_iter_is_end (seq_iter))
+        {
+          ListModelRow *row = g_sequence_get (seq_iter);
+
+          if (row->visible_iter != NULL)
+            row->visible_iter = g_sequence_append (priv->visible, seq_iter);
+
+          seq_iter = g_sequence_iter_next (seq_iter);
+        }
+    }
 }
 
 static guint
@@ -623,27 +915,30 @@ clutter_list_model_get_n_rows (ClutterModel *model)
   if (!clutter_model_get_filter_set (model))
     return g_sequence_get_length (list_model->priv->sequence);
 
-  return CLUTTER_MODEL_CLASS (clutter_list_model_parent_class)->get_n_rows (model);
+  clutter_list_model_ensure_visible (list_model);
+
+  return g_sequence_get_length (list_model->priv->visible);
 }
 
 static void
 clutter_list_model_row_removed (ClutterModel     *model,
                                 ClutterModelIter *iter)
 {
+  ClutterListModelPrivate *priv = CLUTTER_LIST_MODEL (model)->priv;
   ClutterListModelIter *iter_default;
-  guint i, n_columns;
-  GValue *values;
-
-  n_columns = clutter_model_get_n_columns (model);
+  ListModelRow *row;
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
 
-  values = g_sequence_get (iter_default->seq_iter);
+  row = g_sequence_get (iter_default->seq_iter);
 
-  for (i = 0; i < n_columns; i++)
-    g_value_unset (&values[i]);
+  if (row->visible_iter != NULL)
+    g_sequence_remove (row->visible_iter);
+
+  g_hash_table_remove (priv->filter_pending, iter_default->seq_iter);
+  g_hash_table_remove (priv->sort_pending, iter_default->seq_iter);
 
-  g_free (values);
+  list_model_row_free (row, clutter_model_get_n_columns (model));
 
   g_sequence_remove (iter_default->seq_iter);
   iter_default->seq_iter = NULL;
@@ -655,24 +950,25 @@ clutter_list_model_finalize (GObject *gobject)
   ClutterListModel *model = CLUTTER_LIST_MODEL (gobject);
   GSequence *sequence = model->priv->sequence;
   GSequenceIter *iter;
-  guint n_columns, i;
+  guint n_columns;
 
   n_columns = clutter_model_get_n_columns (CLUTTER_MODEL (gobject));
 
   iter = g_sequence_get_begin_iter (sequence);
   while (!g_sequence_iter_is_end (iter))
     {
-      GValue *values = g_sequence_get (iter);
-
-      for (i = 0; i < n_columns; i++)
-        g_value_unset (&values[i]);
-
-      g_free (values);
+      list_model_row_free (g_sequence_get (iter), n_columns);
 
       iter = g_sequence_iter_next (iter);
     }
   g_sequence_free (sequence);
 
+  if (model->priv->visible != NULL)
+    g_sequence_free (model->priv->visible);
+
+  g_hash_table_destroy (model->priv->filter_pending);
+  g_hash_table_destroy (model->priv->sort_pending);
+
   G_OBJECT_CLASS (clutter_list_model_parent_class)->finalize (gobject);
 }
 
@@ -713,6 +1009,8 @@ clutter_list_model_init (ClutterListModel *model)
   model->priv = clutter_list_model_get_instance_private (model);
 
   model->priv->sequence = g_sequence_new (NULL);
+  model->priv->filter_pending = g_hash_table_new (NULL, NULL);
+  model->priv->sort_pending = g_hash_table_new (NULL, NULL);
   model->priv->temp_iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
                                          "model",
                                          model,
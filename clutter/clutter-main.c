@@ -107,6 +107,7 @@ static GCallback clutter_threads_unlock      = NULL;
 /* command line options */
 static gboolean clutter_is_initialized       = FALSE;
 static gboolean clutter_show_fps             = FALSE;
+static gboolean clutter_show_frame_timings   = FALSE;
 static gboolean clutter_fatal_warnings       = FALSE;
 static gboolean clutter_disable_mipmap_text  = FALSE;
 static gboolean clutter_use_fuzzy_picking    = FALSE;
@@ -114,6 +115,7 @@ static gboolean clutter_enable_accessibility = TRUE;
 static gboolean clutter_sync_to_vblank       = TRUE;
 
 static guint clutter_default_fps             = 60;
+static guint clutter_virtual_fps             = 0;
 
 static ClutterTextDirection clutter_text_direction = CLUTTER_TEXT_DIRECTION_LTR;
 
@@ -447,6 +449,22 @@ _clutter_context_get_show_fps (void)
   return context->show_fps;
 }
 
+gboolean
+_clutter_context_get_show_frame_timings (void)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+
+  return context->show_frame_timings;
+}
+
+guint
+_clutter_context_get_virtual_frame_rate (void)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+
+  return context->virtual_frame_rate;
+}
+
 /**
  * clutter_get_accessibility_enabled:
  *
@@ -1599,6 +1617,10 @@ pre_parse_hook (GOptionContext  *context,
   if (env_string)
     clutter_show_fps = TRUE;
 
+  env_string = g_getenv ("CLUTTER_SHOW_FRAME_TIMINGS");
+  if (env_string)
+    clutter_show_frame_timings = TRUE;
+
   env_string = g_getenv ("CLUTTER_DEFAULT_FPS");
   if (env_string)
     {
@@ -1607,6 +1629,18 @@ pre_parse_hook (GOptionContext  *context,
       clutter_default_fps = CLAMP (default_fps, 1, 1000);
     }
 
+  env_string = g_getenv ("CLUTTER_VIRTUAL_FPS");
+  if (env_string)
+    {
+      gint virtual_fps = g_ascii_strtoll (env_string, NULL, 10);
+
+      /* 0 disables the virtual clock */
+      if (virtual_fps > 0)
+        clutter_virtual_fps = MIN (virtual_fps, 1000);
+      else
+        clutter_virtual_fps = 0;
+    }
+
   env_string = g_getenv ("CLUTTER_DISABLE_MIPMAPPED_TEXT");
   if (env_string)
     clutter_disable_mipmap_text = TRUE;
@@ -1651,7 +1685,9 @@ post_parse_hook (GOptionContext  *context,
     }
 
   clutter_context->frame_rate = clutter_default_fps;
+  clutter_context->virtual_frame_rate = clutter_virtual_fps;
   clutter_context->show_fps = clutter_show_fps;
+  clutter_context->show_frame_timings = clutter_show_frame_timings;
   clutter_context->options_parsed = TRUE;
 
   /* If not asked to defer display setup, call clutter_init_real(),
@@ -67,8 +67,13 @@ struct _ClutterMasterClock
 {
   GObject parent_instance;
 
-  /* the list of timelines handled by the clock */
-  GSList *timelines;
+  /* the list of timelines handled by the clock; the links are
+   * embedded inside the timelines themselves
+   */
+  ClutterMasterClockLink *timelines;
+
+  /* the next link to be advanced, updated when removing timelines */
+  ClutterMasterClockLink *next_timeline;
 
   /* the current state of the clock, in usecs */
   gint64 cur_tick;
@@ -76,6 +81,14 @@ struct _ClutterMasterClock
   /* the previous state of the clock, in usecs, used to compute the delta */
   gint64 prev_tick;
 
+  /* the time used to advance the timelines when using a virtual clock;
+   * it is incremented by a fixed step on each frame, in usecs
+   */
+  gint64 virtual_tick;
+
+  /* the objects with notifications frozen while advancing the timelines */
+  GHashTable *frozen_objects;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 frame_budget;
   gint64 remaining_budget;
@@ -95,6 +108,8 @@ struct _ClutterMasterClock
   guint ensure_next_iteration : 1;
 
   guint paused : 1;
+
+  guint in_advance : 1;
 };
 
 struct _ClutterMasterClockClass
@@ -288,6 +303,15 @@ master_clock_next_frame_delay (ClutterMasterClock *master_clock)
   if (swap_delay != 0)
     return swap_delay;
 
+  /* The virtual clock does not depend on the real time, so there's
+   * no point in waiting before drawing the next frame
+   */
+  if (_clutter_context_get_virtual_frame_rate () != 0)
+    {
+      CLUTTER_NOTE (SCHEDULER, "virtual clock, draw the next frame immediately");
+      return 0;
+    }
+
   /* When we have sync-to-vblank, we count on swap-buffer requests (or
    * swap-buffer-complete events if supported in the backend) to throttle our
    * frame rate so no additional delay is needed to start the next frame.
@@ -392,7 +416,8 @@ master_clock_process_events (ClutterMasterClock *master_clock,
 static void
 master_clock_advance_timelines (ClutterMasterClock *master_clock)
 {
-  GSList *timelines, *l;
+  ClutterMasterClockLink *link;
+  gint64 tick_time;
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
 #endif
@@ -404,37 +429,61 @@ master_clock_advance_timelines (ClutterMasterClock *master_clock)
                         0);
 
   /* we protect ourselves from timelines being removed during
-   * the advancement by other timelines by copying the list of
-   * timelines, taking a reference on them, iterating over the
-   * copied list and then releasing the reference.
+   * the advancement by other timelines by keeping a pointer to
+   * the next link to advance; _clutter_master_clock_remove_timeline()
+   * will move it forward if that timeline goes away. since a timeline
+   * removes itself from the master clock when it stops playing or it
+   * is finalized, every link still in the list points to a live
+   * timeline, and we don't need to copy the list or take a reference
+   * on each timeline.
    *
-   * we cannot simply take a reference on the timelines and still
-   * use the list held by the master clock because the do_tick()
-   * might result in the creation of a new timeline, which gets
-   * added at the end of the list with no reference increase and
-   * thus gets disposed at the end of the iteration.
-   *
-   * this implies that a newly added timeline will not be advanced
-   * by this clock iteration, which is perfectly fine since we're
-   * in its first cycle.
-   *
-   * we also cannot steal the master clock timelines list because
-   * a timeline might be removed as the direct result of do_tick()
-   * and remove_timeline() would not find the timeline, failing
-   * and leaving a dangling pointer behind.
+   * the timelines are added at the head of the list, so they are
+   * advanced from the most recently started one to the oldest, as
+   * they always were; this also means that the timelines added while
+   * advancing end up behind the current link, and they are skipped:
+   * a newly added timeline will not be advanced by this clock
+   * iteration, which is perfectly fine since we're in its first cycle.
    */
-  timelines = g_slist_copy (master_clock->timelines);
-  g_slist_foreach (timelines, (GFunc) g_object_ref, NULL);
+
+  if (_clutter_context_get_virtual_frame_rate () != 0)
+    tick_time = master_clock->virtual_tick / 1000;
+  else
+    tick_time = master_clock->cur_tick / 1000;
 
   CLUTTER_TIMER_START (_clutter_uprof_context, master_timeline_advance);
 
-  for (l = timelines; l != NULL; l = l->next)
-    _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+  master_clock->in_advance = TRUE;
 
-  CLUTTER_TIMER_STOP (_clutter_uprof_context, master_timeline_advance);
+  link = master_clock->timelines;
+  while (link != NULL)
+    {
+      master_clock->next_timeline = link->next;
+
+      _clutter_timeline_do_tick (link->timeline, tick_time);
+
+      link = master_clock->next_timeline;
+    }
+
+  master_clock->next_timeline = NULL;
+  master_clock->in_advance = FALSE;
+
+  /* emit the notifications queued by the transitions in one go */
+  if (g_hash_table_size (master_clock->frozen_objects) != 0)
+    {
+      GHashTableIter iter;
+      gpointer key;
+
+      g_hash_table_iter_init (&iter, master_clock->frozen_objects);
+      while (g_hash_table_iter_next (&iter, &key, NULL))
+        {
+          g_hash_table_iter_steal (&iter);
+
+          g_object_thaw_notify (key);
+          g_object_unref (key);
+        }
+    }
 
-  g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
-  g_slist_free (timelines);
+  CLUTTER_TIMER_STOP (_clutter_uprof_context, master_timeline_advance);
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
@@ -551,6 +600,7 @@ clutter_clock_dispatch (GSource     *source,
   ClutterClockSource *clock_source = (ClutterClockSource *) source;
   ClutterMasterClock *master_clock = clock_source->master_clock;
   gboolean stages_updated = FALSE;
+  guint virtual_fps;
   GSList *stages;
 
   CLUTTER_STATIC_TIMER (master_dispatch_timer,
@@ -568,6 +618,14 @@ clutter_clock_dispatch (GSource     *source,
   /* Get the time to use for this frame */
   master_clock->cur_tick = g_source_get_time (source);
 
+  /* When using a virtual clock, the timelines are advanced by the same
+   * amount of time on every frame, regardless of the real time, so that
+   * each run produces the same sequence of frames
+   */
+  virtual_fps = _clutter_context_get_virtual_frame_rate ();
+  if (virtual_fps != 0)
+    master_clock->virtual_tick += G_USEC_PER_SEC / virtual_fps;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   master_clock->remaining_budget = master_clock->frame_budget;
 #endif
@@ -618,7 +676,7 @@ clutter_master_clock_finalize (GObject *gobject)
 {
   ClutterMasterClock *master_clock = CLUTTER_MASTER_CLOCK (gobject);
 
-  g_slist_free (master_clock->timelines);
+  g_hash_table_unref (master_clock->frozen_objects);
 
   G_OBJECT_CLASS (clutter_master_clock_parent_class)->finalize (gobject);
 }
@@ -639,6 +697,8 @@ clutter_master_clock_init (ClutterMasterClock *self)
   source = clutter_clock_source_new (self);
   self->source = source;
 
+  self->frozen_objects = g_hash_table_new (NULL, NULL);
+
   self->idle = FALSE;
   self->ensure_next_iteration = FALSE;
   self->paused = FALSE;
@@ -684,15 +744,23 @@ void
 _clutter_master_clock_add_timeline (ClutterMasterClock *master_clock,
                                     ClutterTimeline    *timeline)
 {
+  ClutterMasterClockLink *link;
   gboolean is_first;
 
-  if (g_slist_find (master_clock->timelines, timeline))
+  link = _clutter_timeline_get_clock_link (timeline);
+  if (link->timeline != NULL)
     return;
 
   is_first = master_clock->timelines == NULL;
 
-  master_clock->timelines = g_slist_prepend (master_clock->timelines,
-                                             timeline);
+  link->timeline = timeline;
+  link->prev = NULL;
+  link->next = master_clock->timelines;
+
+  if (master_clock->timelines != NULL)
+    master_clock->timelines->prev = link;
+
+  master_clock->timelines = link;
 
   if (is_first)
     {
@@ -713,8 +781,27 @@ void
 _clutter_master_clock_remove_timeline (ClutterMasterClock *master_clock,
                                        ClutterTimeline    *timeline)
 {
-  master_clock->timelines = g_slist_remove (master_clock->timelines,
-                                            timeline);
+  ClutterMasterClockLink *link;
+
+  link = _clutter_timeline_get_clock_link (timeline);
+  if (link->timeline == NULL)
+    return;
+
+  /* keep the iteration in master_clock_advance_timelines() valid */
+  if (master_clock->next_timeline == link)
+    master_clock->next_timeline = link->next;
+
+  if (link->prev != NULL)
+    link->prev->next = link->next;
+  else
+    master_clock->timelines = link->next;
+
+  if (link->next != NULL)
+    link->next->prev = link->prev;
+
+  link->timeline = NULL;
+  link->prev = NULL;
+  link->next = NULL;
 }
 
 /*
@@ -747,6 +834,33 @@ _clutter_master_clock_ensure_next_iteration (ClutterMasterClock *master_clock)
   master_clock->ensure_next_iteration = TRUE;
 }
 
+/*
+ * _clutter_master_clock_freeze_notify:
+ * @master_clock: a #ClutterMasterClock
+ * @gobject: a #GObject
+ *
+ * Freezes the property notifications of @gobject until all the
+ * timelines have been advanced for the current frame, so that
+ * objects changed by multiple transitions emit their notifications
+ * only once per frame.
+ *
+ * This function does nothing if it's not called while advancing
+ * the timelines.
+ */
+void
+_clutter_master_clock_freeze_notify (ClutterMasterClock *master_clock,
+                                     GObject            *gobject)
+{
+  if (!master_clock->in_advance)
+    return;
+
+  if (g_hash_table_contains (master_clock->frozen_objects, gobject))
+    return;
+
+  g_hash_table_add (master_clock->frozen_objects, g_object_ref (gobject));
+  g_object_freeze_notify (gobject);
+}
+
 void
 _clutter_master_clock_set_paused (ClutterMasterClock *master_clock,
                                   gboolean            paused)
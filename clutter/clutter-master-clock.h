@@ -33,6 +33,25 @@ G_BEGIN_DECLS
 #define CLUTTER_IS_MASTER_CLOCK(obj)    (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_MASTER_CLOCK))
 
 typedef struct _ClutterMasterClock      ClutterMasterClock;
+typedef struct _ClutterMasterClockLink  ClutterMasterClockLink;
+
+/*< private >
+ * ClutterMasterClockLink:
+ * @timeline: the timeline, or %NULL if the link is not in use
+ * @prev: the previous link in the master clock
+ * @next: the next link in the master clock
+ *
+ * The node used by the master clock to keep track of the playing
+ * timelines. Each #ClutterTimeline embeds one, so adding and removing
+ * timelines to the master clock never allocates.
+ */
+struct _ClutterMasterClockLink
+{
+  ClutterTimeline *timeline;
+
+  ClutterMasterClockLink *prev;
+  ClutterMasterClockLink *next;
+};
 
 GType _clutter_master_clock_get_type (void) G_GNUC_CONST;
 
@@ -45,12 +64,15 @@ void                    _clutter_master_clock_start_running             (Clutter
 void                    _clutter_master_clock_ensure_next_iteration     (ClutterMasterClock *master_clock);
 void                    _clutter_master_clock_set_paused                (ClutterMasterClock *master_clock,
                                                                          gboolean            paused);
+void                    _clutter_master_clock_freeze_notify             (ClutterMasterClock *master_clock,
+                                                                         GObject            *gobject);
 
 void                    _clutter_timeline_advance                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
 gint64                  _clutter_timeline_get_delta                     (ClutterTimeline    *timeline);
 void                    _clutter_timeline_do_tick                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
+ClutterMasterClockLink *_clutter_timeline_get_clock_link                (ClutterTimeline    *timeline);
 
 G_END_DECLS
 
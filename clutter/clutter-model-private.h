@@ -44,6 +44,16 @@ void            _clutter_model_set_column_name  (ClutterModel *model,
                                                  gint          column,
                                                  const gchar  *name);
 
+void            _clutter_model_emit_rows_changed (ClutterModel *model,
+                                                  guint         position,
+                                                  guint         n_removed,
+                                                  guint         n_added);
+void            _clutter_model_emit_row_removed (ClutterModel     *model,
+                                                 ClutterModelIter *iter);
+
+guint           _clutter_model_get_filter_stamp (ClutterModel *model);
+guint           _clutter_model_get_sort_stamp   (ClutterModel *model);
+
 void            _clutter_model_iter_set_row     (ClutterModelIter *iter,
                                                  guint             row);
 
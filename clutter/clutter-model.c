@@ -185,6 +185,8 @@ enum
 
   SORT_CHANGED,
   FILTER_CHANGED,
+
+  ROWS_CHANGED,
   
   LAST_SIGNAL
 };
@@ -214,6 +216,25 @@ struct _ClutterModelPrivate
   ClutterModelSortFunc    sort_func;
   gpointer                sort_data;
   GDestroyNotify          sort_notify;
+
+  /* incremented every time the filter or the sorting change, so that
+   * the implementations can tell whether the indexes they keep for
+   * the filtered and sorted rows are still valid
+   */
+  guint                   filter_stamp;
+  guint                   sort_stamp;
+
+  /* the state of clutter_model_begin_update(); the range of changed
+   * rows goes from update_first to update_end, in the coordinates of
+   * the model as it is now, and update_n_rows is the number of rows
+   * when the update started
+   */
+  guint                   update_depth;
+  guint                   update_first;
+  guint                   update_end;
+  guint                   update_n_rows;
+  guint                   update_all    : 1;
+  guint                   update_resort : 1;
 };
 
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
@@ -458,6 +479,38 @@ clutter_model_class_init (ClutterModelClass *klass)
                   NULL, NULL,
                   _clutter_marshal_VOID__VOID,
                   G_TYPE_NONE, 0);
+
+  /**
+   * ClutterModel::rows-changed:
+   * @model: the #ClutterModel on which the signal is emitted
+   * @position: the position of the first changed row
+   * @n_removed: the number of rows removed at @position
+   * @n_added: the number of rows added at @position
+   *
+   * The ::rows-changed signal is emitted when a range of rows has been
+   * changed at once, by model operations that do not emit the per-row
+   * #ClutterModel::row-added, #ClutterModel::row-removed and
+   * #ClutterModel::row-changed signals, like
+   * clutter_array_model_splice(), and when an update started with
+   * clutter_model_begin_update() ends. In the latter case, the per-row
+   * signals have been emitted as well, if anybody was listening to them.
+   *
+   * Rows that have been replaced are reported as both removed and added.
+   * The positions take into account the filter set on @model, if any.
+   *
+   * Since: 1.22
+   */
+  model_signals[ROWS_CHANGED] =
+    g_signal_new ("rows-changed",
+                  G_TYPE_FROM_CLASS (gobject_class),
+                  G_SIGNAL_RUN_LAST,
+                  G_STRUCT_OFFSET (ClutterModelClass, rows_changed),
+                  NULL, NULL,
+                  _clutter_marshal_VOID__UINT_UINT_UINT,
+                  G_TYPE_NONE, 3,
+                  G_TYPE_UINT,
+                  G_TYPE_UINT,
+                  G_TYPE_UINT);
 }
 
 static void
@@ -479,6 +532,11 @@ clutter_model_init (ClutterModel *self)
   priv->sort_func = NULL;
   priv->sort_data = NULL;
   priv->sort_notify = NULL;
+
+  priv->update_depth = 0;
+  priv->update_first = G_MAXUINT;
+  priv->update_end = 0;
+  priv->update_n_rows = 0;
 }
 
 /* XXX - is this whitelist really necessary? we accept every fundamental
@@ -756,6 +814,107 @@ clutter_scriptable_iface_init (ClutterScriptableIface *iface)
   iface->set_custom_property = clutter_model_set_custom_property;
 }
 
+/* adds the removal of @n_removed rows at @position, followed by the
+ * addition of @n_added rows, to the range of rows changed during an
+ * update
+ */
+static void
+clutter_model_update_range (ClutterModel *model,
+                            guint         position,
+                            guint         n_removed,
+                            guint         n_added)
+{
+  ClutterModelPrivate *priv = model->priv;
+
+  if (priv->update_first == G_MAXUINT)
+    {
+      priv->update_first = position;
+      priv->update_end = position;
+    }
+
+  /* the rows after the end of the range are the ones that did not
+   * change since the update started; they shift with every row added
+   * or removed before them
+   */
+  priv->update_first = MIN (priv->update_first, position);
+  priv->update_end = MAX (priv->update_end, position + n_removed) - n_removed;
+  priv->update_end = MAX (priv->update_end, position) + n_added;
+}
+
+static void
+clutter_model_emit_row_added (ClutterModel     *model,
+                              ClutterModelIter *iter)
+{
+  ClutterModelClass *klass;
+
+  if (model->priv->update_depth == 0)
+    {
+      g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+      return;
+    }
+
+  clutter_model_update_range (model, clutter_model_iter_get_row (iter), 0, 1);
+
+  if (g_signal_has_handler_pending (model, model_signals[ROW_ADDED], 0, TRUE))
+    {
+      g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+      return;
+    }
+
+  klass = CLUTTER_MODEL_GET_CLASS (model);
+  if (klass->row_added != NULL)
+    klass->row_added (model, iter);
+}
+
+static void
+clutter_model_emit_row_changed (ClutterModel     *model,
+                                ClutterModelIter *iter)
+{
+  ClutterModelClass *klass;
+
+  if (model->priv->update_depth == 0)
+    {
+      g_signal_emit (model, model_signals[ROW_CHANGED], 0, iter);
+      return;
+    }
+
+  clutter_model_update_range (model, clutter_model_iter_get_row (iter), 1, 1);
+
+  if (g_signal_has_handler_pending (model, model_signals[ROW_CHANGED], 0, TRUE))
+    {
+      g_signal_emit (model, model_signals[ROW_CHANGED], 0, iter);
+      return;
+    }
+
+  klass = CLUTTER_MODEL_GET_CLASS (model);
+  if (klass->row_changed != NULL)
+    klass->row_changed (model, iter);
+}
+
+/* resorts the model after some rows have been added or changed; unlike
+ * clutter_model_resort(), the sorting function and column did not
+ * change, so the implementation is allowed to only move the rows that
+ * changed since the last time it was sorted
+ */
+static void
+clutter_model_resort_changed_rows (ClutterModel *model)
+{
+  ClutterModelPrivate *priv = model->priv;
+  ClutterModelClass *klass;
+
+  /* while updating, the model is sorted once when the update ends */
+  if (priv->update_depth > 0)
+    {
+      priv->update_resort = TRUE;
+      return;
+    }
+
+  klass = CLUTTER_MODEL_GET_CLASS (model);
+
+  if (klass->resort)
+    klass->resort (model, priv->sort_func, priv->sort_data);
+}
+
 /**
  * clutter_model_resort:
  * @model: a #ClutterModel
@@ -774,6 +933,13 @@ clutter_model_resort (ClutterModel *model)
   g_return_if_fail (CLUTTER_IS_MODEL (model));
   priv = model->priv;
 
+  /* invalidate whatever sorting state the implementation keeps */
+  priv->sort_stamp += 1;
+
+  /* every row might have moved */
+  if (priv->update_depth > 0)
+    priv->update_all = TRUE;
+
   klass = CLUTTER_MODEL_GET_CLASS (model);
 
   if (klass->resort)
@@ -1061,10 +1227,10 @@ clutter_model_appendv (ClutterModel *model,
       clutter_model_iter_set_value (iter, columns[i], &values[i]);
     }
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   if (resort)
-    clutter_model_resort (model);
+    clutter_model_resort_changed_rows (model);
 
   g_object_unref (iter);
 }
@@ -1109,7 +1275,7 @@ clutter_model_append (ClutterModel *model,
   clutter_model_iter_set_internal_valist (iter, args);
   va_end (args);
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   g_object_unref (iter);
 }
@@ -1155,10 +1321,10 @@ clutter_model_prependv (ClutterModel *model,
       clutter_model_iter_set_value (iter, columns[i], &values[i]);
     }
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   if (resort)
-    clutter_model_resort (model);
+    clutter_model_resort_changed_rows (model);
 
   g_object_unref (iter);
 }
@@ -1198,7 +1364,7 @@ clutter_model_prepend (ClutterModel *model,
   clutter_model_iter_set_internal_valist (iter, args);
   va_end (args);
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   g_object_unref (iter);
 }
@@ -1245,7 +1411,7 @@ clutter_model_insert (ClutterModel *model,
   clutter_model_iter_set_internal_valist (iter, args);
   va_end (args);
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   g_object_unref (iter);
 }
@@ -1293,10 +1459,10 @@ clutter_model_insertv (ClutterModel *model,
       clutter_model_iter_set_value (iter, columns[i], &values[i]);
     }
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   if (resort)
-    clutter_model_resort (model);
+    clutter_model_resort_changed_rows (model);
 
   g_object_unref (iter);
 }
@@ -1342,10 +1508,10 @@ clutter_model_insert_value (ClutterModel *model,
   clutter_model_iter_set_value (iter, column, value);
 
   if (added)
-    g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+    clutter_model_emit_row_added (model, iter);
 
   if (priv->sort_column == column)
-    clutter_model_resort (model);
+    clutter_model_resort_changed_rows (model);
 
   g_object_unref (iter);
 }
@@ -1684,6 +1850,11 @@ clutter_model_set_sort (ClutterModel         *model,
  *
  * Filters the @model using the given filtering function.
  *
+ * The result of @func for each row is kept by the model until the
+ * row changes, or a new filter is set; if @func depends on state that
+ * is not stored inside the @model, use clutter_model_refilter() when
+ * that state changes.
+ *
  * Since: 0.6
  */
 void
@@ -1703,11 +1874,49 @@ clutter_model_set_filter (ClutterModel           *model,
   priv->filter_func = func;
   priv->filter_data = user_data;
   priv->filter_notify = notify;
+  priv->filter_stamp += 1;
+
+  if (priv->update_depth > 0)
+    priv->update_all = TRUE;
 
   g_signal_emit (model, model_signals[FILTER_CHANGED], 0);
   g_object_notify (G_OBJECT (model), "filter-set");
 }
 
+/**
+ * clutter_model_refilter:
+ * @model: a #ClutterModel
+ *
+ * Filters the @model again, using the filtering function set with
+ * clutter_model_set_filter().
+ *
+ * The model keeps the result of the filtering function for each row
+ * until the row changes, so this function should be called whenever
+ * the function would return a different value for rows that did not
+ * change, for instance because it depends on some external state.
+ *
+ * Since: 1.22
+ */
+void
+clutter_model_refilter (ClutterModel *model)
+{
+  ClutterModelPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_MODEL (model));
+  priv = model->priv;
+
+  if (priv->filter_func == NULL)
+    return;
+
+  /* invalidate whatever filtering state the implementation keeps */
+  priv->filter_stamp += 1;
+
+  if (priv->update_depth > 0)
+    priv->update_all = TRUE;
+
+  g_signal_emit (model, model_signals[FILTER_CHANGED], 0);
+}
+
 /**
  * clutter_model_get_filter_set:
  * @model: a #ClutterModel
@@ -1727,6 +1936,115 @@ clutter_model_get_filter_set (ClutterModel *model)
   return model->priv->filter_func != NULL;
 }
 
+/**
+ * clutter_model_begin_update:
+ * @model: a #ClutterModel
+ *
+ * Starts a batch of changes to @model, for instance when adding many
+ * rows at once.
+ *
+ * Until the matching call to clutter_model_end_update(), the changed
+ * rows are collected, and clutter_model_end_update() will emit a single
+ * #ClutterModel::rows-changed signal covering all of them. Rows added or
+ * changed while updating a sorted model will be moved to their position
+ * when the update ends.
+ *
+ * The #ClutterModel::row-added, #ClutterModel::row-removed and
+ * #ClutterModel::row-changed signals are still emitted for each row
+ * while updating, but only if there are handlers connected to them;
+ * the cost of the per-row emissions is avoided only if every listener
+ * uses #ClutterModel::rows-changed.
+ *
+ * Calls to this function can be nested; the signal is emitted when the
+ * outermost update ends.
+ *
+ * Since: 1.22
+ */
+void
+clutter_model_begin_update (ClutterModel *model)
+{
+  ClutterModelPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_MODEL (model));
+  priv = model->priv;
+
+  if (priv->update_depth == 0)
+    {
+      priv->update_n_rows = clutter_model_get_n_rows (model);
+      priv->update_first = G_MAXUINT;
+      priv->update_end = 0;
+    }
+
+  priv->update_depth += 1;
+}
+
+/**
+ * clutter_model_end_update:
+ * @model: a #ClutterModel
+ *
+ * Ends a batch of changes started with clutter_model_begin_update().
+ *
+ * When the outermost update ends, @model is sorted, if needed, and the
+ * #ClutterModel::rows-changed signal is emitted for the range of rows
+ * that changed since the update started.
+ *
+ * Since: 1.22
+ */
+void
+clutter_model_end_update (ClutterModel *model)
+{
+  ClutterModelPrivate *priv;
+  guint first, tail, n_rows, n_unchanged;
+  gboolean update_all;
+
+  g_return_if_fail (CLUTTER_IS_MODEL (model));
+  priv = model->priv;
+  g_return_if_fail (priv->update_depth > 0);
+
+  priv->update_depth -= 1;
+  if (priv->update_depth > 0)
+    return;
+
+  update_all = priv->update_all;
+
+  if (priv->update_resort)
+    {
+      priv->update_resort = FALSE;
+
+      /* the rows that were added or changed can end up anywhere */
+      clutter_model_resort_changed_rows (model);
+      update_all = TRUE;
+    }
+
+  priv->update_all = FALSE;
+
+  if (!update_all && priv->update_first == G_MAXUINT)
+    return;
+
+  n_rows = clutter_model_get_n_rows (model);
+
+  /* the positions of the rows added and changed do not take the filter
+   * into account, so every row has to be reported as changed
+   */
+  if (update_all || clutter_model_get_filter_set (model))
+    first = tail = 0;
+  else
+    {
+      n_unchanged = MIN (n_rows, priv->update_n_rows);
+
+      first = MIN (priv->update_first, n_unchanged);
+      tail = priv->update_end < n_rows ? n_rows - priv->update_end : 0;
+      tail = MIN (tail, n_unchanged - first);
+    }
+
+  priv->update_first = G_MAXUINT;
+
+  _clutter_model_emit_rows_changed (model,
+                                    first,
+                                    priv->update_n_rows - first - tail,
+                                    n_rows - first - tail);
+}
+
 /*
  * ClutterModelIter Object 
  */
@@ -1781,6 +2099,104 @@ clutter_model_iter_real_get_row (ClutterModelIter *iter)
   return iter->priv->row;
 }
 
+/*< private >
+ * _clutter_model_emit_rows_changed:
+ * @model: a #ClutterModel
+ * @position: the position of the first changed row
+ * @n_removed: the number of removed rows
+ * @n_added: the number of added rows
+ *
+ * Emits the #ClutterModel::rows-changed signal.
+ */
+void
+_clutter_model_emit_rows_changed (ClutterModel *model,
+                                  guint         position,
+                                  guint         n_removed,
+                                  guint         n_added)
+{
+  if (n_removed == 0 && n_added == 0)
+    return;
+
+  if (model->priv->update_depth > 0)
+    {
+      clutter_model_update_range (model, position, n_removed, n_added);
+      return;
+    }
+
+  g_signal_emit (model, model_signals[ROWS_CHANGED], 0,
+                 position,
+                 n_removed,
+                 n_added);
+}
+
+/*< private >
+ * _clutter_model_emit_row_removed:
+ * @model: a #ClutterModel
+ * @iter: a #ClutterModelIter pointing to the removed row
+ *
+ * Emits the #ClutterModel::row-removed signal. If @model is being
+ * updated, the row is also added to the changed rows, and if nobody
+ * is listening to the signal only the class handler is run, which is
+ * where the implementations remove the row.
+ */
+void
+_clutter_model_emit_row_removed (ClutterModel     *model,
+                                 ClutterModelIter *iter)
+{
+  ClutterModelClass *klass;
+
+  if (model->priv->update_depth == 0)
+    {
+      g_signal_emit (model, model_signals[ROW_REMOVED], 0, iter);
+      return;
+    }
+
+  clutter_model_update_range (model, clutter_model_iter_get_row (iter), 1, 0);
+
+  if (g_signal_has_handler_pending (model, model_signals[ROW_REMOVED], 0, TRUE))
+    {
+      g_signal_emit (model, model_signals[ROW_REMOVED], 0, iter);
+      return;
+    }
+
+  klass = CLUTTER_MODEL_GET_CLASS (model);
+  if (klass->row_removed != NULL)
+    klass->row_removed (model, iter);
+}
+
+/*< private >
+ * _clutter_model_get_filter_stamp:
+ * @model: a #ClutterModel
+ *
+ * Retrieves a counter that changes every time the filter of @model
+ * is changed; implementations can use it to know when the indexes
+ * of the filtered rows they keep need to be rebuilt.
+ *
+ * Return value: the filter stamp
+ */
+guint
+_clutter_model_get_filter_stamp (ClutterModel *model)
+{
+  return model->priv->filter_stamp;
+}
+
+/*< private >
+ * _clutter_model_get_sort_stamp:
+ * @model: a #ClutterModel
+ *
+ * Retrieves a counter that changes every time clutter_model_resort()
+ * is called; implementations can use it to know whether they have to
+ * sort all the rows again, or only the rows that changed since the
+ * last time the model was sorted.
+ *
+ * Return value: the sort stamp
+ */
+guint
+_clutter_model_get_sort_stamp (ClutterModel *model)
+{
+  return model->priv->sort_stamp;
+}
+
 /* private function */
 void
 _clutter_model_iter_set_row (ClutterModelIter *iter,
@@ -2025,7 +2441,7 @@ clutter_model_iter_set_internal_valist (ClutterModelIter *iter,
     }
 
   if (sort)
-    clutter_model_resort (model);
+    clutter_model_resort_changed_rows (model);
 }
 
 static void inline
@@ -2036,7 +2452,7 @@ clutter_model_iter_emit_row_changed (ClutterModelIter *iter)
 
   g_assert (CLUTTER_IS_MODEL (model));
 
-  g_signal_emit (model, model_signals[ROW_CHANGED], 0, iter);
+  clutter_model_emit_row_changed (model, iter);
 }
 
 /**
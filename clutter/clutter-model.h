@@ -138,6 +138,8 @@ struct _ClutterModel
  *   and returning an iterator pointing to it; if the index is a negative
  *   integer, the row should be appended to the model
  * @remove_row: virtual function for removing a row at the given index
+ * @rows_changed: signal class handler for ClutterModel::rows-changed;
+ *   added in Clutter 1.22
  *
  * Class for #ClutterModel instances.
  *
@@ -175,10 +177,13 @@ struct _ClutterModelClass
                                          ClutterModelIter *iter);
   void              (* sort_changed)    (ClutterModel     *model);
   void              (* filter_changed)  (ClutterModel     *model);
+  void              (* rows_changed)    (ClutterModel     *model,
+                                         guint             position,
+                                         guint             n_removed,
+                                         guint             n_added);
 
   /*< private >*/
   /* padding for future expansion */
-  void (*_clutter_model_1) (void);
   void (*_clutter_model_2) (void);
   void (*_clutter_model_3) (void);
   void (*_clutter_model_4) (void);
@@ -277,6 +282,8 @@ void                  clutter_model_set_filter         (ClutterModel     *model,
                                                         GDestroyNotify    notify);
 CLUTTER_AVAILABLE_IN_ALL
 gboolean              clutter_model_get_filter_set     (ClutterModel     *model);
+CLUTTER_AVAILABLE_IN_1_22
+void                  clutter_model_refilter           (ClutterModel     *model);
 
 CLUTTER_AVAILABLE_IN_ALL
 void                  clutter_model_resort             (ClutterModel     *model);
@@ -287,6 +294,11 @@ CLUTTER_AVAILABLE_IN_ALL
 gboolean              clutter_model_filter_iter        (ClutterModel     *model,
                                                         ClutterModelIter *iter);
 
+CLUTTER_AVAILABLE_IN_1_22
+void                  clutter_model_begin_update       (ClutterModel     *model);
+CLUTTER_AVAILABLE_IN_1_22
+void                  clutter_model_end_update         (ClutterModel     *model);
+
 /*
  * ClutterModelIter 
  */
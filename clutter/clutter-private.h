@@ -139,6 +139,9 @@ struct _ClutterMainContext
   /* default FPS; this is only used if we cannot sync to vblank */
   guint frame_rate;
 
+  /* the frame rate of the virtual clock, or 0 to use the real time */
+  guint virtual_frame_rate;
+
   /* actors with a grab on all devices */
   ClutterActor *pointer_grab_actor;
   ClutterActor *keyboard_grab_actor;
@@ -174,6 +177,7 @@ struct _ClutterMainContext
   guint defer_display_setup     : 1;
   guint options_parsed          : 1;
   guint show_fps                : 1;
+  guint show_frame_timings      : 1;
 };
 
 /* shared between clutter-main.c and clutter-frame-source.c */
@@ -200,6 +204,8 @@ ClutterActor *          _clutter_context_pop_shader_stack               (Clutter
 ClutterActor *          _clutter_context_peek_shader_stack              (void);
 gboolean                _clutter_context_get_motion_events_enabled      (void);
 gboolean                _clutter_context_get_show_fps                   (void);
+gboolean                _clutter_context_get_show_frame_timings         (void);
+guint                   _clutter_context_get_virtual_frame_rate         (void);
 
 const gchar *_clutter_gettext (const gchar *str);
 
@@ -36,9 +36,11 @@
 
 #include "clutter-property-transition.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-animatable.h"
 #include "clutter-debug.h"
 #include "clutter-interval.h"
+#include "clutter-master-clock.h"
 #include "clutter-private.h"
 #include "clutter-transition.h"
 
@@ -47,6 +49,9 @@ struct _ClutterPropertyTransitionPrivate
   char *property_name;
 
   GParamSpec *pspec;
+
+  /* whether we can try to set the value directly on a ClutterActor */
+  guint actor_fast_path : 1;
 };
 
 enum
@@ -111,6 +116,13 @@ clutter_property_transition_attached (ClutterTransition *transition,
   if (priv->pspec == NULL)
     return;
 
+  /* the fast path does its own interpolation, so it cannot be used
+   * if the actor class overrides it
+   */
+  priv->actor_fast_path =
+    CLUTTER_IS_ACTOR (animatable) &&
+    CLUTTER_ANIMATABLE_GET_IFACE (animatable)->interpolate_value == NULL;
+
   interval = clutter_transition_get_interval (transition);
   if (interval == NULL)
     return;
@@ -126,6 +138,95 @@ clutter_property_transition_detached (ClutterTransition *transition,
   ClutterPropertyTransitionPrivate *priv = self->priv;
 
   priv->pspec = NULL; 
+  priv->actor_fast_path = FALSE;
+}
+
+/*
+ * clutter_property_transition_set_actor_value:
+ * @self: a #ClutterPropertyTransition
+ * @actor: the #ClutterActor being animated
+ * @interval: the #ClutterInterval of the transition
+ * @progress: the progress of the transition
+ *
+ * Fast path for the numeric properties of #ClutterActor, like the
+ * position, opacity and transformations, which avoids boxing the
+ * interpolated value inside a #GValue and transforming it at each
+ * frame; the property notifications emitted by the actor are also
+ * coalesced until all the timelines have been advanced.
+ *
+ * Return value: %TRUE if the value was set
+ */
+static gboolean
+clutter_property_transition_set_actor_value (ClutterPropertyTransition *self,
+                                             ClutterActor              *actor,
+                                             ClutterInterval           *interval,
+                                             gdouble                    progress)
+{
+  ClutterPropertyTransitionPrivate *priv = self->priv;
+  const GValue *initial, *final;
+  gdouble value;
+  GType i_type;
+
+  /* sub-classes of ClutterInterval can change the interpolation */
+  if (G_OBJECT_TYPE (interval) != CLUTTER_TYPE_INTERVAL)
+    return FALSE;
+
+  i_type = clutter_interval_get_value_type (interval);
+  if (_clutter_has_progress_function (i_type))
+    return FALSE;
+
+  initial = clutter_interval_peek_initial_value (interval);
+  final = clutter_interval_peek_final_value (interval);
+
+  /* this is the same interpolation done by ClutterInterval */
+  switch (i_type)
+    {
+    case G_TYPE_FLOAT:
+      {
+        gdouble ia = g_value_get_float (initial);
+        gdouble ib = g_value_get_float (final);
+
+        value = (gfloat) ((progress * (ib - ia)) + ia);
+      }
+      break;
+
+    case G_TYPE_DOUBLE:
+      {
+        gdouble ia = g_value_get_double (initial);
+        gdouble ib = g_value_get_double (final);
+
+        value = (progress * (ib - ia)) + ia;
+      }
+      break;
+
+    case G_TYPE_UINT:
+      {
+        guint ia = g_value_get_uint (initial);
+        guint ib = g_value_get_uint (final);
+        guint res = (progress * (ib - (gdouble) ia)) + ia;
+
+        value = res;
+      }
+      break;
+
+    case G_TYPE_UCHAR:
+      {
+        guchar ia = g_value_get_uchar (initial);
+        guchar ib = g_value_get_uchar (final);
+        guchar res = (progress * (ib - (gdouble) ia)) + ia;
+
+        value = res;
+      }
+      break;
+
+    default:
+      return FALSE;
+    }
+
+  _clutter_master_clock_freeze_notify (_clutter_master_clock_get_default (),
+                                       G_OBJECT (actor));
+
+  return _clutter_actor_set_animatable_double (actor, priv->pspec, value);
 }
 
 static void
@@ -146,6 +247,18 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
 
   clutter_property_transition_ensure_interval (self, animatable, interval);
 
+  if (priv->actor_fast_path)
+    {
+      if (clutter_property_transition_set_actor_value (self,
+                                                       CLUTTER_ACTOR (animatable),
+                                                       interval,
+                                                       progress))
+        return;
+
+      /* don't try again for the rest of the transition */
+      priv->actor_fast_path = FALSE;
+    }
+
   p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
   i_type = clutter_interval_get_value_type (interval);
 
@@ -0,0 +1,784 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2015  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-rope-text-buffer
+ * @Title: ClutterRopeTextBuffer
+ * @Short_Description: Text buffer for large documents
+ * @See_Also: #ClutterTextBuffer, #ClutterText
+ *
+ * #ClutterRopeTextBuffer is a #ClutterTextBuffer implementation meant
+ * to be used with large documents, like logs or source files.
+ *
+ * The default #ClutterTextBuffer implementation stores its contents
+ * inside a single contiguous allocation, which means that every edit
+ * has to move the text following it, and has to walk the text from
+ * its beginning to find the byte offset of the edit. It is also
+ * limited to %CLUTTER_TEXT_BUFFER_MAX_SIZE bytes.
+ *
+ * #ClutterRopeTextBuffer stores its contents inside a balanced tree of
+ * small pieces of text; each piece records the number of characters and
+ * bytes of its own subtree, so that finding the byte offset of a position,
+ * inserting and deleting text all take a logarithmic time with respect to
+ * the size of the buffer.
+ *
+ * The contents of the buffer are only copied into a contiguous string
+ * when clutter_text_buffer_get_text() is called after an edit.
+ *
+ * A #ClutterRopeTextBuffer can be used with a #ClutterText by using
+ * clutter_text_new_with_buffer() or clutter_text_set_buffer(), e.g.:
+ *
+ * |[<!-- language="C" -->
+ *   ClutterTextBuffer *buffer = clutter_rope_text_buffer_new ();
+ *   ClutterActor *text = clutter_text_new_with_buffer (buffer);
+ *
+ *   g_object_unref (buffer);
+ * ]|
+ *
+ * #ClutterRopeTextBuffer is available since Clutter 1.22.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-rope-text-buffer.h"
+
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+/* Maximum size of a piece of text, in bytes */
+#define PIECE_SIZE      1024
+
+/* the storage of each piece is rounded up to this size, so that
+ * typing inside a piece does not reallocate it every time
+ */
+#define PIECE_GRANULARITY       32
+
+typedef struct _RopeNode        RopeNode;
+
+struct _RopeNode
+{
+  RopeNode *left;
+  RopeNode *right;
+
+  /* the nodes are kept balanced as a treap */
+  guint32 priority;
+
+  /* totals of the subtree rooted at this node */
+  gsize tree_bytes;
+  guint tree_chars;
+
+  /* the piece of text held by this node */
+  gsize n_bytes;
+  guint n_chars;
+
+  /* the storage of the piece, sized to its contents */
+  gchar *text;
+  gsize text_size;
+};
+
+struct _ClutterRopeTextBufferPrivate
+{
+  RopeNode *root;
+
+  /* the contents as a single string, built on demand */
+  gchar *text;
+  gsize text_size;
+  gsize text_bytes;
+
+  guint text_valid : 1;
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (ClutterRopeTextBuffer,
+                            clutter_rope_text_buffer,
+                            CLUTTER_TYPE_TEXT_BUFFER)
+
+/* Overwrite a memory that might contain sensitive information. */
+static void
+trash_area (gchar *area,
+            gsize  len)
+{
+  volatile gchar *varea = (volatile gchar *)area;
+  while (len-- > 0)
+    *varea++ = 0;
+}
+
+static inline gsize
+piece_size_for_bytes (gsize n_bytes)
+{
+  gsize size;
+
+  size = (n_bytes + PIECE_GRANULARITY - 1) & ~((gsize) PIECE_GRANULARITY - 1);
+
+  return CLAMP (size, PIECE_GRANULARITY, PIECE_SIZE);
+}
+
+static inline gsize
+rope_node_get_bytes (const RopeNode *node)
+{
+  return node != NULL ? node->tree_bytes : 0;
+}
+
+static inline guint
+rope_node_get_chars (const RopeNode *node)
+{
+  return node != NULL ? node->tree_chars : 0;
+}
+
+static inline void
+rope_node_update (RopeNode *node)
+{
+  node->tree_bytes = rope_node_get_bytes (node->left)
+                   + node->n_bytes
+                   + rope_node_get_bytes (node->right);
+  node->tree_chars = rope_node_get_chars (node->left)
+                   + node->n_chars
+                   + rope_node_get_chars (node->right);
+}
+
+static RopeNode *
+rope_node_new (const gchar *text,
+               gsize        n_bytes,
+               guint        n_chars,
+               guint32      priority)
+{
+  RopeNode *node;
+
+  g_assert (n_bytes <= PIECE_SIZE);
+
+  node = g_slice_new (RopeNode);
+  node->left = NULL;
+  node->right = NULL;
+  node->priority = priority;
+  node->n_bytes = n_bytes;
+  node->n_chars = n_chars;
+  node->text_size = piece_size_for_bytes (n_bytes);
+  node->text = g_malloc (node->text_size);
+  memcpy (node->text, text, n_bytes);
+
+  rope_node_update (node);
+
+  return node;
+}
+
+static void
+rope_node_free (RopeNode *node)
+{
+  if (node == NULL)
+    return;
+
+  rope_node_free (node->left);
+  rope_node_free (node->right);
+
+  /* Could be a password, so can't leave stuff in memory. */
+  trash_area (node->text, node->text_size);
+  g_free (node->text);
+
+  g_slice_free (RopeNode, node);
+}
+
+/* makes room for @n_bytes inside the piece of @node */
+static void
+rope_node_ensure_size (RopeNode *node,
+                       gsize     n_bytes)
+{
+  gchar *text;
+  gsize size;
+
+  g_assert (n_bytes <= PIECE_SIZE);
+
+  if (n_bytes <= node->text_size)
+    return;
+
+  size = piece_size_for_bytes (MAX (n_bytes, node->text_size * 2));
+
+  text = g_malloc (size);
+  memcpy (text, node->text, node->n_bytes);
+  trash_area (node->text, node->text_size);
+  g_free (node->text);
+
+  node->text = text;
+  node->text_size = size;
+}
+
+static RopeNode *
+rope_first (RopeNode *node)
+{
+  while (node->left != NULL)
+    node = node->left;
+
+  return node;
+}
+
+static RopeNode *
+rope_last (RopeNode *node)
+{
+  while (node->right != NULL)
+    node = node->right;
+
+  return node;
+}
+
+static RopeNode *
+rope_merge (RopeNode *left,
+            RopeNode *right)
+{
+  if (left == NULL)
+    return right;
+
+  if (right == NULL)
+    return left;
+
+  if (left->priority >= right->priority)
+    {
+      left->right = rope_merge (left->right, right);
+      rope_node_update (left);
+      return left;
+    }
+  else
+    {
+      right->left = rope_merge (left, right->left);
+      rope_node_update (right);
+      return right;
+    }
+}
+
+/* splits @node so that @left contains the first @position characters */
+static void
+rope_split (RopeNode  *node,
+            guint      position,
+            RopeNode **left,
+            RopeNode **right)
+{
+  guint left_chars;
+
+  if (node == NULL)
+    {
+      *left = *right = NULL;
+      return;
+    }
+
+  left_chars = rope_node_get_chars (node->left);
+
+  if (position <= left_chars)
+    {
+      rope_split (node->left, position, left, &node->left);
+      rope_node_update (node);
+      *right = node;
+    }
+  else if (position >= left_chars + node->n_chars)
+    {
+      rope_split (node->right, position - left_chars - node->n_chars,
+                  &node->right, right);
+      rope_node_update (node);
+      *left = node;
+    }
+  else
+    {
+      guint head_chars = position - left_chars;
+      gsize head_bytes;
+      RopeNode *tail;
+
+      /* the split point is inside the piece of this node; the tail
+       * of the piece goes into a new node that takes over the right
+       * subtree, and uses the same priority to keep the heap valid
+       */
+      head_bytes = g_utf8_offset_to_pointer (node->text, head_chars)
+                 - node->text;
+
+      tail = rope_node_new (node->text + head_bytes,
+                            node->n_bytes - head_bytes,
+                            node->n_chars - head_chars,
+                            node->priority);
+      tail->right = node->right;
+      rope_node_update (tail);
+
+      trash_area (node->text + head_bytes, node->n_bytes - head_bytes);
+
+      node->right = NULL;
+      node->n_bytes = head_bytes;
+      node->n_chars = head_chars;
+      rope_node_update (node);
+
+      *left = node;
+      *right = tail;
+    }
+}
+
+/* concatenates @left and @right like rope_merge(); if the pieces on
+ * either side of the junction fit inside a single piece, they are
+ * coalesced, so that repeated edits do not leave behind a trail of
+ * small nodes
+ */
+static RopeNode *
+rope_join (RopeNode *left,
+           RopeNode *right)
+{
+  RopeNode *last, *first;
+  guint left_chars;
+
+  if (left == NULL || right == NULL)
+    return rope_merge (left, right);
+
+  last = rope_last (left);
+  first = rope_first (right);
+
+  if (last->n_bytes + first->n_bytes > PIECE_SIZE)
+    return rope_merge (left, right);
+
+  /* detach the two pieces from their trees; splitting at the boundary
+   * of a piece does not allocate
+   */
+  left_chars = rope_node_get_chars (left);
+  rope_split (left, left_chars - last->n_chars, &left, &last);
+  rope_split (right, first->n_chars, &first, &right);
+
+  g_assert (last->left == NULL && last->right == NULL);
+  g_assert (first->left == NULL && first->right == NULL);
+
+  rope_node_ensure_size (last, last->n_bytes + first->n_bytes);
+  memcpy (last->text + last->n_bytes, first->text, first->n_bytes);
+  last->n_bytes += first->n_bytes;
+  last->n_chars += first->n_chars;
+  rope_node_update (last);
+
+  rope_node_free (first);
+
+  return rope_merge (rope_merge (left, last), right);
+}
+
+/* inserts the text inside the piece containing @position, if it fits */
+static gboolean
+rope_insert_in_place (RopeNode    *node,
+                      guint        position,
+                      const gchar *chars,
+                      gsize        n_bytes,
+                      guint        n_chars)
+{
+  guint left_chars;
+  gboolean res;
+
+  if (node == NULL)
+    return FALSE;
+
+  left_chars = rope_node_get_chars (node->left);
+
+  if (position <= left_chars && node->left != NULL)
+    res = rope_insert_in_place (node->left, position,
+                                chars, n_bytes, n_chars);
+  else if (position > left_chars + node->n_chars)
+    res = rope_insert_in_place (node->right,
+                                position - left_chars - node->n_chars,
+                                chars, n_bytes, n_chars);
+  else if (node->n_bytes + n_bytes <= PIECE_SIZE)
+    {
+      gchar *at;
+
+      rope_node_ensure_size (node, node->n_bytes + n_bytes);
+
+      at = g_utf8_offset_to_pointer (node->text, position - left_chars);
+      memmove (at + n_bytes, at, node->text + node->n_bytes - at);
+      memcpy (at, chars, n_bytes);
+
+      node->n_bytes += n_bytes;
+      node->n_chars += n_chars;
+
+      res = TRUE;
+    }
+  else
+    res = FALSE;
+
+  if (res)
+    rope_node_update (node);
+
+  return res;
+}
+
+static RopeNode *
+rope_new_from_text (const gchar *chars,
+                    gsize        n_bytes)
+{
+  RopeNode *res = NULL;
+  const gchar *p = chars;
+  const gchar *end = chars + n_bytes;
+
+  while (p < end)
+    {
+      const gchar *piece_end;
+
+      if (end - p <= PIECE_SIZE)
+        piece_end = end;
+      else
+        piece_end = g_utf8_find_prev_char (p, p + PIECE_SIZE + 1);
+
+      res = rope_merge (res, rope_node_new (p, piece_end - p,
+                                            g_utf8_strlen (p, piece_end - p),
+                                            g_random_int ()));
+
+      p = piece_end;
+    }
+
+  return res;
+}
+
+static gsize
+rope_get_byte_offset (RopeNode *node,
+                      guint     position)
+{
+  gsize res = 0;
+
+  while (node != NULL)
+    {
+      guint left_chars = rope_node_get_chars (node->left);
+
+      if (position < left_chars)
+        node = node->left;
+      else if (position <= left_chars + node->n_chars)
+        {
+          position -= left_chars;
+          res += rope_node_get_bytes (node->left);
+          res += g_utf8_offset_to_pointer (node->text, position) - node->text;
+          break;
+        }
+      else
+        {
+          position -= left_chars + node->n_chars;
+          res += rope_node_get_bytes (node->left) + node->n_bytes;
+          node = node->right;
+        }
+    }
+
+  return res;
+}
+
+static guint
+rope_get_position (RopeNode *node,
+                   gsize     byte_offset)
+{
+  guint res = 0;
+
+  while (node != NULL)
+    {
+      gsize left_bytes = rope_node_get_bytes (node->left);
+
+      if (byte_offset < left_bytes)
+        node = node->left;
+      else if (byte_offset <= left_bytes + node->n_bytes)
+        {
+          byte_offset -= left_bytes;
+          res += rope_node_get_chars (node->left);
+          res += g_utf8_pointer_to_offset (node->text, node->text + byte_offset);
+          break;
+        }
+      else
+        {
+          byte_offset -= left_bytes + node->n_bytes;
+          res += rope_node_get_chars (node->left) + node->n_chars;
+          node = node->right;
+        }
+    }
+
+  return res;
+}
+
+static gchar *
+rope_copy_text (RopeNode *node,
+                gchar    *dest)
+{
+  while (node != NULL)
+    {
+      dest = rope_copy_text (node->left, dest);
+
+      memcpy (dest, node->text, node->n_bytes);
+      dest += node->n_bytes;
+
+      node = node->right;
+    }
+
+  return dest;
+}
+
+static void
+clutter_rope_text_buffer_invalidate_text (ClutterRopeTextBuffer *self)
+{
+  ClutterRopeTextBufferPrivate *priv = self->priv;
+
+  if (!priv->text_valid)
+    return;
+
+  /* Could be a password, so can't leave stuff in memory. */
+  trash_area (priv->text, priv->text_bytes);
+
+  priv->text_bytes = 0;
+  priv->text_valid = FALSE;
+}
+
+static const gchar *
+clutter_rope_text_buffer_get_text (ClutterTextBuffer *buffer,
+                                   gsize             *n_bytes)
+{
+  ClutterRopeTextBufferPrivate *priv = CLUTTER_ROPE_TEXT_BUFFER (buffer)->priv;
+  gsize bytes = rope_node_get_bytes (priv->root);
+
+  if (n_bytes != NULL)
+    *n_bytes = bytes;
+
+  if (!priv->text_valid)
+    {
+      gchar *end;
+
+      /* the previous contents have been trashed already */
+      if (bytes + 1 > priv->text_size)
+        {
+          g_free (priv->text);
+
+          priv->text_size = MAX (bytes + 1, priv->text_size * 2);
+          priv->text = g_malloc (priv->text_size);
+        }
+
+      end = rope_copy_text (priv->root, priv->text);
+      *end = '\0';
+
+      priv->text_bytes = bytes;
+
+      CLUTTER_NOTE (MISC, "Flattened rope text buffer %p (%" G_GSIZE_FORMAT " bytes)",
+                    buffer,
+                    bytes);
+
+      priv->text_valid = TRUE;
+    }
+
+  return priv->text != NULL ? priv->text : "";
+}
+
+static guint
+clutter_rope_text_buffer_get_length (ClutterTextBuffer *buffer)
+{
+  ClutterRopeTextBufferPrivate *priv = CLUTTER_ROPE_TEXT_BUFFER (buffer)->priv;
+
+  return rope_node_get_chars (priv->root);
+}
+
+static guint
+clutter_rope_text_buffer_insert_text (ClutterTextBuffer *buffer,
+                                      guint              position,
+                                      const gchar       *chars,
+                                      guint              n_chars)
+{
+  ClutterRopeTextBufferPrivate *priv = CLUTTER_ROPE_TEXT_BUFFER (buffer)->priv;
+  gsize n_bytes;
+
+  if (n_chars == 0)
+    return 0;
+
+  n_bytes = g_utf8_offset_to_pointer (chars, n_chars) - chars;
+
+  position = MIN (position, rope_node_get_chars (priv->root));
+
+  if (!rope_insert_in_place (priv->root, position, chars, n_bytes, n_chars))
+    {
+      RopeNode *left, *right;
+
+      rope_split (priv->root, position, &left, &right);
+
+      priv->root = rope_join (rope_join (left,
+                                         rope_new_from_text (chars, n_bytes)),
+                              right);
+    }
+
+  clutter_rope_text_buffer_invalidate_text (CLUTTER_ROPE_TEXT_BUFFER (buffer));
+
+  clutter_text_buffer_emit_inserted_text (buffer, position, chars, n_chars);
+
+  return n_chars;
+}
+
+static guint
+clutter_rope_text_buffer_delete_text (ClutterTextBuffer *buffer,
+                                      guint              position,
+                                      guint              n_chars)
+{
+  ClutterRopeTextBufferPrivate *priv = CLUTTER_ROPE_TEXT_BUFFER (buffer)->priv;
+  RopeNode *left, *middle, *right;
+  guint length;
+
+  length = rope_node_get_chars (priv->root);
+
+  if (position > length)
+    position = length;
+  if (position + n_chars > length)
+    n_chars = length - position;
+
+  if (n_chars == 0)
+    return 0;
+
+  rope_split (priv->root, position + n_chars, &middle, &right);
+  rope_split (middle, position, &left, &middle);
+  rope_node_free (middle);
+
+  priv->root = rope_join (left, right);
+
+  clutter_rope_text_buffer_invalidate_text (CLUTTER_ROPE_TEXT_BUFFER (buffer));
+
+  clutter_text_buffer_emit_deleted_text (buffer, position, n_chars);
+
+  return n_chars;
+}
+
+static void
+clutter_rope_text_buffer_finalize (GObject *gobject)
+{
+  ClutterRopeTextBufferPrivate *priv = CLUTTER_ROPE_TEXT_BUFFER (gobject)->priv;
+
+  rope_node_free (priv->root);
+
+  clutter_rope_text_buffer_invalidate_text (CLUTTER_ROPE_TEXT_BUFFER (gobject));
+  g_free (priv->text);
+
+  G_OBJECT_CLASS (clutter_rope_text_buffer_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_rope_text_buffer_class_init (ClutterRopeTextBufferClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterTextBufferClass *buffer_class = CLUTTER_TEXT_BUFFER_CLASS (klass);
+
+  gobject_class->finalize = clutter_rope_text_buffer_finalize;
+
+  buffer_class->get_text = clutter_rope_text_buffer_get_text;
+  buffer_class->get_length = clutter_rope_text_buffer_get_length;
+  buffer_class->insert_text = clutter_rope_text_buffer_insert_text;
+  buffer_class->delete_text = clutter_rope_text_buffer_delete_text;
+}
+
+static void
+clutter_rope_text_buffer_init (ClutterRopeTextBuffer *self)
+{
+  self->priv = clutter_rope_text_buffer_get_instance_private (self);
+}
+
+/**
+ * clutter_rope_text_buffer_new:
+ *
+ * Creates a new, empty #ClutterRopeTextBuffer.
+ *
+ * Return value: (transfer full): the newly created #ClutterRopeTextBuffer.
+ *   Use g_object_unref() when done.
+ *
+ * Since: 1.22
+ */
+ClutterTextBuffer *
+clutter_rope_text_buffer_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_ROPE_TEXT_BUFFER, NULL);
+}
+
+/**
+ * clutter_rope_text_buffer_new_with_text:
+ * @text: (allow-none): initial buffer text
+ * @text_len: initial buffer text length, or -1 for null-terminated.
+ *
+ * Creates a new #ClutterRopeTextBuffer containing @text.
+ *
+ * Return value: (transfer full): the newly created #ClutterRopeTextBuffer.
+ *   Use g_object_unref() when done.
+ *
+ * Since: 1.22
+ */
+ClutterTextBuffer *
+clutter_rope_text_buffer_new_with_text (const gchar *text,
+                                        gssize       text_len)
+{
+  ClutterTextBuffer *buffer;
+
+  buffer = clutter_rope_text_buffer_new ();
+
+  if (text != NULL)
+    clutter_text_buffer_set_text (buffer, text, text_len);
+
+  return buffer;
+}
+
+/**
+ * clutter_rope_text_buffer_get_byte_offset:
+ * @buffer: a #ClutterRopeTextBuffer
+ * @position: a position inside the buffer, in characters
+ *
+ * Retrieves the offset in bytes of @position inside the contents
+ * of @buffer, as returned by clutter_text_buffer_get_text().
+ *
+ * Unlike g_utf8_offset_to_pointer(), this function does not need to
+ * walk the contents of @buffer from the beginning.
+ *
+ * Return value: the offset of @position, in bytes
+ *
+ * Since: 1.22
+ */
+gsize
+clutter_rope_text_buffer_get_byte_offset (ClutterRopeTextBuffer *buffer,
+                                          guint                  position)
+{
+  RopeNode *root;
+
+  g_return_val_if_fail (CLUTTER_IS_ROPE_TEXT_BUFFER (buffer), 0);
+
+  root = buffer->priv->root;
+
+  if (position >= rope_node_get_chars (root))
+    return rope_node_get_bytes (root);
+
+  return rope_get_byte_offset (root, position);
+}
+
+/**
+ * clutter_rope_text_buffer_get_position:
+ * @buffer: a #ClutterRopeTextBuffer
+ * @byte_offset: an offset inside the contents of the buffer, in bytes
+ *
+ * Retrieves the position, in characters, of the character at
+ * @byte_offset inside the contents of @buffer, as returned by
+ * clutter_text_buffer_get_text().
+ *
+ * This is the inverse of clutter_rope_text_buffer_get_byte_offset().
+ *
+ * Return value: the position of @byte_offset, in characters
+ *
+ * Since: 1.22
+ */
+guint
+clutter_rope_text_buffer_get_position (ClutterRopeTextBuffer *buffer,
+                                       gsize                  byte_offset)
+{
+  RopeNode *root;
+
+  g_return_val_if_fail (CLUTTER_IS_ROPE_TEXT_BUFFER (buffer), 0);
+
+  root = buffer->priv->root;
+
+  if (byte_offset >= rope_node_get_bytes (root))
+    return rope_node_get_chars (root);
+
+  return rope_get_position (root, byte_offset);
+}
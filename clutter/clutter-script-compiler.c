@@ -0,0 +1,318 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * clutter-script-compiler: compiles a ClutterScript UI definition
+ *
+ * The compiler parses a JSON UI definition and resolves the values
+ * that ClutterScript would otherwise have to convert from strings
+ * when loading it: enumerations and flags are replaced by their
+ * numeric value, and colors by an array of components, using the
+ * properties of the type of each object. The resulting tree is
+ * stored as a serialized GVariant, which ClutterScript can use
+ * without parsing.
+ *
+ * Values that cannot be resolved, for instance because the type of
+ * an object is not known to the compiler, are stored unchanged, and
+ * will be resolved at run time.
+ *
+ * The compiler does not initialize Clutter, so it can run without a
+ * display, for instance as part of a build: the types are resolved by
+ * name through the GType system, and their classes are only referenced
+ * to look up their properties.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <json-glib/json-glib.h>
+
+#include "clutter-color.h"
+#include "clutter-script.h"
+#include "clutter-script-private.h"
+
+static gboolean
+resolve_enum (GType        gtype,
+              const gchar *string,
+              gint64      *value)
+{
+  GEnumClass *eclass;
+  GEnumValue *ev;
+
+  eclass = g_type_class_ref (gtype);
+  ev = g_enum_get_value_by_name (eclass, string);
+  if (ev == NULL)
+    ev = g_enum_get_value_by_nick (eclass, string);
+
+  if (ev != NULL)
+    *value = ev->value;
+
+  g_type_class_unref (eclass);
+
+  return ev != NULL;
+}
+
+static gboolean
+resolve_flags (GType        gtype,
+               const gchar *string,
+               gint64      *value)
+{
+  GFlagsClass *fclass;
+  gchar **names;
+  gboolean retval = TRUE;
+  guint flags = 0;
+  gint i;
+
+  fclass = g_type_class_ref (gtype);
+  names = g_strsplit (string, "|", -1);
+
+  for (i = 0; names[i] != NULL && retval; i++)
+    {
+      const gchar *name = g_strstrip (names[i]);
+      GFlagsValue *fv;
+
+      fv = g_flags_get_value_by_name (fclass, name);
+      if (fv == NULL)
+        fv = g_flags_get_value_by_nick (fclass, name);
+
+      if (fv != NULL)
+        flags |= fv->value;
+      else
+        retval = FALSE;
+    }
+
+  g_strfreev (names);
+  g_type_class_unref (fclass);
+
+  if (retval)
+    *value = flags;
+
+  return retval;
+}
+
+static void
+resolve_member (JsonObject *object,
+                const gchar *name,
+                GParamSpec  *pspec)
+{
+  JsonNode *node = json_object_get_member (object, name);
+  GType value_type = G_PARAM_SPEC_VALUE_TYPE (pspec);
+  const gchar *string;
+  gint64 value;
+
+  if (json_node_get_value_type (node) != G_TYPE_STRING)
+    return;
+
+  string = json_node_get_string (node);
+
+  if (G_TYPE_IS_ENUM (value_type))
+    {
+      if (resolve_enum (value_type, string, &value))
+        json_object_set_int_member (object, name, value);
+    }
+  else if (G_TYPE_IS_FLAGS (value_type))
+    {
+      if (resolve_flags (value_type, string, &value))
+        json_object_set_int_member (object, name, value);
+    }
+  else if (value_type == CLUTTER_TYPE_COLOR)
+    {
+      ClutterColor color;
+
+      if (clutter_color_from_string (&color, string))
+        {
+          JsonArray *array = json_array_sized_new (4);
+
+          json_array_add_int_element (array, color.red);
+          json_array_add_int_element (array, color.green);
+          json_array_add_int_element (array, color.blue);
+          json_array_add_int_element (array, color.alpha);
+
+          json_object_set_array_member (object, name, array);
+        }
+    }
+}
+
+/* returns the name of the type of @object if it could not be
+ * resolved, and %NULL otherwise
+ */
+static const gchar *
+resolve_object (ClutterScript *script,
+                JsonObject    *object)
+{
+  GObjectClass *klass;
+  const gchar *type_name;
+  GList *members, *l;
+  GType gtype;
+
+  if (!json_object_has_member (object, "type") ||
+      json_object_has_member (object, "type_func"))
+    return NULL;
+
+  type_name = json_object_get_string_member (object, "type");
+  if (type_name == NULL)
+    return NULL;
+
+  gtype = clutter_script_get_type_from_name (script, type_name);
+  if (!G_TYPE_IS_OBJECT (gtype))
+    return type_name;
+
+  klass = g_type_class_ref (gtype);
+
+  members = json_object_get_members (object);
+  for (l = members; l != NULL; l = l->next)
+    {
+      const gchar *name = l->data;
+      GParamSpec *pspec;
+
+      /* child and layout properties depend on the parent */
+      if (strchr (name, ':') != NULL)
+        continue;
+
+      pspec = g_object_class_find_property (klass, name);
+      if (pspec == NULL)
+        continue;
+
+      resolve_member (object, name, pspec);
+    }
+
+  g_list_free (members);
+
+  g_type_class_unref (klass);
+
+  return NULL;
+}
+
+/* resolves the values inside @node, and adds the names of the types
+ * that could not be resolved to @unknown_types
+ */
+static void
+resolve_node (ClutterScript *script,
+              JsonNode      *node,
+              GHashTable    *unknown_types)
+{
+  switch (JSON_NODE_TYPE (node))
+    {
+    case JSON_NODE_OBJECT:
+      {
+        JsonObject *object = json_node_get_object (node);
+        const gchar *type_name;
+        GList *values, *l;
+
+        values = json_object_get_values (object);
+        for (l = values; l != NULL; l = l->next)
+          resolve_node (script, l->data, unknown_types);
+
+        g_list_free (values);
+
+        type_name = resolve_object (script, object);
+        if (type_name != NULL)
+          g_hash_table_add (unknown_types, g_strdup (type_name));
+      }
+      break;
+
+    case JSON_NODE_ARRAY:
+      {
+        JsonArray *array = json_node_get_array (node);
+        guint i, n_elements;
+
+        n_elements = json_array_get_length (array);
+        for (i = 0; i < n_elements; i++)
+          resolve_node (script, json_array_get_element (array, i),
+                        unknown_types);
+      }
+      break;
+
+    default:
+      break;
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  ClutterScript *script;
+  JsonParser *parser;
+  GHashTable *unknown_types;
+  GHashTableIter iter;
+  gpointer type_name;
+  GVariant *variant;
+  GString *buffer;
+  GError *error = NULL;
+  gboolean res;
+
+  if (argc != 3)
+    {
+      g_printerr ("Usage: %s INPUT OUTPUT\n"
+                  "Compiles the ClutterScript UI definition in INPUT "
+                  "and saves it into OUTPUT\n",
+                  argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  parser = json_parser_new ();
+  if (!json_parser_load_from_file (parser, argv[1], &error))
+    {
+      g_printerr ("Unable to parse '%s': %s\n", argv[1], error->message);
+      g_error_free (error);
+      g_object_unref (parser);
+      return EXIT_FAILURE;
+    }
+
+  /* used only to resolve the types, like ClutterScript does */
+  script = clutter_script_new ();
+  unknown_types = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  resolve_node (script, json_parser_get_root (parser), unknown_types);
+  g_object_unref (script);
+
+  g_hash_table_iter_init (&iter, unknown_types);
+  while (g_hash_table_iter_next (&iter, &type_name, NULL))
+    g_printerr ("Unknown type '%s'; its properties will be resolved "
+                "when loading the UI definition\n",
+                (const gchar *) type_name);
+
+  g_hash_table_unref (unknown_types);
+
+  variant = g_variant_new_variant (json_gvariant_serialize (json_parser_get_root (parser)));
+  g_variant_ref_sink (variant);
+
+  buffer = g_string_new_len (CLUTTER_SCRIPT_COMPILED_MAGIC,
+                             CLUTTER_SCRIPT_COMPILED_MAGIC_LEN);
+  g_string_append_len (buffer,
+                       g_variant_get_data (variant),
+                       g_variant_get_size (variant));
+
+  res = g_file_set_contents (argv[2], buffer->str, buffer->len, &error);
+  if (!res)
+    {
+      g_printerr ("Unable to save '%s': %s\n", argv[2], error->message);
+      g_error_free (error);
+    }
+
+  g_string_free (buffer, TRUE);
+  g_variant_unref (variant);
+  g_object_unref (parser);
+
+  return res ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -72,6 +72,116 @@ clutter_script_parser_init (ClutterScriptParser *parser)
 {
 }
 
+/* the caches below are shared by every ClutterScript instance, so
+ * that merging the same UI definitions over and over again does not
+ * require resolving the same type names, properties and enumeration
+ * values every time; types are never unregistered, so the entries
+ * never become stale. only the successful lookups are cached: a type
+ * might be registered later on, for instance by a plugin, and it must
+ * be resolvable by the UI definitions loaded afterwards
+ */
+static GHashTable *symbol_cache = NULL;
+static GHashTable *class_cache = NULL;
+static GHashTable *pspec_cache = NULL;
+static GHashTable *enum_cache = NULL;
+static GHashTable *flags_cache = NULL;
+
+static void
+pspec_cache_value_free (gpointer data)
+{
+  g_param_spec_unref (data);
+}
+
+/* returns the table of string keys for @gtype inside @cache */
+static GHashTable *
+get_type_cache (GHashTable     **cache,
+                GType            gtype,
+                GDestroyNotify   value_free)
+{
+  GHashTable *table;
+
+  if (G_UNLIKELY (*cache == NULL))
+    *cache = g_hash_table_new_full (NULL, NULL,
+                                    NULL,
+                                    (GDestroyNotify) g_hash_table_unref);
+
+  table = g_hash_table_lookup (*cache, GSIZE_TO_POINTER (gtype));
+  if (table == NULL)
+    {
+      table = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                     g_free,
+                                     value_free);
+      g_hash_table_insert (*cache, GSIZE_TO_POINTER (gtype), table);
+    }
+
+  return table;
+}
+
+/* looks up a type in one of the string to GType caches */
+static gboolean
+lookup_type_cache (GHashTable  *cache,
+                   const gchar *name,
+                   GType       *gtype)
+{
+  gpointer value;
+
+  if (cache == NULL)
+    return FALSE;
+
+  value = g_hash_table_lookup (cache, name);
+  if (value == NULL)
+    return FALSE;
+
+  *gtype = (GType) GPOINTER_TO_SIZE (value);
+
+  return TRUE;
+}
+
+static void
+store_type_cache (GHashTable  **cache,
+                  const gchar  *name,
+                  GType         gtype)
+{
+  if (gtype == G_TYPE_INVALID)
+    return;
+
+  if (G_UNLIKELY (*cache == NULL))
+    *cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  g_hash_table_insert (*cache, g_strdup (name), GSIZE_TO_POINTER (gtype));
+}
+
+/*< private >
+ * _clutter_script_find_property:
+ * @klass: a #GObjectClass
+ * @name: the name of a property
+ *
+ * Caching version of g_object_class_find_property().
+ *
+ * Return value: (transfer none): the #GParamSpec, or %NULL
+ */
+GParamSpec *
+_clutter_script_find_property (GObjectClass *klass,
+                               const gchar  *name)
+{
+  GHashTable *table;
+  GParamSpec *pspec;
+
+  table = get_type_cache (&pspec_cache, G_OBJECT_CLASS_TYPE (klass),
+                          pspec_cache_value_free);
+
+  pspec = g_hash_table_lookup (table, name);
+  if (pspec == NULL)
+    {
+      pspec = g_object_class_find_property (klass, name);
+      if (pspec != NULL)
+        g_hash_table_insert (table, g_strdup (name),
+                             g_param_spec_ref (pspec));
+    }
+
+  return pspec;
+}
+
 GType
 _clutter_script_get_type_from_symbol (const gchar *symbol)
 {
@@ -79,11 +189,16 @@ _clutter_script_get_type_from_symbol (const gchar *symbol)
   GTypeGetFunc func;
   GType gtype = G_TYPE_INVALID;
 
+  if (lookup_type_cache (symbol_cache, symbol, &gtype))
+    return gtype;
+
   if (!module)
     module = g_module_open (NULL, 0);
   
   if (g_module_symbol (module, symbol, (gpointer)&func))
     gtype = func ();
+
+  store_type_cache (&symbol_cache, symbol, gtype);
   
   return gtype;
 }
@@ -92,14 +207,19 @@ GType
 _clutter_script_get_type_from_class (const gchar *name)
 {
   static GModule *module = NULL;
-  GString *symbol_name = g_string_sized_new (64);
+  GString *symbol_name;
   GType gtype = G_TYPE_INVALID;
   GTypeGetFunc func;
   gchar *symbol;
   gint i;
 
+  if (lookup_type_cache (class_cache, name, &gtype))
+    return gtype;
+
   if (G_UNLIKELY (!module))
     module = g_module_open (NULL, 0);
+
+  symbol_name = g_string_sized_new (64);
   
   for (i = 0; name[i] != '\0'; i++)
     {
@@ -149,6 +269,8 @@ _clutter_script_get_type_from_class (const gchar *name)
   
   g_free (symbol);
 
+  store_type_cache (&class_cache, name, gtype);
+
   return gtype;
 }
 
@@ -173,12 +295,21 @@ _clutter_script_enum_from_string (GType        type,
 {
   GEnumClass *eclass;
   GEnumValue *ev;
+  GHashTable *table;
+  gpointer cached;
   gchar *endptr;
   gint value;
   gboolean retval = TRUE;
   
   g_return_val_if_fail (G_TYPE_IS_ENUM (type), 0);
   g_return_val_if_fail (string != NULL, 0);
+
+  table = get_type_cache (&enum_cache, type, NULL);
+  if (g_hash_table_lookup_extended (table, string, NULL, &cached))
+    {
+      *enum_value = GPOINTER_TO_INT (cached);
+      return TRUE;
+    }
   
   value = strtoul (string, &endptr, 0);
   if (endptr != string) /* parsed a number */
@@ -198,6 +329,9 @@ _clutter_script_enum_from_string (GType        type,
       g_type_class_unref (eclass);
     }
 
+  if (retval)
+    g_hash_table_insert (table, g_strdup (string), GINT_TO_POINTER (*enum_value));
+
   return retval;
 }
 
@@ -211,10 +345,19 @@ _clutter_script_flags_from_string (GType        type,
   gchar *flagstr;
   GFlagsValue *fv;
   const gchar *flag;
+  GHashTable *table;
+  gpointer cached;
 
   g_return_val_if_fail (G_TYPE_IS_FLAGS (type), 0);
   g_return_val_if_fail (string != NULL, 0);
 
+  table = get_type_cache (&flags_cache, type, NULL);
+  if (g_hash_table_lookup_extended (table, string, NULL, &cached))
+    {
+      *flags_value = GPOINTER_TO_INT (cached);
+      return TRUE;
+    }
+
   ret = TRUE;
   
   value = strtoul (string, &endptr, 0);
@@ -296,6 +439,9 @@ _clutter_script_flags_from_string (GType        type,
       g_type_class_unref (fclass);
     }
 
+  if (ret)
+    g_hash_table_insert (table, g_strdup (string), GINT_TO_POINTER (*flags_value));
+
   return ret;
 }
 
@@ -423,7 +569,7 @@ static gboolean
 parse_color_from_array (JsonArray    *array,
                         ClutterColor *color)
 {
-  if (json_array_get_length (array) != 3 ||
+  if (json_array_get_length (array) != 3 &&
       json_array_get_length (array) != 4)
     return FALSE;
 
@@ -1189,13 +1335,263 @@ clutter_script_parser_object_end (JsonParser *json_parser,
                 g_list_length (oinfo->signals));
 
   _clutter_script_add_object_info (script, oinfo);
-  _clutter_script_construct_object (script, oinfo);
+
+  if (!clutter_script_get_lazy_construction (script))
+    _clutter_script_construct_object (script, oinfo);
 }
 
 static void
 clutter_script_parser_parse_end (JsonParser *parser)
 {
-  clutter_script_ensure_objects (CLUTTER_SCRIPT_PARSER (parser)->script);
+  _clutter_script_update_objects (CLUTTER_SCRIPT_PARSER (parser)->script);
+}
+
+gboolean
+_clutter_script_is_compiled_data (const gchar *data,
+                                  gsize        length)
+{
+  return length > CLUTTER_SCRIPT_COMPILED_MAGIC_LEN &&
+         memcmp (data,
+                 CLUTTER_SCRIPT_COMPILED_MAGIC,
+                 CLUTTER_SCRIPT_COMPILED_MAGIC_LEN) == 0;
+}
+
+/* builds the JSON node for a GVariant in the format produced by
+ * json_gvariant_serialize(), calling the ::object-end handler for the
+ * inner objects before the ones containing them, like JsonParser does
+ */
+static JsonNode *
+clutter_script_parser_node_from_variant (JsonParser *parser,
+                                         GVariant   *variant,
+                                         GError    **error)
+{
+  JsonNode *node = NULL;
+
+  switch (g_variant_classify (variant))
+    {
+    case G_VARIANT_CLASS_BOOLEAN:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_boolean (node, g_variant_get_boolean (variant));
+      break;
+
+    case G_VARIANT_CLASS_BYTE:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, g_variant_get_byte (variant));
+      break;
+
+    case G_VARIANT_CLASS_INT16:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, g_variant_get_int16 (variant));
+      break;
+
+    case G_VARIANT_CLASS_UINT16:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, g_variant_get_uint16 (variant));
+      break;
+
+    case G_VARIANT_CLASS_INT32:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, g_variant_get_int32 (variant));
+      break;
+
+    case G_VARIANT_CLASS_UINT32:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, g_variant_get_uint32 (variant));
+      break;
+
+    case G_VARIANT_CLASS_INT64:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, g_variant_get_int64 (variant));
+      break;
+
+    case G_VARIANT_CLASS_UINT64:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, g_variant_get_uint64 (variant));
+      break;
+
+    case G_VARIANT_CLASS_DOUBLE:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_double (node, g_variant_get_double (variant));
+      break;
+
+    case G_VARIANT_CLASS_STRING:
+    case G_VARIANT_CLASS_OBJECT_PATH:
+    case G_VARIANT_CLASS_SIGNATURE:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_string (node, g_variant_get_string (variant, NULL));
+      break;
+
+    case G_VARIANT_CLASS_VARIANT:
+      {
+        GVariant *child = g_variant_get_variant (variant);
+
+        node = clutter_script_parser_node_from_variant (parser, child, error);
+        g_variant_unref (child);
+      }
+      break;
+
+    case G_VARIANT_CLASS_MAYBE:
+      {
+        GVariant *child = g_variant_get_maybe (variant);
+
+        if (child != NULL)
+          {
+            node = clutter_script_parser_node_from_variant (parser, child, error);
+            g_variant_unref (child);
+          }
+        else
+          node = json_node_new (JSON_NODE_NULL);
+      }
+      break;
+
+    case G_VARIANT_CLASS_ARRAY:
+      if (g_variant_is_of_type (variant, G_VARIANT_TYPE_VARDICT))
+        {
+          JsonObject *object = json_object_new ();
+          GVariantIter iter;
+          const gchar *name;
+          GVariant *child;
+
+          node = json_node_new (JSON_NODE_OBJECT);
+          json_node_take_object (node, object);
+
+          g_variant_iter_init (&iter, variant);
+          while (g_variant_iter_next (&iter, "{&sv}", &name, &child))
+            {
+              JsonNode *member;
+
+              member = clutter_script_parser_node_from_variant (parser, child, error);
+              g_variant_unref (child);
+
+              if (member == NULL)
+                {
+                  json_node_free (node);
+                  return NULL;
+                }
+
+              json_object_set_member (object, name, member);
+            }
+
+          clutter_script_parser_object_end (parser, object);
+          break;
+        }
+
+      /* fall through */
+    case G_VARIANT_CLASS_TUPLE:
+      {
+        JsonArray *array;
+        gsize i, n_children;
+
+        n_children = g_variant_n_children (variant);
+        array = json_array_sized_new (n_children);
+
+        node = json_node_new (JSON_NODE_ARRAY);
+        json_node_take_array (node, array);
+
+        for (i = 0; i < n_children; i++)
+          {
+            GVariant *child = g_variant_get_child_value (variant, i);
+            JsonNode *element;
+
+            element = clutter_script_parser_node_from_variant (parser, child, error);
+            g_variant_unref (child);
+
+            if (element == NULL)
+              {
+                json_node_free (node);
+                return NULL;
+              }
+
+            json_array_add_element (array, element);
+          }
+      }
+      break;
+
+    default:
+      g_set_error (error, CLUTTER_SCRIPT_ERROR,
+                   CLUTTER_SCRIPT_ERROR_INVALID_VALUE,
+                   "Invalid value of type '%s' in compiled UI definition",
+                   g_variant_get_type_string (variant));
+      break;
+    }
+
+  return node;
+}
+
+/*< private >
+ * _clutter_script_parser_load_compiled:
+ * @parser: a #ClutterScriptParser
+ * @data: the contents of a compiled UI definition
+ * @length: the length of @data
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads a UI definition compiled by clutter-script-compiler.
+ *
+ * The JSON tree is built directly from the serialized #GVariant, which
+ * does not require tokenizing and validating the JSON text; the objects
+ * are processed exactly like the ones coming out of the #JsonParser.
+ *
+ * Return value: %TRUE if the definition was loaded
+ */
+gboolean
+_clutter_script_parser_load_compiled (ClutterScriptParser *parser,
+                                      const gchar         *data,
+                                      gsize                length,
+                                      GError             **error)
+{
+  const gchar *contents;
+  GVariant *variant;
+  JsonNode *root;
+  GBytes *bytes;
+  gsize size;
+
+  g_assert (_clutter_script_is_compiled_data (data, length));
+
+  contents = data + CLUTTER_SCRIPT_COMPILED_MAGIC_LEN;
+  size = length - CLUTTER_SCRIPT_COMPILED_MAGIC_LEN;
+
+  /* GVariant requires its data to be aligned for the largest type it
+   * contains; mapped files are, but buffers coming from the application
+   * might not be, so we copy those
+   */
+  if ((GPOINTER_TO_SIZE (contents) % 8) == 0)
+    bytes = g_bytes_new_static (contents, size);
+  else
+    bytes = g_bytes_new (contents, size);
+
+  variant = g_variant_new_from_bytes (G_VARIANT_TYPE_VARIANT, bytes, FALSE);
+  g_variant_ref_sink (variant);
+  g_bytes_unref (bytes);
+
+  CLUTTER_NOTE (SCRIPT, "Loading compiled UI definition (%" G_GSIZE_FORMAT " bytes)",
+                length);
+
+  root = clutter_script_parser_node_from_variant (JSON_PARSER (parser),
+                                                  variant,
+                                                  error);
+
+  /* the strings are copied inside the JSON nodes, so the variant
+   * does not need to outlive the data
+   */
+  g_variant_unref (variant);
+
+  if (root == NULL)
+    return FALSE;
+
+  if (!JSON_NODE_HOLDS_OBJECT (root) && !JSON_NODE_HOLDS_ARRAY (root))
+    {
+      g_set_error_literal (error, CLUTTER_SCRIPT_ERROR,
+                           CLUTTER_SCRIPT_ERROR_INVALID_VALUE,
+                           "Invalid compiled UI definition");
+      json_node_free (root);
+      return FALSE;
+    }
+
+  clutter_script_parser_parse_end (JSON_PARSER (parser));
+
+  json_node_free (root);
+
+  return TRUE;
 }
 
 gboolean
@@ -1735,7 +2131,7 @@ clutter_script_construct_parameters (ClutterScript  *script,
        * class we just skip it and let the class itself deal
        * with it later on
        */
-      pspec = g_object_class_find_property (klass, pinfo->name);
+      pspec = _clutter_script_find_property (klass, pinfo->name);
       if (pspec)
         pinfo->pspec = g_param_spec_ref (pspec);
       else
@@ -2021,6 +2417,12 @@ add_children (ClutterScript *script,
                     g_type_name (G_OBJECT_TYPE (container)));
 
       clutter_container_add_actor (container, CLUTTER_ACTOR (object));
+
+      /* when constructing lazily nobody else is going to set up the
+       * children, and their child properties need the parent anyway
+       */
+      if (clutter_script_get_lazy_construction (script))
+        _clutter_script_ensure_object (script, child_info);
     }
 
   g_list_foreach (oinfo->children, (GFunc) g_free, NULL);
@@ -2152,6 +2554,12 @@ _clutter_script_construct_object (ClutterScript *script,
   GArray *params = NULL;
   guint i;
 
+  CLUTTER_STATIC_COUNTER (script_construct_counter,
+                          "ClutterScript construction counter",
+                          "Increments each time an object defined in "
+                          "a UI definition is constructed",
+                          0 /* no application private data */);
+
   /* we have completely updated the object */
   if (oinfo->object != NULL)
     {
@@ -2245,6 +2653,12 @@ _clutter_script_construct_object (ClutterScript *script,
 
   g_assert (oinfo->object != NULL);
 
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, script_construct_counter);
+
+  CLUTTER_NOTE (SCRIPT, "Constructed object '%s' (type:%s)",
+                oinfo->id,
+                g_type_name (oinfo->gtype));
+
   if (CLUTTER_IS_SCRIPTABLE (oinfo->object))
     clutter_scriptable_set_id (CLUTTER_SCRIPTABLE (oinfo->object), oinfo->id);
   else
@@ -52,6 +52,14 @@ struct _ClutterScriptParser
 
 typedef GType (* GTypeGetFunc) (void);
 
+/* compiled UI definitions, as generated by clutter-script-compiler, start
+ * with this magic string, followed by the JSON tree serialized as a
+ * GVariant of type "v"; the length of the magic keeps the GVariant data
+ * aligned when the file is mapped in memory
+ */
+#define CLUTTER_SCRIPT_COMPILED_MAGIC           "CLSCRIPT"
+#define CLUTTER_SCRIPT_COMPILED_MAGIC_LEN       8
+
 typedef struct {
   gchar *id;
   gchar *class_name;
@@ -101,6 +109,13 @@ void property_info_free (gpointer data);
 
 GType _clutter_script_parser_get_type (void) G_GNUC_CONST;
 
+gboolean _clutter_script_is_compiled_data        (const gchar         *data,
+                                                  gsize                length);
+gboolean _clutter_script_parser_load_compiled    (ClutterScriptParser *parser,
+                                                  const gchar         *data,
+                                                  gsize                length,
+                                                  GError             **error);
+
 gboolean _clutter_script_parse_node        (ClutterScript *script,
                                             GValue        *value,
                                             const gchar   *name,
@@ -110,6 +125,9 @@ gboolean _clutter_script_parse_node        (ClutterScript *script,
 GType    _clutter_script_get_type_from_symbol (const gchar *symbol);
 GType    _clutter_script_get_type_from_class  (const gchar *name);
 
+GParamSpec *_clutter_script_find_property (GObjectClass *klass,
+                                           const gchar  *name);
+
 gulong   _clutter_script_resolve_animation_mode (JsonNode *node);
 
 gboolean _clutter_script_enum_from_string  (GType          gtype,
@@ -145,6 +163,9 @@ void _clutter_script_construct_object (ClutterScript *script,
                                        ObjectInfo    *oinfo);
 void _clutter_script_apply_properties (ClutterScript *script,
                                        ObjectInfo    *oinfo);
+void _clutter_script_ensure_object    (ClutterScript *script,
+                                       ObjectInfo    *oinfo);
+void _clutter_script_update_objects   (ClutterScript *script);
 
 gchar *_clutter_script_generate_fake_id (ClutterScript *script);
 
@@ -218,6 +218,13 @@
  *                   of creating a new #ClutterStage instance
  * ]]></programlisting>
  *
+ * UI definitions can also be compiled ahead of time using the
+ * clutter-script-compiler tool, which resolves the enumeration, flags
+ * and color values using the type of each object, and stores the result
+ * in a binary format. Compiled definitions can be loaded using the same
+ * functions as the JSON ones, and they are faster to load, as they do not
+ * need to be parsed. Since Clutter 1.22.
+ *
  * #ClutterScript is available since Clutter 0.6
  */
 
@@ -225,12 +232,14 @@
 #include "config.h"
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
 
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <glib-object.h>
 #include <gmodule.h>
 
@@ -260,6 +269,7 @@ enum
   PROP_FILENAME_SET,
   PROP_FILENAME,
   PROP_TRANSLATION_DOMAIN,
+  PROP_LAZY_CONSTRUCTION,
 
   PROP_LAST
 };
@@ -284,11 +294,23 @@ struct _ClutterScriptPrivate
   gchar *translation_domain;
 
   gchar *filename;
+
+  /* the signal connection function passed to the last call of
+   * clutter_script_connect_signals_full_notify(), used for the
+   * objects that are constructed afterwards
+   */
+  ClutterScriptConnectFunc connect_func;
+  gpointer connect_data;
+  GDestroyNotify connect_notify;
+
   guint is_filename : 1;
+  guint lazy_construction : 1;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterScript, clutter_script, G_TYPE_OBJECT)
 
+static void clutter_script_clear_connect_func (ClutterScript *script);
+
 static GType
 clutter_script_real_get_type_from_name (ClutterScript *script,
                                         const gchar   *type_name)
@@ -391,6 +413,7 @@ clutter_script_finalize (GObject *gobject)
   g_free (priv->filename);
   g_hash_table_destroy (priv->states);
   g_free (priv->translation_domain);
+  clutter_script_clear_connect_func (CLUTTER_SCRIPT (gobject));
 
   G_OBJECT_CLASS (clutter_script_parent_class)->finalize (gobject);
 }
@@ -409,6 +432,10 @@ clutter_script_set_property (GObject      *gobject,
       clutter_script_set_translation_domain (script, g_value_get_string (value));
       break;
 
+    case PROP_LAZY_CONSTRUCTION:
+      clutter_script_set_lazy_construction (script, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -437,6 +464,10 @@ clutter_script_get_property (GObject    *gobject,
       g_value_set_string (value, script->priv->translation_domain);
       break;
 
+    case PROP_LAZY_CONSTRUCTION:
+      g_value_set_boolean (value, script->priv->lazy_construction);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -499,6 +530,23 @@ clutter_script_class_init (ClutterScriptClass *klass)
                          NULL,
                          CLUTTER_PARAM_READWRITE);
 
+  /**
+   * ClutterScript:lazy-construction:
+   *
+   * Whether the objects defined by a UI definition should be constructed
+   * only when they are needed.
+   *
+   * See clutter_script_set_lazy_construction().
+   *
+   * Since: 1.22
+   */
+  obj_props[PROP_LAZY_CONSTRUCTION] =
+    g_param_spec_boolean ("lazy-construction",
+                          P_("Lazy Construction"),
+                          P_("Whether objects are constructed only when needed"),
+                          FALSE,
+                          CLUTTER_PARAM_READWRITE);
+
   gobject_class->set_property = clutter_script_set_property;
   gobject_class->get_property = clutter_script_get_property;
   gobject_class->finalize = clutter_script_finalize;
@@ -549,6 +597,30 @@ clutter_script_new (void)
   return g_object_new (CLUTTER_TYPE_SCRIPT, NULL);
 }
 
+/* reads only the header of @filename, so that JSON files are not
+ * read twice
+ */
+static gboolean
+clutter_script_file_is_compiled (const gchar *filename)
+{
+  gchar magic[CLUTTER_SCRIPT_COMPILED_MAGIC_LEN];
+  gboolean retval = FALSE;
+  FILE *file;
+
+  file = g_fopen (filename, "rb");
+  if (file == NULL)
+    return FALSE;
+
+  if (fread (magic, 1, sizeof (magic), file) == sizeof (magic))
+    retval = memcmp (magic,
+                     CLUTTER_SCRIPT_COMPILED_MAGIC,
+                     CLUTTER_SCRIPT_COMPILED_MAGIC_LEN) == 0;
+
+  fclose (file);
+
+  return retval;
+}
+
 /**
  * clutter_script_load_from_file:
  * @script: a #ClutterScript
@@ -583,9 +655,40 @@ clutter_script_load_from_file (ClutterScript  *script,
   priv->last_merge_id += 1;
 
   internal_error = NULL;
-  json_parser_load_from_file (JSON_PARSER (priv->parser),
-                              filename,
-                              &internal_error);
+
+  /* compiled UI definitions are used directly from the mapped file;
+   * anything else goes through the JSON parser, which reports errors
+   * about missing files
+   */
+  if (clutter_script_file_is_compiled (filename))
+    {
+      GMappedFile *mapped_file;
+
+      mapped_file = g_mapped_file_new (filename, FALSE, &internal_error);
+      if (mapped_file != NULL)
+        {
+          if (_clutter_script_is_compiled_data (g_mapped_file_get_contents (mapped_file),
+                                                g_mapped_file_get_length (mapped_file)))
+            _clutter_script_parser_load_compiled (CLUTTER_SCRIPT_PARSER (priv->parser),
+                                                  g_mapped_file_get_contents (mapped_file),
+                                                  g_mapped_file_get_length (mapped_file),
+                                                  &internal_error);
+          else
+            g_set_error (&internal_error, CLUTTER_SCRIPT_ERROR,
+                         CLUTTER_SCRIPT_ERROR_INVALID_VALUE,
+                         "Invalid compiled UI definition '%s'",
+                         filename);
+
+          g_mapped_file_unref (mapped_file);
+        }
+    }
+  else
+    {
+      json_parser_load_from_file (JSON_PARSER (priv->parser),
+                                  filename,
+                                  &internal_error);
+    }
+
   if (internal_error)
     {
       g_propagate_error (error, internal_error);
@@ -636,9 +739,16 @@ clutter_script_load_from_data (ClutterScript  *script,
   priv->last_merge_id += 1;
 
   internal_error = NULL;
-  json_parser_load_from_data (JSON_PARSER (priv->parser),
-                              data, length,
-                              &internal_error);
+
+  if (_clutter_script_is_compiled_data (data, length))
+    _clutter_script_parser_load_compiled (CLUTTER_SCRIPT_PARSER (priv->parser),
+                                          data, length,
+                                          &internal_error);
+  else
+    json_parser_load_from_data (JSON_PARSER (priv->parser),
+                                data, length,
+                                &internal_error);
+
   if (internal_error)
     {
       g_propagate_error (error, internal_error);
@@ -714,8 +824,7 @@ clutter_script_get_object (ClutterScript *script,
   if (!oinfo)
     return NULL;
 
-  _clutter_script_construct_object (script, oinfo);
-  _clutter_script_apply_properties (script, oinfo);
+  _clutter_script_ensure_object (script, oinfo);
 
   return oinfo->object;
 }
@@ -852,7 +961,7 @@ clutter_script_unmerge_objects (ClutterScript *script,
   g_slist_foreach (data.ids, (GFunc) g_free, NULL);
   g_slist_free (data.ids);
 
-  clutter_script_ensure_objects (script);
+  _clutter_script_update_objects (script);
 }
 
 static void
@@ -899,6 +1008,37 @@ clutter_script_ensure_objects (ClutterScript *script)
   g_hash_table_foreach (priv->objects, construct_each_objects, script);
 }
 
+static void
+update_each_objects (gpointer key,
+                     gpointer value,
+                     gpointer user_data)
+{
+  ObjectInfo *oinfo = value;
+
+  /* we only resolve what's left of the objects we already built */
+  if (oinfo->object != NULL && oinfo->has_unresolved)
+    _clutter_script_apply_properties (user_data, oinfo);
+}
+
+/*< private >
+ * _clutter_script_update_objects:
+ * @script: a #ClutterScript
+ *
+ * Updates the objects after new definitions have been merged or
+ * removed; unless #ClutterScript:lazy-construction is set, this
+ * also constructs the objects that have not been built yet.
+ */
+void
+_clutter_script_update_objects (ClutterScript *script)
+{
+  ClutterScriptPrivate *priv = script->priv;
+
+  if (priv->lazy_construction)
+    g_hash_table_foreach (priv->objects, update_each_objects, script);
+  else
+    g_hash_table_foreach (priv->objects, construct_each_objects, script);
+}
+
 /**
  * clutter_script_get_type_from_name:
  * @script: a #ClutterScript
@@ -951,6 +1091,15 @@ typedef struct {
   gpointer data;
 } ConnectData;
 
+static void
+connect_data_free (gpointer data)
+{
+  ConnectData *cd = data;
+
+  g_module_close (cd->module);
+  g_free (cd);
+}
+
 /* default signal connection code */
 static void
 clutter_script_default_connect (ClutterScript *script,
@@ -1037,13 +1186,10 @@ clutter_script_connect_signals (ClutterScript *script,
   cd->module = g_module_open (NULL, 0);
   cd->data = user_data;
 
-  clutter_script_connect_signals_full (script,
-                                       clutter_script_default_connect,
-                                       cd);
-
-  g_module_close (cd->module);
-
-  g_free (cd);
+  clutter_script_connect_signals_full_notify (script,
+                                              clutter_script_default_connect,
+                                              cd,
+                                              connect_data_free);
 }
 
 typedef struct {
@@ -1113,10 +1259,17 @@ connect_each_object (gpointer key,
   SignalConnectData *connect_data = data;
   ClutterScript *script = connect_data->script;
   ObjectInfo *oinfo = value;
-  GObject *object = oinfo->object;
+  GObject *object;
   GList *unresolved, *l;
 
+  /* the signals of the objects that have not been built yet will
+   * be connected when they are constructed
+   */
+  if (script->priv->lazy_construction && oinfo->object == NULL)
+    return;
+
   _clutter_script_construct_object (script, oinfo);
+  object = oinfo->object;
 
   unresolved = NULL;
   for (l = oinfo->signals; l != NULL; l = l->next)
@@ -1232,6 +1385,11 @@ connect_each_object (gpointer key,
  *
  * Applications should use clutter_script_connect_signals().
  *
+ * If @script constructs its objects lazily, @func is only used for the
+ * objects that have been already constructed; use
+ * clutter_script_connect_signals_full_notify() to connect the signals
+ * of the objects constructed afterwards as well.
+ *
  * Since: 0.6
  */
 void
@@ -1251,6 +1409,100 @@ clutter_script_connect_signals_full (ClutterScript            *script,
   g_hash_table_foreach (script->priv->objects, connect_each_object, &data);
 }
 
+static void
+clutter_script_clear_connect_func (ClutterScript *script)
+{
+  ClutterScriptPrivate *priv = script->priv;
+  GDestroyNotify notify = priv->connect_notify;
+  gpointer user_data = priv->connect_data;
+
+  priv->connect_func = NULL;
+  priv->connect_data = NULL;
+  priv->connect_notify = NULL;
+
+  if (notify != NULL)
+    notify (user_data);
+}
+
+/**
+ * clutter_script_connect_signals_full_notify:
+ * @script: a #ClutterScript
+ * @func: (scope notified) (closure user_data) (destroy notify): signal
+ *   connection function
+ * @user_data: data to be passed to the signal handlers, or %NULL
+ * @notify: (nullable): function to be called when @func and @user_data
+ *   are not needed any more, or %NULL
+ *
+ * Connects all the signals defined into a UI definition file to their
+ * handlers, like clutter_script_connect_signals_full() does.
+ *
+ * If @script constructs its objects lazily, @func and @user_data are
+ * also used to connect the signals of the objects constructed later on,
+ * until @script is finalized, or until this function is called again;
+ * otherwise, @notify is called before this function returns.
+ *
+ * Since: 1.22
+ */
+void
+clutter_script_connect_signals_full_notify (ClutterScript            *script,
+                                            ClutterScriptConnectFunc  func,
+                                            gpointer                  user_data,
+                                            GDestroyNotify            notify)
+{
+  ClutterScriptPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_SCRIPT (script));
+  g_return_if_fail (func != NULL);
+
+  clutter_script_connect_signals_full (script, func, user_data);
+
+  priv = script->priv;
+
+  if (priv->lazy_construction)
+    {
+      clutter_script_clear_connect_func (script);
+
+      priv->connect_func = func;
+      priv->connect_data = user_data;
+      priv->connect_notify = notify;
+    }
+  else if (notify != NULL)
+    notify (user_data);
+}
+
+/*< private >
+ * _clutter_script_ensure_object:
+ * @script: a #ClutterScript
+ * @oinfo: the #ObjectInfo of the object to build
+ *
+ * Constructs the object described by @oinfo, if needed, and applies
+ * its properties; if the object is being built after a call to
+ * clutter_script_connect_signals(), its signals are connected as well.
+ */
+void
+_clutter_script_ensure_object (ClutterScript *script,
+                               ObjectInfo    *oinfo)
+{
+  ClutterScriptPrivate *priv = script->priv;
+
+  _clutter_script_construct_object (script, oinfo);
+  _clutter_script_apply_properties (script, oinfo);
+
+  if (priv->lazy_construction &&
+      priv->connect_func != NULL &&
+      oinfo->object != NULL &&
+      oinfo->signals != NULL)
+    {
+      SignalConnectData data;
+
+      data.script = script;
+      data.func = priv->connect_func;
+      data.user_data = priv->connect_data;
+
+      connect_each_object (NULL, oinfo, &data);
+    }
+}
+
 GQuark
 clutter_script_error_quark (void)
 {
@@ -1516,6 +1768,60 @@ clutter_script_set_translation_domain (ClutterScript *script,
   g_object_notify_by_pspec (G_OBJECT (script), obj_props[PROP_TRANSLATION_DOMAIN]);
 }
 
+/**
+ * clutter_script_set_lazy_construction:
+ * @script: a #ClutterScript
+ * @lazy: whether the objects should be constructed only when needed
+ *
+ * Sets whether the objects defined inside the UI definitions loaded
+ * by @script should be constructed only when they are needed.
+ *
+ * By default, #ClutterScript constructs every object as soon as the
+ * UI definition has been loaded. If @lazy is %TRUE, an object is only
+ * constructed when it is retrieved using clutter_script_get_object(),
+ * or when another object that references it is constructed; the
+ * signals of the object are connected at the same time, if
+ * clutter_script_connect_signals() or
+ * clutter_script_connect_signals_full_notify() have been already called.
+ *
+ * This function should be called before loading any UI definition.
+ *
+ * Since: 1.22
+ */
+void
+clutter_script_set_lazy_construction (ClutterScript *script,
+                                      gboolean       lazy)
+{
+  g_return_if_fail (CLUTTER_IS_SCRIPT (script));
+
+  lazy = !!lazy;
+
+  if (script->priv->lazy_construction == lazy)
+    return;
+
+  script->priv->lazy_construction = lazy;
+
+  g_object_notify_by_pspec (G_OBJECT (script), obj_props[PROP_LAZY_CONSTRUCTION]);
+}
+
+/**
+ * clutter_script_get_lazy_construction:
+ * @script: a #ClutterScript
+ *
+ * Retrieves the value set using clutter_script_set_lazy_construction().
+ *
+ * Return value: %TRUE if the objects are constructed only when needed
+ *
+ * Since: 1.22
+ */
+gboolean
+clutter_script_get_lazy_construction (ClutterScript *script)
+{
+  g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), FALSE);
+
+  return script->priv->lazy_construction;
+}
+
 /**
  * clutter_script_get_translation_domain:
  * @script: a #ClutterScript
@@ -194,6 +194,11 @@ CLUTTER_AVAILABLE_IN_ALL
 void            clutter_script_connect_signals_full     (ClutterScript             *script,
                                                          ClutterScriptConnectFunc   func,
                                                          gpointer                   user_data);
+CLUTTER_AVAILABLE_IN_1_22
+void            clutter_script_connect_signals_full_notify (ClutterScript          *script,
+                                                         ClutterScriptConnectFunc   func,
+                                                         gpointer                   user_data,
+                                                         GDestroyNotify             notify);
 
 CLUTTER_AVAILABLE_IN_ALL
 void            clutter_script_add_search_paths         (ClutterScript             *script,
@@ -212,6 +217,12 @@ void            clutter_script_set_translation_domain   (ClutterScript
 CLUTTER_AVAILABLE_IN_1_10
 const gchar *   clutter_script_get_translation_domain   (ClutterScript             *script);
 
+CLUTTER_AVAILABLE_IN_1_22
+void            clutter_script_set_lazy_construction    (ClutterScript             *script,
+                                                         gboolean                   lazy);
+CLUTTER_AVAILABLE_IN_1_22
+gboolean        clutter_script_get_lazy_construction    (ClutterScript             *script);
+
 CLUTTER_AVAILABLE_IN_ALL
 const gchar *   clutter_get_script_id                   (GObject                   *gobject);
 
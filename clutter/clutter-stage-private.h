@@ -64,6 +64,9 @@ gboolean            _clutter_stage_do_update             (ClutterStage
 void     _clutter_stage_queue_event                       (ClutterStage *stage,
                                                            ClutterEvent *event,
                                                            gboolean      copy_event);
+void     _clutter_stage_queue_events                      (ClutterStage  *stage,
+                                                           ClutterEvent **events,
+                                                           guint          n_events);
 gboolean _clutter_stage_has_queued_events                 (ClutterStage *stage);
 void     _clutter_stage_process_queued_events             (ClutterStage *stage);
 void     _clutter_stage_update_input_devices              (ClutterStage *stage);
@@ -76,6 +79,7 @@ ClutterActor *_clutter_stage_do_pick (ClutterStage    *stage,
                                       gint             x,
                                       gint             y,
                                       ClutterPickMode  mode);
+void          _clutter_stage_invalidate_pick (ClutterStage *stage);
 
 ClutterPaintVolume *_clutter_stage_paint_volume_stack_allocate (ClutterStage *stage);
 void                _clutter_stage_paint_volume_stack_free_all (ClutterStage *stage);
@@ -97,6 +101,10 @@ void            _clutter_stage_release_pick_id          (ClutterStage *stage,
 ClutterActor *  _clutter_stage_get_actor_by_pick_id     (ClutterStage *stage,
                                                          gint32        pick_id);
 
+GPtrArray *     _clutter_stage_get_event_chain          (ClutterStage *stage);
+void            _clutter_stage_release_event_chain      (ClutterStage *stage,
+                                                         guint         start);
+
 void            _clutter_stage_add_pointer_drag_actor    (ClutterStage       *stage,
                                                           ClutterInputDevice *device,
                                                           ClutterActor       *actor);
@@ -47,6 +47,7 @@
 #endif
 
 #include <math.h>
+#include <string.h>
 #include <cairo.h>
 
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
@@ -65,6 +66,7 @@
 #include "clutter-device-manager-private.h"
 #include "clutter-enum-types.h"
 #include "clutter-event-private.h"
+#include "clutter-event-resampler.h"
 #include "clutter-id-pool.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
@@ -98,6 +100,22 @@ typedef enum { /*< prefix=CLUTTER_STAGE >*/
 
 #define STAGE_NO_CLEAR_ON_PAINT(s)      ((((ClutterStage *) (s))->priv->stage_hints & CLUTTER_STAGE_NO_CLEAR_ON_PAINT) != 0)
 
+/* the number of pick results kept by each stage; the same position is
+ * usually picked a few times in a row, by the input device and by the
+ * crossing events handling, or for every motion event of a pointer that
+ * moves over a scene that does not change
+ */
+#define PICK_CACHE_SIZE         4
+
+typedef struct _PickCacheEntry
+{
+  guint epoch;
+  gint x;
+  gint y;
+  ClutterPickMode mode;
+  ClutterActor *actor;
+} PickCacheEntry;
+
 struct _ClutterStageQueueRedrawEntry
 {
   ClutterActor *actor;
@@ -138,8 +156,36 @@ struct _ClutterStagePrivate
   GTimer *fps_timer;
   gint32 timer_n_frames;
 
+  /* the time spent in each phase of the current frame, in usecs;
+   * only updated if CLUTTER_SHOW_FRAME_TIMINGS is set
+   */
+  gint64 frame_layout_time;
+  gint64 frame_paint_time;
+  gint64 frame_pick_time;
+  gint64 frame_redraw_time;
+  guint frame_counter;
+  guint frame_pick_count;
+  guint frame_pick_hits;
+
   ClutterIDPool *pick_id_pool;
 
+  /* the recent pick results; an entry is valid only as long as its
+   * epoch matches pick_epoch, which is increased every time something
+   * that could change the result of a pick happens
+   */
+  PickCacheEntry pick_cache[PICK_CACHE_SIZE];
+  guint pick_cache_next;
+  guint pick_epoch;
+
+  /* the actors receiving the events currently being emitted, see
+   * _clutter_actor_handle_event(); the first event_chain_pinned
+   * actors hold a reference
+   */
+  GPtrArray *event_chain;
+  guint event_chain_pinned;
+
+  ClutterEventResampler *resampler;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gulong redraw_count;
 #endif /* CLUTTER_ENABLE_DEBUG */
@@ -156,6 +202,7 @@ struct _ClutterStagePrivate
   guint is_user_resizable      : 1;
   guint use_fog                : 1;
   guint throttle_motion_events : 1;
+  guint resample_motion_events : 1;
   guint use_alpha              : 1;
   guint min_size_changed       : 1;
   guint dirty_viewport         : 1;
@@ -635,6 +682,8 @@ _clutter_stage_do_paint (ClutterStage                *stage,
   float viewport[4];
   cairo_rectangle_int_t geom;
   int window_scale;
+  gboolean show_timings;
+  gint64 paint_start = 0;
 
   if (priv->impl == NULL)
     return;
@@ -685,9 +734,18 @@ _clutter_stage_do_paint (ClutterStage                *stage,
 
   _clutter_stage_paint_volume_stack_free_all (stage);
   _clutter_stage_update_active_framebuffer (stage);
+
+  show_timings = _clutter_context_get_show_frame_timings () &&
+                 _clutter_context_get_pick_mode () == CLUTTER_PICK_NONE;
+  if (show_timings)
+    paint_start = g_get_monotonic_time ();
+
   clutter_actor_paint (CLUTTER_ACTOR (stage));
 
   g_signal_emit (stage, stage_signals[AFTER_PAINT], 0);
+
+  if (show_timings)
+    priv->frame_paint_time += g_get_monotonic_time () - paint_start;
 }
 
 /* If we don't implement this here, we get the paint function
@@ -949,32 +1007,18 @@ clutter_stage_real_fullscreen (ClutterStage *stage)
                           CLUTTER_ALLOCATION_NONE);
 }
 
-void
-_clutter_stage_queue_event (ClutterStage *stage,
-                            ClutterEvent *event,
-                            gboolean      copy_event)
+static void
+clutter_stage_push_event (ClutterStage *stage,
+                          ClutterEvent *event,
+                          gint64        receive_time)
 {
-  ClutterStagePrivate *priv;
-  gboolean first_event;
+  ClutterStagePrivate *priv = stage->priv;
   ClutterInputDevice *device;
 
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-
-  priv = stage->priv;
-
-  first_event = priv->event_queue->length == 0;
-
-  if (copy_event)
-    event = clutter_event_copy (event);
-
   g_queue_push_tail (priv->event_queue, event);
 
-  if (first_event)
-    {
-      ClutterMasterClock *master_clock = _clutter_master_clock_get_default ();
-      _clutter_master_clock_start_running (master_clock);
-      _clutter_stage_schedule_update (stage);
-    }
+  if (priv->resampler != NULL)
+    _clutter_event_resampler_add_event (priv->resampler, event, receive_time);
 
   /* if needed, update the state of the input device of the event.
    * we do it here to avoid calling the same code from every backend
@@ -993,9 +1037,82 @@ _clutter_stage_queue_event (ClutterStage *stage,
       _clutter_input_device_set_coords (device, sequence, event_x, event_y, stage);
       _clutter_input_device_set_state (device, event_state);
       _clutter_input_device_set_time (device, event_time);
+
+      if (sequence != NULL)
+        _clutter_event_set_touch_slot (event,
+                                       _clutter_input_device_lookup_touch_slot (device, sequence));
     }
 }
 
+static void
+clutter_stage_start_event_processing (ClutterStage *stage)
+{
+  ClutterMasterClock *master_clock = _clutter_master_clock_get_default ();
+
+  _clutter_master_clock_start_running (master_clock);
+  _clutter_stage_schedule_update (stage);
+}
+
+void
+_clutter_stage_queue_event (ClutterStage *stage,
+                            ClutterEvent *event,
+                            gboolean      copy_event)
+{
+  ClutterStagePrivate *priv;
+  gboolean first_event;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+  first_event = priv->event_queue->length == 0;
+
+  if (copy_event)
+    event = clutter_event_copy (event);
+
+  clutter_stage_push_event (stage, event, g_get_monotonic_time ());
+
+  if (first_event)
+    clutter_stage_start_event_processing (stage);
+}
+
+/*< private >
+ * _clutter_stage_queue_events:
+ * @stage: a #ClutterStage
+ * @events: (array length=n_events) (transfer full): the events to queue
+ * @n_events: the number of events in @events
+ *
+ * Queues a batch of events on @stage, in order; this is equivalent to
+ * calling _clutter_stage_queue_event() without copying each event, but
+ * it is cheaper for backends reading events in bursts.
+ */
+void
+_clutter_stage_queue_events (ClutterStage  *stage,
+                             ClutterEvent **events,
+                             guint          n_events)
+{
+  ClutterStagePrivate *priv;
+  gboolean first_event;
+  gint64 receive_time;
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  if (n_events == 0)
+    return;
+
+  priv = stage->priv;
+
+  first_event = priv->event_queue->length == 0;
+  receive_time = g_get_monotonic_time ();
+
+  for (i = 0; i < n_events; i++)
+    clutter_stage_push_event (stage, events[i], receive_time);
+
+  if (first_event)
+    clutter_stage_start_event_processing (stage);
+}
+
 gboolean
 _clutter_stage_has_queued_events (ClutterStage *stage)
 {
@@ -1013,6 +1130,7 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
 {
   ClutterStagePrivate *priv;
   GList *events, *l;
+  gint64 frame_time;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
@@ -1021,6 +1139,8 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
   if (priv->event_queue->length == 0)
     return;
 
+  frame_time = g_get_monotonic_time ();
+
   /* In case the stage gets destroyed during event processing */
   g_object_ref (stage);
 
@@ -1079,6 +1199,21 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
             }
         }
 
+      /* the last motion of each device is moved to the frame time */
+      if (priv->throttle_motion_events &&
+          priv->resampler != NULL &&
+          _clutter_event_resampler_resample (priv->resampler, event,
+                                             frame_time))
+        {
+          gfloat event_x, event_y;
+
+          clutter_event_get_coords (event, &event_x, &event_y);
+          _clutter_input_device_set_coords (device,
+                                            clutter_event_get_event_sequence (event),
+                                            event_x, event_y,
+                                            stage);
+        }
+
       _clutter_process_event (event);
 
     next_event:
@@ -1153,6 +1288,8 @@ _clutter_stage_maybe_relayout (ClutterActor *actor)
       clutter_actor_allocate (CLUTTER_ACTOR (stage),
                               &box, CLUTTER_ALLOCATION_NONE);
 
+      _clutter_stage_invalidate_pick (stage);
+
       CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
       CLUTTER_TIMER_STOP (_clutter_uprof_context, relayout_timer);
     }
@@ -1164,6 +1301,7 @@ clutter_stage_do_redraw (ClutterStage *stage)
   ClutterBackend *backend = clutter_get_default_backend ();
   ClutterActor *actor = CLUTTER_ACTOR (stage);
   ClutterStagePrivate *priv = stage->priv;
+  gint64 redraw_start = 0;
 
   CLUTTER_STATIC_COUNTER (redraw_counter,
                           "clutter_stage_do_redraw counter",
@@ -1198,8 +1336,14 @@ clutter_stage_do_redraw (ClutterStage *stage)
   CLUTTER_COUNTER_INC (_clutter_uprof_context, redraw_counter);
   CLUTTER_TIMER_START (_clutter_uprof_context, redraw_timer);
 
+  if (_clutter_context_get_show_frame_timings ())
+    redraw_start = g_get_monotonic_time ();
+
   _clutter_stage_window_redraw (priv->impl);
 
+  if (_clutter_context_get_show_frame_timings ())
+    priv->frame_redraw_time += g_get_monotonic_time () - redraw_start;
+
   CLUTTER_TIMER_STOP (_clutter_uprof_context, redraw_timer);
 
   if (_clutter_context_get_show_fps ())
@@ -1217,6 +1361,30 @@ clutter_stage_do_redraw (ClutterStage *stage)
         }
     }
 
+  if (_clutter_context_get_show_frame_timings ())
+    {
+      /* the paint time is included in the redraw time; the rest is
+       * spent by the backend, mostly swapping the buffers
+       */
+      g_print ("*** Frame %u for %s: layout %.3f ms, paint %.3f ms, "
+               "pick %.3f ms (%u/%u cached), swap %.3f ms ***\n",
+               priv->frame_counter++,
+               _clutter_actor_get_debug_name (actor),
+               priv->frame_layout_time / 1000.0,
+               priv->frame_paint_time / 1000.0,
+               priv->frame_pick_time / 1000.0,
+               priv->frame_pick_hits,
+               priv->frame_pick_count,
+               MAX (priv->frame_redraw_time - priv->frame_paint_time, 0) / 1000.0);
+
+      priv->frame_layout_time = 0;
+      priv->frame_paint_time = 0;
+      priv->frame_pick_time = 0;
+      priv->frame_redraw_time = 0;
+      priv->frame_pick_count = 0;
+      priv->frame_pick_hits = 0;
+    }
+
   CLUTTER_NOTE (PAINT, "Redraw finished for stage '%s'[%p]",
                 _clutter_actor_get_debug_name (actor),
                 stage);
@@ -1249,7 +1417,16 @@ _clutter_stage_do_update (ClutterStage *stage)
    * check or clear the pending redraws flag since a relayout may
    * queue a redraw.
    */
-  _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
+  if (_clutter_context_get_show_frame_timings ())
+    {
+      gint64 start = g_get_monotonic_time ();
+
+      _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
+
+      priv->frame_layout_time += g_get_monotonic_time () - start;
+    }
+  else
+    _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
 
   if (!priv->redraw_pending)
     return FALSE;
@@ -1441,6 +1618,78 @@ read_pixels_to_file (char *filename_stem,
   read_count++;
 }
 
+/*< private >
+ * _clutter_stage_invalidate_pick:
+ * @stage: a #ClutterStage
+ *
+ * Discards the cached pick results of @stage.
+ *
+ * This function is called whenever the geometry of the scene changes:
+ * when an actor queues a redraw, when the stage is allocated, and when
+ * an actor is mapped, unmapped or changes its reactivity.
+ */
+void
+_clutter_stage_invalidate_pick (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  priv->pick_epoch += 1;
+
+  /* on overflow, make sure that no old entry matches the new epoch */
+  if (G_UNLIKELY (priv->pick_epoch == 0))
+    {
+      memset (priv->pick_cache, 0, sizeof (priv->pick_cache));
+      priv->pick_epoch = 1;
+    }
+}
+
+static gboolean
+clutter_stage_lookup_pick_cache (ClutterStage     *stage,
+                                 gint              x,
+                                 gint              y,
+                                 ClutterPickMode   mode,
+                                 ClutterActor    **actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  guint i;
+
+  for (i = 0; i < PICK_CACHE_SIZE; i++)
+    {
+      const PickCacheEntry *entry = &priv->pick_cache[i];
+
+      if (entry->epoch == priv->pick_epoch &&
+          entry->x == x &&
+          entry->y == y &&
+          entry->mode == mode)
+        {
+          *actor = entry->actor;
+          return TRUE;
+        }
+    }
+
+  return FALSE;
+}
+
+static void
+clutter_stage_add_pick_cache (ClutterStage    *stage,
+                              gint             x,
+                              gint             y,
+                              ClutterPickMode  mode,
+                              ClutterActor    *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  PickCacheEntry *entry;
+
+  entry = &priv->pick_cache[priv->pick_cache_next];
+  entry->epoch = priv->pick_epoch;
+  entry->x = x;
+  entry->y = y;
+  entry->mode = mode;
+  entry->actor = actor;
+
+  priv->pick_cache_next = (priv->pick_cache_next + 1) % PICK_CACHE_SIZE;
+}
+
 ClutterActor *
 _clutter_stage_do_pick (ClutterStage   *stage,
                         gint            x,
@@ -1461,11 +1710,16 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   gint read_y;
   float stage_width, stage_height;
   int window_scale;
+  gint64 pick_start = 0;
 
   CLUTTER_STATIC_COUNTER (do_pick_counter,
                           "_clutter_stage_do_pick counter",
                           "Increments for each full pick run",
                           0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (pick_cache_hit_counter,
+                          "_clutter_stage_do_pick cache hits",
+                          "Increments for each pick answered by the cache",
+                          0 /* no application private data */);
   CLUTTER_STATIC_TIMER (pick_timer,
                         "Mainloop", /* parent */
                         "Picking",
@@ -1502,6 +1756,22 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   if (x < 0 || x >= stage_width || y < 0 || y >= stage_height)
     return actor;
 
+  priv->frame_pick_count += 1;
+
+  /* the pick buffers are dumped for every pick request */
+  if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)) &&
+      clutter_stage_lookup_pick_cache (stage, x, y, mode, &retval))
+    {
+      CLUTTER_NOTE (PICK, "Reusing pick at %i,%i: %s",
+                    x, y,
+                    retval != NULL ? _clutter_actor_get_debug_name (retval) : "none");
+
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, pick_cache_hit_counter);
+      priv->frame_pick_hits += 1;
+
+      return retval;
+    }
+
 #ifdef CLUTTER_ENABLE_PROFILE
   if (clutter_profile_flags & CLUTTER_PROFILE_PICKING_ONLY)
     _clutter_profile_resume ();
@@ -1510,6 +1780,9 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   CLUTTER_COUNTER_INC (_clutter_uprof_context, do_pick_counter);
   CLUTTER_TIMER_START (_clutter_uprof_context, pick_timer);
 
+  if (_clutter_context_get_show_frame_timings ())
+    pick_start = g_get_monotonic_time ();
+
   context = _clutter_context_get_default ();
   clutter_stage_ensure_current (stage);
   window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
@@ -1597,6 +1870,11 @@ _clutter_stage_do_pick (ClutterStage   *stage,
       retval = _clutter_stage_get_actor_by_pick_id (stage, id_);
     }
 
+  clutter_stage_add_pick_cache (stage, x, y, mode, retval);
+
+  if (_clutter_context_get_show_frame_timings ())
+    priv->frame_pick_time += g_get_monotonic_time () - pick_start;
+
   CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_timer);
 
 #ifdef CLUTTER_ENABLE_PROFILE
@@ -1862,6 +2140,11 @@ clutter_stage_finalize (GObject *object)
 
   _clutter_id_pool_free (priv->pick_id_pool);
 
+  g_ptr_array_unref (priv->event_chain);
+
+  if (priv->resampler != NULL)
+    _clutter_event_resampler_free (priv->resampler);
+
   if (priv->fps_timer != NULL)
     g_timer_destroy (priv->fps_timer);
 
@@ -2346,6 +2629,9 @@ clutter_stage_init (ClutterStage *self)
     g_array_new (FALSE, FALSE, sizeof (ClutterPaintVolume));
 
   priv->pick_id_pool = _clutter_id_pool_new (256);
+  priv->pick_epoch = 1;
+
+  priv->event_chain = g_ptr_array_sized_new (64);
 }
 
 /**
@@ -3769,6 +4055,95 @@ clutter_stage_get_throttle_motion_events (ClutterStage *stage)
   return stage->priv->throttle_motion_events;
 }
 
+static void
+on_resampled_device_removed (ClutterDeviceManager *manager,
+                             ClutterInputDevice   *device,
+                             ClutterStage         *stage)
+{
+  if (stage->priv->resampler != NULL)
+    _clutter_event_resampler_remove_device (stage->priv->resampler, device);
+}
+
+/**
+ * clutter_stage_set_resample_motion_events:
+ * @stage: a #ClutterStage
+ * @resample: %TRUE to resample motion events
+ *
+ * Sets whether the motion and touch update events delivered on each
+ * frame should be resampled at the time of the frame.
+ *
+ * Input devices can report motion at a higher rate than the display
+ * refresh rate; when motion events are throttled, the position of the
+ * event delivered to the @stage and its actors depends on when the last
+ * event was received, which results in uneven movement when dragging or
+ * panning. If motion events are resampled, the position of the pointer
+ * or touch point is interpolated, or predicted for a few milliseconds,
+ * from the recent events of the same device, so that the event matches
+ * the time of the frame. Actions like #ClutterDragAction, #ClutterPanAction
+ * and #ClutterGestureAction will use the resampled positions.
+ *
+ * Resampling has no effect unless motion events are throttled; see
+ * clutter_stage_set_throttle_motion_events().
+ *
+ * Since: 1.22
+ */
+void
+clutter_stage_set_resample_motion_events (ClutterStage *stage,
+                                          gboolean      resample)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+  resample = !!resample;
+
+  if (priv->resample_motion_events == resample)
+    return;
+
+  priv->resample_motion_events = resample;
+
+  if (resample)
+    {
+      priv->resampler = _clutter_event_resampler_new ();
+
+      g_signal_connect_object (clutter_device_manager_get_default (),
+                               "device-removed",
+                               G_CALLBACK (on_resampled_device_removed),
+                               stage,
+                               0);
+    }
+  else
+    {
+      g_signal_handlers_disconnect_by_func (clutter_device_manager_get_default (),
+                                            on_resampled_device_removed,
+                                            stage);
+
+      _clutter_event_resampler_free (priv->resampler);
+      priv->resampler = NULL;
+    }
+}
+
+/**
+ * clutter_stage_get_resample_motion_events:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set with clutter_stage_set_resample_motion_events()
+ *
+ * Return value: %TRUE if the motion events are being resampled,
+ *   and %FALSE otherwise
+ *
+ * Since: 1.22
+ */
+gboolean
+clutter_stage_get_resample_motion_events (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->resample_motion_events;
+}
+
 /**
  * clutter_stage_set_use_alpha:
  * @stage: a #ClutterStage
@@ -4069,6 +4444,9 @@ _clutter_stage_queue_actor_redraw (ClutterStage *stage,
   CLUTTER_NOTE (CLIPPING, "stage_queue_actor_redraw (actor=%s, clip=%p): ",
                 _clutter_actor_get_debug_name (actor), clip);
 
+  /* whatever changed in the actor might also change what it picks */
+  _clutter_stage_invalidate_pick (stage);
+
   if (!priv->redraw_pending)
     {
       ClutterMasterClock *master_clock;
@@ -4329,6 +4707,81 @@ _clutter_stage_get_active_framebuffer (ClutterStage *stage)
   return stage->priv->active_framebuffer;
 }
 
+/*< private >
+ * _clutter_stage_get_event_chain:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the array used by _clutter_actor_handle_event() to hold the
+ * actors receiving an event; the actors are added at the end of the
+ * array, and removed with _clutter_stage_release_event_chain().
+ *
+ * The actors are not referenced when they are added: they are all
+ * mapped, and an actor leaving the scene is unmapped before it can be
+ * destroyed or finalized, at which point the stage takes a reference
+ * on all the actors of the array. This keeps the actors alive until
+ * the end of the emission, without the cost of a reference on each
+ * actor for every event.
+ *
+ * Return value: (transfer none): the event chain of @stage
+ */
+GPtrArray *
+_clutter_stage_get_event_chain (ClutterStage *stage)
+{
+  return stage->priv->event_chain;
+}
+
+static void
+clutter_stage_pin_event_chain (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  guint i;
+
+  CLUTTER_NOTE (EVENT, "Pinning %u actors of the event chain",
+                priv->event_chain->len - priv->event_chain_pinned);
+
+  for (i = priv->event_chain_pinned; i < priv->event_chain->len; i++)
+    g_object_ref (g_ptr_array_index (priv->event_chain, i));
+
+  priv->event_chain_pinned = priv->event_chain->len;
+}
+
+/*< private >
+ * _clutter_stage_release_event_chain:
+ * @stage: a #ClutterStage
+ * @start: the length of the event chain before the actors receiving
+ *   the current event were added
+ *
+ * Removes the actors added to the event chain of @stage after @start,
+ * releasing the references taken on them, if any.
+ */
+void
+_clutter_stage_release_event_chain (ClutterStage *stage,
+                                    guint         start)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  gpointer *pinned = NULL;
+  guint i, n_pinned = 0;
+
+  if (priv->event_chain_pinned > start)
+    {
+      n_pinned = priv->event_chain_pinned - start;
+      pinned = g_memdup (priv->event_chain->pdata + start,
+                         n_pinned * sizeof (gpointer));
+
+      priv->event_chain_pinned = start;
+    }
+
+  g_ptr_array_set_size (priv->event_chain, start);
+
+  /* releasing the references might finalize the actors, so we need
+   * to remove them from the chain first
+   */
+  for (i = 0; i < n_pinned; i++)
+    g_object_unref (pinned[i]);
+
+  g_free (pinned);
+}
+
 gint32
 _clutter_stage_acquire_pick_id (ClutterStage *stage,
                                 ClutterActor *actor)
@@ -4337,6 +4790,8 @@ _clutter_stage_acquire_pick_id (ClutterStage *stage,
 
   g_assert (priv->pick_id_pool != NULL);
 
+  _clutter_stage_invalidate_pick (stage);
+
   return _clutter_id_pool_add (priv->pick_id_pool, actor);
 }
 
@@ -4348,6 +4803,13 @@ _clutter_stage_release_pick_id (ClutterStage *stage,
 
   g_assert (priv->pick_id_pool != NULL);
 
+  /* the cache must not return an actor that is going away */
+  _clutter_stage_invalidate_pick (stage);
+
+  /* neither must the emission of the current events */
+  if (priv->event_chain_pinned < priv->event_chain->len)
+    clutter_stage_pin_event_chain (stage);
+
   _clutter_id_pool_remove (priv->pick_id_pool, pick_id);
 }
 
@@ -200,6 +200,11 @@ void            clutter_stage_set_throttle_motion_events        (ClutterStage
                                                                  gboolean               throttle);
 CLUTTER_AVAILABLE_IN_ALL
 gboolean        clutter_stage_get_throttle_motion_events        (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_22
+void            clutter_stage_set_resample_motion_events        (ClutterStage          *stage,
+                                                                 gboolean               resample);
+CLUTTER_AVAILABLE_IN_1_22
+gboolean        clutter_stage_get_resample_motion_events        (ClutterStage          *stage);
 CLUTTER_AVAILABLE_IN_ALL
 void            clutter_stage_set_motion_events_enabled         (ClutterStage          *stage,
                                                                  gboolean               enabled);
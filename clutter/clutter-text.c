@@ -60,6 +60,7 @@
 #include "clutter-private.h"    /* includes <cogl-pango/cogl-pango.h> */
 #include "clutter-profile.h"
 #include "clutter-property-transition.h"
+#include "clutter-rope-text-buffer.h"
 #include "clutter-text-buffer.h"
 #include "clutter-units.h"
 #include "clutter-paint-volume-private.h"
@@ -202,6 +203,14 @@ struct _ClutterTextPrivate
   guint show_password_hint      : 1;
   guint password_hint_visible   : 1;
   guint resolved_direction      : 4;
+  guint in_edit                 : 1;
+  guint edit_redraw_queued      : 1;
+
+  /* the range of the contents changed by the current edit, in
+   * characters; only valid while in_edit is set
+   */
+  gint edit_position;
+  gint edit_n_chars;
 };
 
 enum
@@ -313,6 +322,19 @@ clutter_text_queue_redraw (ClutterActor *self)
 #define clutter_actor_queue_redraw \
   Please_use_clutter_text_queue_redraw_instead
 
+static inline void
+clutter_text_queue_redraw_for_positions (ClutterText *self)
+{
+  /* if we are inside an edit, buffer_notify_text() has already queued
+   * a redraw covering both the old and the new cursor and selection,
+   * so we only need to dirty the paint volume
+   */
+  if (self->priv->edit_redraw_queued)
+    clutter_text_dirty_paint_volume (self);
+  else
+    clutter_text_queue_redraw (CLUTTER_ACTOR (self));
+}
+
 #define offset_real(t,p)        ((p) == -1 ? g_utf8_strlen ((t), -1) : (p))
 
 static gint
@@ -333,6 +355,42 @@ offset_to_bytes (const gchar *text,
 
 #define bytes_to_offset(t,p)    (g_utf8_pointer_to_offset ((t), (t) + (p)))
 
+/* retrieves the byte offset of @position inside the contents of the
+ * buffer; a ClutterRopeTextBuffer can find it without copying its
+ * contents into a single string and walking them
+ */
+static gint
+clutter_text_get_byte_offset (ClutterText *self,
+                              gint         position)
+{
+  ClutterTextBuffer *buffer = get_buffer (self);
+
+  if (CLUTTER_IS_ROPE_TEXT_BUFFER (buffer))
+    {
+      if (position < 0)
+        position = G_MAXINT;
+
+      return clutter_rope_text_buffer_get_byte_offset (CLUTTER_ROPE_TEXT_BUFFER (buffer),
+                                                       position);
+    }
+
+  return offset_to_bytes (clutter_text_buffer_get_text (buffer), position);
+}
+
+/* the inverse of clutter_text_get_byte_offset() */
+static gint
+clutter_text_get_char_offset (ClutterText *self,
+                              gint         index_)
+{
+  ClutterTextBuffer *buffer = get_buffer (self);
+
+  if (CLUTTER_IS_ROPE_TEXT_BUFFER (buffer))
+    return clutter_rope_text_buffer_get_position (CLUTTER_ROPE_TEXT_BUFFER (buffer),
+                                                  index_);
+
+  return bytes_to_offset (clutter_text_buffer_get_text (buffer), index_);
+}
+
 static inline void
 clutter_text_clear_selection (ClutterText *self)
 {
@@ -972,7 +1030,7 @@ clutter_text_position_to_coords (ClutterText *self,
     {
       if (priv->password_char == 0)
         {
-          n_bytes = clutter_text_buffer_get_bytes (get_buffer (self));
+          n_bytes = clutter_text_get_byte_offset (self, n_chars);
           if (priv->editable && priv->preedit_set)
             index_ = n_bytes + strlen (priv->preedit_str);
           else
@@ -985,6 +1043,17 @@ clutter_text_position_to_coords (ClutterText *self,
     {
       index_ = 0;
     }
+  else if (priv->password_char != 0 && priv->preedit_str == NULL)
+    {
+      index_ = position * password_char_bytes;
+    }
+  else if (priv->preedit_str == NULL)
+    {
+      /* without a pre-edit string, the layout contains the text of
+       * the buffer, so we don't need to copy it
+       */
+      index_ = clutter_text_get_byte_offset (self, position);
+    }
   else
     {
       gchar *text = clutter_text_get_display_text (self);
@@ -1771,15 +1840,13 @@ clutter_text_move_line_start (ClutterText *self,
   gint line_no;
   gint index_;
   gint position;
-  const gchar *text;
 
   layout = clutter_text_get_layout (self);
-  text = clutter_text_buffer_get_text (get_buffer (self));
 
   if (start == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, start);
+    index_ = clutter_text_get_byte_offset (self, start);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -1791,7 +1858,7 @@ clutter_text_move_line_start (ClutterText *self,
 
   pango_layout_line_x_to_index (layout_line, 0, &index_, NULL);
 
-  position = bytes_to_offset (text, index_);
+  position = clutter_text_get_char_offset (self, index_);
 
   return position;
 }
@@ -1807,15 +1874,13 @@ clutter_text_move_line_end (ClutterText *self,
   gint index_;
   gint trailing;
   gint position;
-  const gchar *text;
 
   layout = clutter_text_get_layout (self);
-  text = clutter_text_buffer_get_text (get_buffer (self));
 
   if (start == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = clutter_text_get_byte_offset (self, priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -1828,7 +1893,7 @@ clutter_text_move_line_end (ClutterText *self,
   pango_layout_line_x_to_index (layout_line, G_MAXINT, &index_, &trailing);
   index_ += trailing;
 
-  position = bytes_to_offset (text, index_);
+  position = clutter_text_get_char_offset (self, index_);
 
   return position;
 }
@@ -1901,12 +1966,10 @@ clutter_text_press (ClutterActor *actor,
   res = clutter_actor_transform_stage_point (actor, x, y, &x, &y);
   if (res)
     {
-      const char *text;
       int offset;
 
       index_ = clutter_text_coords_to_position (self, x, y);
-      text = clutter_text_buffer_get_text (get_buffer (self));
-      offset = bytes_to_offset (text, index_);
+      offset = clutter_text_get_char_offset (self, index_);
 
       /* what we select depends on the number of button clicks we
        * receive, and whether we are selectable:
@@ -1968,7 +2031,6 @@ clutter_text_move (ClutterActor *actor,
   gfloat x, y;
   gint index_, offset;
   gboolean res;
-  const gchar *text;
 
   if (!priv->in_select_drag)
     return CLUTTER_EVENT_PROPAGATE;
@@ -1980,8 +2042,7 @@ clutter_text_move (ClutterActor *actor,
     return CLUTTER_EVENT_PROPAGATE;
 
   index_ = clutter_text_coords_to_position (self, x, y);
-  text = clutter_text_buffer_get_text (get_buffer (self));
-  offset = bytes_to_offset (text, index_);
+  offset = clutter_text_get_char_offset (self, index_);
 
   if (priv->selectable)
     clutter_text_set_cursor_position (self, offset);
@@ -2801,15 +2862,13 @@ clutter_text_real_move_up (ClutterText         *self,
   gint index_, trailing;
   gint pos;
   gint x;
-  const gchar *text;
 
   layout = clutter_text_get_layout (self);
-  text = clutter_text_buffer_get_text (get_buffer (self));
 
   if (priv->position == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = clutter_text_get_byte_offset (self, priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -2830,7 +2889,7 @@ clutter_text_real_move_up (ClutterText         *self,
 
   g_object_freeze_notify (G_OBJECT (self));
 
-  pos = bytes_to_offset (text, index_);
+  pos = clutter_text_get_char_offset (self, index_);
   clutter_text_set_cursor_position (self, pos + trailing);
 
   /* Store the target x position to avoid drifting left and right when
@@ -2858,15 +2917,13 @@ clutter_text_real_move_down (ClutterText         *self,
   gint index_, trailing;
   gint x;
   gint pos;
-  const gchar *text;
 
   layout = clutter_text_get_layout (self);
-  text = clutter_text_buffer_get_text (get_buffer (self));
 
   if (priv->position == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = clutter_text_get_byte_offset (self, priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -2883,7 +2940,7 @@ clutter_text_real_move_down (ClutterText         *self,
 
   g_object_freeze_notify (G_OBJECT (self));
 
-  pos = bytes_to_offset (text, index_);
+  pos = clutter_text_get_char_offset (self, index_);
   clutter_text_set_cursor_position (self, pos + trailing);
 
   /* Store the target x position to avoid drifting left and right when
@@ -4335,16 +4392,265 @@ buffer_deleted_text (ClutterTextBuffer *buffer,
     }
 }
 
+/*< private >
+ * clutter_text_get_edit_layout:
+ * @self: a #ClutterText
+ *
+ * Retrieves the cached layout used to paint an editable, multi-line
+ * #ClutterText, if the contents of @self can be redrawn incrementally
+ * after an edit.
+ *
+ * Return value: (transfer none): a #PangoLayout, or %NULL
+ */
+static PangoLayout *
+clutter_text_get_edit_layout (ClutterText *self)
+{
+  ClutterTextPrivate *priv = self->priv;
+  ClutterActorBox alloc = { 0, };
+  gboolean natural_width_set = FALSE;
+  gint width;
+  gint i;
+
+  /* only edits coming from the actor itself are tracked, and only
+   * when the attributes do not depend on byte offsets inside the
+   * contents
+   */
+  if (!priv->in_edit ||
+      !priv->editable ||
+      priv->single_line_mode ||
+      priv->preedit_set ||
+      priv->attrs != NULL)
+    return NULL;
+
+  /* wrapping and ellipsizing also depends on the allocated height */
+  if (priv->wrap && priv->ellipsize != PANGO_ELLIPSIZE_NONE)
+    return NULL;
+
+  /* subclasses might paint something that depends on the contents */
+  if (G_OBJECT_TYPE (self) != CLUTTER_TYPE_TEXT)
+    return NULL;
+
+  if (!clutter_actor_has_allocation (CLUTTER_ACTOR (self)))
+    return NULL;
+
+  /* the preferred width depends on the longest line, which we cannot
+   * know without laying out the whole contents again
+   */
+  g_object_get (self, "natural-width-set", &natural_width_set, NULL);
+  if (!natural_width_set)
+    return NULL;
+
+  clutter_actor_get_allocation_box (CLUTTER_ACTOR (self), &alloc);
+  width = (alloc.x2 - alloc.x1) * 1024 + 0.5f;
+
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      PangoLayout *layout = priv->cached_layouts[i].layout;
+
+      if (layout != NULL &&
+          pango_layout_get_width (layout) == width &&
+          pango_layout_get_height (layout) == -1)
+        return layout;
+    }
+
+  return NULL;
+}
+
+static void
+layout_get_line_yrange (PangoLayout *layout,
+                        gint         line_no,
+                        gint        *y0,
+                        gint        *y1)
+{
+  PangoLayoutIter *iter;
+
+  iter = pango_layout_get_iter (layout);
+
+  while (line_no-- > 0)
+    {
+      if (!pango_layout_iter_next_line (iter))
+        break;
+    }
+
+  pango_layout_iter_get_line_yrange (iter, y0, y1);
+  pango_layout_iter_free (iter);
+}
+
+static gint
+layout_get_line_for_index (PangoLayout *layout,
+                           gint         index_)
+{
+  gint line_no = 0;
+
+  pango_layout_index_to_line_x (layout, index_, FALSE, &line_no, NULL);
+
+  return line_no;
+}
+
+/*< private >
+ * clutter_text_queue_edit_redraw:
+ * @self: a #ClutterText
+ * @old_layout: the layout used to paint @self before the edit
+ *
+ * Compares @old_layout with the layout of the current contents, and
+ * if the edit did not change the size of the text it queues a redraw
+ * limited to the lines that changed, and to the cursor and selection.
+ *
+ * Return value: %TRUE if a redraw was queued; if %FALSE, the caller
+ *   should queue a relayout
+ */
+static gboolean
+clutter_text_queue_edit_redraw (ClutterText *self,
+                                PangoLayout *old_layout)
+{
+  ClutterTextPrivate *priv = self->priv;
+  PangoRectangle old_ink, old_logical;
+  PangoRectangle new_ink, new_logical;
+  ClutterActorBox alloc = { 0, };
+  PangoLayout *new_layout;
+  const gchar *old_text, *new_text;
+  gint edit_start, edit_end;
+  gint first_line, last_line;
+  gint y0, y1, line_y0, line_y1;
+  gint delimiter, next_paragraph;
+  gfloat x1, x2, clip_y1, clip_y2;
+  cairo_rectangle_int_t clip;
+  guint old_direction;
+
+  CLUTTER_STATIC_COUNTER (text_edit_redraw_counter,
+                          "Text incremental redraw counter",
+                          "Increments for each edit redrawn without relayout",
+                          0);
+
+  clutter_actor_get_allocation_box (CLUTTER_ACTOR (self), &alloc);
+
+  old_direction = priv->resolved_direction;
+  new_layout = clutter_text_create_layout (self,
+                                           alloc.x2 - alloc.x1,
+                                           alloc.y2 - alloc.y1);
+
+  /* a change of direction affects the alignment of every line */
+  if (priv->resolved_direction != old_direction)
+    return FALSE;
+
+  pango_layout_get_extents (old_layout, &old_ink, &old_logical);
+  pango_layout_get_extents (new_layout, &new_ink, &new_logical);
+
+  if (old_logical.y != new_logical.y ||
+      old_logical.height != new_logical.height ||
+      pango_layout_get_line_count (old_layout) !=
+      pango_layout_get_line_count (new_layout))
+    return FALSE;
+
+  old_text = pango_layout_get_text (old_layout);
+  new_text = pango_layout_get_text (new_layout);
+
+  /* the edit is known, so we do not need to compare the old and new
+   * contents to find it; the layout has a character for each character
+   * of the buffer, even when using a password character
+   */
+  edit_start = offset_to_bytes (new_text, priv->edit_position);
+  edit_end = edit_start + offset_to_bytes (new_text + edit_start,
+                                           priv->edit_n_chars);
+
+  /* the start of the edit might move a word back to the previous
+   * line when wrapping; lines before that are not affected, and
+   * since the line count did not change, the paragraphs following
+   * the edited one are laid out at the same position as before
+   */
+  first_line = layout_get_line_for_index (new_layout, edit_start);
+  if (first_line > 0)
+    first_line -= 1;
+
+  pango_find_paragraph_boundary (new_text + edit_end, -1,
+                                 &delimiter,
+                                 &next_paragraph);
+  last_line = layout_get_line_for_index (new_layout, edit_end + delimiter);
+
+  layout_get_line_yrange (new_layout, first_line, &y0, &line_y1);
+  layout_get_line_yrange (new_layout, last_line, &line_y0, &y1);
+
+  /* the old selection might span lines outside of the edit */
+  if (priv->position != priv->selection_bound)
+    {
+      gint start_index = offset_to_bytes (old_text, priv->position);
+      gint end_index = offset_to_bytes (old_text, priv->selection_bound);
+
+      layout_get_line_yrange (old_layout,
+                              layout_get_line_for_index (old_layout,
+                                                         MIN (start_index, end_index)),
+                              &line_y0, &line_y1);
+      y0 = MIN (y0, line_y0);
+
+      layout_get_line_yrange (old_layout,
+                              layout_get_line_for_index (old_layout,
+                                                         MAX (start_index, end_index)),
+                              &line_y0, &line_y1);
+      y1 = MAX (y1, line_y1);
+    }
+
+  x1 = MIN (0, MIN (old_ink.x, new_ink.x) / (float) PANGO_SCALE);
+  x2 = MAX (alloc.x2 - alloc.x1,
+            MAX (old_ink.x + old_ink.width,
+                 new_ink.x + new_ink.width) / (float) PANGO_SCALE);
+  x1 += priv->text_x;
+  x2 += priv->text_x + priv->cursor_size;
+
+  clip_y1 = priv->text_y + y0 / (float) PANGO_SCALE;
+  clip_y2 = priv->text_y + y1 / (float) PANGO_SCALE;
+
+  /* the old cursor */
+  if (priv->cursor_visible && priv->has_focus)
+    {
+      clip_y1 = MIN (clip_y1, clutter_rect_get_y (&priv->cursor_rect));
+      clip_y2 = MAX (clip_y2, clutter_rect_get_y (&priv->cursor_rect)
+                            + clutter_rect_get_height (&priv->cursor_rect));
+    }
+
+  clip.x = floorf (x1);
+  clip.y = floorf (clip_y1);
+  clip.width = ceilf (x2) - clip.x;
+  clip.height = ceilf (clip_y2) - clip.y;
+
+  CLUTTER_NOTE (PAINT, "Edit of text actor '%s' redraws lines %d-%d "
+                       "(clip: %d, %d, %d x %d)",
+                _clutter_actor_get_debug_name (CLUTTER_ACTOR (self)),
+                first_line, last_line,
+                clip.x, clip.y, clip.width, clip.height);
+
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, text_edit_redraw_counter);
+
+  clutter_actor_queue_redraw_with_clip (CLUTTER_ACTOR (self), &clip);
+
+  priv->edit_redraw_queued = TRUE;
+
+  return TRUE;
+}
+
 static void
 buffer_notify_text (ClutterTextBuffer *buffer,
                     GParamSpec        *spec,
                     ClutterText       *self)
 {
+  PangoLayout *old_layout;
+
   g_object_freeze_notify (G_OBJECT (self));
 
+  /* keep the layout used for painting around, so that we can find
+   * out which lines were changed by the edit
+   */
+  old_layout = clutter_text_get_edit_layout (self);
+  if (old_layout != NULL)
+    g_object_ref (old_layout);
+
   clutter_text_dirty_cache (self);
 
-  clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+  if (old_layout == NULL ||
+      !clutter_text_queue_edit_redraw (self, old_layout))
+    clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+
+  if (old_layout != NULL)
+    g_object_unref (old_layout);
 
   g_signal_emit (self, text_signals[TEXT_CHANGED], 0);
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_TEXT]);
@@ -4867,7 +5173,7 @@ clutter_text_set_selection_bound (ClutterText *self,
       else
         priv->selection_bound = selection_bound;
 
-      clutter_text_queue_redraw (CLUTTER_ACTOR (self));
+      clutter_text_queue_redraw_for_positions (self);
 
       g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_SELECTION_BOUND]);
     }
@@ -5773,7 +6079,7 @@ clutter_text_set_cursor_position (ClutterText *self,
      time the cursor is moved up or down */
   priv->x_pos = -1;
 
-  clutter_text_queue_redraw (CLUTTER_ACTOR (self));
+  clutter_text_queue_redraw_for_positions (self);
 
   /* XXX:2.0 - remove */
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_POSITION]);
@@ -5951,7 +6257,12 @@ clutter_text_real_insert_text (ClutterText *self,
    * following signal handlers: buffer_inserted_text(),
    * buffer_notify_text(), buffer_notify_max_length()
    */
+  self->priv->in_edit = TRUE;
+  self->priv->edit_position = start_pos;
+  self->priv->edit_n_chars = n_chars;
   clutter_text_buffer_insert_text (get_buffer (self), start_pos, chars, n_chars);
+  self->priv->in_edit = FALSE;
+  self->priv->edit_redraw_queued = FALSE;
 }
 
 /**
@@ -6026,7 +6337,12 @@ void clutter_text_real_delete_text (ClutterText *self,
    * following signal handlers: buffer_deleted_text(),
    * buffer_notify_text(), buffer_notify_max_length()
    */
+  self->priv->in_edit = TRUE;
+  self->priv->edit_position = start_pos;
+  self->priv->edit_n_chars = 0;
   clutter_text_buffer_delete_text (get_buffer (self), start_pos, end_pos - start_pos);
+  self->priv->in_edit = FALSE;
+  self->priv->edit_redraw_queued = FALSE;
 }
 
 
@@ -0,0 +1,1022 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2015  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-tiled-image
+ * @Title: ClutterTiledImage
+ * @Short_Description: Tiled content for very large images
+ * @See_Also: #ClutterImage
+ *
+ * #ClutterTiledImage is a #ClutterContent implementation that displays
+ * images too large to fit inside a single texture, like maps or scanned
+ * documents.
+ *
+ * The image data is provided on demand, one tile at a time, by a
+ * #ClutterTiledImageFunc set using clutter_tiled_image_set_source().
+ * The image is split into a pyramid of levels of detail, each level
+ * being half the size of the previous one; when painting, only the
+ * tiles that intersect the visible part of the actor are requested,
+ * using the level that best matches the on screen size of the image.
+ *
+ * Tiles are uploaded to the GPU and kept inside a cache; once the size
+ * of the cache grows past the #ClutterTiledImage:memory-budget, the
+ * least recently painted tiles are released. In order to avoid stalls
+ * while painting, at most #ClutterTiledImage:max-uploads tiles are
+ * requested for each paint; missing tiles are replaced by the closest
+ * cached tile from a coarser level, and requested in the next frames.
+ *
+ * #ClutterTiledImage is available since Clutter 1.22.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
+
+#include "clutter-tiled-image.h"
+
+#include "clutter-actor.h"
+#include "clutter-color.h"
+#include "clutter-content-private.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-paint-node.h"
+#include "clutter-paint-nodes.h"
+#include "clutter-private.h"
+
+#define DEFAULT_TILE_SIZE       256
+#define DEFAULT_MEMORY_BUDGET   (64 * 1024 * 1024)
+#define DEFAULT_MAX_UPLOADS     4
+
+/* the maximum number of levels we support; a 32k pixels wide image
+ * with 1 pixel tiles would still fit
+ */
+#define MAX_LEVELS              16
+
+typedef struct _ClutterTile
+{
+  /* packed level, row and column */
+  gint64 key;
+
+  guint level;
+  guint column;
+  guint row;
+
+  CoglTexture *texture;
+  gsize size;
+
+  /* the paint serial of the last paint using this tile */
+  guint last_used;
+
+  /* link inside the LRU queue */
+  GList link;
+} ClutterTile;
+
+struct _ClutterTiledImagePrivate
+{
+  guint width;
+  guint height;
+  guint tile_size;
+  guint n_levels;
+  CoglPixelFormat pixel_format;
+
+  ClutterTiledImageFunc tile_func;
+  gpointer tile_data;
+  GDestroyNotify tile_notify;
+
+  /* gint64 key -> ClutterTile */
+  GHashTable *tiles;
+
+  /* most recently used tiles at the head */
+  GQueue lru;
+
+  guint64 memory_budget;
+  guint64 memory_usage;
+
+  guint max_uploads;
+
+  guint paint_serial;
+
+  guint redraw_id;
+};
+
+enum
+{
+  PROP_0,
+
+  PROP_MEMORY_BUDGET,
+  PROP_MAX_UPLOADS,
+
+  PROP_LAST
+};
+
+static GParamSpec *obj_props[PROP_LAST] = { NULL, };
+
+static void clutter_content_iface_init (ClutterContentIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (ClutterTiledImage, clutter_tiled_image, G_TYPE_OBJECT,
+                         G_ADD_PRIVATE (ClutterTiledImage)
+                         G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_CONTENT,
+                                                clutter_content_iface_init))
+
+static inline gint64
+tile_key (guint level,
+          guint column,
+          guint row)
+{
+  return ((gint64) level << 48) | ((gint64) row << 24) | (gint64) column;
+}
+
+static inline guint
+level_size (guint size,
+            guint level)
+{
+  return MAX (1, (size + (1 << level) - 1) >> level);
+}
+
+static guint
+pixel_format_get_bytes_per_pixel (CoglPixelFormat format)
+{
+  switch (format)
+    {
+    case COGL_PIXEL_FORMAT_A_8:
+    case COGL_PIXEL_FORMAT_G_8:
+      return 1;
+
+    case COGL_PIXEL_FORMAT_RGB_565:
+    case COGL_PIXEL_FORMAT_RGBA_4444:
+    case COGL_PIXEL_FORMAT_RGBA_4444_PRE:
+    case COGL_PIXEL_FORMAT_RGBA_5551:
+    case COGL_PIXEL_FORMAT_RGBA_5551_PRE:
+      return 2;
+
+    case COGL_PIXEL_FORMAT_RGB_888:
+    case COGL_PIXEL_FORMAT_BGR_888:
+      return 3;
+
+    default:
+      return 4;
+    }
+}
+
+static void
+clutter_tile_free (gpointer data)
+{
+  ClutterTile *tile = data;
+
+  if (tile->texture != NULL)
+    cogl_object_unref (tile->texture);
+
+  g_slice_free (ClutterTile, tile);
+}
+
+static void
+clutter_tiled_image_remove_tile (ClutterTiledImage *self,
+                                 ClutterTile       *tile)
+{
+  ClutterTiledImagePrivate *priv = self->priv;
+
+  g_queue_unlink (&priv->lru, &tile->link);
+  priv->memory_usage -= tile->size;
+
+  g_hash_table_remove (priv->tiles, &tile->key);
+}
+
+static void
+clutter_tiled_image_clear_tiles (ClutterTiledImage *self)
+{
+  ClutterTiledImagePrivate *priv = self->priv;
+
+  while (priv->lru.tail != NULL)
+    clutter_tiled_image_remove_tile (self, priv->lru.tail->data);
+
+  g_assert (priv->memory_usage == 0);
+}
+
+/* releases the least recently used tiles until the cache fits inside
+ * the memory budget; the tiles used by the current paint are never
+ * released, as they are still referenced by the paint nodes
+ */
+static void
+clutter_tiled_image_trim_cache (ClutterTiledImage *self)
+{
+  ClutterTiledImagePrivate *priv = self->priv;
+
+  while (priv->memory_usage > priv->memory_budget && priv->lru.tail != NULL)
+    {
+      ClutterTile *tile = priv->lru.tail->data;
+
+      if (tile->last_used == priv->paint_serial)
+        break;
+
+      CLUTTER_NOTE (TEXTURE, "Evicting tile %u:%u,%u (%" G_GSIZE_FORMAT " bytes)",
+                    tile->level, tile->column, tile->row,
+                    tile->size);
+
+      clutter_tiled_image_remove_tile (self, tile);
+    }
+}
+
+static ClutterTile *
+clutter_tiled_image_lookup_tile (ClutterTiledImage *self,
+                                 guint              level,
+                                 guint              column,
+                                 guint              row)
+{
+  ClutterTiledImagePrivate *priv = self->priv;
+  ClutterTile *tile;
+  gint64 key;
+
+  key = tile_key (level, column, row);
+  tile = g_hash_table_lookup (priv->tiles, &key);
+  if (tile == NULL)
+    return NULL;
+
+  /* move the tile to the head of the LRU queue */
+  tile->last_used = priv->paint_serial;
+  g_queue_unlink (&priv->lru, &tile->link);
+  g_queue_push_head_link (&priv->lru, &tile->link);
+
+  return tile;
+}
+
+/* requests the data of a tile from the tile source and uploads it; if
+ * the source fails to provide the data, the tile is not cached, so that
+ * it can be requested again by a later paint
+ */
+static ClutterTile *
+clutter_tiled_image_load_tile (ClutterTiledImage *self,
+                               guint              level,
+                               guint              column,
+                               guint              row)
+{
+  ClutterTiledImagePrivate *priv = self->priv;
+  CoglTextureFlags flags = COGL_TEXTURE_NONE;
+  guint level_width, level_height;
+  guint tile_width, tile_height;
+  guint row_stride = 0;
+  guint bpp;
+  CoglTexture *texture;
+  ClutterTile *tile;
+  GBytes *data;
+
+  level_width = level_size (priv->width, level);
+  level_height = level_size (priv->height, level);
+
+  tile_width = MIN (priv->tile_size, level_width - column * priv->tile_size);
+  tile_height = MIN (priv->tile_size, level_height - row * priv->tile_size);
+
+  bpp = pixel_format_get_bytes_per_pixel (priv->pixel_format);
+
+  data = priv->tile_func (self, level, column, row,
+                          tile_width, tile_height,
+                          &row_stride,
+                          priv->tile_data);
+  if (data == NULL)
+    {
+      CLUTTER_NOTE (TEXTURE, "Unable to load tile %u:%u,%u",
+                    level, column, row);
+      return NULL;
+    }
+
+  if (row_stride == 0)
+    row_stride = tile_width * bpp;
+
+  if (row_stride < tile_width * bpp ||
+      g_bytes_get_size (data) < (gsize) row_stride * tile_height)
+    {
+      g_warning ("The data of the tile %u:%u,%u is too short: "
+                 "%" G_GSIZE_FORMAT " bytes, expected %" G_GSIZE_FORMAT,
+                 level, column, row,
+                 g_bytes_get_size (data),
+                 (gsize) row_stride * tile_height);
+      g_bytes_unref (data);
+      return NULL;
+    }
+
+  if (tile_width >= 512 && tile_height >= 512)
+    flags |= COGL_TEXTURE_NO_ATLAS;
+
+  texture = cogl_texture_new_from_data (tile_width, tile_height,
+                                        flags,
+                                        priv->pixel_format,
+                                        COGL_PIXEL_FORMAT_ANY,
+                                        row_stride,
+                                        g_bytes_get_data (data, NULL));
+  g_bytes_unref (data);
+
+  if (texture == NULL)
+    {
+      CLUTTER_NOTE (TEXTURE, "Unable to upload tile %u:%u,%u",
+                    level, column, row);
+      return NULL;
+    }
+
+  tile = g_slice_new0 (ClutterTile);
+  tile->key = tile_key (level, column, row);
+  tile->level = level;
+  tile->column = column;
+  tile->row = row;
+  tile->texture = texture;
+  tile->size = (gsize) tile_width * tile_height * bpp;
+  tile->link.data = tile;
+  tile->last_used = priv->paint_serial;
+
+  g_hash_table_insert (priv->tiles, &tile->key, tile);
+  g_queue_push_head_link (&priv->lru, &tile->link);
+  priv->memory_usage += tile->size;
+
+  return tile;
+}
+
+static gboolean
+clutter_tiled_image_queue_redraw (gpointer data)
+{
+  ClutterTiledImage *self = data;
+
+  self->priv->redraw_id = 0;
+
+  _clutter_content_queue_redraw (CLUTTER_CONTENT (self));
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+clutter_tiled_image_schedule_redraw (ClutterTiledImage *self)
+{
+  ClutterTiledImagePrivate *priv = self->priv;
+
+  if (priv->redraw_id != 0)
+    return;
+
+  /* we cannot queue a redraw while painting, so we defer it to
+   * the end of the current frame
+   */
+  priv->redraw_id =
+    clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_POST_PAINT,
+                                           clutter_tiled_image_queue_redraw,
+                                           g_object_ref (self),
+                                           g_object_unref);
+}
+
+/* computes the area of the image that is visible on the stage, in
+ * image pixels, and the scale of an image pixel on the stage
+ */
+static void
+clutter_tiled_image_get_visible_area (ClutterTiledImage     *self,
+                                      ClutterActor          *actor,
+                                      const ClutterActorBox *box,
+                                      ClutterActorBox       *visible,
+                                      float                 *scale)
+{
+  ClutterTiledImagePrivate *priv = self->priv;
+  float box_width, box_height;
+  float actor_width, actor_height;
+  float t_width, t_height;
+  ClutterActorBox paint_box;
+  ClutterActor *stage;
+
+  box_width = box->x2 - box->x1;
+  box_height = box->y2 - box->y1;
+
+  visible->x1 = 0.f;
+  visible->y1 = 0.f;
+  visible->x2 = priv->width;
+  visible->y2 = priv->height;
+
+  *scale = MAX (box_width / priv->width, box_height / priv->height);
+
+  stage = clutter_actor_get_stage (actor);
+  if (stage == NULL)
+    return;
+
+  clutter_actor_get_size (actor, &actor_width, &actor_height);
+  clutter_actor_get_transformed_size (actor, &t_width, &t_height);
+
+  if (actor_width > 0.f && actor_height > 0.f)
+    *scale = MAX (t_width / actor_width * box_width / priv->width,
+                  t_height / actor_height * box_height / priv->height);
+
+  if (clutter_actor_get_paint_box (actor, &paint_box))
+    {
+      float stage_width, stage_height;
+      float x[4], y[4];
+      float x1, y1, x2, y2;
+      int i;
+
+      clutter_actor_get_size (stage, &stage_width, &stage_height);
+
+      paint_box.x1 = CLAMP (paint_box.x1, 0.f, stage_width);
+      paint_box.y1 = CLAMP (paint_box.y1, 0.f, stage_height);
+      paint_box.x2 = CLAMP (paint_box.x2, 0.f, stage_width);
+      paint_box.y2 = CLAMP (paint_box.y2, 0.f, stage_height);
+
+      if (!clutter_actor_transform_stage_point (actor,
+                                                paint_box.x1, paint_box.y1,
+                                                &x[0], &y[0]) ||
+          !clutter_actor_transform_stage_point (actor,
+                                                paint_box.x2, paint_box.y1,
+                                                &x[1], &y[1]) ||
+          !clutter_actor_transform_stage_point (actor,
+                                                paint_box.x1, paint_box.y2,
+                                                &x[2], &y[2]) ||
+          !clutter_actor_transform_stage_point (actor,
+                                                paint_box.x2, paint_box.y2,
+                                                &x[3], &y[3]))
+        return;
+
+      x1 = x2 = x[0];
+      y1 = y2 = y[0];
+      for (i = 1; i < 4; i++)
+        {
+          x1 = MIN (x1, x[i]);
+          y1 = MIN (y1, y[i]);
+          x2 = MAX (x2, x[i]);
+          y2 = MAX (y2, y[i]);
+        }
+
+      /* map from actor coordinates to image pixels */
+      visible->x1 = CLAMP ((x1 - box->x1) / box_width * priv->width,
+                           0.f, priv->width);
+      visible->y1 = CLAMP ((y1 - box->y1) / box_height * priv->height,
+                           0.f, priv->height);
+      visible->x2 = CLAMP ((x2 - box->x1) / box_width * priv->width,
+                           0.f, priv->width);
+      visible->y2 = CLAMP ((y2 - box->y1) / box_height * priv->height,
+                           0.f, priv->height);
+    }
+}
+
+static guint
+clutter_tiled_image_get_level_for_scale (ClutterTiledImage *self,
+                                         float              scale)
+{
+  int level;
+
+  if (scale <= 0.f || scale >= 1.f)
+    return 0;
+
+  level = (int) floorf (log2f (1.f / scale));
+
+  return CLAMP (level, 0, (int) self->priv->n_levels - 1);
+}
+
+static void
+clutter_tiled_image_add_tile_node (ClutterTiledImage     *self,
+                                   ClutterPaintNode      *root,
+                                   ClutterTile           *tile,
+                                   const ClutterActorBox *box,
+                                   const ClutterActorBox *tile_area,
+                                   const ClutterColor    *color,
+                                   ClutterScalingFilter   min_f,
+                                   ClutterScalingFilter   mag_f)
+{
+  ClutterTiledImagePrivate *priv = self->priv;
+  float scale_x, scale_y;
+  float tile_x, tile_y;
+  float tile_width, tile_height;
+  ClutterPaintNode *node;
+  ClutterActorBox rect;
+
+  /* tile_area is in image pixels; map it to actor coordinates */
+  scale_x = (box->x2 - box->x1) / priv->width;
+  scale_y = (box->y2 - box->y1) / priv->height;
+
+  rect.x1 = box->x1 + tile_area->x1 * scale_x;
+  rect.y1 = box->y1 + tile_area->y1 * scale_y;
+  rect.x2 = box->x1 + tile_area->x2 * scale_x;
+  rect.y2 = box->y1 + tile_area->y2 * scale_y;
+
+  /* and to the texture coordinates of the tile */
+  tile_x = (float) (tile->column * priv->tile_size) * (1 << tile->level);
+  tile_y = (float) (tile->row * priv->tile_size) * (1 << tile->level);
+  tile_width = cogl_texture_get_width (tile->texture) * (1 << tile->level);
+  tile_height = cogl_texture_get_height (tile->texture) * (1 << tile->level);
+
+  node = clutter_texture_node_new (tile->texture, color, min_f, mag_f);
+  clutter_paint_node_set_name (node, "TiledImage");
+  clutter_paint_node_add_texture_rectangle (node, &rect,
+                                            (tile_area->x1 - tile_x) / tile_width,
+                                            (tile_area->y1 - tile_y) / tile_height,
+                                            (tile_area->x2 - tile_x) / tile_width,
+                                            (tile_area->y2 - tile_y) / tile_height);
+
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+}
+
+static void
+clutter_tiled_image_paint_content (ClutterContent   *content,
+                                   ClutterActor     *actor,
+                                   ClutterPaintNode *root)
+{
+  ClutterTiledImage *self = CLUTTER_TILED_IMAGE (content);
+  ClutterTiledImagePrivate *priv = self->priv;
+  ClutterScalingFilter min_f, mag_f;
+  ClutterActorBox box, visible;
+  guint level, tile_span;
+  guint col_start, col_end;
+  guint row_start, row_end;
+  guint column, row;
+  guint n_uploads = 0;
+  gboolean incomplete = FALSE;
+  ClutterColor color;
+  float scale;
+
+  if (priv->tile_func == NULL)
+    return;
+
+  clutter_actor_get_content_box (actor, &box);
+  if (box.x2 - box.x1 <= 0.f || box.y2 - box.y1 <= 0.f)
+    return;
+
+  clutter_actor_get_content_scaling_filters (actor, &min_f, &mag_f);
+
+  color.red = 255;
+  color.green = 255;
+  color.blue = 255;
+  color.alpha = clutter_actor_get_paint_opacity (actor);
+
+  priv->paint_serial += 1;
+
+  clutter_tiled_image_get_visible_area (self, actor, &box, &visible, &scale);
+  if (visible.x2 <= visible.x1 || visible.y2 <= visible.y1)
+    return;
+
+  level = clutter_tiled_image_get_level_for_scale (self, scale);
+
+  /* the size of a tile of this level, in image pixels */
+  tile_span = priv->tile_size << level;
+
+  col_start = (guint) visible.x1 / tile_span;
+  row_start = (guint) visible.y1 / tile_span;
+  col_end = ((guint) ceilf (visible.x2) + tile_span - 1) / tile_span;
+  row_end = ((guint) ceilf (visible.y2) + tile_span - 1) / tile_span;
+
+  CLUTTER_NOTE (PAINT, "Painting tiles [%u, %u] x [%u, %u] at level %u",
+                col_start, col_end, row_start, row_end,
+                level);
+
+  for (row = row_start; row < row_end; row++)
+    {
+      for (column = col_start; column < col_end; column++)
+        {
+          ClutterActorBox tile_area;
+          ClutterTile *tile;
+          guint l;
+
+          tile_area.x1 = column * tile_span;
+          tile_area.y1 = row * tile_span;
+          tile_area.x2 = MIN (tile_area.x1 + tile_span, priv->width);
+          tile_area.y2 = MIN (tile_area.y1 + tile_span, priv->height);
+
+          tile = clutter_tiled_image_lookup_tile (self, level, column, row);
+          if (tile == NULL && n_uploads < priv->max_uploads)
+            {
+              tile = clutter_tiled_image_load_tile (self, level,
+                                                    column, row);
+              n_uploads += 1;
+            }
+
+          /* missing tiles, including the ones that failed to load,
+           * are requested again in the next frame
+           */
+          if (tile == NULL)
+            incomplete = TRUE;
+
+          if (tile != NULL)
+            {
+              clutter_tiled_image_add_tile_node (self, root, tile,
+                                                 &box, &tile_area,
+                                                 &color,
+                                                 min_f, mag_f);
+              continue;
+            }
+
+          /* use the closest coarser tile we have, if any */
+          for (l = level + 1; l < priv->n_levels; l++)
+            {
+              guint shift = l - level;
+
+              tile = clutter_tiled_image_lookup_tile (self, l,
+                                                      column >> shift,
+                                                      row >> shift);
+              if (tile != NULL)
+                {
+                  clutter_tiled_image_add_tile_node (self, root, tile,
+                                                     &box, &tile_area,
+                                                     &color,
+                                                     min_f, mag_f);
+                  break;
+                }
+            }
+        }
+    }
+
+  clutter_tiled_image_trim_cache (self);
+
+  if (incomplete)
+    clutter_tiled_image_schedule_redraw (self);
+}
+
+static gboolean
+clutter_tiled_image_get_preferred_size (ClutterContent *content,
+                                        gfloat         *width,
+                                        gfloat         *height)
+{
+  ClutterTiledImagePrivate *priv = CLUTTER_TILED_IMAGE (content)->priv;
+
+  if (priv->tile_func == NULL)
+    return FALSE;
+
+  if (width != NULL)
+    *width = priv->width;
+
+  if (height != NULL)
+    *height = priv->height;
+
+  return TRUE;
+}
+
+static void
+clutter_tiled_image_invalidate (ClutterContent *content)
+{
+  /* the contents of the tiles changed, so we need to drop them */
+  clutter_tiled_image_clear_tiles (CLUTTER_TILED_IMAGE (content));
+}
+
+static void
+clutter_content_iface_init (ClutterContentIface *iface)
+{
+  iface->get_preferred_size = clutter_tiled_image_get_preferred_size;
+  iface->paint_content = clutter_tiled_image_paint_content;
+  iface->invalidate = clutter_tiled_image_invalidate;
+}
+
+static void
+clutter_tiled_image_finalize (GObject *gobject)
+{
+  ClutterTiledImage *self = CLUTTER_TILED_IMAGE (gobject);
+  ClutterTiledImagePrivate *priv = self->priv;
+
+  clutter_tiled_image_clear_tiles (self);
+  g_hash_table_unref (priv->tiles);
+
+  if (priv->tile_notify != NULL)
+    priv->tile_notify (priv->tile_data);
+
+  G_OBJECT_CLASS (clutter_tiled_image_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_tiled_image_set_property (GObject      *gobject,
+                                  guint         prop_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  ClutterTiledImage *self = CLUTTER_TILED_IMAGE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_MEMORY_BUDGET:
+      clutter_tiled_image_set_memory_budget (self, g_value_get_uint64 (value));
+      break;
+
+    case PROP_MAX_UPLOADS:
+      clutter_tiled_image_set_max_uploads (self, g_value_get_uint (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_tiled_image_get_property (GObject    *gobject,
+                                  guint       prop_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  ClutterTiledImagePrivate *priv = CLUTTER_TILED_IMAGE (gobject)->priv;
+
+  switch (prop_id)
+    {
+    case PROP_MEMORY_BUDGET:
+      g_value_set_uint64 (value, priv->memory_budget);
+      break;
+
+    case PROP_MAX_UPLOADS:
+      g_value_set_uint (value, priv->max_uploads);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_tiled_image_class_init (ClutterTiledImageClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  /**
+   * ClutterTiledImage:memory-budget:
+   *
+   * The maximum amount of texture memory, in bytes, used by the
+   * cached tiles.
+   *
+   * The tiles painted by the current frame are never released, so
+   * the memory usage may temporarily exceed this value.
+   *
+   * Since: 1.22
+   */
+  obj_props[PROP_MEMORY_BUDGET] =
+    g_param_spec_uint64 ("memory-budget",
+                         P_("Memory Budget"),
+                         P_("The maximum amount of texture memory used by the tiles"),
+                         0, G_MAXUINT64,
+                         DEFAULT_MEMORY_BUDGET,
+                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterTiledImage:max-uploads:
+   *
+   * The maximum number of tiles that can be requested and uploaded
+   * for each paint.
+   *
+   * Since: 1.22
+   */
+  obj_props[PROP_MAX_UPLOADS] =
+    g_param_spec_uint ("max-uploads",
+                       P_("Maximum Uploads"),
+                       P_("The maximum number of tiles uploaded for each paint"),
+                       1, G_MAXUINT,
+                       DEFAULT_MAX_UPLOADS,
+                       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  gobject_class->set_property = clutter_tiled_image_set_property;
+  gobject_class->get_property = clutter_tiled_image_get_property;
+  gobject_class->finalize = clutter_tiled_image_finalize;
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+}
+
+static void
+clutter_tiled_image_init (ClutterTiledImage *self)
+{
+  ClutterTiledImagePrivate *priv;
+
+  self->priv = priv = clutter_tiled_image_get_instance_private (self);
+
+  priv->tiles = g_hash_table_new_full (g_int64_hash, g_int64_equal,
+                                       NULL,
+                                       clutter_tile_free);
+  g_queue_init (&priv->lru);
+
+  priv->tile_size = DEFAULT_TILE_SIZE;
+  priv->memory_budget = DEFAULT_MEMORY_BUDGET;
+  priv->max_uploads = DEFAULT_MAX_UPLOADS;
+}
+
+/**
+ * clutter_tiled_image_new:
+ *
+ * Creates a new #ClutterTiledImage instance.
+ *
+ * Return value: (transfer full): the newly created #ClutterTiledImage
+ *   instance. Use g_object_unref() when done.
+ *
+ * Since: 1.22
+ */
+ClutterContent *
+clutter_tiled_image_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_TILED_IMAGE, NULL);
+}
+
+/**
+ * clutter_tiled_image_set_source:
+ * @image: a #ClutterTiledImage
+ * @width: the width of the full resolution image
+ * @height: the height of the full resolution image
+ * @tile_size: the size of each tile, in pixels, or 0 for the default
+ * @pixel_format: the Cogl pixel format of the tiles data
+ * @func: (allow-none): the function used to retrieve the tiles data
+ * @user_data: data to pass to @func
+ * @notify: a function called when @func is not used any more
+ *
+ * Sets the source of the image data displayed by @image.
+ *
+ * The image is split into levels of detail, each one half the size of
+ * the previous one, until the whole image fits inside a single tile; each
+ * level is split into tiles of @tile_size x @tile_size pixels, except the
+ * ones on the right and bottom edges, which may be smaller.
+ *
+ * The @func will be called when painting, for each tile that intersects
+ * the visible area of the actor and that is not already cached.
+ *
+ * Setting a new source drops all the cached tiles, and invalidates @image.
+ *
+ * Since: 1.22
+ */
+void
+clutter_tiled_image_set_source (ClutterTiledImage     *image,
+                                guint                  width,
+                                guint                  height,
+                                guint                  tile_size,
+                                CoglPixelFormat        pixel_format,
+                                ClutterTiledImageFunc  func,
+                                gpointer               user_data,
+                                GDestroyNotify         notify)
+{
+  ClutterTiledImagePrivate *priv;
+  guint size;
+
+  g_return_if_fail (CLUTTER_IS_TILED_IMAGE (image));
+  g_return_if_fail (func == NULL || (width > 0 && height > 0));
+
+  priv = image->priv;
+
+  if (priv->tile_notify != NULL)
+    priv->tile_notify (priv->tile_data);
+
+  priv->width = width;
+  priv->height = height;
+  priv->tile_size = tile_size > 0 ? tile_size : DEFAULT_TILE_SIZE;
+  priv->pixel_format = pixel_format;
+  priv->tile_func = func;
+  priv->tile_data = user_data;
+  priv->tile_notify = notify;
+
+  /* add levels until the whole image fits inside a single tile */
+  priv->n_levels = 1;
+  size = MAX (width, height);
+  while (size > priv->tile_size && priv->n_levels < MAX_LEVELS)
+    {
+      size = (size + 1) / 2;
+      priv->n_levels += 1;
+    }
+
+  clutter_content_invalidate (CLUTTER_CONTENT (image));
+}
+
+/**
+ * clutter_tiled_image_get_n_levels:
+ * @image: a #ClutterTiledImage
+ *
+ * Retrieves the number of levels of detail of @image.
+ *
+ * Return value: the number of levels, or 0 if no source was set
+ *
+ * Since: 1.22
+ */
+guint
+clutter_tiled_image_get_n_levels (ClutterTiledImage *image)
+{
+  g_return_val_if_fail (CLUTTER_IS_TILED_IMAGE (image), 0);
+
+  if (image->priv->tile_func == NULL)
+    return 0;
+
+  return image->priv->n_levels;
+}
+
+/**
+ * clutter_tiled_image_set_memory_budget:
+ * @image: a #ClutterTiledImage
+ * @budget: the maximum amount of texture memory, in bytes
+ *
+ * Sets the maximum amount of texture memory used by the tiles
+ * cached by @image.
+ *
+ * Since: 1.22
+ */
+void
+clutter_tiled_image_set_memory_budget (ClutterTiledImage *image,
+                                       guint64            budget)
+{
+  ClutterTiledImagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TILED_IMAGE (image));
+
+  priv = image->priv;
+
+  if (priv->memory_budget == budget)
+    return;
+
+  priv->memory_budget = budget;
+
+  clutter_tiled_image_trim_cache (image);
+
+  g_object_notify_by_pspec (G_OBJECT (image), obj_props[PROP_MEMORY_BUDGET]);
+}
+
+/**
+ * clutter_tiled_image_get_memory_budget:
+ * @image: a #ClutterTiledImage
+ *
+ * Retrieves the value set by clutter_tiled_image_set_memory_budget().
+ *
+ * Return value: the memory budget, in bytes
+ *
+ * Since: 1.22
+ */
+guint64
+clutter_tiled_image_get_memory_budget (ClutterTiledImage *image)
+{
+  g_return_val_if_fail (CLUTTER_IS_TILED_IMAGE (image), 0);
+
+  return image->priv->memory_budget;
+}
+
+/**
+ * clutter_tiled_image_set_max_uploads:
+ * @image: a #ClutterTiledImage
+ * @max_uploads: the maximum number of tiles to upload for each paint
+ *
+ * Sets the maximum number of tiles that @image will request and upload
+ * each time it is painted.
+ *
+ * Lower values keep the frame rate steady, at the cost of the image
+ * taking more frames to reach its full level of detail.
+ *
+ * Since: 1.22
+ */
+void
+clutter_tiled_image_set_max_uploads (ClutterTiledImage *image,
+                                     guint              max_uploads)
+{
+  ClutterTiledImagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TILED_IMAGE (image));
+  g_return_if_fail (max_uploads > 0);
+
+  priv = image->priv;
+
+  if (priv->max_uploads == max_uploads)
+    return;
+
+  priv->max_uploads = max_uploads;
+
+  g_object_notify_by_pspec (G_OBJECT (image), obj_props[PROP_MAX_UPLOADS]);
+}
+
+/**
+ * clutter_tiled_image_get_max_uploads:
+ * @image: a #ClutterTiledImage
+ *
+ * Retrieves the value set by clutter_tiled_image_set_max_uploads().
+ *
+ * Return value: the maximum number of tiles uploaded for each paint
+ *
+ * Since: 1.22
+ */
+guint
+clutter_tiled_image_get_max_uploads (ClutterTiledImage *image)
+{
+  g_return_val_if_fail (CLUTTER_IS_TILED_IMAGE (image), DEFAULT_MAX_UPLOADS);
+
+  return image->priv->max_uploads;
+}
+
+/**
+ * clutter_tiled_image_get_memory_usage:
+ * @image: a #ClutterTiledImage
+ *
+ * Retrieves the amount of texture memory currently used by the
+ * tiles cached by @image.
+ *
+ * Return value: the memory usage, in bytes
+ *
+ * Since: 1.22
+ */
+guint64
+clutter_tiled_image_get_memory_usage (ClutterTiledImage *image)
+{
+  g_return_val_if_fail (CLUTTER_IS_TILED_IMAGE (image), 0);
+
+  return image->priv->memory_usage;
+}
@@ -0,0 +1,147 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2015  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#ifndef __CLUTTER_TILED_IMAGE_H__
+#define __CLUTTER_TILED_IMAGE_H__
+
+#include <cogl/cogl.h>
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_TILED_IMAGE                (clutter_tiled_image_get_type ())
+#define CLUTTER_TILED_IMAGE(obj)                (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_TILED_IMAGE, ClutterTiledImage))
+#define CLUTTER_IS_TILED_IMAGE(obj)             (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_TILED_IMAGE))
+#define CLUTTER_TILED_IMAGE_CLASS(klass)        (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_TILED_IMAGE, ClutterTiledImageClass))
+#define CLUTTER_IS_TILED_IMAGE_CLASS(klass)     (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_TILED_IMAGE))
+#define CLUTTER_TILED_IMAGE_GET_CLASS(obj)      (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_TILED_IMAGE, ClutterTiledImageClass))
+
+typedef struct _ClutterTiledImage               ClutterTiledImage;
+typedef struct _ClutterTiledImagePrivate        ClutterTiledImagePrivate;
+typedef struct _ClutterTiledImageClass          ClutterTiledImageClass;
+
+/**
+ * ClutterTiledImageFunc:
+ * @image: the #ClutterTiledImage requesting the tile
+ * @level: the level of detail of the tile; level 0 is the full
+ *   resolution image, and each following level halves the size
+ *   of the previous one
+ * @column: the column of the tile inside @level
+ * @row: the row of the tile inside @level
+ * @width: the width of the tile, in pixels
+ * @height: the height of the tile, in pixels
+ * @row_stride: (out): return location for the length of each row
+ *   inside the returned data
+ * @user_data: data passed to clutter_tiled_image_set_source()
+ *
+ * A function used by #ClutterTiledImage to retrieve the pixel data
+ * of a tile.
+ *
+ * The pixel data must use the #CoglPixelFormat passed to
+ * clutter_tiled_image_set_source().
+ *
+ * The returned data must contain at least @row_stride times @height
+ * bytes; if @row_stride is left to 0, the rows are assumed to be packed.
+ *
+ * Return value: (transfer full): the pixel data of the tile, or %NULL
+ *   if the tile could not be loaded; failed tiles are requested again
+ *   in the following frames
+ *
+ * Since: 1.22
+ */
+typedef GBytes *(* ClutterTiledImageFunc) (ClutterTiledImage *image,
+                                           guint              level,
+                                           guint              column,
+                                           guint              row,
+                                           guint              width,
+                                           guint              height,
+                                           guint             *row_stride,
+                                           gpointer           user_data);
+
+/**
+ * ClutterTiledImage:
+ *
+ * The #ClutterTiledImage structure contains
+ * private data and should only be accessed using the provided
+ * API.
+ *
+ * Since: 1.22
+ */
+struct _ClutterTiledImage
+{
+  /*< private >*/
+  GObject parent_instance;
+
+  ClutterTiledImagePrivate *priv;
+};
+
+/**
+ * ClutterTiledImageClass:
+ *
+ * The #ClutterTiledImageClass structure contains
+ * private data.
+ *
+ * Since: 1.22
+ */
+struct _ClutterTiledImageClass
+{
+  /*< private >*/
+  GObjectClass parent_class;
+
+  gpointer _padding[16];
+};
+
+CLUTTER_AVAILABLE_IN_1_22
+GType clutter_tiled_image_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_22
+ClutterContent *        clutter_tiled_image_new                 (void);
+CLUTTER_AVAILABLE_IN_1_22
+void                    clutter_tiled_image_set_source          (ClutterTiledImage     *image,
+                                                                 guint                  width,
+                                                                 guint                  height,
+                                                                 guint                  tile_size,
+                                                                 CoglPixelFormat        pixel_format,
+                                                                 ClutterTiledImageFunc  func,
+                                                                 gpointer               user_data,
+                                                                 GDestroyNotify         notify);
+CLUTTER_AVAILABLE_IN_1_22
+guint                   clutter_tiled_image_get_n_levels        (ClutterTiledImage     *image);
+CLUTTER_AVAILABLE_IN_1_22
+void                    clutter_tiled_image_set_memory_budget   (ClutterTiledImage     *image,
+                                                                 guint64                budget);
+CLUTTER_AVAILABLE_IN_1_22
+guint64                 clutter_tiled_image_get_memory_budget   (ClutterTiledImage     *image);
+CLUTTER_AVAILABLE_IN_1_22
+void                    clutter_tiled_image_set_max_uploads     (ClutterTiledImage     *image,
+                                                                 guint                  max_uploads);
+CLUTTER_AVAILABLE_IN_1_22
+guint                   clutter_tiled_image_get_max_uploads     (ClutterTiledImage     *image);
+CLUTTER_AVAILABLE_IN_1_22
+guint64                 clutter_tiled_image_get_memory_usage    (ClutterTiledImage     *image);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TILED_IMAGE_H__ */
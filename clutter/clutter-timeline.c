@@ -47,6 +47,13 @@
  * time elapsed since the last emission of the #ClutterTimeline::new-frame
  * signal.
  *
+ * Since many timelines can be running at the same time, and most of them
+ * have nobody listening to #ClutterTimeline::new-frame, the signal is only
+ * emitted if a handler is connected to it; otherwise, the class handler is
+ * called directly, bypassing emission hooks and overridden class closures.
+ * Running timelines are advanced from the most recently started one to
+ * the oldest one.
+ *
  * Initial state can be set up by using the #ClutterTimeline::started signal,
  * while final state can be set up by using the #ClutterTimeline::stopped
  * signal. The #ClutterTimeline guarantees the emission of at least a single
@@ -128,6 +135,9 @@ struct _ClutterTimelinePrivate
 
   GHashTable *markers_by_name;
 
+  /* The link used by the master clock while playing */
+  ClutterMasterClockLink clock_link;
+
   /* Time we last advanced the elapsed time and showed a frame */
   gint64 last_frame_time;
 
@@ -150,6 +160,11 @@ struct _ClutterTimelinePrivate
   ClutterPoint cb_1;
   ClutterPoint cb_2;
 
+  /* the curve for the cubic bezier progress modes, computed when
+   * the progress mode is set
+   */
+  ClutterCubicBezier bezier;
+
   guint is_playing         : 1;
 
   /* If we've just started playing and haven't yet gotten
@@ -705,6 +720,12 @@ clutter_timeline_class_init (ClutterTimelineClass *klass)
    * The ::new-frame signal is emitted for each timeline running
    * timeline before a new frame is drawn to give animations a chance
    * to update the scene.
+   *
+   * If no handler is connected to the signal, the signal is not
+   * emitted, and the #ClutterTimelineClass.new_frame virtual function
+   * is called directly instead; this means that emission hooks, and
+   * class closures overridden with g_signal_override_class_closure(),
+   * are not invoked unless a handler is connected as well.
    */
   timeline_signals[NEW_FRAME] =
     g_signal_new (I_("new-frame"),
@@ -934,7 +955,8 @@ check_markers (ClutterTimeline *timeline,
   struct CheckIfMarkerHitClosure data;
 
   /* shortcircuit here if we don't have any marker installed */
-  if (priv->markers_by_name == NULL)
+  if (priv->markers_by_name == NULL ||
+      g_hash_table_size (priv->markers_by_name) == 0)
     return;
 
   /* store the details of the timeline so that changing them in a
@@ -954,10 +976,25 @@ static void
 emit_frame_signal (ClutterTimeline *timeline)
 {
   ClutterTimelinePrivate *priv = timeline->priv;
+  ClutterTimelineClass *klass;
 
   /* see bug https://bugzilla.gnome.org/show_bug.cgi?id=654066 */
   gint elapsed = (gint) priv->elapsed_time;
 
+  /* the signal emission is expensive when advancing many timelines,
+   * and most of them have nobody listening; if there are no handlers
+   * connected we can skip it, and just call the class handler, if
+   * any, like ClutterTransition does
+   */
+  if (!g_signal_has_handler_pending (timeline, timeline_signals[NEW_FRAME], 0, TRUE))
+    {
+      klass = CLUTTER_TIMELINE_GET_CLASS (timeline);
+      if (klass->new_frame != NULL)
+        klass->new_frame (timeline, elapsed);
+
+      return;
+    }
+
   CLUTTER_NOTE (SCHEDULER, "Emitting ::new-frame signal on timeline[%p]", timeline);
 
   g_signal_emit (timeline, timeline_signals[NEW_FRAME], 0, elapsed);
@@ -1695,6 +1732,21 @@ _clutter_timeline_advance (ClutterTimeline *timeline,
   g_object_unref (timeline);
 }
 
+/*< private >
+ * clutter_timeline_get_clock_link:
+ * @timeline: a #ClutterTimeline
+ *
+ * Retrieves the link used by the master clock to keep track of
+ * @timeline while it is playing.
+ *
+ * Return value: (transfer none): the link embedded in @timeline
+ */
+ClutterMasterClockLink *
+_clutter_timeline_get_clock_link (ClutterTimeline *timeline)
+{
+  return &timeline->priv->clock_link;
+}
+
 /*< private >
  * clutter_timeline_do_tick
  * @timeline: a #ClutterTimeline
@@ -2246,31 +2298,51 @@ clutter_timeline_progress_func (ClutterTimeline *timeline,
       return clutter_ease_steps_end (elapsed, duration, 1);
 
     case CLUTTER_CUBIC_BEZIER:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        priv->cb_1.x, priv->cb_1.y,
-                                        priv->cb_2.x, priv->cb_2.y);
+    case CLUTTER_EASE:
+    case CLUTTER_EASE_IN:
+    case CLUTTER_EASE_OUT:
+    case CLUTTER_EASE_IN_OUT:
+      return clutter_cubic_bezier_evaluate (&priv->bezier, elapsed / duration);
+
+    default:
+      break;
+    }
+
+  return clutter_easing_for_mode (priv->progress_mode, elapsed, duration);
+}
+
+static void
+clutter_timeline_update_cubic_bezier (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+
+  switch (priv->progress_mode)
+    {
+    case CLUTTER_CUBIC_BEZIER:
+      clutter_cubic_bezier_init (&priv->bezier,
+                                 priv->cb_1.x, priv->cb_1.y,
+                                 priv->cb_2.x, priv->cb_2.y);
+      break;
 
     case CLUTTER_EASE:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.25, 0.1, 0.25, 1.0);
+      clutter_cubic_bezier_init (&priv->bezier, 0.25, 0.1, 0.25, 1.0);
+      break;
 
     case CLUTTER_EASE_IN:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.42, 0.0, 1.0, 1.0);
+      clutter_cubic_bezier_init (&priv->bezier, 0.42, 0.0, 1.0, 1.0);
+      break;
 
     case CLUTTER_EASE_OUT:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.0, 0.0, 0.58, 1.0);
+      clutter_cubic_bezier_init (&priv->bezier, 0.0, 0.0, 0.58, 1.0);
+      break;
 
     case CLUTTER_EASE_IN_OUT:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.42, 0.0, 0.58, 1.0);
+      clutter_cubic_bezier_init (&priv->bezier, 0.42, 0.0, 0.58, 1.0);
+      break;
 
     default:
       break;
     }
-
-  return clutter_easing_for_mode (priv->progress_mode, elapsed, duration);
 }
 
 /**
@@ -2313,6 +2385,8 @@ clutter_timeline_set_progress_mode (ClutterTimeline      *timeline,
   priv->progress_data = NULL;
   priv->progress_notify = NULL;
 
+  clutter_timeline_update_cubic_bezier (timeline);
+
   g_object_notify_by_pspec (G_OBJECT (timeline), obj_props[PROP_PROGRESS_MODE]);
 }
 
@@ -2494,6 +2568,9 @@ clutter_timeline_set_cubic_bezier_progress (ClutterTimeline    *timeline,
   priv->cb_2.x = CLAMP (priv->cb_2.x, 0.f, 1.f);
 
   clutter_timeline_set_progress_mode (timeline, CLUTTER_CUBIC_BEZIER);
+
+  /* the progress mode might not have changed */
+  clutter_timeline_update_cubic_bezier (timeline);
 }
 
 /**
@@ -36,6 +36,7 @@
 #include "clutter-actor-meta.h"
 #include "clutter-align-constraint.h"
 #include "clutter-animatable.h"
+#include "clutter-array-model.h"
 #include "clutter-backend.h"
 #include "clutter-bind-constraint.h"
 #include "clutter-binding-pool.h"
@@ -88,6 +89,7 @@
 #include "clutter-path-constraint.h"
 #include "clutter-path.h"
 #include "clutter-property-transition.h"
+#include "clutter-rope-text-buffer.h"
 #include "clutter-rotate-action.h"
 #include "clutter-scriptable.h"
 #include "clutter-script.h"
@@ -103,6 +105,7 @@
 #include "clutter-test-utils.h"
 #include "clutter-texture.h"
 #include "clutter-text.h"
+#include "clutter-tiled-image.h"
 #include "clutter-timeline.h"
 #include "clutter-transition-group.h"
 #include "clutter-transition.h"
@@ -208,6 +208,8 @@ typedef struct State
                                   names */
   GList        *keys;          /* list of all keys pertaining to transitions
                                   from other states to this one */
+  GHashTable   *key_groups;    /* the first link inside keys for each
+                                  object and property pair */
   GArray       *animators;     /* list of animators for transitioning from
                                 * specific source states */
   ClutterState *clutter_state; /* the ClutterState object this state belongs to
@@ -228,8 +230,17 @@ struct _ClutterStatePrivate
   State           *target_state;      /* target state name */
   ClutterAnimator *current_animator;  /* !NULL if the current transition is
                                          overriden by an animator */
+  GArray          *frame_keys;        /* the keys applied on each frame of
+                                         the current transition */
+  guint            frame_keys_valid : 1;
 };
 
+typedef struct FrameKey {
+  ClutterStateKey *key;               /* the key used for an object and
+                                         property pair */
+  GValue           value;             /* storage for the interpolated value */
+} FrameKey;
+
 #define SLAVE_TIMELINE_LENGTH 10000
 
 /*
@@ -326,11 +337,31 @@ sort_props_func (gconstpointer a,
   return pa->object - pb->object;
 }
 
+static guint
+key_group_hash (gconstpointer v)
+{
+  const ClutterStateKey *key = v;
+
+  return g_direct_hash (key->object) ^ g_direct_hash (key->property_name);
+}
+
+static gboolean
+key_group_equal (gconstpointer a,
+                 gconstpointer b)
+{
+  const ClutterStateKey *pa = a;
+  const ClutterStateKey *pb = b;
+
+  return pa->object == pb->object && pa->property_name == pb->property_name;
+}
+
 static State * clutter_state_fetch_state (ClutterState *state,
                                           const gchar  *state_name,
                                           gboolean      force_creation);
 static void object_disappeared (gpointer data,
                                 GObject *where_the_object_was);
+static void state_remove_key_link (State *state,
+                                   GList *link);
 
 static ClutterStateKey *
 clutter_state_key_new (State       *state,
@@ -439,6 +470,7 @@ again_from_start:
 	  /* Note the safe while() loop, because we modify the list inline */
           while (k != NULL)
             {
+              GList *link = k;
               ClutterStateKey *key = k->data;
 
 	      k = k->next;
@@ -449,7 +481,8 @@ again_from_start:
                   && (property_name == NULL || ((property_name == key->property_name))))
                 {
                   /* Remove matching key */
-                  target_state->keys = g_list_remove (target_state->keys, key);
+                  state_remove_key_link (target_state, link);
+                  this->priv->frame_keys_valid = FALSE;
                   key->is_inert = is_inert;
                   clutter_state_key_free (key);
 
@@ -497,6 +530,7 @@ state_free (gpointer data)
 
   g_array_free (state->animators, TRUE);
   g_hash_table_destroy (state->durations);
+  g_hash_table_destroy (state->key_groups);
   g_free (state);
 }
 
@@ -511,16 +545,94 @@ state_new (ClutterState *clutter_state,
   state->name = name;
   state->animators = g_array_new (TRUE, TRUE, sizeof (StateAnimator));
   state->durations = g_hash_table_new (g_direct_hash, g_direct_equal);
+  state->key_groups = g_hash_table_new (key_group_hash, key_group_equal);
 
   return state;
 }
 
+/* adds @key to the keys of @state, replacing the key for the same
+ * object, property and source state, if any
+ */
+static void
+state_insert_key (State           *state,
+                  ClutterStateKey *key)
+{
+  GList *group, *l, *prev;
+
+  group = g_hash_table_lookup (state->key_groups, key);
+  if (group == NULL)
+    {
+      /* the first key for the object and property */
+      for (l = state->keys, prev = NULL;
+           l != NULL && sort_props_func (key, l->data) > 0;
+           prev = l, l = l->next)
+        ;
+
+      state->keys = g_list_insert_before (state->keys, l, key);
+      g_hash_table_insert (state->key_groups, key,
+                           prev != NULL ? prev->next : state->keys);
+      return;
+    }
+
+  /* the keys for the same object and property are next to each other,
+   * sorted by source state, and there are only as many of them as there
+   * are source states, so we just need to look inside the group
+   */
+  for (l = group; l != NULL; l = l->next)
+    {
+      ClutterStateKey *old_key = l->data;
+      gint res;
+
+      if (!key_group_equal (old_key, key))
+        break;
+
+      res = sort_props_func (key, old_key);
+      if (res == 0)
+        {
+          l->data = key;
+
+          if (l == group)
+            g_hash_table_replace (state->key_groups, key, l);
+
+          clutter_state_key_free (old_key);
+          return;
+        }
+
+      if (res < 0)
+        break;
+    }
+
+  state->keys = g_list_insert_before (state->keys, l, key);
+
+  if (l == group)
+    g_hash_table_replace (state->key_groups, key, group->prev);
+}
+
+/* removes @link from the keys of @state, without freeing the key */
+static void
+state_remove_key_link (State *state,
+                       GList *link)
+{
+  ClutterStateKey *key = link->data;
+
+  if (g_hash_table_lookup (state->key_groups, key) == link)
+    {
+      if (link->next != NULL && key_group_equal (link->next->data, key))
+        g_hash_table_replace (state->key_groups, link->next->data, link->next);
+      else
+        g_hash_table_remove (state->key_groups, key);
+    }
+
+  state->keys = g_list_delete_link (state->keys, link);
+}
+
 static void 
 clutter_state_finalize (GObject *object)
 {
   ClutterStatePrivate *priv = CLUTTER_STATE (object)->priv;
 
   g_hash_table_destroy (priv->states);
+  g_array_unref (priv->frame_keys);
 
   g_object_unref (priv->timeline);
   g_object_unref (priv->slave_timeline);
@@ -544,100 +656,137 @@ clutter_state_completed (ClutterTimeline *timeline,
 }
 
 static void
-clutter_state_new_frame (ClutterTimeline *timeline,
-                         gint             msecs,
-                         ClutterState    *state)
+frame_key_clear (gpointer data)
+{
+  FrameKey *frame_key = data;
+
+  g_value_unset (&frame_key->value);
+}
+
+/* collects the keys of the target state that are applied during the
+ * current transition: for each object and property, the key for the
+ * source state takes precedence over the key without a source state,
+ * which is always the last one of its group
+ */
+static void
+clutter_state_ensure_frame_keys (ClutterState *state)
 {
   ClutterStatePrivate *priv = state->priv;
   GList *k;
-  gdouble progress;
-  const gchar *curprop = NULL;
-  GObject *curobj = NULL;
-  gboolean found_specific = FALSE;
 
-  if (priv->current_animator)
+  if (priv->frame_keys_valid)
     return;
 
-  progress = clutter_timeline_get_progress (timeline);
+  g_array_set_size (priv->frame_keys, 0);
+  priv->frame_keys_valid = TRUE;
+
+  if (priv->target_state == NULL)
+    return;
 
-  for (k = priv->target_state->keys; k; k = k->next)
+  k = priv->target_state->keys;
+  while (k != NULL)
     {
-      ClutterStateKey *key = k->data;
-      gdouble sub_progress;
+      ClutterStateKey *group = k->data;
+      ClutterStateKey *found = NULL;
 
-      if ((curprop && !(curprop == key->property_name)) ||
-          key->object != curobj)
+      for (; k != NULL && key_group_equal (k->data, group); k = k->next)
         {
-          curprop = key->property_name;
-          curobj = key->object;
-          found_specific = FALSE;
-        }
+          ClutterStateKey *key = k->data;
+
+          if (found != NULL)
+            continue;
 
-      if (!found_specific)
-        {
           if (key->source_state != NULL &&
               key->source_state->name != NULL &&
-              priv->source_state_name != NULL && 
+              priv->source_state_name != NULL &&
               g_str_equal (priv->source_state_name, key->source_state->name))
-            {
-              found_specific = TRUE;
-            }
+            found = key;
+          else if (key->source_state == NULL)
+            found = key;
+        }
 
-          if (found_specific || key->source_state == NULL)
-            {
-              gdouble pre_delay = key->pre_delay + key->pre_pre_delay;
+      if (found != NULL)
+        {
+          FrameKey frame_key = { found, G_VALUE_INIT };
 
-              sub_progress = (progress - pre_delay)
-                           / (1.0 - (pre_delay + key->post_delay));
+          g_value_init (&frame_key.value,
+                        clutter_state_key_get_property_type (found));
+          g_array_append_val (priv->frame_keys, frame_key);
+        }
+    }
+}
 
-              if (sub_progress >= 0.0)
-                {
-                  if (sub_progress >= 1.0)
-                    sub_progress = 1.0;
+static void
+clutter_state_new_frame (ClutterTimeline *timeline,
+                         gint             msecs,
+                         ClutterState    *state)
+{
+  ClutterStatePrivate *priv = state->priv;
+  gdouble progress;
+  guint i;
 
-                  clutter_timeline_advance (priv->slave_timeline,
-                                            sub_progress * SLAVE_TIMELINE_LENGTH);
-                  sub_progress = clutter_alpha_get_alpha (key->alpha);
+  if (priv->current_animator)
+    return;
 
-                  if (key->is_animatable)
-                    {
-                      ClutterAnimatable *animatable;
-                      GValue value = G_VALUE_INIT;
-                      gboolean res;
+  progress = clutter_timeline_get_progress (timeline);
 
-                      animatable = CLUTTER_ANIMATABLE (key->object);
+  clutter_state_ensure_frame_keys (state);
 
-                      g_value_init (&value, clutter_state_key_get_property_type (key));
+  for (i = 0; i < priv->frame_keys->len; i++)
+    {
+      FrameKey *frame_key = &g_array_index (priv->frame_keys, FrameKey, i);
+      ClutterStateKey *key = frame_key->key;
+      gdouble pre_delay = key->pre_delay + key->pre_pre_delay;
+      gdouble sub_progress;
 
-                      res =
-                        clutter_animatable_interpolate_value (animatable,
-                                                              key->property_name,
-                                                              key->interval,
-                                                              sub_progress,
-                                                              &value);
+      /* setting the properties might have changed the keys */
+      if (!priv->frame_keys_valid)
+        break;
 
-                      if (res)
-                        clutter_animatable_set_final_state (animatable,
-                                                            key->property_name,
-                                                            &value);
+      sub_progress = (progress - pre_delay)
+                   / (1.0 - (pre_delay + key->post_delay));
 
-                      g_value_unset (&value);
-                    }
-                  else
-                    {
-                      const GValue *value;
+      if (sub_progress >= 0.0)
+        {
+          if (sub_progress >= 1.0)
+            sub_progress = 1.0;
 
-                      value = clutter_interval_compute (key->interval, sub_progress);
-                      if (value != NULL)
-                        g_object_set_property (key->object, key->property_name, value);
-                    }
-                }
+          clutter_timeline_advance (priv->slave_timeline,
+                                    sub_progress * SLAVE_TIMELINE_LENGTH);
+          sub_progress = clutter_alpha_get_alpha (key->alpha);
+
+          if (key->is_animatable)
+            {
+              ClutterAnimatable *animatable;
+              gboolean res;
+
+              animatable = CLUTTER_ANIMATABLE (key->object);
 
-              /* XXX: should the target value of the default destination be
-               * used even when found a specific source_state key?
-               */
+              res =
+                clutter_animatable_interpolate_value (animatable,
+                                                      key->property_name,
+                                                      key->interval,
+                                                      sub_progress,
+                                                      &frame_key->value);
+
+              if (res)
+                clutter_animatable_set_final_state (animatable,
+                                                    key->property_name,
+                                                    &frame_key->value);
+            }
+          else
+            {
+              const GValue *value;
+
+              value = clutter_interval_compute (key->interval, sub_progress);
+              if (value != NULL)
+                g_object_set_property (key->object, key->property_name, value);
             }
         }
+
+      /* XXX: should the target value of the default destination be
+       * used even when found a specific source_state key?
+       */
     }
 }
 
@@ -651,7 +800,7 @@ clutter_state_change (ClutterState *state,
   ClutterAnimator     *animator;
   State               *new_state;
   guint                duration;
-  GList               *k;
+  guint                i;
 
   g_return_val_if_fail (CLUTTER_IS_STATE (state), NULL);
 
@@ -668,6 +817,7 @@ clutter_state_change (ClutterState *state,
 
       priv->source_state_name = priv->target_state_name = NULL;
       priv->source_state = priv->target_state = NULL;
+      priv->frame_keys_valid = FALSE;
 
       clutter_timeline_stop (priv->timeline);
       clutter_timeline_rewind (priv->timeline);
@@ -701,6 +851,7 @@ clutter_state_change (ClutterState *state,
 
   priv->source_state_name = priv->target_state_name;
   priv->target_state_name = target_state_name;
+  priv->frame_keys_valid = FALSE;
 
   g_object_notify_by_pspec (G_OBJECT (state), obj_props[PROP_STATE]);
 
@@ -734,9 +885,12 @@ clutter_state_change (ClutterState *state,
     }
   else
     {
-      for (k = new_state->keys; k != NULL; k = k->next)
+      /* only the keys used by this transition need to be set up */
+      clutter_state_ensure_frame_keys (state);
+
+      for (i = 0; i < priv->frame_keys->len; i++)
         {
-          ClutterStateKey *key = k->data;
+          ClutterStateKey *key = g_array_index (priv->frame_keys, FrameKey, i).key;
           GValue initial = G_VALUE_INIT;
 
           /* Reset the pre-pre-delay - this is only used for setting keys
@@ -1066,21 +1220,11 @@ clutter_state_set_key_internal (ClutterState    *state,
 {
   ClutterStatePrivate *priv = state->priv;
   State *target_state = key->target_state;
-  GList *old_item = NULL;
 
-  if ((old_item = g_list_find_custom (target_state->keys,
-                                      key,
-                                      sort_props_func)))
-    {
-      ClutterStateKey *old_key = old_item->data;
+  state_insert_key (target_state, key);
 
-      target_state->keys = g_list_remove (target_state->keys, old_key);
-      clutter_state_key_free (old_key);
-    }
-
-  target_state->keys = g_list_insert_sorted (target_state->keys,
-                                             key,
-                                             sort_props_func);
+  if (target_state == priv->target_state)
+    priv->frame_keys_valid = FALSE;
 
   /* If the current target state is modified, we have some work to do.
    *
@@ -1531,6 +1675,9 @@ clutter_state_init (ClutterState *self)
                                         NULL,
                                         state_free);
 
+  priv->frame_keys = g_array_new (FALSE, FALSE, sizeof (FrameKey));
+  g_array_set_clear_func (priv->frame_keys, frame_key_clear);
+
   self->priv->source_state_name = NULL;
   self->priv->target_state_name = NULL;
 
@@ -57,6 +57,25 @@
 
 #define AUTOREPEAT_VALUE 2
 
+#define us2ms(us) ((guint32) ((us) / 1000))
+#define ms2us(ms) ((guint64) (ms) * 1000)
+
+/* newer versions of libinput report the time of the events in
+ * microseconds, which we keep in the ClutterEvent
+ */
+#ifdef HAVE_LIBINPUT_TIME_USEC
+#define keyboard_event_get_time_us(e)   libinput_event_keyboard_get_time_usec (e)
+#define pointer_event_get_time_us(e)    libinput_event_pointer_get_time_usec (e)
+#define touch_event_get_time_us(e)      libinput_event_touch_get_time_usec (e)
+#else
+#define keyboard_event_get_time_us(e)   ms2us (libinput_event_keyboard_get_time (e))
+#define pointer_event_get_time_us(e)    ms2us (libinput_event_pointer_get_time (e))
+#define touch_event_get_time_us(e)      ms2us (libinput_event_touch_get_time (e))
+#endif
+
+/* the initial size of the batch of events handed to the stage */
+#define EVENT_BATCH_SIZE 64
+
 /* Try to keep the pointer inside the stage. Hopefully no one is using
  * this backend with stages smaller than this. */
 #define INITIAL_POINTER_X 16
@@ -81,7 +100,10 @@ struct _ClutterSeatEvdev
   ClutterInputDevice *core_pointer;
   ClutterInputDevice *core_keyboard;
 
-  GHashTable *touches;
+  /* the touch points, indexed by libinput slot plus one, since
+   * devices without slots use -1
+   */
+  GPtrArray *touches;
 
   struct xkb_state *xkb;
   xkb_led_index_t caps_lock_led;
@@ -178,6 +200,9 @@ struct _ClutterEventSource
 
   ClutterDeviceManagerEvdev *manager_evdev;
   GPollFD event_poll_fd;
+
+  /* the events read in a single dispatch, reused across dispatches */
+  GPtrArray *batch;
 };
 
 static void
@@ -240,7 +265,7 @@ clutter_seat_evdev_sync_leds (ClutterSeatEvdev *seat);
 
 static void
 notify_key_device (ClutterInputDevice *input_device,
-		   guint32             time_,
+		   guint64             time_us,
 		   guint32             key,
 		   guint32             state,
 		   gboolean            update_keys)
@@ -266,7 +291,8 @@ notify_key_device (ClutterInputDevice *input_device,
 					     stage,
 					     seat->xkb,
 					     seat->button_state,
-					     time_, key, state);
+					     us2ms (time_us), key, state);
+  _clutter_event_set_time_usec (event, time_us);
 
   /* We must be careful and not pass multiple releases to xkb, otherwise it gets
      confused and locks the modifiers */
@@ -333,20 +359,20 @@ static gboolean
 keyboard_repeat (gpointer data)
 {
   ClutterSeatEvdev *seat = data;
-  guint32 time;
+  guint64 time_us;
 
   g_return_val_if_fail (seat->repeat_device != NULL, G_SOURCE_REMOVE);
 
-  time = g_source_get_time (g_main_context_find_source_by_id (NULL, seat->repeat_timer)) / 1000;
+  time_us = g_source_get_time (g_main_context_find_source_by_id (NULL, seat->repeat_timer));
 
-  notify_key_device (seat->repeat_device, time, seat->repeat_key, AUTOREPEAT_VALUE, FALSE);
+  notify_key_device (seat->repeat_device, time_us, seat->repeat_key, AUTOREPEAT_VALUE, FALSE);
 
   return G_SOURCE_CONTINUE;
 }
 
 static void
 notify_absolute_motion (ClutterInputDevice *input_device,
-			guint32             time_,
+			guint64             time_us,
 			gfloat              x,
 			gfloat              y)
 {
@@ -375,7 +401,7 @@ notify_absolute_motion (ClutterInputDevice *input_device,
   if (manager_evdev->priv->constrain_callback)
     {
       manager_evdev->priv->constrain_callback (seat->core_pointer,
-                                               time_, &x, &y,
+                                               us2ms (time_us), &x, &y,
 					       manager_evdev->priv->constrain_data);
     }
   else
@@ -384,7 +410,7 @@ notify_absolute_motion (ClutterInputDevice *input_device,
       y = CLAMP (y, 0.f, stage_height - 1);
     }
 
-  event->motion.time = time_;
+  _clutter_event_set_time_usec (event, time_us);
   event->motion.stage = stage;
   event->motion.device = seat->core_pointer;
   _clutter_xkb_translate_state (event, seat->xkb, seat->button_state);
@@ -400,7 +426,7 @@ notify_absolute_motion (ClutterInputDevice *input_device,
 
 static void
 notify_relative_motion (ClutterInputDevice *input_device,
-                        guint32             time_,
+                        guint64             time_us,
                         double              dx,
                         double              dy)
 {
@@ -421,12 +447,12 @@ notify_relative_motion (ClutterInputDevice *input_device,
   new_x = point.x + dx;
   new_y = point.y + dy;
 
-  notify_absolute_motion (input_device, time_, new_x, new_y);
+  notify_absolute_motion (input_device, time_us, new_x, new_y);
 }
 
 static void
 notify_scroll (ClutterInputDevice *input_device,
-               guint32             time_,
+               guint64             time_us,
                gdouble             dx,
                gdouble             dy)
 {
@@ -448,7 +474,7 @@ notify_scroll (ClutterInputDevice *input_device,
 
   event = clutter_event_new (CLUTTER_SCROLL);
 
-  event->scroll.time = time_;
+  _clutter_event_set_time_usec (event, time_us);
   event->scroll.stage = CLUTTER_STAGE (stage);
   event->scroll.device = seat->core_pointer;
   _clutter_xkb_translate_state (event, seat->xkb, seat->button_state);
@@ -473,7 +499,7 @@ notify_scroll (ClutterInputDevice *input_device,
 
 static void
 notify_button (ClutterInputDevice *input_device,
-               guint32             time_,
+               guint64             time_us,
                guint32             button,
                guint32             state)
 {
@@ -537,7 +563,7 @@ notify_button (ClutterInputDevice *input_device,
   else
     seat->button_state &= ~maskmap[button - BTN_LEFT];
 
-  event->button.time = time_;
+  _clutter_event_set_time_usec (event, time_us);
   event->button.stage = CLUTTER_STAGE (stage);
   event->button.device = seat->core_pointer;
   _clutter_xkb_translate_state (event, seat->xkb, seat->button_state);
@@ -556,7 +582,7 @@ notify_button (ClutterInputDevice *input_device,
 static void
 notify_touch_event (ClutterInputDevice *input_device,
 		    ClutterEventType    evtype,
-		    guint32             time_,
+		    guint64             time_us,
 		    gint32              slot,
 		    gdouble             x,
 		    gdouble             y)
@@ -577,7 +603,7 @@ notify_touch_event (ClutterInputDevice *input_device,
 
   event = clutter_event_new (evtype);
 
-  event->touch.time = time_;
+  _clutter_event_set_time_usec (event, time_us);
   event->touch.stage = CLUTTER_STAGE (stage);
   event->touch.device = seat->core_pointer;
   event->touch.x = x;
@@ -605,6 +631,20 @@ dispatch_libinput (ClutterDeviceManagerEvdev *manager_evdev)
   process_events (manager_evdev);
 }
 
+static void
+queue_event_batch (ClutterEventSource *source,
+                   ClutterStage       *stage)
+{
+  GPtrArray *batch = source->batch;
+
+  if (batch->len == 0)
+    return;
+
+  /* forward the events into clutter for emission etc. */
+  _clutter_stage_queue_events (stage, (ClutterEvent **) batch->pdata, batch->len);
+  g_ptr_array_set_size (batch, 0);
+}
+
 static gboolean
 clutter_event_dispatch (GSource     *g_source,
                         GSourceFunc  callback,
@@ -612,51 +652,65 @@ clutter_event_dispatch (GSource     *g_source,
 {
   ClutterEventSource *source = (ClutterEventSource *) g_source;
   ClutterDeviceManagerEvdev *manager_evdev;
+  ClutterStage *batch_stage = NULL;
   ClutterEvent *event;
+  gboolean queued = FALSE;
+  GSList *l;
 
   _clutter_threads_acquire_lock ();
 
   manager_evdev = source->manager_evdev;
 
-  /* Don't queue more events if we haven't finished handling the previous batch
-   */
-  if (clutter_events_pending ())
-    goto queue_event;
-
   dispatch_libinput (manager_evdev);
 
- queue_event:
-  event = clutter_event_get ();
-
-  if (event)
+  /* hand all the pending events to the stages at once; consecutive
+   * events for the same stage are queued as a single batch
+   */
+  while ((event = clutter_event_get ()) != NULL)
     {
-      ClutterModifierType event_state;
       ClutterInputDevice *input_device =
         clutter_event_get_source_device (event);
-      ClutterInputDeviceEvdev *device_evdev =
-        CLUTTER_INPUT_DEVICE_EVDEV (input_device);
-      ClutterSeatEvdev *seat =
-        _clutter_input_device_evdev_get_seat (device_evdev);
 
       /* Drop events if we don't have any stage to forward them to */
-      if (!_clutter_input_device_get_stage (input_device))
-        goto out;
+      if (input_device == NULL ||
+          !_clutter_input_device_get_stage (input_device))
+        {
+          clutter_event_free (event);
+          continue;
+        }
+
+      if (event->any.stage != batch_stage)
+        {
+          queue_event_batch (source, batch_stage);
+          batch_stage = event->any.stage;
+        }
+
+      g_ptr_array_add (source->batch, event);
+      queued = TRUE;
+    }
+
+  queue_event_batch (source, batch_stage);
 
-      /* forward the event into clutter for emission etc. */
-      _clutter_stage_queue_event (event->any.stage, event, FALSE);
+  /* update the device states *after* the events */
+  if (queued)
+    {
+      for (l = manager_evdev->priv->seats; l != NULL; l = l->next)
+        {
+          ClutterSeatEvdev *seat = l->data;
+          ClutterModifierType event_state;
 
-      /* update the device states *after* the event */
-      event_state = seat->button_state |
-        xkb_state_serialize_mods (seat->xkb, XKB_STATE_MODS_EFFECTIVE);
-      _clutter_input_device_set_state (seat->core_pointer, event_state);
-      _clutter_input_device_set_state (seat->core_keyboard, event_state);
+          event_state = seat->button_state |
+            xkb_state_serialize_mods (seat->xkb, XKB_STATE_MODS_EFFECTIVE);
+          _clutter_input_device_set_state (seat->core_pointer, event_state);
+          _clutter_input_device_set_state (seat->core_keyboard, event_state);
+        }
     }
 
-out:
   _clutter_threads_release_lock ();
 
   return TRUE;
 }
+
 static GSourceFuncs event_funcs = {
   clutter_event_prepare,
   clutter_event_check,
@@ -677,6 +731,7 @@ clutter_event_source_new (ClutterDeviceManagerEvdev *manager_evdev)
 
   /* setup the source */
   event_source->manager_evdev = manager_evdev;
+  event_source->batch = g_ptr_array_sized_new (EVENT_BATCH_SIZE);
 
   fd = libinput_get_fd (priv->libinput);
   event_source->event_poll_fd.fd = fd;
@@ -702,6 +757,8 @@ clutter_event_source_free (ClutterEventSource *source)
    * about it */
   close (source->event_poll_fd.fd);
 
+  g_ptr_array_unref (source->batch);
+
   g_source_destroy (g_source);
   g_source_unref (g_source);
 }
@@ -751,8 +808,8 @@ clutter_seat_evdev_new (ClutterDeviceManagerEvdev *manager_evdev)
   _clutter_device_manager_add_device (manager, device);
   seat->core_keyboard = device;
 
-  seat->touches = g_hash_table_new_full (NULL, NULL, NULL,
-                                         (GDestroyNotify) clutter_touch_state_free);
+  seat->touches =
+    g_ptr_array_new_with_free_func ((GDestroyNotify) clutter_touch_state_free);
 
   ctx = xkb_context_new(0);
   g_assert (ctx);
@@ -799,7 +856,7 @@ clutter_seat_evdev_free (ClutterSeatEvdev *seat)
       g_object_unref (device);
     }
   g_slist_free (seat->devices);
-  g_hash_table_unref (seat->touches);
+  g_ptr_array_unref (seat->touches);
 
   xkb_state_unref (seat->xkb);
 
@@ -1073,11 +1130,19 @@ _device_seat_add_touch (ClutterInputDevice *input_device,
     CLUTTER_INPUT_DEVICE_EVDEV (input_device);
   ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
   ClutterTouchState *touch;
+  guint index = id + 1;
 
-  touch = g_slice_new0 (ClutterTouchState);
-  touch->id = id;
+  if (index >= seat->touches->len)
+    g_ptr_array_set_size (seat->touches, index + 1);
 
-  g_hash_table_insert (seat->touches, GUINT_TO_POINTER (id), touch);
+  touch = g_ptr_array_index (seat->touches, index);
+  if (touch == NULL)
+    {
+      touch = g_slice_new0 (ClutterTouchState);
+      g_ptr_array_index (seat->touches, index) = touch;
+    }
+
+  touch->id = id;
 
   return touch;
 }
@@ -1089,8 +1154,13 @@ _device_seat_remove_touch (ClutterInputDevice *input_device,
   ClutterInputDeviceEvdev *device_evdev =
     CLUTTER_INPUT_DEVICE_EVDEV (input_device);
   ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
+  guint index = id + 1;
 
-  g_hash_table_remove (seat->touches, GUINT_TO_POINTER (id));
+  if (index < seat->touches->len)
+    {
+      g_clear_pointer (&g_ptr_array_index (seat->touches, index),
+                       clutter_touch_state_free);
+    }
 }
 
 static ClutterTouchState *
@@ -1100,8 +1170,12 @@ _device_seat_get_touch (ClutterInputDevice *input_device,
   ClutterInputDeviceEvdev *device_evdev =
     CLUTTER_INPUT_DEVICE_EVDEV (input_device);
   ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
+  guint index = id + 1;
 
-  return g_hash_table_lookup (seat->touches, GUINT_TO_POINTER (id));
+  if (index >= seat->touches->len)
+    return NULL;
+
+  return g_ptr_array_index (seat->touches, index);
 }
 
 static gboolean
@@ -1116,39 +1190,40 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
     {
     case LIBINPUT_EVENT_KEYBOARD_KEY:
       {
-        guint32 time, key, key_state;
+        guint64 time_us;
+        guint32 key, key_state;
         struct libinput_event_keyboard *key_event =
           libinput_event_get_keyboard_event (event);
         device = libinput_device_get_user_data (libinput_device);
 
-        time = libinput_event_keyboard_get_time (key_event);
+        time_us = keyboard_event_get_time_us (key_event);
         key = libinput_event_keyboard_get_key (key_event);
         key_state = libinput_event_keyboard_get_key_state (key_event) ==
                     LIBINPUT_KEY_STATE_PRESSED;
-        notify_key_device (device, time, key, key_state, TRUE);
+        notify_key_device (device, time_us, key, key_state, TRUE);
 
         break;
       }
 
     case LIBINPUT_EVENT_POINTER_MOTION:
       {
-        guint32 time;
+        guint64 time_us;
         double dx, dy;
         struct libinput_event_pointer *motion_event =
           libinput_event_get_pointer_event (event);
         device = libinput_device_get_user_data (libinput_device);
 
-        time = libinput_event_pointer_get_time (motion_event);
+        time_us = pointer_event_get_time_us (motion_event);
         dx = libinput_event_pointer_get_dx (motion_event);
         dy = libinput_event_pointer_get_dy (motion_event);
-        notify_relative_motion (device, time, dx, dy);
+        notify_relative_motion (device, time_us, dx, dy);
 
         break;
       }
 
     case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
       {
-        guint32 time;
+        guint64 time_us;
         double x, y;
         gfloat stage_width, stage_height;
         ClutterStage *stage;
@@ -1163,28 +1238,29 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
         stage_width = clutter_actor_get_width (CLUTTER_ACTOR (stage));
         stage_height = clutter_actor_get_height (CLUTTER_ACTOR (stage));
 
-        time = libinput_event_pointer_get_time (motion_event);
+        time_us = pointer_event_get_time_us (motion_event);
         x = libinput_event_pointer_get_absolute_x_transformed (motion_event,
                                                                stage_width);
         y = libinput_event_pointer_get_absolute_y_transformed (motion_event,
                                                                stage_height);
-        notify_absolute_motion (device, time, x, y);
+        notify_absolute_motion (device, time_us, x, y);
 
         break;
       }
 
     case LIBINPUT_EVENT_POINTER_BUTTON:
       {
-        guint32 time, button, button_state;
+        guint64 time_us;
+        guint32 button, button_state;
         struct libinput_event_pointer *button_event =
           libinput_event_get_pointer_event (event);
         device = libinput_device_get_user_data (libinput_device);
 
-        time = libinput_event_pointer_get_time (button_event);
+        time_us = pointer_event_get_time_us (button_event);
         button = libinput_event_pointer_get_button (button_event);
         button_state = libinput_event_pointer_get_button_state (button_event) ==
                        LIBINPUT_BUTTON_STATE_PRESSED;
-        notify_button (device, time, button, button_state);
+        notify_button (device, time_us, button, button_state);
 
         break;
       }
@@ -1192,13 +1268,13 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
     case LIBINPUT_EVENT_POINTER_AXIS:
       {
         gdouble value, dx = 0.0, dy = 0.0;
-        guint32 time;
+        guint64 time_us;
         enum libinput_pointer_axis axis;
         struct libinput_event_pointer *axis_event =
           libinput_event_get_pointer_event (event);
         device = libinput_device_get_user_data (libinput_device);
 
-        time = libinput_event_pointer_get_time (axis_event);
+        time_us = pointer_event_get_time_us (axis_event);
         value = libinput_event_pointer_get_axis_value (axis_event);
         axis = libinput_event_pointer_get_axis (axis_event);
 
@@ -1216,7 +1292,7 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
 
           }
 
-        notify_scroll (device, time, dx, dy);
+        notify_scroll (device, time_us, dx, dy);
         break;
 
       }
@@ -1224,7 +1300,7 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
     case LIBINPUT_EVENT_TOUCH_DOWN:
       {
         gint32 slot;
-        guint32 time;
+        guint64 time_us;
         double x, y;
         gfloat stage_width, stage_height;
         ClutterStage *stage;
@@ -1241,7 +1317,7 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
         stage_height = clutter_actor_get_height (CLUTTER_ACTOR (stage));
 
         slot = libinput_event_touch_get_slot (touch_event);
-        time = libinput_event_touch_get_time (touch_event);
+        time_us = touch_event_get_time_us (touch_event);
         x = libinput_event_touch_get_x_transformed (touch_event,
                                                     stage_width);
         y = libinput_event_touch_get_y_transformed (touch_event,
@@ -1251,7 +1327,7 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
         touch_state->coords.x = x;
         touch_state->coords.y = y;
 
-        notify_touch_event (device, CLUTTER_TOUCH_BEGIN, time, slot,
+        notify_touch_event (device, CLUTTER_TOUCH_BEGIN, time_us, slot,
                              touch_state->coords.x, touch_state->coords.y);
         break;
       }
@@ -1259,17 +1335,17 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
     case LIBINPUT_EVENT_TOUCH_UP:
       {
         gint32 slot;
-        guint32 time;
+        guint64 time_us;
         ClutterTouchState *touch_state;
         struct libinput_event_touch *touch_event =
           libinput_event_get_touch_event (event);
         device = libinput_device_get_user_data (libinput_device);
 
         slot = libinput_event_touch_get_slot (touch_event);
-        time = libinput_event_touch_get_time (touch_event);
+        time_us = touch_event_get_time_us (touch_event);
         touch_state = _device_seat_get_touch (device, slot);
 
-        notify_touch_event (device, CLUTTER_TOUCH_END, time, slot,
+        notify_touch_event (device, CLUTTER_TOUCH_END, time_us, slot,
 			    touch_state->coords.x, touch_state->coords.y);
         _device_seat_remove_touch (device, slot);
 
@@ -1279,7 +1355,7 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
     case LIBINPUT_EVENT_TOUCH_MOTION:
       {
         gint32 slot;
-        guint32 time;
+        guint64 time_us;
         double x, y;
         gfloat stage_width, stage_height;
         ClutterStage *stage;
@@ -1296,7 +1372,7 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
         stage_height = clutter_actor_get_height (CLUTTER_ACTOR (stage));
 
         slot = libinput_event_touch_get_slot (touch_event);
-        time = libinput_event_touch_get_time (touch_event);
+        time_us = touch_event_get_time_us (touch_event);
         x = libinput_event_touch_get_x_transformed (touch_event,
                                                     stage_width);
         y = libinput_event_touch_get_y_transformed (touch_event,
@@ -1306,32 +1382,37 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
         touch_state->coords.x = x;
         touch_state->coords.y = y;
 
-        notify_touch_event (device, CLUTTER_TOUCH_UPDATE, time, slot,
+        notify_touch_event (device, CLUTTER_TOUCH_UPDATE, time_us, slot,
 			    touch_state->coords.x, touch_state->coords.y);
         break;
       }
     case LIBINPUT_EVENT_TOUCH_CANCEL:
       {
-        ClutterTouchState *touch_state;
-        GHashTableIter iter;
-        guint32 time;
+        guint64 time_us;
+        guint i;
         struct libinput_event_touch *touch_event =
           libinput_event_get_touch_event (event);
         ClutterSeatEvdev *seat;
 
         device = libinput_device_get_user_data (libinput_device);
-        time = libinput_event_touch_get_time (touch_event);
+        time_us = touch_event_get_time_us (touch_event);
         seat = _clutter_input_device_evdev_get_seat (CLUTTER_INPUT_DEVICE_EVDEV (device));
-        g_hash_table_iter_init (&iter, seat->touches);
 
-        while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &touch_state))
+        for (i = 0; i < seat->touches->len; i++)
           {
+            ClutterTouchState *touch_state =
+              g_ptr_array_index (seat->touches, i);
+
+            if (touch_state == NULL)
+              continue;
+
             notify_touch_event (device, CLUTTER_TOUCH_CANCEL,
-                                time, touch_state->id,
+                                time_us, touch_state->id,
                                 touch_state->coords.x, touch_state->coords.y);
-            g_hash_table_iter_remove (&iter);
           }
 
+        g_ptr_array_set_size (seat->touches, 0);
+
         break;
       }
     default:
@@ -2080,5 +2161,5 @@ clutter_evdev_warp_pointer (ClutterInputDevice   *pointer_device,
                             int                   x,
                             int                   y)
 {
-  notify_absolute_motion (pointer_device, time_, x, y);
+  notify_absolute_motion (pointer_device, ms2us (time_), x, y);
 }
@@ -42,6 +42,9 @@
 
 #if 0
 /* XEMBED protocol support for toolkit embedding */
+/* the events handed to a stage at once by the event source */
+#define EVENT_BATCH_SIZE                64
+
 #define XEMBED_MAPPED                   (1 << 0)
 #define MAX_SUPPORTED_XEMBED_VERSION    1
 
@@ -307,7 +310,10 @@ clutter_event_dispatch (GSource     *source,
                         gpointer     user_data)
 {
   ClutterBackendX11 *backend = ((ClutterEventSource *) source)->backend;
+  ClutterEvent *batch[EVENT_BATCH_SIZE];
+  ClutterStage *batch_stage = NULL;
   ClutterEvent *event;
+  guint n_batched = 0;
 
   _clutter_threads_acquire_lock ();
 
@@ -316,14 +322,33 @@ clutter_event_dispatch (GSource     *source,
   */
   events_queue (backend);
 
-  /* Pop an event off the queue if any */
-  event = clutter_event_get ();
-  if (event != NULL)
+  /* forward the pending events into clutter for emission etc.; this
+   * also includes the events added with clutter_event_put(), and the
+   * consecutive events for the same stage are queued as a single batch
+   */
+  while ((event = clutter_event_get ()) != NULL)
     {
-      /* forward the event into clutter for emission etc. */
-      _clutter_stage_queue_event (event->any.stage, event, FALSE);
+      if (event->any.stage == NULL)
+        {
+          clutter_event_free (event);
+          continue;
+        }
+
+      if (event->any.stage != batch_stage || n_batched == EVENT_BATCH_SIZE)
+        {
+          if (n_batched > 0)
+            _clutter_stage_queue_events (batch_stage, batch, n_batched);
+
+          batch_stage = event->any.stage;
+          n_batched = 0;
+        }
+
+      batch[n_batched++] = event;
     }
 
+  if (n_batched > 0)
+    _clutter_stage_queue_events (batch_stage, batch, n_batched);
+
   _clutter_threads_release_lock ();
 
   return TRUE;
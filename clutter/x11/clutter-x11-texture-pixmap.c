@@ -121,6 +121,13 @@ struct _ClutterX11TexturePixmapPrivate
 
   Damage        damage;
 
+  /* the damage accumulated since the last frame, in pixmap coordinates;
+   * it is flushed by a repaint function right before the stage update
+   */
+  cairo_rectangle_int_t pending_damage;
+  guint                 n_pending_damage;
+  guint                 damage_flush_id;
+
   gint          window_x, window_y;
   gint          window_width, window_height;
 
@@ -160,18 +167,112 @@ check_extensions (ClutterX11TexturePixmap *texture)
   return TRUE;
 }
 
+static gboolean
+flush_pending_damage (gpointer data)
+{
+  ClutterX11TexturePixmap *texture = data;
+  ClutterX11TexturePixmapPrivate *priv = texture->priv;
+  cairo_rectangle_int_t damage = priv->pending_damage;
+
+  /* the texture was disposed after the repaint functions were
+   * taken out of the list to be run
+   */
+  if (priv->damage_flush_id == 0)
+    return G_SOURCE_REMOVE;
+
+  CLUTTER_NOTE (TEXTURE, "Flushing %u damaged areas: %d, %d - %d x %d",
+                priv->n_pending_damage,
+                damage.x, damage.y,
+                damage.width, damage.height);
+
+  priv->damage_flush_id = 0;
+  priv->n_pending_damage = 0;
+
+  /* the stage keeps a single clip for each actor queueing a redraw,
+   * so we queue one redraw for the bounding box of all the damage
+   * instead of one for each damaged area
+   */
+  g_signal_emit (texture, signals[QUEUE_DAMAGE_REDRAW],
+                 0,
+                 damage.x,
+                 damage.y,
+                 damage.width,
+                 damage.height);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+add_pending_damage (ClutterX11TexturePixmap *texture,
+                    gint                     x,
+                    gint                     y,
+                    gint                     width,
+                    gint                     height)
+{
+  ClutterX11TexturePixmapPrivate *priv = texture->priv;
+  cairo_rectangle_int_t *damage = &priv->pending_damage;
+
+  if (width <= 0 || height <= 0)
+    return;
+
+  if (priv->n_pending_damage == 0)
+    {
+      damage->x = x;
+      damage->y = y;
+      damage->width = width;
+      damage->height = height;
+    }
+  else
+    {
+      gint x2 = MAX (damage->x + damage->width, x + width);
+      gint y2 = MAX (damage->y + damage->height, y + height);
+
+      damage->x = MIN (damage->x, x);
+      damage->y = MIN (damage->y, y);
+      damage->width = x2 - damage->x;
+      damage->height = y2 - damage->y;
+    }
+
+  priv->n_pending_damage += 1;
+
+  if (priv->damage_flush_id == 0)
+    {
+      priv->damage_flush_id =
+        clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT |
+                                               CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD,
+                                               flush_pending_damage,
+                                               g_object_ref (texture),
+                                               g_object_unref);
+    }
+}
+
+static void
+clear_pending_damage (ClutterX11TexturePixmap *texture)
+{
+  ClutterX11TexturePixmapPrivate *priv = texture->priv;
+
+  if (priv->damage_flush_id != 0)
+    {
+      clutter_threads_remove_repaint_func (priv->damage_flush_id);
+      priv->damage_flush_id = 0;
+    }
+
+  priv->n_pending_damage = 0;
+}
+
 static void
 process_damage_event (ClutterX11TexturePixmap *texture,
                       XDamageNotifyEvent *damage_event)
 {
   /* Cogl will deal with updating the texture and subtracting from the
-     damage region so we only need to queue a redraw */
-  g_signal_emit (texture, signals[QUEUE_DAMAGE_REDRAW],
-                 0,
-                 damage_event->area.x,
-                 damage_event->area.y,
-                 damage_event->area.width,
-                 damage_event->area.height);
+     damage region so we only need to queue a redraw; busy clients can
+     send many damage events for each frame, so we accumulate them and
+     queue the redraw once before the next paint */
+  add_pending_damage (texture,
+                      damage_event->area.x,
+                      damage_event->area.y,
+                      damage_event->area.width,
+                      damage_event->area.height);
 }
 
 static ClutterX11FilterReturn
@@ -395,6 +496,8 @@ clutter_x11_texture_pixmap_init (ClutterX11TexturePixmap *self)
 
   self->priv->automatic_updates = FALSE;
   self->priv->damage = None;
+  self->priv->damage_flush_id = 0;
+  self->priv->n_pending_damage = 0;
   self->priv->window = None;
   self->priv->pixmap = None;
   self->priv->pixmap_height = 0;
@@ -413,6 +516,7 @@ clutter_x11_texture_pixmap_dispose (GObject *object)
   ClutterX11TexturePixmap *texture = CLUTTER_X11_TEXTURE_PIXMAP (object);
 
   free_damage_resources (texture);
+  clear_pending_damage (texture);
 
   clutter_x11_remove_filter (on_x_event_filter_too, (gpointer)texture);
   clutter_x11_texture_pixmap_set_pixmap (texture, None);
@@ -682,6 +786,10 @@ clutter_x11_texture_pixmap_class_init (ClutterX11TexturePixmapClass *klass)
    * clutter_x11_texture_pixmap_update_area). This usually means a
    * redraw needs to be queued for the actor.
    *
+   * The signal is emitted at most once per frame, right before the
+   * stage is updated, with the bounding box of all the sub-regions
+   * that changed since the previous frame.
+   *
    * The default handler will queue a clipped redraw in response to
    * the damage, using the assumption that the pixmap is being painted
    * to a rectangle covering the transformed allocation of the actor.
@@ -855,6 +963,9 @@ clutter_x11_texture_pixmap_set_pixmap (ClutterX11TexturePixmap *texture,
       priv->pixmap = pixmap;
       new_pixmap = TRUE;
 
+      /* the damage accumulated so far refers to the old pixmap */
+      clear_pending_damage (texture);
+
       /* The damage object is created on the pixmap, so it needs to be
        * recreated with a change in pixmap.
        */
@@ -982,6 +1093,9 @@ clutter_x11_texture_pixmap_set_window (ClutterX11TexturePixmap *texture,
       clutter_x11_texture_pixmap_set_pixmap (texture, None);
     }
 
+  /* the damage accumulated so far refers to the old window */
+  clear_pending_damage (texture);
+
   priv->window = window;
   priv->window_redirect_automatic = automatic;
   priv->window_mapped = FALSE;
@@ -1232,9 +1346,9 @@ clutter_x11_texture_pixmap_update_area (ClutterX11TexturePixmap *texture,
 
   /* The default handler for the "queue-damage-redraw" signal is
    * clutter_x11_texture_pixmap_real_queue_damage_redraw which will queue a
-   * clipped redraw. */
-  g_signal_emit (texture, signals[QUEUE_DAMAGE_REDRAW],
-                 0, x, y, width, height);
+   * clipped redraw; the signal is emitted once per frame, for all the
+   * areas updated since the previous one. */
+  add_pending_damage (texture, x, y, width, height);
 }
 
 /**
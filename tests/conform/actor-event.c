@@ -0,0 +1,221 @@
+#include <clutter/clutter.h>
+
+typedef enum {
+  ACTION_NONE,
+  ACTION_DESTROY,
+  ACTION_EMIT
+} Action;
+
+typedef struct {
+  /* the stage, followed by the ancestors of the source */
+  ClutterActor *actors[4];
+  GString *log;
+
+  /* what to do, from which handler */
+  Action action;
+  ClutterActor *trigger;
+  gboolean trigger_capture;
+  ClutterActor *victim;
+
+  guint n_delivered;
+} EventData;
+
+static const char *names[] = { "stage", "a", "b", "c" };
+
+static const char *
+get_name (EventData    *data,
+          ClutterActor *actor)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (data->actors); i++)
+    if (data->actors[i] == actor)
+      return names[i];
+
+  g_assert_not_reached ();
+
+  return NULL;
+}
+
+static void
+record_event (EventData    *data,
+              ClutterActor *actor,
+              ClutterEvent *event,
+              gboolean      capture)
+{
+  g_string_append_printf (data->log, "%s%s:%s",
+                          data->log->len > 0 ? " " : "",
+                          get_name (data, actor),
+                          capture ? "capture" : "bubble");
+
+  if (actor == data->trigger && capture == data->trigger_capture)
+    {
+      switch (data->action)
+        {
+        case ACTION_DESTROY:
+          clutter_actor_destroy (data->victim);
+          break;
+
+        case ACTION_EMIT:
+          /* events emitted from a handler are queued, and delivered
+           * after the current one, with an event chain of their own
+           */
+          clutter_do_event (event);
+          break;
+
+        case ACTION_NONE:
+          break;
+        }
+
+      data->action = ACTION_NONE;
+    }
+
+  if (actor == data->actors[0] && !capture)
+    data->n_delivered += 1;
+}
+
+static gboolean
+on_captured_event (ClutterActor *actor,
+                   ClutterEvent *event,
+                   EventData    *data)
+{
+  record_event (data, actor, event, TRUE);
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static gboolean
+on_event (ClutterActor *actor,
+          ClutterEvent *event,
+          EventData    *data)
+{
+  record_event (data, actor, event, FALSE);
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static void
+emit_event (EventData *data,
+            guint      n_events)
+{
+  ClutterEvent *event;
+
+  /* the source is set, so no picking is involved */
+  event = clutter_event_new (CLUTTER_KEY_PRESS);
+  clutter_event_set_stage (event, CLUTTER_STAGE (data->actors[0]));
+  clutter_event_set_source (event, data->actors[3]);
+  clutter_event_set_key_symbol (event, CLUTTER_KEY_a);
+
+  clutter_do_event (event);
+  clutter_event_free (event);
+
+  while (data->n_delivered < n_events)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+check_event_chain (Action       action,
+                   guint        trigger,
+                   gboolean     trigger_capture,
+                   guint        victim,
+                   guint        n_events,
+                   const char  *expected)
+{
+  EventData data = { { NULL, }, };
+  ClutterActor *victim_actor;
+  guint i;
+
+  data.actors[0] = clutter_test_get_stage ();
+  data.log = g_string_new (NULL);
+
+  for (i = 1; i < G_N_ELEMENTS (data.actors); i++)
+    {
+      data.actors[i] = clutter_actor_new ();
+      clutter_actor_add_child (data.actors[i - 1], data.actors[i]);
+    }
+
+  for (i = 0; i < G_N_ELEMENTS (data.actors); i++)
+    {
+      g_signal_connect (data.actors[i], "captured-event",
+                        G_CALLBACK (on_captured_event),
+                        &data);
+      g_signal_connect (data.actors[i], "event",
+                        G_CALLBACK (on_event),
+                        &data);
+    }
+
+  data.action = action;
+  data.trigger = data.actors[trigger];
+  data.trigger_capture = trigger_capture;
+  data.victim = data.actors[victim];
+
+  /* the actors are only referenced by their parents */
+  victim_actor = data.victim;
+  if (action == ACTION_DESTROY)
+    g_object_add_weak_pointer (G_OBJECT (victim_actor),
+                               (gpointer *) &victim_actor);
+
+  clutter_actor_show (data.actors[0]);
+  emit_event (&data, n_events);
+
+  if (g_test_verbose ())
+    g_print ("Event chain: %s\n", data.log->str);
+
+  g_assert_cmpstr (data.log->str, ==, expected);
+  g_assert_cmpuint (data.n_delivered, ==, n_events);
+
+  /* the destroyed actors are released at the end of the emission */
+  if (action == ACTION_DESTROY)
+    g_assert_null (victim_actor);
+
+  g_signal_handlers_disconnect_by_data (data.actors[0], &data);
+  clutter_actor_destroy_all_children (data.actors[0]);
+
+  g_string_free (data.log, TRUE);
+}
+
+static void
+actor_event_destroy_ancestor (void)
+{
+  /* the destroyed actors do not receive the event any more, but the
+   * rest of the chain does
+   */
+  check_event_chain (ACTION_DESTROY, 3, TRUE, 1, 1,
+                     "stage:capture a:capture b:capture c:capture "
+                     "stage:bubble");
+  check_event_chain (ACTION_DESTROY, 2, FALSE, 1, 1,
+                     "stage:capture a:capture b:capture c:capture "
+                     "c:bubble b:bubble stage:bubble");
+}
+
+static void
+actor_event_destroy_source (void)
+{
+  check_event_chain (ACTION_DESTROY, 0, TRUE, 3, 1,
+                     "stage:capture a:capture b:capture "
+                     "b:bubble a:bubble stage:bubble");
+  check_event_chain (ACTION_DESTROY, 3, FALSE, 3, 1,
+                     "stage:capture a:capture b:capture c:capture "
+                     "c:bubble b:bubble a:bubble stage:bubble");
+}
+
+static void
+actor_event_emit_nested (void)
+{
+  check_event_chain (ACTION_EMIT, 2, TRUE, 0, 2,
+                     "stage:capture a:capture b:capture c:capture "
+                     "c:bubble b:bubble a:bubble stage:bubble "
+                     "stage:capture a:capture b:capture c:capture "
+                     "c:bubble b:bubble a:bubble stage:bubble");
+  check_event_chain (ACTION_EMIT, 1, FALSE, 0, 2,
+                     "stage:capture a:capture b:capture c:capture "
+                     "c:bubble b:bubble a:bubble stage:bubble "
+                     "stage:capture a:capture b:capture c:capture "
+                     "c:bubble b:bubble a:bubble stage:bubble");
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/event/destroy-ancestor", actor_event_destroy_ancestor)
+  CLUTTER_TEST_UNIT ("/actor/event/destroy-source", actor_event_destroy_source)
+  CLUTTER_TEST_UNIT ("/actor/event/emit-nested", actor_event_emit_nested)
+)
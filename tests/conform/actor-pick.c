@@ -282,6 +282,148 @@ actor_pick (void)
   g_assert (state.pass);
 }
 
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *left;
+  ClutterActor *right;
+  guint n_paints;
+  gboolean pass;
+} CacheState;
+
+static void
+check_pick (CacheState      *state,
+            ClutterPickMode  mode,
+            gfloat           x,
+            gfloat           y,
+            ClutterActor    *expected)
+{
+  ClutterActorBox box;
+  ClutterActor *actor;
+
+  /* apply the pending layout changes, without painting the stage */
+  clutter_actor_get_allocation_box (state->stage, &box);
+
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
+                                          mode, x, y);
+
+  if (g_test_verbose ())
+    g_print ("%4.0f,%4.0f -> %p (expected %p): %s\n",
+             x, y, actor, expected,
+             actor == expected ? "pass" : "FAIL");
+
+  if (actor != expected)
+    state->pass = FALSE;
+}
+
+static void
+on_after_paint (ClutterStage *stage,
+                CacheState   *state)
+{
+  state->n_paints += 1;
+}
+
+static gboolean
+on_cache_idle (gpointer data)
+{
+  CacheState *state = data;
+
+  state->n_paints = 0;
+  g_signal_connect (state->stage, "after-paint",
+                    G_CALLBACK (on_after_paint),
+                    state);
+
+  /* the second pick at the same position is answered by the cache */
+  check_pick (state, CLUTTER_PICK_REACTIVE, 50, 50, state->left);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 50, 50, state->left);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 250, 250, state->stage);
+
+  if (g_test_verbose ())
+    g_print ("Moving the actor:\n");
+
+  clutter_actor_set_position (state->left, 200, 200);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 50, 50, state->stage);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 250, 250, state->left);
+
+  if (g_test_verbose ())
+    g_print ("Hiding the actor:\n");
+
+  clutter_actor_hide (state->left);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 250, 250, state->stage);
+
+  clutter_actor_show (state->left);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 250, 250, state->left);
+
+  if (g_test_verbose ())
+    g_print ("Making the actor not reactive:\n");
+
+  clutter_actor_set_reactive (state->left, FALSE);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 250, 250, state->stage);
+  check_pick (state, CLUTTER_PICK_ALL, 250, 250, state->left);
+
+  clutter_actor_set_reactive (state->left, TRUE);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 250, 250, state->left);
+
+  if (g_test_verbose ())
+    g_print ("Resizing the stage:\n");
+
+  /* the right actor is aligned to the right edge of the stage */
+  check_pick (state, CLUTTER_PICK_REACTIVE, 350, 50, state->stage);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 590, 50, state->right);
+
+  clutter_actor_set_size (state->stage, 400, STAGE_HEIGHT);
+  check_pick (state, CLUTTER_PICK_REACTIVE, 350, 50, state->right);
+
+  g_signal_handlers_disconnect_by_func (state->stage, on_after_paint, state);
+
+  if (state->n_paints != 0)
+    {
+      if (g_test_verbose ())
+        g_print ("The stage was painted %u times\n", state->n_paints);
+
+      state->pass = FALSE;
+    }
+
+  clutter_main_quit ();
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+actor_pick_cache (void)
+{
+  CacheState state;
+
+  state.pass = TRUE;
+
+  state.stage = clutter_test_get_stage ();
+  clutter_actor_set_size (state.stage, STAGE_WIDTH, STAGE_HEIGHT);
+
+  state.left = clutter_actor_new ();
+  clutter_actor_set_background_color (state.left, CLUTTER_COLOR_Red);
+  clutter_actor_set_size (state.left, 100, 100);
+  clutter_actor_set_reactive (state.left, TRUE);
+  clutter_actor_add_child (state.stage, state.left);
+
+  state.right = clutter_actor_new ();
+  clutter_actor_set_background_color (state.right, CLUTTER_COLOR_Blue);
+  clutter_actor_set_size (state.right, 100, 100);
+  clutter_actor_set_reactive (state.right, TRUE);
+  clutter_actor_add_constraint (state.right,
+                                clutter_align_constraint_new (state.stage,
+                                                              CLUTTER_ALIGN_X_AXIS,
+                                                              1.0));
+  clutter_actor_add_child (state.stage, state.right);
+
+  clutter_actor_show (state.stage);
+
+  clutter_threads_add_idle (on_cache_idle, &state);
+
+  clutter_main ();
+
+  g_assert (state.pass);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/pick", actor_pick)
+  CLUTTER_TEST_UNIT ("/actor/pick/cache", actor_pick_cache)
 )
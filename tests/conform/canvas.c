@@ -0,0 +1,192 @@
+#include <clutter/clutter.h>
+
+#define CANVAS_SIZE     64
+
+typedef struct {
+  GMutex lock;
+  GCond cond;
+
+  /* protected by lock */
+  ClutterColor color;
+  gboolean blocked;
+  guint n_draws;
+
+  /* only used by the main thread */
+  guint n_finished;
+} CanvasData;
+
+static gboolean
+on_draw (ClutterCanvas *canvas,
+         cairo_t       *cr,
+         int            width,
+         int            height,
+         CanvasData    *data)
+{
+  ClutterColor color;
+
+  g_mutex_lock (&data->lock);
+
+  /* the color is the one set when the draw started */
+  color = data->color;
+  data->n_draws += 1;
+  g_cond_broadcast (&data->cond);
+
+  while (data->blocked)
+    g_cond_wait (&data->cond, &data->lock);
+
+  g_mutex_unlock (&data->lock);
+
+  clutter_cairo_set_source_color (cr, &color);
+  cairo_paint (cr);
+
+  return TRUE;
+}
+
+static void
+on_draw_finished (ClutterCanvas *canvas,
+                  CanvasData    *data)
+{
+  g_assert (g_main_context_is_owner (g_main_context_default ()));
+
+  data->n_finished += 1;
+}
+
+static void
+set_color (CanvasData         *data,
+           const ClutterColor *color)
+{
+  g_mutex_lock (&data->lock);
+  data->color = *color;
+  g_mutex_unlock (&data->lock);
+}
+
+static void
+set_blocked (CanvasData *data,
+             gboolean    blocked)
+{
+  g_mutex_lock (&data->lock);
+  data->blocked = blocked;
+  g_cond_broadcast (&data->cond);
+  g_mutex_unlock (&data->lock);
+}
+
+static guint
+get_n_draws (CanvasData *data)
+{
+  guint res;
+
+  g_mutex_lock (&data->lock);
+  res = data->n_draws;
+  g_mutex_unlock (&data->lock);
+
+  return res;
+}
+
+/* waits until @n_draws draws were started; the draws run in a
+ * worker thread, so we do not need the main loop for this
+ */
+static void
+wait_for_draws (CanvasData *data,
+                guint       n_draws)
+{
+  g_mutex_lock (&data->lock);
+
+  while (data->n_draws < n_draws)
+    g_cond_wait (&data->cond, &data->lock);
+
+  g_mutex_unlock (&data->lock);
+}
+
+static void
+wait_for_finished (CanvasData *data,
+                   guint       n_finished)
+{
+  while (data->n_finished < n_finished)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+canvas_async (void)
+{
+  ClutterContent *canvas = clutter_canvas_new ();
+  CanvasData data = { { 0, }, };
+  ClutterPoint point = CLUTTER_POINT_INIT (CANVAS_SIZE / 2, CANVAS_SIZE / 2);
+  ClutterActor *stage, *actor;
+
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+
+  g_signal_connect (canvas, "draw", G_CALLBACK (on_draw), &data);
+  g_signal_connect (canvas, "draw-finished",
+                    G_CALLBACK (on_draw_finished),
+                    &data);
+
+  stage = clutter_test_get_stage ();
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_size (actor, CANVAS_SIZE, CANVAS_SIZE);
+  clutter_actor_set_content (actor, canvas);
+  clutter_actor_add_child (stage, actor);
+
+  clutter_canvas_set_async (CLUTTER_CANVAS (canvas), TRUE);
+
+  /* the draw happens in a worker thread, and completes in the main one */
+  set_color (&data, CLUTTER_COLOR_Red);
+  clutter_canvas_set_size (CLUTTER_CANVAS (canvas), CANVAS_SIZE, CANVAS_SIZE);
+  wait_for_finished (&data, 1);
+  g_assert_cmpuint (get_n_draws (&data), ==, 1);
+  clutter_test_assert_color_at_point (stage, &point, CLUTTER_COLOR_Red);
+
+  /* the previous contents are painted until the new ones are ready */
+  set_blocked (&data, TRUE);
+  set_color (&data, CLUTTER_COLOR_Blue);
+  clutter_content_invalidate (canvas);
+  wait_for_draws (&data, 2);
+  clutter_test_assert_color_at_point (stage, &point, CLUTTER_COLOR_Red);
+  g_assert_cmpuint (data.n_finished, ==, 1);
+
+  /* the invalidations during a draw are coalesced into a single draw */
+  set_color (&data, CLUTTER_COLOR_Green);
+  clutter_content_invalidate (canvas);
+  clutter_content_invalidate (canvas);
+  clutter_content_invalidate (canvas);
+
+  set_blocked (&data, FALSE);
+  wait_for_finished (&data, 3);
+  g_assert_cmpuint (get_n_draws (&data), ==, 3);
+  clutter_test_assert_color_at_point (stage, &point, CLUTTER_COLOR_Green);
+
+  /* switching to synchronous drawing replaces the draw in flight */
+  set_blocked (&data, TRUE);
+  set_color (&data, CLUTTER_COLOR_Yellow);
+  clutter_content_invalidate (canvas);
+  wait_for_draws (&data, 4);
+
+  set_color (&data, CLUTTER_COLOR_Magenta);
+  clutter_canvas_set_async (CLUTTER_CANVAS (canvas), FALSE);
+  set_blocked (&data, FALSE);
+
+  /* the synchronous draw happens once the cancelled one is done */
+  while (get_n_draws (&data) < 5)
+    g_main_context_iteration (NULL, TRUE);
+
+  clutter_test_assert_color_at_point (stage, &point, CLUTTER_COLOR_Magenta);
+  g_assert_cmpuint (data.n_finished, ==, 3);
+
+  /* synchronous draws happen right away */
+  set_color (&data, CLUTTER_COLOR_Cyan);
+  clutter_content_invalidate (canvas);
+  g_assert_cmpuint (get_n_draws (&data), ==, 6);
+  clutter_test_assert_color_at_point (stage, &point, CLUTTER_COLOR_Cyan);
+  g_assert_cmpuint (data.n_finished, ==, 3);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (canvas);
+
+  g_mutex_clear (&data.lock);
+  g_cond_clear (&data.cond);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/canvas/async", canvas_async)
+)
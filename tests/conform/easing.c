@@ -0,0 +1,129 @@
+#include <math.h>
+#include <clutter/clutter.h>
+
+/* the reference implementation, solving the cubic bezier curve by
+ * bisection on every evaluation
+ */
+static double
+reference_bezier_sample (double t,
+                         double c_1,
+                         double c_2)
+{
+  double omt = 1.0 - t;
+
+  return 3.0 * omt * omt * t * c_1
+       + 3.0 * omt * t * t * c_2
+       + t * t * t;
+}
+
+static double
+reference_cubic_bezier (double p,
+                        double x_1,
+                        double y_1,
+                        double x_2,
+                        double y_2)
+{
+  double min_t = 0, max_t = 1;
+  int i;
+
+  if (p == 0.0)
+    return 0.0;
+
+  if (p == 1.0)
+    return 1.0;
+
+  for (i = 0; i < 30; i++)
+    {
+      double guess_t = (min_t + max_t) / 2.0;
+
+      if (p < reference_bezier_sample (guess_t, x_1, x_2))
+        max_t = guess_t;
+      else
+        min_t = guess_t;
+    }
+
+  return reference_bezier_sample ((min_t + max_t) / 2.0, y_1, y_2);
+}
+
+static void
+check_timeline_bezier (ClutterTimeline *timeline,
+                       double           x_1,
+                       double           y_1,
+                       double           x_2,
+                       double           y_2)
+{
+  guint duration = clutter_timeline_get_duration (timeline);
+  guint msecs;
+
+  for (msecs = 0; msecs <= duration; msecs++)
+    {
+      double expected, progress;
+
+      clutter_timeline_advance (timeline, msecs);
+      progress = clutter_timeline_get_progress (timeline);
+      expected = reference_cubic_bezier ((double) msecs / duration,
+                                         x_1, y_1,
+                                         x_2, y_2);
+
+      if (fabs (progress - expected) > 1e-6)
+        g_error ("cubic-bezier(%g, %g, %g, %g) at %u ms: "
+                 "expected %g, got %g",
+                 x_1, y_1, x_2, y_2,
+                 msecs, expected, progress);
+    }
+}
+
+static void
+easing_cubic_bezier_modes (void)
+{
+  ClutterTimeline *timeline = clutter_timeline_new (1000);
+
+  clutter_timeline_set_progress_mode (timeline, CLUTTER_EASE);
+  check_timeline_bezier (timeline, 0.25, 0.1, 0.25, 1.0);
+
+  clutter_timeline_set_progress_mode (timeline, CLUTTER_EASE_IN);
+  check_timeline_bezier (timeline, 0.42, 0.0, 1.0, 1.0);
+
+  clutter_timeline_set_progress_mode (timeline, CLUTTER_EASE_OUT);
+  check_timeline_bezier (timeline, 0.0, 0.0, 0.58, 1.0);
+
+  clutter_timeline_set_progress_mode (timeline, CLUTTER_EASE_IN_OUT);
+  check_timeline_bezier (timeline, 0.42, 0.0, 0.58, 1.0);
+
+  g_object_unref (timeline);
+}
+
+static void
+easing_cubic_bezier_random (void)
+{
+  ClutterTimeline *timeline = clutter_timeline_new (500);
+  GRand *rand = g_rand_new_with_seed (42);
+  int i;
+
+  for (i = 0; i < 200; i++)
+    {
+      ClutterPoint c_1, c_2;
+
+      c_1.x = g_rand_double (rand);
+      c_1.y = g_rand_double_range (rand, -1.0, 2.0);
+      c_2.x = g_rand_double (rand);
+      c_2.y = g_rand_double_range (rand, -1.0, 2.0);
+
+      /* exercise the flat sections of the curve as well */
+      if (i % 4 == 0)
+        c_1.x = 0.0;
+      if (i % 5 == 0)
+        c_2.x = 1.0;
+
+      clutter_timeline_set_cubic_bezier_progress (timeline, &c_1, &c_2);
+      check_timeline_bezier (timeline, c_1.x, c_1.y, c_2.x, c_2.y);
+    }
+
+  g_rand_free (rand);
+  g_object_unref (timeline);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/easing/cubic-bezier-modes", easing_cubic_bezier_modes)
+  CLUTTER_TEST_UNIT ("/easing/cubic-bezier-random", easing_cubic_bezier_random)
+)
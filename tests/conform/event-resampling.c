@@ -0,0 +1,183 @@
+#include <math.h>
+#include <clutter/clutter.h>
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterInputDevice *device;
+
+  guint n_motions;
+  gfloat x;
+  guint32 time;
+} ResampleData;
+
+static gboolean
+on_captured_event (ClutterActor *stage,
+                   ClutterEvent *event,
+                   ResampleData *data)
+{
+  if (clutter_event_type (event) == CLUTTER_MOTION)
+    {
+      data->n_motions += 1;
+      data->x = clutter_event_get_x (event);
+      data->time = clutter_event_get_time (event);
+
+      if (g_test_verbose ())
+        g_print ("Motion: %.2f at %u\n", data->x, data->time);
+    }
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static gboolean
+resample_data_init (ResampleData *data)
+{
+  ClutterDeviceManager *manager;
+
+  manager = clutter_device_manager_get_default ();
+
+  data->device = clutter_device_manager_get_core_device (manager, CLUTTER_POINTER_DEVICE);
+  if (data->device == NULL)
+    {
+      g_test_skip ("No pointer device available");
+      return FALSE;
+    }
+
+  data->stage = clutter_test_get_stage ();
+  data->n_motions = 0;
+
+  clutter_stage_set_throttle_motion_events (CLUTTER_STAGE (data->stage), TRUE);
+  clutter_stage_set_resample_motion_events (CLUTTER_STAGE (data->stage), TRUE);
+
+  g_signal_connect (data->stage, "captured-event",
+                    G_CALLBACK (on_captured_event),
+                    data);
+
+  clutter_actor_show (data->stage);
+
+  return TRUE;
+}
+
+/* the events are queued on the stage right away, at the current time,
+ * and they are processed together at the next frame
+ */
+static void
+queue_motion (ResampleData *data,
+              guint32       time_,
+              gfloat        x)
+{
+  ClutterEvent *event;
+
+  event = clutter_event_new (CLUTTER_MOTION);
+  clutter_event_set_stage (event, CLUTTER_STAGE (data->stage));
+  clutter_event_set_source (event, data->stage);
+  clutter_event_set_device (event, data->device);
+  clutter_event_set_time (event, time_);
+  clutter_event_set_coords (event, x, 10.f);
+
+  clutter_do_event (event);
+  clutter_event_free (event);
+}
+
+static void
+process_motions (ResampleData *data)
+{
+  while (data->n_motions == 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* the motions are throttled, and only the last one is delivered */
+  g_assert_cmpuint (data->n_motions, ==, 1);
+
+  g_signal_handlers_disconnect_by_data (data->stage, data);
+}
+
+static void
+event_resampling_interpolate (void)
+{
+  ResampleData data;
+
+  if (!resample_data_init (&data))
+    return;
+
+  /* the events are delivered as soon as they are generated, and they
+   * are processed in less than the resampling latency of 5ms, so the
+   * delivered event lies between the last two
+   */
+  queue_motion (&data, 1000, 0.f);
+  queue_motion (&data, 1010, 100.f);
+  process_motions (&data);
+
+  g_assert_cmpfloat (data.x, >=, 50.f);
+  g_assert_cmpfloat (data.x, <, 100.f);
+  g_assert_cmpuint (data.time, >=, 1005);
+  g_assert_cmpuint (data.time, <, 1010);
+}
+
+static void
+event_resampling_predict (void)
+{
+  ResampleData data;
+
+  if (!resample_data_init (&data))
+    return;
+
+  /* when the frame is late, the position is predicted from the last two
+   * events for at most 8ms after the last one
+   */
+  queue_motion (&data, 1000, 0.f);
+  queue_motion (&data, 1020, 100.f);
+  g_usleep (40 * 1000);
+  process_motions (&data);
+
+  g_assert_cmpfloat (fabsf (data.x - 140.f), <, 0.01f);
+  g_assert_cmpuint (data.time, ==, 1028);
+}
+
+static void
+event_resampling_predict_half_interval (void)
+{
+  ResampleData data;
+
+  if (!resample_data_init (&data))
+    return;
+
+  /* ... and for at most half of the interval between them */
+  queue_motion (&data, 1000, 0.f);
+  queue_motion (&data, 1010, 100.f);
+  g_usleep (40 * 1000);
+  process_motions (&data);
+
+  g_assert_cmpfloat (fabsf (data.x - 150.f), <, 0.01f);
+  g_assert_cmpuint (data.time, ==, 1015);
+}
+
+static void
+event_resampling_clock_offset (void)
+{
+  ResampleData data;
+
+  if (!resample_data_init (&data))
+    return;
+
+  /* the offset between the event clock and the monotonic clock is the
+   * smallest delay between the time of an event and the time at which
+   * it has been queued, which is the one of the first event here; if
+   * the delay of the last event were used instead, the frame would look
+   * on time, and the position would be interpolated
+   */
+  queue_motion (&data, 1000, 0.f);
+  g_usleep (10 * 1000);
+  queue_motion (&data, 1010, 50.f);
+  g_usleep (25 * 1000);
+  queue_motion (&data, 1020, 100.f);
+  process_motions (&data);
+
+  g_assert_cmpfloat (fabsf (data.x - 125.f), <, 0.01f);
+  g_assert_cmpuint (data.time, ==, 1025);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/event-resampling/interpolate", event_resampling_interpolate)
+  CLUTTER_TEST_UNIT ("/event-resampling/predict", event_resampling_predict)
+  CLUTTER_TEST_UNIT ("/event-resampling/predict-half-interval", event_resampling_predict_half_interval)
+  CLUTTER_TEST_UNIT ("/event-resampling/clock-offset", event_resampling_clock_offset)
+)
@@ -0,0 +1,168 @@
+#include <gio/gio.h>
+#include <clutter/clutter.h>
+
+typedef struct {
+  gboolean done;
+  gboolean success;
+  GError *error;
+} LoadData;
+
+static const guint8 pixels[] = {
+  0xff, 0x00, 0x00, 0xff,   0x00, 0xff, 0x00, 0xff,
+  0x00, 0x00, 0xff, 0xff,   0xff, 0xff, 0xff, 0xff,
+};
+
+static void
+on_load_finished (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      user_data)
+{
+  LoadData *data = user_data;
+
+  data->success = clutter_image_load_finish (CLUTTER_IMAGE (source),
+                                             result,
+                                             &data->error);
+  data->done = TRUE;
+}
+
+static void
+wait_for_load (LoadData *data)
+{
+  while (!data->done)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+load_bytes (ClutterContent *image,
+            GCancellable   *cancellable,
+            LoadData       *data)
+{
+  GBytes *bytes = g_bytes_new_static (pixels, sizeof (pixels));
+
+  clutter_image_load_bytes_async (CLUTTER_IMAGE (image), bytes,
+                                  COGL_PIXEL_FORMAT_RGBA_8888,
+                                  2, 2, 8,
+                                  G_PRIORITY_DEFAULT,
+                                  cancellable,
+                                  on_load_finished,
+                                  data);
+
+  g_bytes_unref (bytes);
+}
+
+static void
+image_async_load (void)
+{
+  ClutterContent *image = clutter_image_new ();
+  LoadData data = { FALSE, };
+  gfloat width, height;
+
+  clutter_actor_show (clutter_test_get_stage ());
+
+  load_bytes (image, NULL, &data);
+  wait_for_load (&data);
+
+  g_assert_no_error (data.error);
+  g_assert (data.success);
+
+  g_assert (clutter_content_get_preferred_size (image, &width, &height));
+  g_assert_cmpfloat (width, ==, 2);
+  g_assert_cmpfloat (height, ==, 2);
+
+  g_object_unref (image);
+}
+
+static void
+image_async_cancel (void)
+{
+  ClutterContent *image = clutter_image_new ();
+  GCancellable *cancellable = g_cancellable_new ();
+  LoadData data = { FALSE, };
+
+  clutter_actor_show (clutter_test_get_stage ());
+
+  load_bytes (image, cancellable, &data);
+  g_cancellable_cancel (cancellable);
+  wait_for_load (&data);
+
+  g_assert_error (data.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_assert (!data.success);
+  g_assert (!clutter_content_get_preferred_size (image, NULL, NULL));
+  g_clear_error (&data.error);
+
+  /* a cancellable that is already cancelled cancels the load right away */
+  data.done = FALSE;
+  load_bytes (image, cancellable, &data);
+  wait_for_load (&data);
+
+  g_assert_error (data.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_clear_error (&data.error);
+
+  g_object_unref (cancellable);
+  g_object_unref (image);
+}
+
+static void
+image_async_cancel_decode (void)
+{
+  ClutterContent *image = clutter_image_new ();
+  GCancellable *cancellable = g_cancellable_new ();
+  LoadData data = { FALSE, };
+
+  clutter_actor_show (clutter_test_get_stage ());
+
+  /* depending on whether a worker thread already picked up the job,
+   * the load fails either because it was cancelled or because the
+   * file does not exist; either way, it has to complete
+   */
+  clutter_image_load_async (CLUTTER_IMAGE (image),
+                            "/does/not/exist.png",
+                            G_PRIORITY_DEFAULT,
+                            cancellable,
+                            on_load_finished,
+                            &data);
+  g_cancellable_cancel (cancellable);
+  wait_for_load (&data);
+
+  g_assert (data.error != NULL);
+  g_assert (!data.success);
+  g_clear_error (&data.error);
+
+  g_object_unref (cancellable);
+  g_object_unref (image);
+}
+
+static void
+image_async_dispose (void)
+{
+  ClutterContent *image = clutter_image_new ();
+  GCancellable *cancellable = g_cancellable_new ();
+  LoadData data = { FALSE, };
+
+  clutter_actor_show (clutter_test_get_stage ());
+
+  g_object_add_weak_pointer (G_OBJECT (image), (gpointer *) &image);
+
+  /* the pending load keeps the image alive until it completes */
+  load_bytes (image, cancellable, &data);
+  g_object_unref (image);
+  g_assert (image != NULL);
+
+  g_cancellable_cancel (cancellable);
+  wait_for_load (&data);
+
+  g_assert_error (data.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_clear_error (&data.error);
+
+  while (image != NULL)
+    g_main_context_iteration (NULL, FALSE);
+
+  g_object_unref (cancellable);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/image/async/load", image_async_load)
+  CLUTTER_TEST_UNIT ("/image/async/cancel", image_async_cancel)
+  CLUTTER_TEST_UNIT ("/image/async/cancel-decode", image_async_cancel_decode)
+  CLUTTER_TEST_UNIT ("/image/async/dispose", image_async_dispose)
+)
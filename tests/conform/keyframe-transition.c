@@ -0,0 +1,113 @@
+#include <math.h>
+#include <clutter/clutter.h>
+
+#define N_KEY_FRAMES    99
+
+/* sets up a keyframe transition on the :x property where each key frame
+ * is on the line going from 0 to 1000, so that the value of the property
+ * is always 1000 times the progress of the transition
+ */
+static ClutterTransition *
+create_linear_transition (ClutterActor *actor,
+                          gboolean      reversed)
+{
+  ClutterTransition *transition;
+  double keys[N_KEY_FRAMES];
+  GValue values[N_KEY_FRAMES] = { G_VALUE_INIT, };
+  int i;
+
+  for (i = 0; i < N_KEY_FRAMES; i++)
+    {
+      int key = reversed ? N_KEY_FRAMES - i : i + 1;
+
+      keys[i] = key / 100.0;
+
+      g_value_init (&values[i], G_TYPE_FLOAT);
+      g_value_set_float (&values[i], key * 10.f);
+    }
+
+  transition = clutter_keyframe_transition_new ("x");
+  clutter_transition_set_from (transition, G_TYPE_FLOAT, 0.f);
+  clutter_transition_set_to (transition, G_TYPE_FLOAT, 1000.f);
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), 1000);
+
+  clutter_keyframe_transition_set_key_frames (CLUTTER_KEYFRAME_TRANSITION (transition),
+                                              N_KEY_FRAMES, keys);
+  clutter_keyframe_transition_set_values (CLUTTER_KEYFRAME_TRANSITION (transition),
+                                          N_KEY_FRAMES, values);
+
+  for (i = 0; i < N_KEY_FRAMES; i++)
+    g_value_unset (&values[i]);
+
+  clutter_transition_set_animatable (transition, CLUTTER_ANIMATABLE (actor));
+
+  g_signal_emit_by_name (transition, "started");
+
+  return transition;
+}
+
+static void
+seek_and_check (ClutterTransition *transition,
+                ClutterActor      *actor,
+                guint              msecs)
+{
+  clutter_timeline_advance (CLUTTER_TIMELINE (transition), msecs);
+  g_signal_emit_by_name (transition, "new-frame", msecs);
+
+  if (g_test_verbose ())
+    g_print ("elapsed: %u ms, x: %.3f\n", msecs, clutter_actor_get_x (actor));
+
+  g_assert_cmpfloat (fabsf (clutter_actor_get_x (actor) - (float) msecs), <, 0.5f);
+}
+
+static void
+keyframe_transition_seek (void)
+{
+  ClutterActor *actor = clutter_actor_new ();
+  ClutterTransition *transition;
+
+  g_object_ref_sink (actor);
+
+  transition = create_linear_transition (actor, FALSE);
+
+  /* stepping */
+  seek_and_check (transition, actor, 5);
+  seek_and_check (transition, actor, 12);
+  seek_and_check (transition, actor, 25);
+
+  /* seeking forward and backward across many key frames */
+  seek_and_check (transition, actor, 737);
+  seek_and_check (transition, actor, 120);
+  seek_and_check (transition, actor, 995);
+  seek_and_check (transition, actor, 1000);
+  seek_and_check (transition, actor, 0);
+
+  clutter_transition_set_animatable (transition, NULL);
+  g_object_unref (transition);
+  g_object_unref (actor);
+}
+
+static void
+keyframe_transition_sort (void)
+{
+  ClutterActor *actor = clutter_actor_new ();
+  ClutterTransition *transition;
+
+  g_object_ref_sink (actor);
+
+  /* the key frames are sorted when the transition starts */
+  transition = create_linear_transition (actor, TRUE);
+
+  seek_and_check (transition, actor, 15);
+  seek_and_check (transition, actor, 480);
+  seek_and_check (transition, actor, 950);
+
+  clutter_transition_set_animatable (transition, NULL);
+  g_object_unref (transition);
+  g_object_unref (actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/keyframe-transition/seek", keyframe_transition_seek)
+  CLUTTER_TEST_UNIT ("/keyframe-transition/sort", keyframe_transition_sort)
+)
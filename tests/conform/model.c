@@ -169,36 +169,31 @@ filter_odd_rows (ClutterModel     *model,
   return FALSE;
 }
 
-static void
-list_model_filter (void)
+static gboolean
+filter_rows_below (ClutterModel     *model,
+                   ClutterModelIter *iter,
+                   gpointer          data)
 {
-  ModelData test_data = { NULL, 0 };
-  ClutterModelIter *iter;
-  gint i;
-
-  test_data.model = clutter_list_model_new (N_COLUMNS,
-                                            G_TYPE_STRING, "Foo",
-                                            G_TYPE_INT,    "Bar");
-  test_data.n_row = 0;
+  gint *threshold = data;
+  gint bar_value;
 
-  for (i = 1; i < 10; i++)
-    {
-      gchar *foo = g_strdup_printf ("String %d", i);
+  clutter_model_iter_get (iter, COLUMN_BAR, &bar_value, -1);
 
-      clutter_model_append (test_data.model,
-                            COLUMN_FOO, foo,
-                            COLUMN_BAR, i,
-                            -1);
+  return bar_value < *threshold;
+}
 
-      g_free (foo);
-    }
+static void
+check_model_filter (ModelData *test_data)
+{
+  ClutterModelIter *iter;
+  gint i;
 
   if (g_test_verbose ())
     g_print ("Forward iteration (filter odd)...\n");
 
-  clutter_model_set_filter (test_data.model, filter_odd_rows, NULL, NULL);
+  clutter_model_set_filter (test_data->model, filter_odd_rows, NULL, NULL);
 
-  iter = clutter_model_get_first_iter (test_data.model);
+  iter = clutter_model_get_first_iter (test_data->model);
   g_assert (iter != NULL);
 
   i = 0;
@@ -217,9 +212,9 @@ list_model_filter (void)
   if (g_test_verbose ())
     g_print ("Backward iteration (filter even)...\n");
 
-  clutter_model_set_filter (test_data.model, filter_even_rows, NULL, NULL);
+  clutter_model_set_filter (test_data->model, filter_even_rows, NULL, NULL);
 
-  iter = clutter_model_get_last_iter (test_data.model);
+  iter = clutter_model_get_last_iter (test_data->model);
   g_assert (iter != NULL);
 
   i = 0;
@@ -239,19 +234,45 @@ list_model_filter (void)
   if (g_test_verbose ())
     g_print ("get_iter_at_row...\n");
 
-  clutter_model_set_filter (test_data.model, filter_odd_rows, NULL, NULL);
+  clutter_model_set_filter (test_data->model, filter_odd_rows, NULL, NULL);
 
   for (i = 0; i < 5; i++)
     {
-      iter = clutter_model_get_iter_at_row (test_data.model, i);
+      iter = clutter_model_get_iter_at_row (test_data->model, i);
       compare_iter (iter, i ,
                     filter_odd[i].expected_foo,
                     filter_odd[i].expected_bar);
       g_object_unref (iter);
     }
 
-  iter = clutter_model_get_iter_at_row (test_data.model, 5);
+  iter = clutter_model_get_iter_at_row (test_data->model, 5);
   g_assert (iter == NULL);
+}
+
+static void
+list_model_filter (void)
+{
+  ModelData test_data = { NULL, 0 };
+  gint i;
+
+  test_data.model = clutter_list_model_new (N_COLUMNS,
+                                            G_TYPE_STRING, "Foo",
+                                            G_TYPE_INT,    "Bar");
+  test_data.n_row = 0;
+
+  for (i = 1; i < 10; i++)
+    {
+      gchar *foo = g_strdup_printf ("String %d", i);
+
+      clutter_model_append (test_data.model,
+                            COLUMN_FOO, foo,
+                            COLUMN_BAR, i,
+                            -1);
+
+      g_free (foo);
+    }
+
+  check_model_filter (&test_data);
 
   g_object_unref (test_data.model);
 }
@@ -518,10 +539,502 @@ list_model_row_changed (void)
   g_object_unref (test_data.model);
 }
 
+typedef struct _RowsChangedData
+{
+  guint position;
+  guint n_removed;
+  guint n_added;
+
+  guint n_emissions;
+} RowsChangedData;
+
+static void
+on_rows_changed (ClutterModel    *model,
+                 guint            position,
+                 guint            n_removed,
+                 guint            n_added,
+                 RowsChangedData *data)
+{
+  if (g_test_verbose ())
+    g_print ("rows-changed: position %u, removed %u, added %u\n",
+             position, n_removed, n_added);
+
+  data->position = position;
+  data->n_removed = n_removed;
+  data->n_added = n_added;
+  data->n_emissions += 1;
+}
+
+static void
+populate_array_model (ClutterModel    *model,
+                      RowsChangedData *data)
+{
+  const guint columns[] = { COLUMN_FOO, COLUMN_BAR };
+  const gchar *foo[G_N_ELEMENTS (base_model)];
+  gint bar[G_N_ELEMENTS (base_model)];
+  gconstpointer values[] = { foo, bar };
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (base_model); i++)
+    {
+      foo[i] = base_model[i].expected_foo;
+      bar[i] = base_model[i].expected_bar;
+    }
+
+  clutter_array_model_append_rows (CLUTTER_ARRAY_MODEL (model),
+                                   G_N_ELEMENTS (base_model),
+                                   G_N_ELEMENTS (columns), columns,
+                                   values);
+
+  g_assert_cmpint (data->n_emissions, ==, 1);
+  g_assert_cmpint (data->position, ==, 0);
+  g_assert_cmpint (data->n_removed, ==, 0);
+  g_assert_cmpint (data->n_added, ==, G_N_ELEMENTS (base_model));
+}
+
+static void
+array_model_populate (void)
+{
+  RowsChangedData changed_data = { 0, };
+  ModelData test_data = { NULL, 0 };
+  ClutterModelIter *iter;
+  gint i;
+
+  test_data.model = clutter_array_model_new (N_COLUMNS,
+                                             G_TYPE_STRING, "Foo",
+                                             G_TYPE_INT,    "Bar");
+
+  g_signal_connect (test_data.model, "row-added",
+                    G_CALLBACK (on_row_added),
+                    &test_data);
+  g_signal_connect (test_data.model, "rows-changed",
+                    G_CALLBACK (on_rows_changed),
+                    &changed_data);
+
+  /* bulk additions do not emit ::row-added */
+  populate_array_model (test_data.model, &changed_data);
+  g_assert_cmpint (test_data.n_row, ==, 0);
+  g_assert_cmpint (clutter_model_get_n_rows (test_data.model), ==, G_N_ELEMENTS (base_model));
+
+  /* the same iterator can be used to access any row */
+  iter = clutter_model_get_first_iter (test_data.model);
+  for (i = G_N_ELEMENTS (base_model) - 1; i >= 0; i--)
+    {
+      g_assert (clutter_array_model_iter_seek (iter, i));
+
+      compare_iter (iter, i,
+                    base_model[i].expected_foo,
+                    base_model[i].expected_bar);
+
+      g_assert_cmpstr (clutter_array_model_iter_get_string (iter, COLUMN_FOO),
+                       ==,
+                       base_model[i].expected_foo);
+      g_assert_cmpint (clutter_array_model_iter_get_int (iter, COLUMN_BAR),
+                       ==,
+                       base_model[i].expected_bar);
+    }
+
+  g_assert (!clutter_array_model_iter_seek (iter, G_N_ELEMENTS (base_model)));
+  g_assert_cmpint (clutter_model_iter_get_row (iter), ==, 0);
+
+  g_object_unref (iter);
+
+  /* while the per-row functions still emit ::row-added */
+  test_data.n_row = G_N_ELEMENTS (base_model) - 1;
+  clutter_model_remove (test_data.model, test_data.n_row);
+  clutter_model_append (test_data.model,
+                        COLUMN_FOO, base_model[test_data.n_row].expected_foo,
+                        COLUMN_BAR, base_model[test_data.n_row].expected_bar,
+                        -1);
+  g_assert_cmpint (test_data.n_row, ==, G_N_ELEMENTS (base_model));
+  g_assert_cmpint (changed_data.n_emissions, ==, 1);
+
+  g_object_unref (test_data.model);
+}
+
+static void
+array_model_filter (void)
+{
+  RowsChangedData changed_data = { 0, };
+  ModelData test_data = { NULL, 0 };
+
+  test_data.model = clutter_array_model_new (N_COLUMNS,
+                                             G_TYPE_STRING, "Foo",
+                                             G_TYPE_INT,    "Bar");
+  g_signal_connect (test_data.model, "rows-changed",
+                    G_CALLBACK (on_rows_changed),
+                    &changed_data);
+
+  populate_array_model (test_data.model, &changed_data);
+
+  check_model_filter (&test_data);
+
+  g_object_unref (test_data.model);
+}
+
+static void
+array_model_splice (void)
+{
+  RowsChangedData changed_data = { 0, };
+  const guint columns[] = { COLUMN_FOO, COLUMN_BAR };
+  const gchar *foo[] = { "Spliced 1", "Spliced 2" };
+  const gint bar[] = { 10, 12 };
+  gconstpointer values[] = { foo, bar };
+  ClutterModelIter *iter;
+  ClutterModel *model;
+
+  model = clutter_array_model_new (N_COLUMNS,
+                                   G_TYPE_STRING, "Foo",
+                                   G_TYPE_INT,    "Bar");
+  g_signal_connect (model, "rows-changed",
+                    G_CALLBACK (on_rows_changed),
+                    &changed_data);
+
+  populate_array_model (model, &changed_data);
+
+  /* replace "String 3" to "String 5" with two rows */
+  clutter_array_model_splice (CLUTTER_ARRAY_MODEL (model),
+                              2, 3, 2,
+                              G_N_ELEMENTS (columns), columns,
+                              values);
+
+  g_assert_cmpint (changed_data.n_emissions, ==, 2);
+  g_assert_cmpint (changed_data.position, ==, 2);
+  g_assert_cmpint (changed_data.n_removed, ==, 3);
+  g_assert_cmpint (changed_data.n_added, ==, 2);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 8);
+
+  iter = clutter_model_get_iter_at_row (model, 1);
+  compare_iter (iter, 1, "String 2", 2);
+  iter = clutter_model_iter_next (iter);
+  compare_iter (iter, 2, "Spliced 1", 10);
+  iter = clutter_model_iter_next (iter);
+  compare_iter (iter, 3, "Spliced 2", 12);
+  iter = clutter_model_iter_next (iter);
+  compare_iter (iter, 4, "String 6", 6);
+  g_object_unref (iter);
+
+  /* positions are reported using the filtered rows */
+  clutter_model_set_filter (model, filter_even_rows, NULL, NULL);
+
+  clutter_array_model_splice (CLUTTER_ARRAY_MODEL (model),
+                              4, 4, 0,
+                              0, NULL,
+                              NULL);
+
+  g_assert_cmpint (changed_data.n_emissions, ==, 3);
+  g_assert_cmpint (changed_data.position, ==, 3);
+  g_assert_cmpint (changed_data.n_removed, ==, 2);
+  g_assert_cmpint (changed_data.n_added, ==, 0);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 3);
+
+  iter = clutter_model_get_iter_at_row (model, 2);
+  compare_iter (iter, 2, "Spliced 2", 12);
+  g_object_unref (iter);
+
+  g_object_unref (model);
+}
+
+static gint
+sort_bar_descending (ClutterModel *model,
+                     const GValue *a,
+                     const GValue *b,
+                     gpointer      dummy G_GNUC_UNUSED)
+{
+  return g_value_get_int (b) - g_value_get_int (a);
+}
+
+static void
+set_bar_value (ClutterModel *model,
+               guint         row,
+               gint          bar)
+{
+  GValue value = G_VALUE_INIT;
+
+  g_value_init (&value, G_TYPE_INT);
+  g_value_set_int (&value, bar);
+  clutter_model_insert_value (model, row, COLUMN_BAR, &value);
+  g_value_unset (&value);
+}
+
+static void
+check_bar_values (ClutterModel *model,
+                  const gint   *expected,
+                  guint         n_expected)
+{
+  ClutterModelIter *iter;
+  guint i;
+  gint bar;
+
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, n_expected);
+
+  for (i = 0; i < n_expected; i++)
+    {
+      iter = clutter_model_get_iter_at_row (model, i);
+      g_assert (iter != NULL);
+
+      clutter_model_iter_get (iter, COLUMN_BAR, &bar, -1);
+      g_assert_cmpint (bar, ==, expected[i]);
+
+      g_object_unref (iter);
+    }
+
+  g_assert (clutter_model_get_iter_at_row (model, n_expected) == NULL);
+
+  iter = clutter_model_get_first_iter (model);
+  for (i = 0; !clutter_model_iter_is_last (iter); i++)
+    {
+      g_assert_cmpint (i, <, n_expected);
+
+      clutter_model_iter_get (iter, COLUMN_BAR, &bar, -1);
+      g_assert_cmpint (bar, ==, expected[i]);
+
+      iter = clutter_model_iter_next (iter);
+    }
+
+  g_assert_cmpint (i, ==, n_expected);
+  g_object_unref (iter);
+}
+
+/* checks that the filtered and sorted rows are kept up to date when
+ * rows are added, changed and removed
+ */
+static void
+check_model_index (ClutterModel *model)
+{
+  const gint sorted[] = { 8, 6, 4, 2 };
+  const gint appended[] = { 10, 8, 6, 4, 2 };
+  const gint filtered_out[] = { 10, 8, 4, 2 };
+  const gint moved[] = { 12, 10, 8, 4 };
+  const gint removed[] = { 10, 8, 4 };
+  const gint below_8[] = { 7, 5, 4, 3, 3, 1 };
+  const gint below_4[] = { 3, 3, 1 };
+  const gint unfiltered[] = { 10, 9, 8, 7, 5, 4, 3, 3, 1 };
+  gint threshold = 8;
+
+  clutter_model_set_filter (model, filter_even_rows, NULL, NULL);
+  clutter_model_set_sort (model, COLUMN_BAR, sort_bar_descending, NULL, NULL);
+  check_bar_values (model, sorted, G_N_ELEMENTS (sorted));
+
+  clutter_model_append (model,
+                        COLUMN_FOO, "String 10",
+                        COLUMN_BAR, 10,
+                        -1);
+  check_bar_values (model, appended, G_N_ELEMENTS (appended));
+
+  /* 6 becomes 3, and gets filtered out */
+  set_bar_value (model, 2, 3);
+  check_bar_values (model, filtered_out, G_N_ELEMENTS (filtered_out));
+
+  /* 2 becomes 12, and moves to the top */
+  set_bar_value (model, 3, 12);
+  check_bar_values (model, moved, G_N_ELEMENTS (moved));
+
+  clutter_model_remove (model, 0);
+  check_bar_values (model, removed, G_N_ELEMENTS (removed));
+
+  clutter_model_set_filter (model, filter_rows_below, &threshold, NULL);
+  check_bar_values (model, below_8, G_N_ELEMENTS (below_8));
+
+  /* the filter depends on state outside of the model */
+  threshold = 4;
+  clutter_model_refilter (model);
+  check_bar_values (model, below_4, G_N_ELEMENTS (below_4));
+
+  clutter_model_set_filter (model, NULL, NULL, NULL);
+  check_bar_values (model, unfiltered, G_N_ELEMENTS (unfiltered));
+}
+
+static void
+list_model_index (void)
+{
+  ClutterModel *model;
+  gint i;
+
+  model = clutter_list_model_new (N_COLUMNS,
+                                  G_TYPE_STRING, "Foo",
+                                  G_TYPE_INT,    "Bar");
+
+  for (i = 1; i < 10; i++)
+    {
+      gchar *foo = g_strdup_printf ("String %d", i);
+
+      clutter_model_append (model,
+                            COLUMN_FOO, foo,
+                            COLUMN_BAR, i,
+                            -1);
+
+      g_free (foo);
+    }
+
+  check_model_index (model);
+
+  g_object_unref (model);
+}
+
+static void
+array_model_index (void)
+{
+  RowsChangedData changed_data = { 0, };
+  ClutterModel *model;
+
+  model = clutter_array_model_new (N_COLUMNS,
+                                   G_TYPE_STRING, "Foo",
+                                   G_TYPE_INT,    "Bar");
+  g_signal_connect (model, "rows-changed",
+                    G_CALLBACK (on_rows_changed),
+                    &changed_data);
+
+  populate_array_model (model, &changed_data);
+
+  check_model_index (model);
+
+  g_object_unref (model);
+}
+
+static void
+on_row_signal (ClutterModel     *model,
+               ClutterModelIter *iter,
+               guint            *n_emissions)
+{
+  *n_emissions += 1;
+}
+
+static void
+list_model_update (void)
+{
+  RowsChangedData changed_data = { 0, };
+  ClutterModelIter *iter;
+  ClutterModel *model;
+  guint n_row_emissions = 0;
+  gint i, bar;
+
+  model = clutter_list_model_new (N_COLUMNS,
+                                  G_TYPE_STRING, "Foo",
+                                  G_TYPE_INT,    "Bar");
+
+  for (i = 1; i < 10; i++)
+    clutter_model_append (model, COLUMN_FOO, "String", COLUMN_BAR, i, -1);
+
+  g_signal_connect (model, "rows-changed",
+                    G_CALLBACK (on_rows_changed),
+                    &changed_data);
+
+  /* appending */
+  clutter_model_begin_update (model);
+
+  for (i = 10; i < 13; i++)
+    clutter_model_append (model, COLUMN_FOO, "Appended", COLUMN_BAR, i, -1);
+
+  g_assert_cmpint (changed_data.n_emissions, ==, 0);
+
+  clutter_model_end_update (model);
+
+  g_assert_cmpint (changed_data.n_emissions, ==, 1);
+  g_assert_cmpint (changed_data.position, ==, 9);
+  g_assert_cmpint (changed_data.n_removed, ==, 0);
+  g_assert_cmpint (changed_data.n_added, ==, 3);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 12);
+
+  /* nested updates removing and changing rows */
+  clutter_model_begin_update (model);
+  clutter_model_begin_update (model);
+
+  clutter_model_remove (model, 0);
+
+  iter = clutter_model_get_iter_at_row (model, 4);
+  clutter_model_iter_set (iter, COLUMN_BAR, 42, -1);
+  g_object_unref (iter);
+
+  clutter_model_end_update (model);
+
+  g_assert_cmpint (changed_data.n_emissions, ==, 1);
+
+  clutter_model_end_update (model);
+
+  /* the first six rows changed, and the rest are still the same */
+  g_assert_cmpint (changed_data.n_emissions, ==, 2);
+  g_assert_cmpint (changed_data.position, ==, 0);
+  g_assert_cmpint (changed_data.n_removed, ==, 6);
+  g_assert_cmpint (changed_data.n_added, ==, 5);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 11);
+
+  /* sorting happens once, at the end of the update */
+  clutter_model_set_sort (model, COLUMN_BAR, sort_bar_descending, NULL, NULL);
+
+  clutter_model_begin_update (model);
+  clutter_model_append (model, COLUMN_FOO, "Sorted", COLUMN_BAR, 100, -1);
+  clutter_model_append (model, COLUMN_FOO, "Sorted", COLUMN_BAR, 0, -1);
+  clutter_model_end_update (model);
+
+  g_assert_cmpint (changed_data.n_emissions, ==, 3);
+  g_assert_cmpint (changed_data.position, ==, 0);
+  g_assert_cmpint (changed_data.n_removed, ==, 11);
+  g_assert_cmpint (changed_data.n_added, ==, 13);
+
+  iter = clutter_model_get_first_iter (model);
+  clutter_model_iter_get (iter, COLUMN_BAR, &bar, -1);
+  g_assert_cmpint (bar, ==, 100);
+  g_object_unref (iter);
+
+  iter = clutter_model_get_iter_at_row (model, 12);
+  clutter_model_iter_get (iter, COLUMN_BAR, &bar, -1);
+  g_assert_cmpint (bar, ==, 0);
+  g_object_unref (iter);
+
+  /* the per-row signals are still emitted while updating, if there
+   * are handlers connected to them
+   */
+  g_signal_connect (model, "row-added",
+                    G_CALLBACK (on_row_signal),
+                    &n_row_emissions);
+  g_signal_connect (model, "row-removed",
+                    G_CALLBACK (on_row_signal),
+                    &n_row_emissions);
+  g_signal_connect (model, "row-changed",
+                    G_CALLBACK (on_row_signal),
+                    &n_row_emissions);
+
+  clutter_model_begin_update (model);
+
+  clutter_model_append (model, COLUMN_FOO, "Listened", COLUMN_BAR, 50, -1);
+  g_assert_cmpint (n_row_emissions, ==, 1);
+
+  clutter_model_remove (model, 0);
+  g_assert_cmpint (n_row_emissions, ==, 2);
+
+  iter = clutter_model_get_iter_at_row (model, 4);
+  clutter_model_iter_set (iter, COLUMN_BAR, 42, -1);
+  g_object_unref (iter);
+  g_assert_cmpint (n_row_emissions, ==, 3);
+
+  g_assert_cmpint (changed_data.n_emissions, ==, 3);
+
+  clutter_model_end_update (model);
+
+  g_assert_cmpint (n_row_emissions, ==, 3);
+  g_assert_cmpint (changed_data.n_emissions, ==, 4);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 13);
+
+  /* outside of an update, only the per-row signals are emitted */
+  clutter_model_append (model, COLUMN_FOO, "Unbatched", COLUMN_BAR, 7, -1);
+
+  g_assert_cmpint (n_row_emissions, >, 3);
+  g_assert_cmpint (changed_data.n_emissions, ==, 4);
+
+  g_object_unref (model);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/list-model/populate", list_model_populate)
   CLUTTER_TEST_UNIT ("/list-model/iterate", list_model_iterate)
   CLUTTER_TEST_UNIT ("/list-model/filter", list_model_filter)
   CLUTTER_TEST_UNIT ("/list-model/row-changed", list_model_row_changed)
   CLUTTER_TEST_UNIT ("/list-model/from-script", list_model_from_script)
+  CLUTTER_TEST_UNIT ("/list-model/index", list_model_index)
+  CLUTTER_TEST_UNIT ("/list-model/update", list_model_update)
+  CLUTTER_TEST_UNIT ("/array-model/populate", array_model_populate)
+  CLUTTER_TEST_UNIT ("/array-model/filter", array_model_filter)
+  CLUTTER_TEST_UNIT ("/array-model/splice", array_model_splice)
+  CLUTTER_TEST_UNIT ("/array-model/index", array_model_index)
 )
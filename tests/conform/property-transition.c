@@ -0,0 +1,236 @@
+#include <clutter/clutter.h>
+
+/* an interval that does not change anything; sub-classes of
+ * ClutterInterval are animated through ClutterAnimatable
+ */
+typedef struct _TestInterval            TestInterval;
+typedef struct _ClutterIntervalClass    TestIntervalClass;
+
+struct _TestInterval
+{
+  ClutterInterval parent_instance;
+};
+
+GType test_interval_get_type (void);
+
+G_DEFINE_TYPE (TestInterval, test_interval, CLUTTER_TYPE_INTERVAL)
+
+static void
+test_interval_class_init (TestIntervalClass *klass)
+{
+}
+
+static void
+test_interval_init (TestInterval *self)
+{
+}
+
+/* an actor that jumps to the final value of :x half way through
+ * the transition
+ */
+typedef struct _TestActor               TestActor;
+typedef struct _ClutterActorClass       TestActorClass;
+
+struct _TestActor
+{
+  ClutterActor parent_instance;
+};
+
+GType test_actor_get_type (void);
+
+static void test_actor_animatable_iface_init (ClutterAnimatableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (TestActor, test_actor, CLUTTER_TYPE_ACTOR,
+                         G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_ANIMATABLE,
+                                                test_actor_animatable_iface_init))
+
+static gboolean
+test_actor_interpolate_value (ClutterAnimatable *animatable,
+                              const gchar       *property_name,
+                              ClutterInterval   *interval,
+                              gdouble            progress,
+                              GValue            *value)
+{
+  const GValue *res;
+
+  if (progress < 0.5)
+    res = clutter_interval_peek_initial_value (interval);
+  else
+    res = clutter_interval_peek_final_value (interval);
+
+  g_value_copy (res, value);
+
+  return TRUE;
+}
+
+static void
+test_actor_animatable_iface_init (ClutterAnimatableIface *iface)
+{
+  /* the rest of the interface is inherited from ClutterActor */
+  iface->interpolate_value = test_actor_interpolate_value;
+}
+
+static void
+test_actor_class_init (TestActorClass *klass)
+{
+}
+
+static void
+test_actor_init (TestActor *self)
+{
+}
+
+static ClutterTransition *
+create_transition (ClutterActor    *actor,
+                   const char      *property_name,
+                   ClutterInterval *interval)
+{
+  ClutterTransition *transition;
+
+  transition = clutter_property_transition_new (property_name);
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), 1000);
+  clutter_transition_set_interval (transition, interval);
+  clutter_transition_set_animatable (transition, CLUTTER_ANIMATABLE (actor));
+
+  g_signal_emit_by_name (transition, "started");
+
+  return transition;
+}
+
+static void
+seek (ClutterTransition *transition,
+      guint              msecs)
+{
+  clutter_timeline_advance (CLUTTER_TIMELINE (transition), msecs);
+  g_signal_emit_by_name (transition, "new-frame", msecs);
+}
+
+static gdouble
+get_double_property (ClutterActor *actor,
+                     const char   *property_name)
+{
+  GValue value = G_VALUE_INIT;
+  GValue res = G_VALUE_INIT;
+  GParamSpec *pspec;
+  gdouble retval;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (actor),
+                                        property_name);
+
+  g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (pspec));
+  g_value_init (&res, G_TYPE_DOUBLE);
+
+  g_object_get_property (G_OBJECT (actor), property_name, &value);
+  g_value_transform (&value, &res);
+  retval = g_value_get_double (&res);
+
+  g_value_unset (&value);
+  g_value_unset (&res);
+
+  return retval;
+}
+
+static void
+property_transition_fast_path (void)
+{
+  static const struct {
+    const char *name;
+    GType type;
+    gdouble from;
+    gdouble to;
+  } properties[] = {
+    { "x", G_TYPE_FLOAT, -20.0, 133.3 },
+    { "width", G_TYPE_FLOAT, 10.0, 55.5 },
+    { "opacity", G_TYPE_UINT, 0, 255 },
+    { "scale-x", G_TYPE_DOUBLE, 1.0, 3.25 },
+    { "rotation-angle-z", G_TYPE_DOUBLE, 0.0, 270.0 },
+  };
+  guint i, msecs;
+
+  for (i = 0; i < G_N_ELEMENTS (properties); i++)
+    {
+      ClutterActor *fast_actor = clutter_actor_new ();
+      ClutterActor *slow_actor = clutter_actor_new ();
+      ClutterTransition *fast, *slow;
+      ClutterInterval *interval;
+      GValue from = G_VALUE_INIT;
+      GValue to = G_VALUE_INIT;
+
+      g_object_ref_sink (fast_actor);
+      g_object_ref_sink (slow_actor);
+
+      g_value_init (&from, G_TYPE_DOUBLE);
+      g_value_set_double (&from, properties[i].from);
+      g_value_init (&to, G_TYPE_DOUBLE);
+      g_value_set_double (&to, properties[i].to);
+
+      interval = clutter_interval_new_with_values (properties[i].type,
+                                                   NULL, NULL);
+      clutter_interval_set_initial_value (interval, &from);
+      clutter_interval_set_final_value (interval, &to);
+      fast = create_transition (fast_actor, properties[i].name, interval);
+
+      interval = g_object_new (test_interval_get_type (),
+                               "value-type", properties[i].type,
+                               NULL);
+      clutter_interval_set_initial_value (interval, &from);
+      clutter_interval_set_final_value (interval, &to);
+      slow = create_transition (slow_actor, properties[i].name, interval);
+
+      for (msecs = 0; msecs <= 1000; msecs += 50)
+        {
+          seek (fast, msecs);
+          seek (slow, msecs);
+
+          if (g_test_verbose ())
+            g_print ("%s: elapsed: %u ms, fast: %.6f, slow: %.6f\n",
+                     properties[i].name,
+                     msecs,
+                     get_double_property (fast_actor, properties[i].name),
+                     get_double_property (slow_actor, properties[i].name));
+
+          g_assert_cmpfloat (get_double_property (fast_actor, properties[i].name),
+                             ==,
+                             get_double_property (slow_actor, properties[i].name));
+        }
+
+      g_value_unset (&from);
+      g_value_unset (&to);
+
+      g_object_unref (fast);
+      g_object_unref (slow);
+      g_object_unref (fast_actor);
+      g_object_unref (slow_actor);
+    }
+}
+
+static void
+property_transition_custom_interpolate (void)
+{
+  ClutterActor *actor = g_object_new (test_actor_get_type (), NULL);
+  ClutterTransition *transition;
+  ClutterInterval *interval;
+
+  g_object_ref_sink (actor);
+
+  interval = clutter_interval_new (G_TYPE_FLOAT, 0.f, 100.f);
+  transition = create_transition (actor, "x", interval);
+
+  /* the interpolation of the actor class is used at each frame */
+  seek (transition, 250);
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 0.f);
+
+  seek (transition, 400);
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 0.f);
+
+  seek (transition, 750);
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 100.f);
+
+  g_object_unref (transition);
+  g_object_unref (actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/property-transition/fast-path", property_transition_fast_path)
+  CLUTTER_TEST_UNIT ("/property-transition/custom-interpolate", property_transition_custom_interpolate)
+)
@@ -1,5 +1,7 @@
 #include <stdlib.h>
 #include <string.h>
+#include <glib/gstdio.h>
+#include <gmodule.h>
 
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
 #include <clutter/clutter.h>
@@ -113,9 +115,12 @@ test_group_class_init (TestGroupClass *klass)
 {
 }
 
+static guint n_test_groups = 0;
+
 static void
 test_group_init (TestGroup *self)
 {
+  n_test_groups += 1;
 }
 
 static void
@@ -415,6 +420,235 @@ script_margin (void)
   g_free (test_file);
 }
 
+static void
+script_compiled (void)
+{
+  ClutterScript *script;
+  ClutterActor *actor;
+  ClutterColor color;
+  JsonObject *object;
+  JsonArray *array;
+  JsonNode *root;
+  GVariant *variant;
+  GError *error = NULL;
+  gchar *argv[4];
+  gchar *test_file, *compiled_file;
+  gchar *contents, *buffer;
+  gsize length;
+  gint status, fd;
+
+  test_file = g_test_build_filename (G_TEST_DIST, "scripts", "test-script-compiled.json", NULL);
+
+  fd = g_file_open_tmp ("script-compiled-XXXXXX.uic", &compiled_file, &error);
+  g_assert_no_error (error);
+  g_close (fd, NULL);
+
+  /* the compiler does not need a display */
+  argv[0] = (gchar *) CLUTTER_SCRIPT_COMPILER;
+  argv[1] = test_file;
+  argv[2] = compiled_file;
+  argv[3] = NULL;
+
+  g_spawn_sync (NULL, argv, NULL, G_SPAWN_DEFAULT,
+                NULL, NULL,
+                NULL, NULL,
+                &status,
+                &error);
+  g_assert_no_error (error);
+
+  g_spawn_check_exit_status (status, &error);
+  g_assert_no_error (error);
+
+  /* a compiled UI definition is the serialized JSON tree after a magic
+   * string, with the enumerations, flags and colors already resolved
+   */
+  g_file_get_contents (compiled_file, &contents, &length, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (length, >, 8);
+  g_assert (memcmp (contents, "CLSCRIPT", 8) == 0);
+
+  variant = g_variant_new_from_data (G_VARIANT_TYPE_VARIANT,
+                                     contents + 8, length - 8,
+                                     FALSE,
+                                     NULL, NULL);
+  root = json_gvariant_deserialize (variant, NULL, &error);
+  g_assert_no_error (error);
+
+  object = json_node_get_object (root);
+  g_assert_cmpstr (json_object_get_string_member (object, "name"), ==, "Compiled Actor");
+  g_assert (json_node_get_value_type (json_object_get_member (object, "x-align")) == G_TYPE_INT64);
+  g_assert_cmpint (json_object_get_int_member (object, "x-align"), ==, CLUTTER_ACTOR_ALIGN_CENTER);
+  g_assert (json_node_get_value_type (json_object_get_member (object, "content-repeat")) == G_TYPE_INT64);
+  g_assert_cmpint (json_object_get_int_member (object, "content-repeat"), ==, CLUTTER_REPEAT_BOTH);
+
+  array = json_object_get_array_member (object, "background-color");
+  g_assert_cmpuint (json_array_get_length (array), ==, 4);
+  g_assert_cmpint (json_array_get_int_element (array, 0), ==, 0xff);
+  g_assert_cmpint (json_array_get_int_element (array, 1), ==, 0x00);
+  g_assert_cmpint (json_array_get_int_element (array, 2), ==, 0x00);
+  g_assert_cmpint (json_array_get_int_element (array, 3), ==, 0x80);
+
+  json_node_free (root);
+  g_variant_unref (variant);
+
+  /* compiled files are recognized by their header */
+  script = clutter_script_new ();
+  clutter_script_load_from_file (script, compiled_file, &error);
+  if (g_test_verbose () && error)
+    g_print ("Error: %s", error->message);
+
+  g_assert_no_error (error);
+
+  actor = CLUTTER_ACTOR (clutter_script_get_object (script, "test-actor"));
+  g_assert (CLUTTER_IS_ACTOR (actor));
+  g_assert_cmpstr (clutter_actor_get_name (actor), ==, "Compiled Actor");
+  g_assert_cmpint (clutter_actor_get_x_align (actor), ==, CLUTTER_ACTOR_ALIGN_CENTER);
+  g_assert_cmpint (clutter_actor_get_content_repeat (actor), ==, CLUTTER_REPEAT_BOTH);
+
+  clutter_actor_get_background_color (actor, &color);
+  g_assert_cmpint (color.red, ==, 0xff);
+  g_assert_cmpint (color.green, ==, 0x00);
+  g_assert_cmpint (color.blue, ==, 0x00);
+  g_assert_cmpint (color.alpha, ==, 0x80);
+
+  g_object_unref (script);
+
+  /* compiled data does not need to be aligned */
+  buffer = g_malloc (length + 1);
+  memcpy (buffer + 1, contents, length);
+
+  script = clutter_script_new ();
+  clutter_script_load_from_data (script, buffer + 1, length, &error);
+  g_assert_no_error (error);
+  g_assert (CLUTTER_IS_ACTOR (clutter_script_get_object (script, "test-actor")));
+  g_object_unref (script);
+
+  g_unlink (compiled_file);
+
+  g_free (buffer);
+  g_free (contents);
+  g_free (compiled_file);
+  g_free (test_file);
+}
+
+static void
+script_lazy_construction (void)
+{
+  ClutterScript *script = clutter_script_new ();
+  GObject *container, *actor;
+  GError *error = NULL;
+  gboolean focus_ret;
+  gchar *test_file;
+  guint n_groups;
+
+  clutter_script_set_lazy_construction (script, TRUE);
+
+  n_groups = n_test_groups;
+
+  test_file = g_test_build_filename (G_TEST_DIST, "scripts", "test-script-child.json", NULL);
+  clutter_script_load_from_file (script, test_file, &error);
+  g_assert_no_error (error);
+
+  /* nothing is built until we ask for it */
+  g_assert_cmpuint (n_test_groups, ==, n_groups);
+
+  container = clutter_script_get_object (script, "test-group");
+  g_assert (TEST_IS_GROUP (container));
+  g_assert_cmpuint (n_test_groups, ==, n_groups + 1);
+
+  /* the children are built along with their parent */
+  actor = clutter_script_get_object (script, "test-rect-1");
+  g_assert (CLUTTER_IS_RECTANGLE (actor));
+  g_assert (clutter_actor_get_parent (CLUTTER_ACTOR (actor)) == CLUTTER_ACTOR (container));
+
+  focus_ret = FALSE;
+  clutter_container_child_get (CLUTTER_CONTAINER (container),
+                               CLUTTER_ACTOR (actor),
+                               "focus", &focus_ret,
+                               NULL);
+  g_assert (focus_ret);
+
+  g_assert_cmpuint (n_test_groups, ==, n_groups + 1);
+
+  g_object_unref (script);
+  g_free (test_file);
+}
+
+/* looked up by clutter_script_connect_signals() */
+G_MODULE_EXPORT void script_lazy_signals_on_hide (ClutterActor *actor,
+                                                  guint        *n_hidden);
+
+G_MODULE_EXPORT void
+script_lazy_signals_on_hide (ClutterActor *actor,
+                             guint        *n_hidden)
+{
+  *n_hidden += 1;
+}
+
+static void
+script_lazy_signals (void)
+{
+  ClutterScript *script = clutter_script_new ();
+  GObject *container;
+  GError *error = NULL;
+  gchar *test_file;
+  guint n_groups, n_hidden;
+
+  clutter_script_set_lazy_construction (script, TRUE);
+
+  n_groups = n_test_groups;
+  n_hidden = 0;
+
+  test_file = g_test_build_filename (G_TEST_DIST, "scripts", "test-script-lazy-signals.json", NULL);
+  clutter_script_load_from_file (script, test_file, &error);
+  g_assert_no_error (error);
+
+  /* connecting the signals does not build the objects */
+  clutter_script_connect_signals (script, &n_hidden);
+  g_assert_cmpuint (n_test_groups, ==, n_groups);
+
+  /* the signals are connected once the object is built */
+  container = clutter_script_get_object (script, "test-group");
+  g_assert (TEST_IS_GROUP (container));
+  g_assert_cmpuint (n_test_groups, ==, n_groups + 1);
+
+  clutter_actor_show (CLUTTER_ACTOR (container));
+  clutter_actor_hide (CLUTTER_ACTOR (container));
+  g_assert_cmpuint (n_hidden, ==, 1);
+
+  g_object_unref (script);
+  g_free (test_file);
+}
+
+static void
+script_color_array (void)
+{
+  static const char *test_data =
+    "{"
+    "  \"id\" : \"actor\","
+    "  \"type\" : \"ClutterActor\","
+    "  \"background-color\" : [ 255, 0, 128, 64 ]"
+    "}";
+  ClutterScript *script = clutter_script_new ();
+  ClutterColor color = { 0, };
+  GError *error = NULL;
+  GObject *actor;
+
+  clutter_script_load_from_data (script, test_data, -1, &error);
+  g_assert_no_error (error);
+
+  actor = clutter_script_get_object (script, "actor");
+  g_assert (CLUTTER_IS_ACTOR (actor));
+
+  clutter_actor_get_background_color (CLUTTER_ACTOR (actor), &color);
+  g_assert_cmpint (color.red, ==, 255);
+  g_assert_cmpint (color.green, ==, 0);
+  g_assert_cmpint (color.blue, ==, 128);
+  g_assert_cmpint (color.alpha, ==, 64);
+
+  g_object_unref (script);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/script/single-object", script_single)
   CLUTTER_TEST_UNIT ("/script/container-child", script_child)
@@ -424,4 +658,8 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/script/object-property", script_object_property)
   CLUTTER_TEST_UNIT ("/script/layout-property", script_layout_property)
   CLUTTER_TEST_UNIT ("/script/actor-margin", script_margin)
+  CLUTTER_TEST_UNIT ("/script/compiled", script_compiled)
+  CLUTTER_TEST_UNIT ("/script/color-array", script_color_array)
+  CLUTTER_TEST_UNIT ("/script/lazy-construction", script_lazy_construction)
+  CLUTTER_TEST_UNIT ("/script/lazy-signals", script_lazy_signals)
 )
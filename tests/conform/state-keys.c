@@ -0,0 +1,169 @@
+#define CLUTTER_DISABLE_DEPRECATION_WARNINGS
+#include <clutter/clutter.h>
+
+static void
+set_x_key (ClutterState *state,
+           const gchar  *source_state_name,
+           const gchar  *target_state_name,
+           ClutterActor *actor,
+           gfloat        x)
+{
+  GValue value = G_VALUE_INIT;
+
+  g_value_init (&value, G_TYPE_FLOAT);
+  g_value_set_float (&value, x);
+
+  clutter_state_set_key (state, source_state_name, target_state_name,
+                         G_OBJECT (actor), "x",
+                         CLUTTER_LINEAR,
+                         &value,
+                         0.0, 0.0);
+
+  g_value_unset (&value);
+}
+
+static guint
+count_keys (ClutterState *state,
+            const gchar  *source_state_name,
+            const gchar  *target_state_name,
+            ClutterActor *actor,
+            const gchar  *property_name)
+{
+  GList *keys;
+  guint n_keys;
+
+  keys = clutter_state_get_keys (state, source_state_name, target_state_name,
+                                 actor != NULL ? G_OBJECT (actor) : NULL,
+                                 property_name);
+  n_keys = g_list_length (keys);
+  g_list_free (keys);
+
+  return n_keys;
+}
+
+static void
+state_keys_set_and_get (void)
+{
+  ClutterState *state = clutter_state_new ();
+  ClutterActor *actor = clutter_actor_new ();
+  GList *keys;
+
+  g_object_ref_sink (actor);
+
+  set_x_key (state, NULL, "a", actor, 10);
+  set_x_key (state, NULL, "b", actor, 50);
+  set_x_key (state, "a", "b", actor, 100);
+  clutter_state_set (state, NULL, "b", actor, "y", CLUTTER_LINEAR, 30.0, NULL);
+
+  g_assert_cmpint (count_keys (state, NULL, NULL, NULL, NULL), ==, 4);
+  g_assert_cmpint (count_keys (state, NULL, "b", NULL, NULL), ==, 3);
+  g_assert_cmpint (count_keys (state, NULL, "b", actor, "x"), ==, 2);
+  g_assert_cmpint (count_keys (state, "a", "b", actor, "x"), ==, 1);
+  g_assert_cmpint (count_keys (state, NULL, "b", actor, "y"), ==, 1);
+
+  /* the keys of a state are sorted by object and property, and the key
+   * with a source state comes before the key without one
+   */
+  keys = clutter_state_get_keys (state, NULL, "b", G_OBJECT (actor), "x");
+  g_assert_cmpstr (clutter_state_key_get_source_state_name (keys->data), ==, "a");
+  g_assert (clutter_state_key_get_source_state_name (keys->next->data) == NULL);
+  g_list_free (keys);
+
+  /* setting a key again replaces it */
+  set_x_key (state, "a", "b", actor, 120);
+  set_x_key (state, NULL, "b", actor, 60);
+  g_assert_cmpint (count_keys (state, NULL, "b", actor, "x"), ==, 2);
+
+  keys = clutter_state_get_keys (state, "a", "b", G_OBJECT (actor), "x");
+  g_assert_cmpint (g_list_length (keys), ==, 1);
+  {
+    GValue value = G_VALUE_INIT;
+
+    g_value_init (&value, G_TYPE_FLOAT);
+    clutter_state_key_get_value (keys->data, &value);
+    g_assert_cmpfloat (g_value_get_float (&value), ==, 120);
+    g_value_unset (&value);
+  }
+  g_list_free (keys);
+
+  g_object_unref (state);
+  g_object_unref (actor);
+}
+
+static void
+state_keys_source_precedence (void)
+{
+  ClutterState *state = clutter_state_new ();
+  ClutterActor *actor = clutter_actor_new ();
+
+  g_object_ref_sink (actor);
+
+  set_x_key (state, NULL, "a", actor, 10);
+  set_x_key (state, NULL, "b", actor, 50);
+  set_x_key (state, "a", "b", actor, 100);
+  set_x_key (state, NULL, "c", actor, 20);
+
+  clutter_state_warp_to_state (state, "a");
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 10);
+
+  /* the key from the source state wins over the key without a source */
+  clutter_state_warp_to_state (state, "b");
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 100);
+
+  clutter_state_warp_to_state (state, "c");
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 20);
+
+  /* from any other state, the key without a source is used */
+  clutter_state_warp_to_state (state, "b");
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 50);
+
+  g_object_unref (state);
+  g_object_unref (actor);
+}
+
+static void
+state_keys_remove (void)
+{
+  ClutterState *state = clutter_state_new ();
+  ClutterActor *actor = clutter_actor_new ();
+  ClutterActor *other = clutter_actor_new ();
+
+  g_object_ref_sink (actor);
+  g_object_ref_sink (other);
+
+  set_x_key (state, NULL, "a", actor, 10);
+  set_x_key (state, NULL, "b", actor, 50);
+  set_x_key (state, "a", "b", actor, 100);
+  set_x_key (state, NULL, "b", other, 70);
+
+  /* removing the key with a source falls back to the one without */
+  clutter_state_remove_key (state, "a", "b", G_OBJECT (actor), "x");
+  g_assert_cmpint (count_keys (state, NULL, "b", actor, "x"), ==, 1);
+  g_assert_cmpint (count_keys (state, "a", "b", actor, "x"), ==, 0);
+
+  clutter_state_warp_to_state (state, "a");
+  clutter_state_warp_to_state (state, "b");
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 50);
+  g_assert_cmpfloat (clutter_actor_get_x (other), ==, 70);
+
+  /* removing all the keys of an object keeps the keys of the others */
+  clutter_state_remove_key (state, NULL, NULL, G_OBJECT (actor), NULL);
+  g_assert_cmpint (count_keys (state, NULL, NULL, actor, NULL), ==, 0);
+  g_assert_cmpint (count_keys (state, NULL, "b", other, "x"), ==, 1);
+
+  /* keys can be added back after their group went away */
+  set_x_key (state, NULL, "b", actor, 80);
+  set_x_key (state, "b", "b", actor, 90);
+  g_assert_cmpint (count_keys (state, NULL, "b", actor, "x"), ==, 2);
+  g_assert_cmpint (count_keys (state, NULL, "b", NULL, NULL), ==, 3);
+
+  g_object_unref (state);
+  g_object_unref (actor);
+  g_object_unref (other);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/state/keys/set-and-get", state_keys_set_and_get)
+  CLUTTER_TEST_UNIT ("/state/keys/source-precedence", state_keys_source_precedence)
+  CLUTTER_TEST_UNIT ("/state/keys/remove", state_keys_remove)
+)
@@ -533,6 +533,132 @@ text_idempotent_use_markup (void)
   clutter_actor_destroy (CLUTTER_ACTOR (text));
 }
 
+static void
+on_queue_relayout (ClutterActor *actor,
+                   gint         *n_relayouts)
+{
+  *n_relayouts += 1;
+}
+
+static void
+text_edit_relayout (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterText *text;
+  int n_relayouts = 0;
+
+  text = CLUTTER_TEXT (clutter_text_new ());
+  clutter_text_set_editable (text, TRUE);
+  clutter_text_set_line_wrap (text, TRUE);
+  clutter_text_set_text (text, "foo bar\nbaz");
+  clutter_actor_set_width (CLUTTER_ACTOR (text), 200);
+  clutter_actor_add_child (stage, CLUTTER_ACTOR (text));
+
+  clutter_actor_allocate_preferred_size (CLUTTER_ACTOR (text),
+                                         CLUTTER_ALLOCATION_NONE);
+
+  g_signal_connect (text, "queue-relayout",
+                    G_CALLBACK (on_queue_relayout),
+                    &n_relayouts);
+
+  /* an edit that does not change the number of lines only needs
+   * a redraw of the edited paragraph
+   */
+  clutter_text_insert_text (text, "o", 1);
+  g_assert_cmpstr (clutter_text_get_text (text), ==, "fooo bar\nbaz");
+  g_assert_cmpint (n_relayouts, ==, 0);
+
+  clutter_text_delete_text (text, 9, 10);
+  g_assert_cmpstr (clutter_text_get_text (text), ==, "fooo bar\naz");
+  g_assert_cmpint (n_relayouts, ==, 0);
+
+  /* adding a new line changes the preferred height */
+  clutter_text_insert_text (text, "\n", -1);
+  g_assert_cmpint (n_relayouts, >, 0);
+
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+}
+
+static void
+text_rope_buffer (void)
+{
+  ClutterTextBuffer *buffer;
+  ClutterText *text;
+  GString *expected;
+  GRand *rand;
+  int i;
+
+  buffer = clutter_rope_text_buffer_new ();
+  text = CLUTTER_TEXT (clutter_text_new_with_buffer (buffer));
+  g_object_ref_sink (text);
+  g_object_unref (buffer);
+
+  expected = g_string_new (NULL);
+  rand = g_rand_new_with_seed (42);
+
+  /* mirror random edits on a GString, with enough text to span
+   * multiple pieces of the rope
+   */
+  for (i = 0; i < 2000; i++)
+    {
+      guint n_chars = g_utf8_strlen (expected->str, -1);
+      guint position = g_rand_int_range (rand, 0, n_chars + 1);
+
+      if (n_chars > 0 && g_rand_int_range (rand, 0, 4) == 0)
+        {
+          guint len = g_rand_int_range (rand, 1, 64);
+          gsize start, end;
+
+          len = MIN (len, n_chars - position);
+
+          start = g_utf8_offset_to_pointer (expected->str, position) - expected->str;
+          end = g_utf8_offset_to_pointer (expected->str, position + len) - expected->str;
+          g_string_erase (expected, start, end - start);
+
+          clutter_text_delete_text (text, position, position + len);
+        }
+      else
+        {
+          const TestData *t = &test_text_data[i % G_N_ELEMENTS (test_text_data)];
+          GString *chunk = g_string_new (NULL);
+          gsize at;
+          int j;
+
+          for (j = 0; j < 8; j++)
+            g_string_append_len (chunk, t->bytes, t->nbytes);
+
+          at = g_utf8_offset_to_pointer (expected->str, position) - expected->str;
+          g_string_insert_len (expected, at, chunk->str, chunk->len);
+
+          clutter_text_insert_text (text, chunk->str, position);
+
+          g_string_free (chunk, TRUE);
+        }
+
+      g_assert_cmpint (clutter_text_buffer_get_bytes (buffer), ==, expected->len);
+    }
+
+  g_assert_cmpstr (clutter_text_get_text (text), ==, expected->str);
+  g_assert_cmpint (clutter_text_buffer_get_length (buffer), ==,
+                   g_utf8_strlen (expected->str, -1));
+
+  for (i = 0; i < clutter_text_buffer_get_length (buffer); i += 97)
+    {
+      gsize offset = g_utf8_offset_to_pointer (expected->str, i) - expected->str;
+
+      g_assert_cmpint (clutter_rope_text_buffer_get_byte_offset (CLUTTER_ROPE_TEXT_BUFFER (buffer), i),
+                       ==,
+                       offset);
+      g_assert_cmpint (clutter_rope_text_buffer_get_position (CLUTTER_ROPE_TEXT_BUFFER (buffer), offset),
+                       ==,
+                       i);
+    }
+
+  g_rand_free (rand);
+  g_string_free (expected, TRUE);
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/text/utf8-validation", text_utf8_validation)
   CLUTTER_TEST_UNIT ("/text/set-empty", text_set_empty)
@@ -547,4 +673,6 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/text/cursor", text_cursor)
   CLUTTER_TEST_UNIT ("/text/event", text_event)
   CLUTTER_TEST_UNIT ("/text/idempotent-use-markup", text_idempotent_use_markup)
+  CLUTTER_TEST_UNIT ("/text/edit-relayout", text_edit_relayout)
+  CLUTTER_TEST_UNIT ("/text/rope-buffer", text_rope_buffer)
 )
@@ -0,0 +1,163 @@
+#include <string.h>
+#include <clutter/clutter.h>
+
+#define IMAGE_SIZE      64
+#define TILE_SIZE       32
+
+typedef enum {
+  TILE_LOAD,
+  TILE_FAIL,
+  TILE_SHORT
+} TileMode;
+
+typedef struct {
+  TileMode mode;
+  guint bpp;
+  guint n_requests;
+} TileData;
+
+static GBytes *
+get_tile (ClutterTiledImage *image,
+          guint              level,
+          guint              column,
+          guint              row,
+          guint              width,
+          guint              height,
+          guint             *row_stride,
+          gpointer           user_data)
+{
+  TileData *data = user_data;
+  gsize size;
+  guint8 *pixels;
+
+  data->n_requests += 1;
+
+  if (data->mode == TILE_FAIL)
+    return NULL;
+
+  *row_stride = width * data->bpp;
+
+  size = (gsize) *row_stride * height;
+  if (data->mode == TILE_SHORT)
+    size -= 1;
+
+  pixels = g_malloc (size);
+  memset (pixels, 0xff, size);
+
+  return g_bytes_new_take (pixels, size);
+}
+
+static ClutterActor *
+create_actor (ClutterContent *image)
+{
+  ClutterActor *actor = clutter_actor_new ();
+
+  clutter_actor_set_size (actor, IMAGE_SIZE, IMAGE_SIZE);
+  clutter_actor_set_content (actor, image);
+  clutter_actor_add_child (clutter_test_get_stage (), actor);
+
+  return actor;
+}
+
+static void
+wait_for_requests (TileData *data,
+                   guint     n_requests)
+{
+  while (data->n_requests < n_requests)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+tiled_image_failure (void)
+{
+  ClutterContent *image = clutter_tiled_image_new ();
+  TileData data = { TILE_FAIL, 4, 0 };
+  ClutterActor *actor;
+  int i;
+
+  clutter_tiled_image_set_source (CLUTTER_TILED_IMAGE (image),
+                                  IMAGE_SIZE, IMAGE_SIZE, TILE_SIZE,
+                                  COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                  get_tile, &data, NULL);
+  actor = create_actor (image);
+  clutter_actor_show (clutter_test_get_stage ());
+
+  /* the failed tiles are not cached... */
+  wait_for_requests (&data, 4);
+  g_assert_cmpuint (clutter_tiled_image_get_memory_usage (CLUTTER_TILED_IMAGE (image)), ==, 0);
+
+  /* ...and they are requested again in the next frame */
+  wait_for_requests (&data, 8);
+  g_assert_cmpuint (clutter_tiled_image_get_memory_usage (CLUTTER_TILED_IMAGE (image)), ==, 0);
+
+  /* data shorter than the tile is refused, once per tile */
+  for (i = 0; i < 4; i++)
+    g_test_expect_message ("Clutter", G_LOG_LEVEL_WARNING, "*too short*");
+
+  data.mode = TILE_SHORT;
+  wait_for_requests (&data, 12);
+  g_test_assert_expected_messages ();
+  g_assert_cmpuint (clutter_tiled_image_get_memory_usage (CLUTTER_TILED_IMAGE (image)), ==, 0);
+
+  /* once the source recovers, all the tiles get loaded */
+  data.mode = TILE_LOAD;
+  while (clutter_tiled_image_get_memory_usage (CLUTTER_TILED_IMAGE (image)) <
+         IMAGE_SIZE * IMAGE_SIZE * 4)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpuint (clutter_tiled_image_get_memory_usage (CLUTTER_TILED_IMAGE (image)), ==, IMAGE_SIZE * IMAGE_SIZE * 4);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (image);
+}
+
+static void
+tiled_image_eviction (void)
+{
+  ClutterContent *image = clutter_tiled_image_new ();
+  TileData data = { TILE_LOAD, 2, 0 };
+  ClutterActor *actor;
+  guint n_requests;
+
+  /* the cost of a tile depends on the pixel format */
+  clutter_tiled_image_set_source (CLUTTER_TILED_IMAGE (image),
+                                  IMAGE_SIZE, IMAGE_SIZE, TILE_SIZE,
+                                  COGL_PIXEL_FORMAT_RGB_565,
+                                  get_tile, &data, NULL);
+  clutter_tiled_image_set_memory_budget (CLUTTER_TILED_IMAGE (image),
+                                         TILE_SIZE * TILE_SIZE * 2);
+  g_assert_cmpuint (clutter_tiled_image_get_n_levels (CLUTTER_TILED_IMAGE (image)), ==, 2);
+
+  actor = create_actor (image);
+  clutter_actor_show (clutter_test_get_stage ());
+
+  /* the tiles painted by the current frame are kept over budget */
+  wait_for_requests (&data, 4);
+  g_assert_cmpuint (clutter_tiled_image_get_memory_usage (CLUTTER_TILED_IMAGE (image)), ==, IMAGE_SIZE * IMAGE_SIZE * 2);
+
+  /* at half size, the single tile of the next level is used, and the
+   * tiles of the full resolution level are released
+   */
+  n_requests = data.n_requests;
+  clutter_actor_set_scale (actor, 0.5, 0.5);
+  wait_for_requests (&data, n_requests + 1);
+
+  while (clutter_tiled_image_get_memory_usage (CLUTTER_TILED_IMAGE (image)) >
+         TILE_SIZE * TILE_SIZE * 2)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpuint (clutter_tiled_image_get_memory_usage (CLUTTER_TILED_IMAGE (image)), ==, TILE_SIZE * TILE_SIZE * 2);
+
+  /* the released tiles are requested again when needed */
+  n_requests = data.n_requests;
+  clutter_actor_set_scale (actor, 1.0, 1.0);
+  wait_for_requests (&data, n_requests + 4);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (image);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/tiled-image/failure", tiled_image_failure)
+  CLUTTER_TEST_UNIT ("/tiled-image/eviction", tiled_image_eviction)
+)
@@ -0,0 +1,92 @@
+#include <clutter/clutter.h>
+#include <clutter/x11/clutter-x11.h>
+
+typedef struct {
+  guint n_redraws;
+  cairo_rectangle_int_t area;
+} DamageData;
+
+static void
+on_queue_damage_redraw (ClutterX11TexturePixmap *texture,
+                        gint                     x,
+                        gint                     y,
+                        gint                     width,
+                        gint                     height,
+                        DamageData              *data)
+{
+  data->n_redraws += 1;
+  data->area.x = x;
+  data->area.y = y;
+  data->area.width = width;
+  data->area.height = height;
+}
+
+static void
+wait_for_redraws (DamageData *data,
+                  guint       n_redraws)
+{
+  while (data->n_redraws < n_redraws)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+texture_pixmap_damage_batching (void)
+{
+  ClutterActor *stage, *texture;
+  DamageData data = { 0, };
+
+  if (!clutter_check_windowing_backend (CLUTTER_WINDOWING_X11))
+    {
+      if (g_test_verbose ())
+        g_print ("Skipping, the X11 backend is not in use\n");
+
+      return;
+    }
+
+  stage = clutter_test_get_stage ();
+
+  texture = clutter_x11_texture_pixmap_new ();
+  clutter_actor_set_size (texture, 100, 100);
+  clutter_actor_add_child (stage, texture);
+  g_signal_connect (texture, "queue-damage-redraw",
+                    G_CALLBACK (on_queue_damage_redraw),
+                    &data);
+
+  clutter_actor_show (stage);
+
+  /* the updates of the same frame are coalesced */
+  clutter_x11_texture_pixmap_update_area (CLUTTER_X11_TEXTURE_PIXMAP (texture),
+                                          0, 0, 10, 10);
+  clutter_x11_texture_pixmap_update_area (CLUTTER_X11_TEXTURE_PIXMAP (texture),
+                                          50, 20, 5, 5);
+  clutter_x11_texture_pixmap_update_area (CLUTTER_X11_TEXTURE_PIXMAP (texture),
+                                          5, 40, 10, 10);
+  g_assert_cmpint (data.n_redraws, ==, 0);
+
+  wait_for_redraws (&data, 1);
+  g_assert_cmpint (data.n_redraws, ==, 1);
+  g_assert_cmpint (data.area.x, ==, 0);
+  g_assert_cmpint (data.area.y, ==, 0);
+  g_assert_cmpint (data.area.width, ==, 55);
+  g_assert_cmpint (data.area.height, ==, 50);
+
+  /* the next frame starts from an empty area */
+  clutter_x11_texture_pixmap_update_area (CLUTTER_X11_TEXTURE_PIXMAP (texture),
+                                          30, 30, 2, 3);
+
+  wait_for_redraws (&data, 2);
+  g_assert_cmpint (data.n_redraws, ==, 2);
+  g_assert_cmpint (data.area.x, ==, 30);
+  g_assert_cmpint (data.area.y, ==, 30);
+  g_assert_cmpint (data.area.width, ==, 2);
+  g_assert_cmpint (data.area.height, ==, 3);
+
+  /* destroying the texture with pending damage drops it */
+  clutter_x11_texture_pixmap_update_area (CLUTTER_X11_TEXTURE_PIXMAP (texture),
+                                          0, 0, 1, 1);
+  clutter_actor_destroy (texture);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/x11-texture-pixmap/damage-batching", texture_pixmap_damage_batching)
+)
@@ -0,0 +1,128 @@
+#include <stdlib.h>
+#include <math.h>
+#include <cairo.h>
+#include <gmodule.h>
+#include <clutter/clutter.h>
+
+#define IMAGE_SIZE      16384
+#define TILE_SIZE       256
+
+static GBytes *
+generate_tile (ClutterTiledImage *image,
+               guint              level,
+               guint              column,
+               guint              row,
+               guint              width,
+               guint              height,
+               guint             *row_stride,
+               gpointer           user_data)
+{
+  cairo_surface_t *surface;
+  unsigned char *data;
+  char label[64];
+  int stride;
+  cairo_t *cr;
+
+  stride = cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, width);
+  data = g_malloc0 (stride * height);
+
+  surface = cairo_image_surface_create_for_data (data, CAIRO_FORMAT_ARGB32,
+                                                 width, height,
+                                                 stride);
+  cr = cairo_create (surface);
+
+  if ((column + row) % 2 == 0)
+    cairo_set_source_rgb (cr, 0.8, 0.8, 0.8);
+  else
+    cairo_set_source_rgb (cr, 0.4, 0.4, 0.6);
+  cairo_paint (cr);
+
+  cairo_set_source_rgb (cr, 0, 0, 0);
+  cairo_rectangle (cr, 0.5, 0.5, width - 1, height - 1);
+  cairo_stroke (cr);
+
+  g_snprintf (label, sizeof (label), "L%u (%u, %u)", level, column, row);
+  cairo_move_to (cr, 8, 24);
+  cairo_set_font_size (cr, 16);
+  cairo_show_text (cr, label);
+
+  cairo_destroy (cr);
+  cairo_surface_destroy (surface);
+
+  *row_stride = stride;
+
+  return g_bytes_new_take (data, stride * height);
+}
+
+static gboolean
+on_scroll (ClutterActor *actor,
+           ClutterEvent *event)
+{
+  double scale;
+
+  clutter_actor_get_scale (actor, &scale, NULL);
+
+  switch (clutter_event_get_scroll_direction (event))
+    {
+    case CLUTTER_SCROLL_UP:
+      scale = MIN (scale * 1.25, 1.0);
+      break;
+
+    case CLUTTER_SCROLL_DOWN:
+      scale = MAX (scale / 1.25, 1.0 / 64);
+      break;
+
+    default:
+      return CLUTTER_EVENT_PROPAGATE;
+    }
+
+  clutter_actor_save_easing_state (actor);
+  clutter_actor_set_scale (actor, scale, scale);
+  clutter_actor_restore_easing_state (actor);
+
+  return CLUTTER_EVENT_STOP;
+}
+
+G_MODULE_EXPORT int
+test_tiled_image_main (int argc, char *argv[])
+{
+  ClutterActor *stage, *actor;
+  ClutterContent *image;
+
+  if (clutter_init (&argc, &argv) != CLUTTER_INIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  stage = clutter_stage_new ();
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Tiled Image");
+  clutter_stage_set_user_resizable (CLUTTER_STAGE (stage), TRUE);
+  g_signal_connect (stage, "destroy", G_CALLBACK (clutter_main_quit), NULL);
+  clutter_actor_show (stage);
+
+  image = clutter_tiled_image_new ();
+  clutter_tiled_image_set_source (CLUTTER_TILED_IMAGE (image),
+                                  IMAGE_SIZE, IMAGE_SIZE,
+                                  TILE_SIZE,
+                                  CLUTTER_CAIRO_FORMAT_ARGB32,
+                                  generate_tile,
+                                  NULL, NULL);
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_content (actor, image);
+  clutter_actor_set_size (actor, IMAGE_SIZE, IMAGE_SIZE);
+  clutter_actor_set_scale (actor, 1.0 / 32, 1.0 / 32);
+  clutter_actor_set_reactive (actor, TRUE);
+  clutter_actor_add_action (actor, clutter_drag_action_new ());
+  g_signal_connect (actor, "scroll-event", G_CALLBACK (on_scroll), NULL);
+  clutter_actor_add_child (stage, actor);
+  g_object_unref (image);
+
+  clutter_main ();
+
+  return EXIT_SUCCESS;
+}
+
+G_MODULE_EXPORT const char *
+test_tiled_image_describe (void)
+{
+  return "Display a very large image using tiles.";
+}
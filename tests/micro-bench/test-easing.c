@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_ITERATIONS 200
+
+static gint n_iterations = N_ITERATIONS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-iterations", 'i',
+    0,
+    G_OPTION_ARG_INT, &n_iterations,
+    "Number of iterations", "ITERATIONS"
+  },
+  { NULL }
+};
+
+static const struct {
+  ClutterAnimationMode mode;
+  const char *name;
+} modes[] = {
+  { CLUTTER_LINEAR, "linear" },
+  { CLUTTER_EASE_IN_OUT_CUBIC, "easeInOutCubic" },
+  { CLUTTER_EASE_IN_OUT_EXPO, "easeInOutExpo" },
+  { CLUTTER_EASE_IN_OUT_ELASTIC, "easeInOutElastic" },
+  { CLUTTER_EASE_IN_OUT_BOUNCE, "easeInOutBounce" },
+  { CLUTTER_EASE, "ease" },
+  { CLUTTER_EASE_IN_OUT, "easeInOut" },
+};
+
+/* the previous implementation of the cubic bezier easing, which
+ * bisects the curve on every evaluation
+ */
+static double
+reference_bezier_sample (double t,
+                         double c_1,
+                         double c_2)
+{
+  double omt = 1.0 - t;
+
+  return 3.0 * omt * omt * t * c_1
+       + 3.0 * omt * t * t * c_2
+       + t * t * t;
+}
+
+static double
+reference_cubic_bezier (double p,
+                        double x_1,
+                        double y_1,
+                        double x_2,
+                        double y_2)
+{
+  double min_t = 0, max_t = 1;
+  int i;
+
+  for (i = 0; i < 30; i++)
+    {
+      double guess_t = (min_t + max_t) / 2.0;
+
+      if (p < reference_bezier_sample (guess_t, x_1, x_2))
+        max_t = guess_t;
+      else
+        min_t = guess_t;
+    }
+
+  return reference_bezier_sample ((min_t + max_t) / 2.0, y_1, y_2);
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterTimeline *timeline;
+  GError *error = NULL;
+  GTimer *timer;
+  guint duration, i;
+  double sum = 0.0;
+  gint n;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  duration = 1000;
+  timeline = clutter_timeline_new (duration);
+  timer = g_timer_new ();
+
+  printf ("Easing performance test, %d x %u evaluations\n",
+          n_iterations,
+          duration);
+
+  for (i = 0; i < G_N_ELEMENTS (modes); i++)
+    {
+      clutter_timeline_set_progress_mode (timeline, modes[i].mode);
+
+      g_timer_start (timer);
+
+      for (n = 0; n < n_iterations; n++)
+        {
+          guint msecs;
+
+          for (msecs = 0; msecs < duration; msecs++)
+            {
+              clutter_timeline_advance (timeline, msecs);
+              sum += clutter_timeline_get_progress (timeline);
+            }
+        }
+
+      g_timer_stop (timer);
+
+      printf ("%-20s: %.1f ns per evaluation\n",
+              modes[i].name,
+              g_timer_elapsed (timer, NULL) * 1e9 / (n_iterations * duration));
+    }
+
+  g_timer_start (timer);
+
+  for (n = 0; n < n_iterations; n++)
+    {
+      guint msecs;
+
+      for (msecs = 0; msecs < duration; msecs++)
+        sum += reference_cubic_bezier ((double) msecs / duration,
+                                       0.42, 0.0, 0.58, 1.0);
+    }
+
+  g_timer_stop (timer);
+
+  printf ("%-20s: %.1f ns per evaluation\n",
+          "reference easeInOut",
+          g_timer_elapsed (timer, NULL) * 1e9 / (n_iterations * duration));
+
+  /* keep the compiler from discarding the evaluations */
+  if (sum < 0.0)
+    printf ("%g\n", sum);
+
+  g_timer_destroy (timer);
+  g_object_unref (timeline);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_EVENTS 100000
+#define BURST_SIZE 32
+
+static gint n_events = N_EVENTS;
+static gint burst_size = BURST_SIZE;
+
+static GOptionEntry entries[] = {
+  {
+    "num-events", 'e',
+    0,
+    G_OPTION_ARG_INT, &n_events,
+    "Number of events to replay", "EVENTS"
+  },
+  {
+    "burst-size", 'b',
+    0,
+    G_OPTION_ARG_INT, &burst_size,
+    "Number of events put before waiting for their delivery", "EVENTS"
+  },
+  { NULL }
+};
+
+static guint n_delivered = 0;
+
+/* NOTE: the events are replayed through clutter_event_put(); the event
+ * source of the backend hands all the events put in a burst to the
+ * stage as a single batch, like the evdev backend does with the events
+ * read from libinput, so the burst size is also the size of the batches
+ * going through the event queue of the stage
+ */
+
+/* a stand-in for a recording of an input device: a pointer moving
+ * in circles at 1 kHz, with a click every 100 events, interleaved
+ * with two fingers touching the screen
+ */
+static GPtrArray *
+generate_recording (ClutterStage       *stage,
+                    ClutterInputDevice *device)
+{
+  GPtrArray *recording;
+  guint32 base_time = clutter_get_current_event_time ();
+  gint i;
+
+  recording = g_ptr_array_new_with_free_func ((GDestroyNotify) clutter_event_free);
+
+  for (i = 0; i < n_events; i++)
+    {
+      ClutterEvent *event;
+      gdouble angle = i * G_PI / 500.0;
+      gint phase = i % 100;
+
+      if (phase == 0)
+        event = clutter_event_new (CLUTTER_BUTTON_PRESS);
+      else if (phase == 1)
+        event = clutter_event_new (CLUTTER_BUTTON_RELEASE);
+      else if (phase == 50)
+        event = clutter_event_new (CLUTTER_TOUCH_BEGIN);
+      else if (phase == 99)
+        event = clutter_event_new (CLUTTER_TOUCH_END);
+      else if (phase > 50)
+        event = clutter_event_new (CLUTTER_TOUCH_UPDATE);
+      else
+        event = clutter_event_new (CLUTTER_MOTION);
+
+      if (event->type == CLUTTER_BUTTON_PRESS ||
+          event->type == CLUTTER_BUTTON_RELEASE)
+        event->button.button = CLUTTER_BUTTON_PRIMARY;
+
+      if (event->type >= CLUTTER_TOUCH_BEGIN &&
+          event->type <= CLUTTER_TOUCH_CANCEL)
+        event->touch.sequence = GINT_TO_POINTER (1 + (i / 100) % 2);
+
+      clutter_event_set_stage (event, stage);
+      clutter_event_set_device (event, device);
+      clutter_event_set_source_device (event, device);
+      clutter_event_set_coords (event,
+                                400.f + 200.f * cos (angle),
+                                300.f + 200.f * sin (angle));
+      clutter_event_set_time (event, base_time + i);
+
+      g_ptr_array_add (recording, event);
+    }
+
+  return recording;
+}
+
+static gboolean
+on_captured_event (ClutterActor *stage,
+                   ClutterEvent *event,
+                   gpointer      dummy)
+{
+  switch (clutter_event_type (event))
+    {
+    case CLUTTER_MOTION:
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_BUTTON_RELEASE:
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_UPDATE:
+    case CLUTTER_TOUCH_END:
+      n_delivered += 1;
+      break;
+
+    default:
+      break;
+    }
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterDeviceManager *manager;
+  ClutterInputDevice *device;
+  ClutterActor *stage;
+  GPtrArray *recording;
+  GError *error = NULL;
+  GTimer *timer;
+  gdouble elapsed;
+  guint i, n_sent;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, 800, 600);
+
+  /* every event of the recording should reach the stage */
+  clutter_stage_set_throttle_motion_events (CLUTTER_STAGE (stage), FALSE);
+  g_signal_connect (stage, "captured-event",
+                    G_CALLBACK (on_captured_event),
+                    NULL);
+  clutter_actor_show (stage);
+
+  manager = clutter_device_manager_get_default ();
+  device = clutter_device_manager_get_core_device (manager,
+                                                   CLUTTER_POINTER_DEVICE);
+
+  recording = generate_recording (CLUTTER_STAGE (stage), device);
+
+  printf ("Putting %u events, %d at a time\n",
+          recording->len,
+          burst_size);
+
+  timer = g_timer_new ();
+
+  for (i = 0, n_sent = 0; i < recording->len; i++)
+    {
+      clutter_event_put (g_ptr_array_index (recording, i));
+      n_sent += 1;
+
+      if (n_sent % burst_size != 0 && i < recording->len - 1)
+        continue;
+
+      while (n_delivered < n_sent)
+        g_main_context_iteration (NULL, TRUE);
+    }
+
+  g_timer_stop (timer);
+  elapsed = g_timer_elapsed (timer, NULL);
+
+  printf ("%u events delivered in %.3f ms: %.0f events/sec\n",
+          n_delivered,
+          elapsed * 1000.0,
+          n_delivered / elapsed);
+
+  g_timer_destroy (timer);
+  g_ptr_array_unref (recording);
+  clutter_actor_destroy (stage);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_EVENTS 1000000
+#define DEPTH 20
+#define BURST_SIZE 256
+
+static gint n_events = N_EVENTS;
+static gint depth = DEPTH;
+static gint burst_size = BURST_SIZE;
+
+static GOptionEntry entries[] = {
+  {
+    "num-events", 'e',
+    0,
+    G_OPTION_ARG_INT, &n_events,
+    "Number of motion events to deliver", "EVENTS"
+  },
+  {
+    "depth", 'd',
+    0,
+    G_OPTION_ARG_INT, &depth,
+    "Number of nested actors above the event source", "DEPTH"
+  },
+  {
+    "burst-size", 'b',
+    0,
+    G_OPTION_ARG_INT, &burst_size,
+    "Number of events queued at once", "EVENTS"
+  },
+  { NULL }
+};
+
+static guint n_captured = 0;
+static guint n_delivered = 0;
+
+static gboolean
+on_captured_event (ClutterActor *actor,
+                   ClutterEvent *event,
+                   gpointer      dummy)
+{
+  if (clutter_event_type (event) == CLUTTER_MOTION)
+    n_captured += 1;
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static gboolean
+on_motion_event (ClutterActor *actor,
+                 ClutterEvent *event,
+                 gpointer      dummy)
+{
+  n_delivered += 1;
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterDeviceManager *manager;
+  ClutterInputDevice *device;
+  ClutterActor *stage, *parent, *leaf;
+  GError *error = NULL;
+  GTimer *timer;
+  gdouble elapsed;
+  gint i;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, 800, 600);
+  clutter_stage_set_throttle_motion_events (CLUTTER_STAGE (stage), FALSE);
+
+  /* a chain of reactive actors, each one inside the previous one; every
+   * actor of the chain receives the events in both phases
+   */
+  parent = stage;
+  leaf = stage;
+  for (i = 0; i < depth; i++)
+    {
+      leaf = clutter_actor_new ();
+      clutter_actor_set_position (leaf, 5, 5);
+      clutter_actor_set_size (leaf, 700 - 10 * i, 500 - 10 * i);
+      clutter_actor_set_reactive (leaf, TRUE);
+      g_signal_connect (leaf, "captured-event",
+                        G_CALLBACK (on_captured_event),
+                        NULL);
+      g_signal_connect (leaf, "motion-event",
+                        G_CALLBACK (on_motion_event),
+                        NULL);
+      clutter_actor_add_child (parent, leaf);
+
+      parent = leaf;
+    }
+
+  clutter_actor_show (stage);
+
+  manager = clutter_device_manager_get_default ();
+  device = clutter_device_manager_get_core_device (manager,
+                                                   CLUTTER_POINTER_DEVICE);
+
+  /* the time includes queueing the events, running the main loop and
+   * picking the source of each event, as well as building the event
+   * chain and emitting the signals on each actor
+   */
+  printf ("Delivering %d motion events through %d actors\n"
+          "(timing event queueing, main loop, picking and emission)\n",
+          n_events, depth + 1);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_events; i++)
+    {
+      ClutterEvent *event = clutter_event_new (CLUTTER_MOTION);
+
+      /* the scene does not change, so all the events but the first
+       * should reach the same actor without a full pick
+       */
+      clutter_event_set_stage (event, CLUTTER_STAGE (stage));
+      clutter_event_set_device (event, device);
+      clutter_event_set_source_device (event, device);
+      clutter_event_set_coords (event, 200.f, 200.f);
+      clutter_event_set_time (event, clutter_get_current_event_time ());
+      clutter_event_put (event);
+      clutter_event_free (event);
+
+      if ((i + 1) % burst_size != 0 && i < n_events - 1)
+        continue;
+
+      while (n_delivered < (guint) (i + 1) * depth)
+        g_main_context_iteration (NULL, TRUE);
+    }
+
+  g_timer_stop (timer);
+  elapsed = g_timer_elapsed (timer, NULL);
+
+  printf ("%u emissions (%u captured) in %.3f ms: %.0f events/sec\n",
+          n_delivered,
+          n_captured,
+          elapsed * 1000.0,
+          n_events / elapsed);
+
+  g_timer_destroy (timer);
+  clutter_actor_destroy (stage);
+
+  return EXIT_SUCCESS;
+}
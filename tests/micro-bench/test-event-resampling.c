@@ -0,0 +1,296 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define RATE 240
+#define DURATION 2000
+
+static gchar *trace_file = NULL;
+static gint rate = RATE;
+static gint duration = DURATION;
+
+static GOptionEntry entries[] = {
+  {
+    "trace", 't',
+    0,
+    G_OPTION_ARG_FILENAME, &trace_file,
+    "Replay the 'time x y' samples in FILE, with times in milliseconds", "FILE"
+  },
+  {
+    "rate", 'r',
+    0,
+    G_OPTION_ARG_INT, &rate,
+    "Sample rate of the generated trace", "HZ"
+  },
+  {
+    "duration", 'd',
+    0,
+    G_OPTION_ARG_INT, &duration,
+    "Duration of the generated trace", "MSECS"
+  },
+  { NULL }
+};
+
+typedef struct {
+  gdouble time;
+  gfloat x, y;
+} Sample;
+
+typedef struct {
+  GArray *trace;
+
+  ClutterActor *stage;
+  ClutterInputDevice *device;
+
+  gint64 start_time;
+  guint32 base_event_time;
+  guint next_sample;
+
+  /* statistics of the delivered events */
+  guint n_events;
+  gdouble error_sum;
+  gdouble error_max;
+  gdouble step_sum;
+  gdouble step_sq_sum;
+  gboolean has_last;
+  gfloat last_x, last_y;
+} Replay;
+
+static GArray *
+generate_trace (void)
+{
+  GArray *trace = g_array_new (FALSE, FALSE, sizeof (Sample));
+  gint i, n_samples = duration * rate / 1000;
+
+  /* a circular drag, one revolution per second */
+  for (i = 0; i < n_samples; i++)
+    {
+      Sample sample;
+
+      sample.time = i * 1000.0 / rate;
+      sample.x = 400.f + 200.f * cos (sample.time * 2.0 * G_PI / 1000.0);
+      sample.y = 300.f + 200.f * sin (sample.time * 2.0 * G_PI / 1000.0);
+      g_array_append_val (trace, sample);
+    }
+
+  return trace;
+}
+
+static GArray *
+load_trace (const gchar *filename)
+{
+  GArray *trace;
+  gchar *contents, **lines;
+  GError *error = NULL;
+  gint i;
+
+  if (!g_file_get_contents (filename, &contents, NULL, &error))
+    {
+      g_printerr ("Unable to load '%s': %s\n", filename, error->message);
+      exit (EXIT_FAILURE);
+    }
+
+  trace = g_array_new (FALSE, FALSE, sizeof (Sample));
+  lines = g_strsplit (contents, "\n", -1);
+
+  for (i = 0; lines[i] != NULL; i++)
+    {
+      Sample sample;
+
+      if (lines[i][0] == '#')
+        continue;
+
+      if (sscanf (lines[i], "%lf %f %f", &sample.time, &sample.x, &sample.y) == 3)
+        g_array_append_val (trace, sample);
+    }
+
+  g_strfreev (lines);
+  g_free (contents);
+
+  return trace;
+}
+
+/* the position of the trace at @time, which is what the user sees
+ * under the finger when the frame is presented
+ */
+static void
+trace_get_position (GArray  *trace,
+                    gdouble  time,
+                    gfloat  *x,
+                    gfloat  *y)
+{
+  const Sample *a, *b;
+  gdouble alpha;
+  guint i;
+
+  for (i = 1; i < trace->len - 1; i++)
+    {
+      if (g_array_index (trace, Sample, i).time >= time)
+        break;
+    }
+
+  a = &g_array_index (trace, Sample, i - 1);
+  b = &g_array_index (trace, Sample, i);
+
+  alpha = (time - a->time) / MAX (b->time - a->time, 0.001);
+  alpha = CLAMP (alpha, 0.0, 1.0);
+
+  *x = a->x + (b->x - a->x) * alpha;
+  *y = a->y + (b->y - a->y) * alpha;
+}
+
+static gboolean
+feed_events (gpointer data)
+{
+  Replay *replay = data;
+  gdouble elapsed;
+
+  elapsed = (g_get_monotonic_time () - replay->start_time) / 1000.0;
+
+  while (replay->next_sample < replay->trace->len)
+    {
+      const Sample *sample = &g_array_index (replay->trace, Sample,
+                                             replay->next_sample);
+      ClutterEvent *event;
+
+      if (sample->time > elapsed)
+        return G_SOURCE_CONTINUE;
+
+      event = clutter_event_new (CLUTTER_MOTION);
+      clutter_event_set_stage (event, CLUTTER_STAGE (replay->stage));
+      clutter_event_set_device (event, replay->device);
+      clutter_event_set_coords (event, sample->x, sample->y);
+      clutter_event_set_time (event, replay->base_event_time + sample->time);
+      clutter_event_put (event);
+      clutter_event_free (event);
+
+      replay->next_sample += 1;
+    }
+
+  clutter_main_quit ();
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+on_captured_event (ClutterActor *stage,
+                   ClutterEvent *event,
+                   Replay       *replay)
+{
+  gfloat x, y, real_x, real_y, step;
+  gdouble elapsed, error;
+
+  if (clutter_event_type (event) != CLUTTER_MOTION)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  elapsed = (g_get_monotonic_time () - replay->start_time) / 1000.0;
+
+  clutter_event_get_coords (event, &x, &y);
+  trace_get_position (replay->trace, elapsed, &real_x, &real_y);
+
+  error = sqrt ((x - real_x) * (x - real_x) + (y - real_y) * (y - real_y));
+  replay->error_sum += error;
+  replay->error_max = MAX (replay->error_max, error);
+
+  if (replay->has_last)
+    {
+      step = sqrt ((x - replay->last_x) * (x - replay->last_x) +
+                   (y - replay->last_y) * (y - replay->last_y));
+      replay->step_sum += step;
+      replay->step_sq_sum += step * step;
+    }
+
+  replay->last_x = x;
+  replay->last_y = y;
+  replay->has_last = TRUE;
+  replay->n_events += 1;
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static void
+run_replay (GArray   *trace,
+            gboolean  resample)
+{
+  ClutterDeviceManager *manager;
+  Replay replay = { 0, };
+  gdouble step_mean, step_dev;
+  guint n_steps;
+
+  replay.trace = trace;
+
+  manager = clutter_device_manager_get_default ();
+  replay.device =
+    clutter_device_manager_get_core_device (manager, CLUTTER_POINTER_DEVICE);
+
+  replay.stage = clutter_stage_new ();
+  clutter_actor_set_size (replay.stage, 800, 600);
+  clutter_stage_set_resample_motion_events (CLUTTER_STAGE (replay.stage),
+                                            resample);
+  g_signal_connect (replay.stage, "captured-event",
+                    G_CALLBACK (on_captured_event),
+                    &replay);
+  clutter_actor_show (replay.stage);
+
+  replay.start_time = g_get_monotonic_time ();
+  replay.base_event_time = clutter_get_current_event_time ();
+  clutter_threads_add_timeout (1, feed_events, &replay);
+
+  clutter_main ();
+
+  n_steps = MAX (replay.n_events, 2) - 1;
+  step_mean = replay.step_sum / n_steps;
+  step_dev = sqrt (MAX (replay.step_sq_sum / n_steps - step_mean * step_mean, 0));
+
+  printf ("%-12s %6u frames, error: %7.2f px mean, %7.2f px max, "
+          "step: %6.2f px mean, %6.2f px deviation\n",
+          resample ? "resampled" : "throttled",
+          replay.n_events,
+          replay.error_sum / MAX (replay.n_events, 1),
+          replay.error_max,
+          step_mean,
+          step_dev);
+
+  clutter_actor_destroy (replay.stage);
+}
+
+int
+main (int argc, char **argv)
+{
+  GArray *trace;
+  GError *error = NULL;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  if (trace_file != NULL)
+    trace = load_trace (trace_file);
+  else
+    trace = generate_trace ();
+
+  if (trace->len < 2)
+    {
+      g_printerr ("The trace needs at least two samples\n");
+      return EXIT_FAILURE;
+    }
+
+  printf ("Replaying %u samples over %.0f ms\n",
+          trace->len,
+          g_array_index (trace, Sample, trace->len - 1).time);
+
+  run_replay (trace, FALSE);
+  run_replay (trace, TRUE);
+
+  g_array_unref (trace);
+
+  return EXIT_SUCCESS;
+}
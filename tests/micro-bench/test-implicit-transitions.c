@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_ACTORS 50
+#define N_FRAMES 300
+
+static gint n_actors = N_ACTORS;
+static gint n_frames = N_FRAMES;
+static gboolean short_transitions = FALSE;
+
+static GOptionEntry entries[] = {
+  {
+    "num-actors", 'a',
+    0,
+    G_OPTION_ARG_INT, &n_actors,
+    "Number of actors", "ACTORS"
+  },
+  {
+    "num-frames", 'f',
+    0,
+    G_OPTION_ARG_INT, &n_frames,
+    "Number of frames", "FRAMES"
+  },
+  {
+    "short", 's',
+    0,
+    G_OPTION_ARG_NONE, &short_transitions,
+    "Let the transitions complete before retargeting them", NULL
+  },
+  { NULL }
+};
+
+static ClutterActor **actors = NULL;
+static GTimer *timer = NULL;
+static gint frame = 0;
+static guint n_retargets = 0;
+
+static gint
+get_n_instances (GType gtype)
+{
+#if GLIB_CHECK_VERSION (2, 44, 0)
+  return g_type_get_instance_count (gtype);
+#else
+  return -1;
+#endif
+}
+
+static void
+retarget_actors (void)
+{
+  gint i;
+
+  /* this is what a scroll-driven UI does on every motion event: the
+   * same properties get a new final value while the previous transition
+   * might still be running
+   */
+  for (i = 0; i < n_actors; i++)
+    {
+      ClutterActor *actor = actors[i];
+
+      clutter_actor_save_easing_state (actor);
+      clutter_actor_set_easing_duration (actor, short_transitions ? 1 : 250);
+      clutter_actor_set_position (actor,
+                                  (i * 37 + frame * 3) % 800,
+                                  (i * 53 + frame * 5) % 600);
+      clutter_actor_set_opacity (actor, (i + frame) % 256);
+      clutter_actor_restore_easing_state (actor);
+
+      n_retargets += 3;
+    }
+}
+
+static void
+on_new_frame (ClutterTimeline *timeline,
+              gint             msecs,
+              ClutterActor    *stage)
+{
+  static gint transitions_at_start = -1;
+  static gint intervals_at_start = -1;
+
+  if (frame == 0)
+    {
+      transitions_at_start = get_n_instances (CLUTTER_TYPE_PROPERTY_TRANSITION);
+      intervals_at_start = get_n_instances (CLUTTER_TYPE_INTERVAL);
+    }
+
+  if (frame++ < n_frames)
+    {
+      retarget_actors ();
+      return;
+    }
+
+  g_timer_stop (timer);
+
+  printf ("%d frames, %u retargets: %.3f ms per frame\n",
+          n_frames,
+          n_retargets,
+          g_timer_elapsed (timer, NULL) * 1000.0 / n_frames);
+
+  if (transitions_at_start >= 0 && intervals_at_start >= 0)
+    {
+      gint n_transitions, n_intervals;
+
+      n_transitions = get_n_instances (CLUTTER_TYPE_PROPERTY_TRANSITION);
+      n_intervals = get_n_instances (CLUTTER_TYPE_INTERVAL);
+
+      /* the counts are only available with GOBJECT_DEBUG=instance-count */
+      if (n_transitions > 0)
+        printf ("transitions: %d (+%d), intervals: %d (+%d)\n",
+                n_transitions, n_transitions - transitions_at_start,
+                n_intervals, n_intervals - intervals_at_start);
+      else
+        printf ("Run with GOBJECT_DEBUG=instance-count to get the "
+                "number of allocated transitions\n");
+    }
+
+  clutter_main_quit ();
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterTimeline *timeline;
+  ClutterActor *stage;
+  GError *error = NULL;
+  gint i;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, 800, 600);
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Implicit transitions");
+
+  printf ("Implicit transitions performance test with %d actors (%s)\n",
+          n_actors,
+          short_transitions ? "completed" : "running");
+
+  actors = g_new (ClutterActor *, n_actors);
+  for (i = 0; i < n_actors; i++)
+    {
+      actors[i] = clutter_actor_new ();
+      clutter_actor_set_background_color (actors[i], CLUTTER_COLOR_LightSkyBlue);
+      clutter_actor_set_size (actors[i], 8, 8);
+      clutter_actor_add_child (stage, actors[i]);
+    }
+
+  /* a timeline that is used only to count the frames */
+  timeline = clutter_timeline_new (1000);
+  clutter_timeline_set_repeat_count (timeline, -1);
+  g_signal_connect (timeline, "new-frame", G_CALLBACK (on_new_frame), stage);
+
+  clutter_actor_show (stage);
+
+  timer = g_timer_new ();
+  clutter_timeline_start (timeline);
+
+  clutter_main ();
+
+  g_free (actors);
+  g_timer_destroy (timer);
+  g_object_unref (timeline);
+  clutter_actor_destroy (stage);
+
+  return EXIT_SUCCESS;
+}
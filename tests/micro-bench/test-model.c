@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_ROWS 100000
+#define N_LOOKUPS 10000
+#define N_CHANGES 100
+
+static gint n_rows = N_ROWS;
+static gint n_lookups = N_LOOKUPS;
+static gint n_changes = N_CHANGES;
+
+static GOptionEntry entries[] = {
+  {
+    "num-rows", 'r',
+    0,
+    G_OPTION_ARG_INT, &n_rows,
+    "Number of rows in the model", "ROWS"
+  },
+  {
+    "num-lookups", 'l',
+    0,
+    G_OPTION_ARG_INT, &n_lookups,
+    "Number of rows looked up by position", "LOOKUPS"
+  },
+  {
+    "num-changes", 'c',
+    0,
+    G_OPTION_ARG_INT, &n_changes,
+    "Number of rows added and changed while sorted", "CHANGES"
+  },
+  { NULL }
+};
+
+static gboolean
+filter_even (ClutterModel     *model,
+             ClutterModelIter *iter,
+             gpointer          dummy)
+{
+  gint score;
+
+  clutter_model_iter_get (iter, 0, &score, -1);
+
+  return (score % 2) == 0;
+}
+
+static void
+report (const gchar *name,
+        GTimer      *timer,
+        gint         n_ops)
+{
+  printf ("  %-24s %10.3f ms (%.3f us per operation)\n",
+          name,
+          g_timer_elapsed (timer, NULL) * 1000.0,
+          g_timer_elapsed (timer, NULL) * 1000000.0 / MAX (n_ops, 1));
+}
+
+static void
+run_model (const gchar  *name,
+           ClutterModel *model)
+{
+  ClutterModelIter *iter;
+  GTimer *timer;
+  GRand *rand;
+  guint n_visible;
+  gint i;
+
+  printf ("%s, %d rows\n", name, n_rows);
+
+  rand = g_rand_new_with_seed (42);
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_rows; i++)
+    clutter_model_append (model,
+                          0, g_rand_int_range (rand, 0, n_rows),
+                          1, "row",
+                          -1);
+
+  g_timer_stop (timer);
+  report ("append", timer, n_rows);
+
+  /* filtering */
+  g_timer_start (timer);
+  clutter_model_set_filter (model, filter_even, NULL, NULL);
+  n_visible = clutter_model_get_n_rows (model);
+  g_timer_stop (timer);
+  report ("set filter", timer, 1);
+
+  g_timer_start (timer);
+  for (i = 0; i < n_lookups; i++)
+    {
+      iter = clutter_model_get_iter_at_row (model,
+                                            g_rand_int_range (rand, 0, n_visible));
+      g_object_unref (iter);
+    }
+  g_timer_stop (timer);
+  report ("filtered lookup", timer, n_lookups);
+
+  g_timer_start (timer);
+  iter = clutter_model_get_first_iter (model);
+  while (!clutter_model_iter_is_last (iter))
+    iter = clutter_model_iter_next (iter);
+  g_object_unref (iter);
+  g_timer_stop (timer);
+  report ("filtered iteration", timer, n_visible);
+
+  /* sorting */
+  g_timer_start (timer);
+  clutter_model_set_sorting_column (model, 0);
+  g_timer_stop (timer);
+  report ("sort", timer, 1);
+
+  g_timer_start (timer);
+  for (i = 0; i < n_changes; i++)
+    clutter_model_append (model,
+                          0, g_rand_int_range (rand, 0, n_rows),
+                          1, "added",
+                          -1);
+  g_timer_stop (timer);
+  report ("sorted append", timer, n_changes);
+
+  g_timer_start (timer);
+  for (i = 0; i < n_changes; i++)
+    {
+      GValue value = G_VALUE_INIT;
+
+      g_value_init (&value, G_TYPE_INT);
+      g_value_set_int (&value, g_rand_int_range (rand, 0, n_rows));
+      clutter_model_insert_value (model,
+                                  g_rand_int_range (rand, 0, n_visible),
+                                  0, &value);
+      g_value_unset (&value);
+    }
+  g_timer_stop (timer);
+  report ("sorted change", timer, n_changes);
+
+  g_timer_destroy (timer);
+  g_rand_free (rand);
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterModel *model;
+  GError *error = NULL;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  model = clutter_list_model_new (2, G_TYPE_INT, "Score", G_TYPE_STRING, "Name");
+  run_model ("ClutterListModel", model);
+  g_object_unref (model);
+
+  model = clutter_array_model_new (2, G_TYPE_INT, "Score", G_TYPE_STRING, "Name");
+  run_model ("ClutterArrayModel", model);
+  g_object_unref (model);
+
+  return EXIT_SUCCESS;
+}
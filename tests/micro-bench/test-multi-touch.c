@@ -0,0 +1,191 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_TOUCHES 10
+#define N_ACTIONS 10
+#define N_FRAMES 500
+
+static gint n_touches = N_TOUCHES;
+static gint n_actions = N_ACTIONS;
+static gint n_frames = N_FRAMES;
+
+static GOptionEntry entries[] = {
+  {
+    "num-touches", 't',
+    0,
+    G_OPTION_ARG_INT, &n_touches,
+    "Number of touch points down at once", "TOUCHES"
+  },
+  {
+    "num-actions", 'a',
+    0,
+    G_OPTION_ARG_INT, &n_actions,
+    "Number of gesture actions on the touched actor", "ACTIONS"
+  },
+  {
+    "num-frames", 'f',
+    0,
+    G_OPTION_ARG_INT, &n_frames,
+    "Number of updates of each touch point", "FRAMES"
+  },
+  { NULL }
+};
+
+static guint n_sent = 0;
+static guint n_delivered = 0;
+static guint n_progress = 0;
+
+static gboolean
+on_captured_event (ClutterActor *stage,
+                   ClutterEvent *event,
+                   gpointer      dummy)
+{
+  switch (clutter_event_type (event))
+    {
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_UPDATE:
+    case CLUTTER_TOUCH_END:
+      n_delivered += 1;
+      break;
+
+    default:
+      break;
+    }
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static gboolean
+on_gesture_progress (ClutterGestureAction *action,
+                     ClutterActor         *actor,
+                     gpointer              dummy)
+{
+  n_progress += 1;
+
+  return TRUE;
+}
+
+static void
+put_touch_event (ClutterStage       *stage,
+                 ClutterInputDevice *device,
+                 ClutterEventType    type,
+                 gint                touch,
+                 gint                frame)
+{
+  ClutterEvent *event = clutter_event_new (type);
+  gdouble angle = frame * G_PI / 120.0 + touch * 2.0 * G_PI / n_touches;
+  gfloat radius = 50.f + 20.f * touch;
+
+  event->touch.sequence = GINT_TO_POINTER (touch + 1);
+  clutter_event_set_stage (event, stage);
+  clutter_event_set_device (event, device);
+  clutter_event_set_source_device (event, device);
+  clutter_event_set_coords (event,
+                            400.f + radius * cos (angle),
+                            300.f + radius * sin (angle));
+  clutter_event_set_time (event, clutter_get_current_event_time () + frame * 4);
+
+  clutter_event_put (event);
+  clutter_event_free (event);
+
+  n_sent += 1;
+}
+
+static void
+flush_events (void)
+{
+  while (n_delivered < n_sent)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterDeviceManager *manager;
+  ClutterInputDevice *device;
+  ClutterActor *stage, *actor;
+  GError *error = NULL;
+  GTimer *timer;
+  gdouble elapsed;
+  gint i, frame;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, 800, 600);
+  clutter_stage_set_throttle_motion_events (CLUTTER_STAGE (stage), FALSE);
+  g_signal_connect (stage, "captured-event",
+                    G_CALLBACK (on_captured_event),
+                    NULL);
+
+  actor = clutter_actor_new ();
+  clutter_actor_add_constraint (actor, clutter_bind_constraint_new (stage, CLUTTER_BIND_SIZE, 0));
+  clutter_actor_set_reactive (actor, TRUE);
+  clutter_actor_add_child (stage, actor);
+
+  for (i = 0; i < n_actions; i++)
+    {
+      ClutterAction *action = clutter_gesture_action_new ();
+
+      clutter_gesture_action_set_n_touch_points (CLUTTER_GESTURE_ACTION (action),
+                                                 1 + i % n_touches);
+      g_signal_connect (action, "gesture-progress",
+                        G_CALLBACK (on_gesture_progress),
+                        NULL);
+      clutter_actor_add_action (actor, action);
+    }
+
+  clutter_actor_show (stage);
+
+  manager = clutter_device_manager_get_default ();
+  device = clutter_device_manager_get_core_device (manager,
+                                                   CLUTTER_POINTER_DEVICE);
+
+  printf ("%d touch points, %d gesture actions, %d frames\n",
+          n_touches, n_actions, n_frames);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_touches; i++)
+    put_touch_event (CLUTTER_STAGE (stage), device, CLUTTER_TOUCH_BEGIN, i, 0);
+  flush_events ();
+
+  for (frame = 1; frame <= n_frames; frame++)
+    {
+      for (i = 0; i < n_touches; i++)
+        put_touch_event (CLUTTER_STAGE (stage), device, CLUTTER_TOUCH_UPDATE, i, frame);
+      flush_events ();
+    }
+
+  for (i = 0; i < n_touches; i++)
+    put_touch_event (CLUTTER_STAGE (stage), device, CLUTTER_TOUCH_END, i, frame);
+  flush_events ();
+
+  g_timer_stop (timer);
+  elapsed = g_timer_elapsed (timer, NULL);
+
+  printf ("%u touch events in %.3f ms: %.0f events/sec, %u gesture updates\n",
+          n_delivered,
+          elapsed * 1000.0,
+          n_delivered / elapsed,
+          n_progress);
+
+  g_timer_destroy (timer);
+  clutter_actor_destroy (stage);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib/gstdio.h>
+#include <clutter/clutter.h>
+
+#define N_OBJECTS 500
+#define N_RUNS 20
+
+static gint n_objects = N_OBJECTS;
+static gint n_runs = N_RUNS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-objects", 'o',
+    0,
+    G_OPTION_ARG_INT, &n_objects,
+    "Number of objects in the UI definition", "OBJECTS"
+  },
+  {
+    "num-runs", 'r',
+    0,
+    G_OPTION_ARG_INT, &n_runs,
+    "Number of times the UI definition is loaded", "RUNS"
+  },
+  { NULL }
+};
+
+static gchar *
+generate_definition (void)
+{
+  GString *buffer = g_string_new ("[\n");
+  gint i;
+
+  for (i = 0; i < n_objects; i++)
+    {
+      g_string_append_printf (buffer,
+                              "  {\n"
+                              "    \"id\" : \"actor-%d\",\n"
+                              "    \"type\" : \"ClutterActor\",\n"
+                              "    \"x\" : %d, \"y\" : %d,\n"
+                              "    \"width\" : 32, \"height\" : 32,\n"
+                              "    \"x-align\" : \"center\",\n"
+                              "    \"y-expand\" : true,\n"
+                              "    \"request-mode\" : \"height-for-width\",\n"
+                              "    \"background-color\" : \"%s\",\n"
+                              "    \"children\" : [\n"
+                              "      {\n"
+                              "        \"type\" : \"ClutterText\",\n"
+                              "        \"text\" : \"Label %d\",\n"
+                              "        \"color\" : \"white\",\n"
+                              "        \"ellipsize\" : \"PANGO_ELLIPSIZE_END\"\n"
+                              "      }\n"
+                              "    ]\n"
+                              "  }%s\n",
+                              i,
+                              (i * 37) % 800, (i * 53) % 600,
+                              i % 2 == 0 ? "#ff000080" : "skyblue",
+                              i,
+                              i < n_objects - 1 ? "," : "");
+    }
+
+  g_string_append (buffer, "]\n");
+
+  return g_string_free (buffer, FALSE);
+}
+
+static double
+load_definition (const gchar *filename)
+{
+  GTimer *timer = g_timer_new ();
+  double elapsed;
+  gint i;
+
+  for (i = 0; i < n_runs; i++)
+    {
+      ClutterScript *script = clutter_script_new ();
+      GError *error = NULL;
+
+      clutter_script_load_from_file (script, filename, &error);
+      if (error != NULL)
+        {
+          g_printerr ("Unable to load '%s': %s\n", filename, error->message);
+          exit (EXIT_FAILURE);
+        }
+
+      clutter_script_unmerge_objects (script, 1);
+      g_object_unref (script);
+    }
+
+  g_timer_stop (timer);
+  elapsed = g_timer_elapsed (timer, NULL) * 1000.0 / n_runs;
+  g_timer_destroy (timer);
+
+  return elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  gchar *json_file, *compiled_file, *data;
+  gchar *compiler_argv[4];
+  GError *error = NULL;
+  gint status;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("ClutterScript loading test with %d objects\n", n_objects);
+
+  json_file = g_build_filename (g_get_tmp_dir (), "test-script-load.json", NULL);
+  compiled_file = g_build_filename (g_get_tmp_dir (), "test-script-load.uic", NULL);
+
+  data = generate_definition ();
+  if (!g_file_set_contents (json_file, data, -1, &error))
+    {
+      g_printerr ("Unable to save '%s': %s\n", json_file, error->message);
+      return EXIT_FAILURE;
+    }
+
+  compiler_argv[0] = (gchar *) CLUTTER_SCRIPT_COMPILER;
+  compiler_argv[1] = json_file;
+  compiler_argv[2] = compiled_file;
+  compiler_argv[3] = NULL;
+
+  if (!g_spawn_sync (NULL, compiler_argv, NULL, 0, NULL, NULL,
+                     NULL, NULL,
+                     &status,
+                     &error) ||
+      status != 0)
+    {
+      g_printerr ("Unable to compile '%s': %s\n",
+                  json_file,
+                  error != NULL ? error->message : "compiler failed");
+      return EXIT_FAILURE;
+    }
+
+  printf ("JSON: %.3f ms per load\n", load_definition (json_file));
+  printf ("compiled: %.3f ms per load\n", load_definition (compiled_file));
+
+  g_unlink (json_file);
+  g_unlink (compiled_file);
+
+  g_free (data);
+  g_free (json_file);
+  g_free (compiled_file);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_MERGES 1000
+
+static gint n_merges = N_MERGES;
+
+static GOptionEntry entries[] = {
+  {
+    "num-merges", 'm',
+    0,
+    G_OPTION_ARG_INT, &n_merges,
+    "Number of times the UI fragment is merged", "MERGES"
+  },
+  { NULL }
+};
+
+/* a small fragment, like the ones applications merge and unmerge when
+ * showing a dialog or a list row; it uses enumerations, flags and colors
+ * which all have to be resolved from strings
+ */
+static const gchar *fragment =
+"[\n"
+"  {\n"
+"    \"id\" : \"row\",\n"
+"    \"type\" : \"ClutterActor\",\n"
+"    \"width\" : 320, \"height\" : 48,\n"
+"    \"x-align\" : \"fill\",\n"
+"    \"x-expand\" : true,\n"
+"    \"request-mode\" : \"height-for-width\",\n"
+"    \"background-color\" : \"#3465a4\",\n"
+"    \"layout-manager\" : {\n"
+"      \"type\" : \"ClutterBoxLayout\",\n"
+"      \"orientation\" : \"horizontal\",\n"
+"      \"spacing\" : 6\n"
+"    },\n"
+"    \"children\" : [\n"
+"      {\n"
+"        \"id\" : \"icon\",\n"
+"        \"type\" : \"ClutterActor\",\n"
+"        \"width\" : 32, \"height\" : 32,\n"
+"        \"y-align\" : \"center\",\n"
+"        \"background-color\" : \"white\"\n"
+"      },\n"
+"      {\n"
+"        \"id\" : \"label\",\n"
+"        \"type\" : \"ClutterText\",\n"
+"        \"text\" : \"Row\",\n"
+"        \"color\" : \"#eeeeecff\",\n"
+"        \"ellipsize\" : \"PANGO_ELLIPSIZE_END\",\n"
+"        \"line-alignment\" : \"PANGO_ALIGN_LEFT\",\n"
+"        \"x-expand\" : true,\n"
+"        \"y-align\" : \"center\"\n"
+"      }\n"
+"    ]\n"
+"  }\n"
+"]\n";
+
+int
+main (int argc, char **argv)
+{
+  ClutterScript *script;
+  GError *error = NULL;
+  GTimer *timer;
+  double first;
+  gint i;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("ClutterScript merge test with %d merges\n", n_merges);
+
+  script = clutter_script_new ();
+  timer = g_timer_new ();
+
+  /* the first merge has to resolve all the names, so it is reported
+   * separately from the following ones
+   */
+  first = 0.0;
+
+  for (i = 0; i < n_merges; i++)
+    {
+      guint merge_id;
+
+      merge_id = clutter_script_load_from_data (script, fragment, -1, &error);
+      if (error != NULL)
+        {
+          g_printerr ("Unable to load the UI fragment: %s\n", error->message);
+          return EXIT_FAILURE;
+        }
+
+      clutter_script_unmerge_objects (script, merge_id);
+
+      if (i == 0)
+        first = g_timer_elapsed (timer, NULL) * 1000.0;
+    }
+
+  g_timer_stop (timer);
+
+  printf ("first merge: %.3f ms\n", first);
+  if (n_merges > 1)
+    printf ("%.3f ms per merge\n",
+            (g_timer_elapsed (timer, NULL) * 1000.0 - first) / (n_merges - 1));
+
+  g_timer_destroy (timer);
+  g_object_unref (script);
+
+  return EXIT_SUCCESS;
+}
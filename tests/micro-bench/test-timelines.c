@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_TIMELINES 10000
+#define N_FRAMES 300
+
+static gint n_timelines = N_TIMELINES;
+static gint n_frames = N_FRAMES;
+
+static GOptionEntry entries[] = {
+  {
+    "num-timelines", 't',
+    0,
+    G_OPTION_ARG_INT, &n_timelines,
+    "Number of timelines", "TIMELINES"
+  },
+  {
+    "num-frames", 'f',
+    0,
+    G_OPTION_ARG_INT, &n_frames,
+    "Number of frames", "FRAMES"
+  },
+  { NULL }
+};
+
+static GTimer *timer = NULL;
+static gint frame = 0;
+
+static void
+on_new_frame (ClutterTimeline *timeline,
+              gint             msecs,
+              gpointer         data)
+{
+  if (frame++ < n_frames)
+    return;
+
+  g_timer_stop (timer);
+
+  printf ("%d frames, %d timelines: %.3f ms per frame\n",
+          n_frames,
+          n_timelines,
+          g_timer_elapsed (timer, NULL) * 1000.0 / n_frames);
+
+  clutter_main_quit ();
+}
+
+static void
+on_completed (ClutterTimeline *timeline)
+{
+  clutter_timeline_rewind (timeline);
+  clutter_timeline_start (timeline);
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterTimeline *timeline;
+  ClutterTimeline **timelines;
+  ClutterActor *stage;
+  GError *error = NULL;
+  gint i;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Timelines");
+  clutter_actor_show (stage);
+
+  printf ("Timelines performance test with %d timelines\n", n_timelines);
+
+  /* a timeline that is used only to count the frames */
+  timeline = clutter_timeline_new (1000);
+  clutter_timeline_set_repeat_count (timeline, -1);
+  g_signal_connect (timeline, "new-frame", G_CALLBACK (on_new_frame), NULL);
+
+  /* the timelines being benchmarked have no handlers and no markers;
+   * every tenth is stopped and started again on each cycle, to
+   * exercise the removal and addition of timelines while the master
+   * clock is advancing them
+   */
+  timelines = g_new (ClutterTimeline *, n_timelines);
+  for (i = 0; i < n_timelines; i++)
+    {
+      timelines[i] = clutter_timeline_new (100 + (i % 900));
+
+      if (i % 10 == 0)
+        g_signal_connect (timelines[i], "completed",
+                          G_CALLBACK (on_completed),
+                          NULL);
+      else
+        clutter_timeline_set_repeat_count (timelines[i], -1);
+    }
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_timelines; i++)
+    clutter_timeline_start (timelines[i]);
+
+  clutter_timeline_start (timeline);
+
+  clutter_main ();
+
+  for (i = 0; i < n_timelines; i++)
+    g_object_unref (timelines[i]);
+
+  g_free (timelines);
+  g_timer_destroy (timer);
+  g_object_unref (timeline);
+  clutter_actor_destroy (stage);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_ACTORS 5000
+#define N_FRAMES 300
+
+static gint n_actors = N_ACTORS;
+static gint n_frames = N_FRAMES;
+
+static GOptionEntry entries[] = {
+  {
+    "num-actors", 'a',
+    0,
+    G_OPTION_ARG_INT, &n_actors,
+    "Number of actors", "ACTORS"
+  },
+  {
+    "num-frames", 'f',
+    0,
+    G_OPTION_ARG_INT, &n_frames,
+    "Number of frames", "FRAMES"
+  },
+  { NULL }
+};
+
+static GTimer *timer = NULL;
+static gint frame = 0;
+
+static void
+on_new_frame (ClutterTimeline *timeline,
+              gint             msecs,
+              ClutterActor    *stage)
+{
+  if (frame++ < n_frames)
+    return;
+
+  g_timer_stop (timer);
+
+  printf ("%d frames, %d transitions: %.3f ms per frame\n",
+          n_frames,
+          n_actors * 5,
+          g_timer_elapsed (timer, NULL) * 1000.0 / n_frames);
+
+  clutter_main_quit ();
+}
+
+static void
+animate_actor (ClutterActor *actor,
+               gint          i)
+{
+  ClutterTransition *transition;
+
+  clutter_actor_save_easing_state (actor);
+  clutter_actor_set_easing_duration (actor, 1000);
+  clutter_actor_set_easing_mode (actor, CLUTTER_EASE_IN_OUT_CUBIC);
+
+  clutter_actor_set_position (actor, (i * 37) % 800, (i * 53) % 600);
+  clutter_actor_set_opacity (actor, 64);
+  clutter_actor_set_scale (actor, 2.0, 2.0);
+
+  clutter_actor_restore_easing_state (actor);
+
+  /* keep every transition running for the whole benchmark */
+  transition = clutter_actor_get_transition (actor, "x");
+  clutter_timeline_set_repeat_count (CLUTTER_TIMELINE (transition), -1);
+  clutter_timeline_set_auto_reverse (CLUTTER_TIMELINE (transition), TRUE);
+
+  transition = clutter_actor_get_transition (actor, "y");
+  clutter_timeline_set_repeat_count (CLUTTER_TIMELINE (transition), -1);
+  clutter_timeline_set_auto_reverse (CLUTTER_TIMELINE (transition), TRUE);
+
+  transition = clutter_actor_get_transition (actor, "opacity");
+  clutter_timeline_set_repeat_count (CLUTTER_TIMELINE (transition), -1);
+  clutter_timeline_set_auto_reverse (CLUTTER_TIMELINE (transition), TRUE);
+
+  transition = clutter_actor_get_transition (actor, "scale-x");
+  clutter_timeline_set_repeat_count (CLUTTER_TIMELINE (transition), -1);
+  clutter_timeline_set_auto_reverse (CLUTTER_TIMELINE (transition), TRUE);
+
+  transition = clutter_actor_get_transition (actor, "scale-y");
+  clutter_timeline_set_repeat_count (CLUTTER_TIMELINE (transition), -1);
+  clutter_timeline_set_auto_reverse (CLUTTER_TIMELINE (transition), TRUE);
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterTimeline *timeline;
+  ClutterActor *stage;
+  GError *error = NULL;
+  gint i;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, 800, 600);
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Transitions");
+
+  printf ("Transitions performance test with %d actors\n", n_actors);
+
+  for (i = 0; i < n_actors; i++)
+    {
+      ClutterActor *actor = clutter_actor_new ();
+
+      clutter_actor_set_background_color (actor, CLUTTER_COLOR_LightSkyBlue);
+      clutter_actor_set_size (actor, 8, 8);
+      clutter_actor_add_child (stage, actor);
+
+      animate_actor (actor, i);
+    }
+
+  /* a timeline that is used only to count the frames */
+  timeline = clutter_timeline_new (1000);
+  clutter_timeline_set_repeat_count (timeline, -1);
+  g_signal_connect (timeline, "new-frame", G_CALLBACK (on_new_frame), stage);
+
+  clutter_actor_show (stage);
+
+  timer = g_timer_new ();
+  clutter_timeline_start (timeline);
+
+  clutter_main ();
+
+  g_timer_destroy (timer);
+  g_object_unref (timeline);
+  clutter_actor_destroy (stage);
+
+  return EXIT_SUCCESS;
+}
@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <stdlib.h>
 #include <glib.h>
 #include <clutter/clutter.h>
@@ -6,6 +7,25 @@ static GTimer *testtimer = NULL;
 static gint testframes = 0;
 static float testmaxtime = 1.0;
 
+/* the frame rate of the virtual clock, or 0 if using the real time */
+static gint testvirtualfps = 0;
+
+/* the number of frames started, used to record and replay events */
+static guint testframe = 0;
+static FILE *testrecordfile = NULL;
+static GArray *testreplayevents = NULL;
+static guint testreplayindex = 0;
+
+typedef struct {
+  guint frame;
+  ClutterEventType type;
+  gfloat x, y;
+  guint button;
+  guint keyval;
+  guint16 keycode;
+  ClutterModifierType state;
+} PerfRecordedEvent;
+
 /* initialize environment to be suitable for fps testing */
 void clutter_perf_fps_init (void)
 {
@@ -16,6 +36,13 @@ void clutter_perf_fps_init (void)
   /* also overrride internal default FPS */
   g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
 
+  /* advance the animations by a fixed step on each frame, so that
+   * every run draws the same frames; set CLUTTER_VIRTUAL_FPS to 0
+   * to use the real time instead
+   */
+  g_setenv ("CLUTTER_VIRTUAL_FPS", "60", FALSE);
+  testvirtualfps = atoi (g_getenv ("CLUTTER_VIRTUAL_FPS"));
+
   if (g_getenv ("CLUTTER_PERFORMANCE_TEST_DURATION"))
     testmaxtime = atof(g_getenv("CLUTTER_PERFORMANCE_TEST_DURATION"));
   else
@@ -26,21 +53,63 @@ void clutter_perf_fps_init (void)
 
 static void perf_stage_paint_cb (ClutterStage *stage, gpointer *data);
 static gboolean perf_fake_mouse_cb (gpointer stage);
+static gboolean perf_frame_cb (gpointer stage);
+static gboolean perf_record_event_cb (const ClutterEvent *event, gpointer data);
+static void perf_load_events (const gchar *filename);
+static void perf_replay_events (ClutterStage *stage);
 
+/* to record the input events of a run, set CLUTTER_PERFORMANCE_RECORD_EVENTS
+ * to the name of a file; to replay them in the same frames, set
+ * CLUTTER_PERFORMANCE_REPLAY_EVENTS to the name of the recorded file
+ */
 void clutter_perf_fps_start (ClutterStage *stage)
 {
+  const gchar *filename;
+
+  filename = g_getenv ("CLUTTER_PERFORMANCE_RECORD_EVENTS");
+  if (filename != NULL)
+    {
+      testrecordfile = fopen (filename, "w");
+      if (testrecordfile == NULL)
+        g_error ("Unable to open '%s' for writing", filename);
+
+      clutter_event_add_filter (stage, perf_record_event_cb, NULL, NULL);
+    }
+
+  filename = g_getenv ("CLUTTER_PERFORMANCE_REPLAY_EVENTS");
+  if (filename != NULL)
+    {
+      perf_load_events (filename);
+      perf_replay_events (stage);
+    }
+
+  clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT,
+                                         perf_frame_cb,
+                                         stage,
+                                         NULL);
+
   g_signal_connect (stage, "paint", G_CALLBACK (perf_stage_paint_cb), NULL);
 }
 
 void clutter_perf_fake_mouse (ClutterStage *stage)
 {
-  clutter_threads_add_timeout (1000/60, perf_fake_mouse_cb, stage);
+  /* with a virtual clock, move the pointer once per frame */
+  if (testvirtualfps > 0)
+    clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT,
+                                           perf_fake_mouse_cb,
+                                           stage,
+                                           NULL);
+  else
+    clutter_threads_add_timeout (1000/60, perf_fake_mouse_cb, stage);
 }
 
 void clutter_perf_fps_report (const gchar *id)
 {
   g_print ("\n@ %s: %.2f fps \n",
        id, testframes / g_timer_elapsed (testtimer, NULL));
+
+  if (testrecordfile != NULL)
+    fclose (testrecordfile);
 }
 
 static void perf_stage_paint_cb (ClutterStage *stage, gpointer *data)
@@ -48,12 +117,163 @@ static void perf_stage_paint_cb (ClutterStage *stage, gpointer *data)
   if (!testtimer)
     testtimer = g_timer_new ();
   testframes ++;
-  if (g_timer_elapsed (testtimer, NULL) > testmaxtime)
+
+  /* with a virtual clock, the duration of the test is measured in
+   * frames, so that every run draws the same number of them
+   */
+  if (testvirtualfps > 0)
+    {
+      if (testframes > testmaxtime * testvirtualfps)
+        clutter_main_quit ();
+    }
+  else if (g_timer_elapsed (testtimer, NULL) > testmaxtime)
     {
       clutter_main_quit ();
     }
 }
 
+static gboolean perf_frame_cb (gpointer stage)
+{
+  testframe ++;
+
+  /* the events queued now are processed at the start of the next frame */
+  if (testreplayevents != NULL)
+    perf_replay_events (stage);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean perf_record_event_cb (const ClutterEvent *event, gpointer data)
+{
+  gfloat x = 0, y = 0;
+
+  switch (clutter_event_type (event))
+    {
+    case CLUTTER_MOTION:
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_BUTTON_RELEASE:
+    case CLUTTER_KEY_PRESS:
+    case CLUTTER_KEY_RELEASE:
+      break;
+
+    default:
+      return CLUTTER_EVENT_PROPAGATE;
+    }
+
+  clutter_event_get_coords (event, &x, &y);
+
+  fprintf (testrecordfile, "%u %d %.2f %.2f %u %u %u %u\n",
+           testframe,
+           clutter_event_type (event),
+           x, y,
+           clutter_event_type (event) == CLUTTER_BUTTON_PRESS ||
+           clutter_event_type (event) == CLUTTER_BUTTON_RELEASE
+             ? clutter_event_get_button (event)
+             : 0,
+           clutter_event_type (event) == CLUTTER_KEY_PRESS ||
+           clutter_event_type (event) == CLUTTER_KEY_RELEASE
+             ? clutter_event_get_key_symbol (event)
+             : 0,
+           clutter_event_type (event) == CLUTTER_KEY_PRESS ||
+           clutter_event_type (event) == CLUTTER_KEY_RELEASE
+             ? clutter_event_get_key_code (event)
+             : 0,
+           clutter_event_get_state (event));
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static void perf_load_events (const gchar *filename)
+{
+  PerfRecordedEvent recorded;
+  gchar *contents;
+  gchar **lines;
+  GError *error = NULL;
+  gint i;
+
+  if (!g_file_get_contents (filename, &contents, NULL, &error))
+    g_error ("Unable to load the events: %s", error->message);
+
+  testreplayevents = g_array_new (FALSE, TRUE, sizeof (PerfRecordedEvent));
+
+  lines = g_strsplit (contents, "\n", -1);
+  for (i = 0; lines[i] != NULL; i++)
+    {
+      guint type, keycode, state;
+
+      if (sscanf (lines[i], "%u %u %f %f %u %u %u %u",
+                  &recorded.frame,
+                  &type,
+                  &recorded.x, &recorded.y,
+                  &recorded.button,
+                  &recorded.keyval,
+                  &keycode,
+                  &state) != 8)
+        continue;
+
+      recorded.type = type;
+      recorded.keycode = keycode;
+      recorded.state = state;
+
+      g_array_append_val (testreplayevents, recorded);
+    }
+
+  g_strfreev (lines);
+  g_free (contents);
+}
+
+static void perf_replay_events (ClutterStage *stage)
+{
+  ClutterDeviceManager *manager = clutter_device_manager_get_default ();
+
+  while (testreplayindex < testreplayevents->len)
+    {
+      PerfRecordedEvent *recorded;
+      ClutterInputDevice *device;
+      ClutterEvent *event;
+
+      recorded = &g_array_index (testreplayevents,
+                                 PerfRecordedEvent,
+                                 testreplayindex);
+      if (recorded->frame > testframe)
+        break;
+
+      testreplayindex ++;
+
+      event = clutter_event_new (recorded->type);
+
+      if (recorded->type == CLUTTER_KEY_PRESS ||
+          recorded->type == CLUTTER_KEY_RELEASE)
+        {
+          device = clutter_device_manager_get_core_device (manager,
+                                                           CLUTTER_KEYBOARD_DEVICE);
+          clutter_event_set_key_symbol (event, recorded->keyval);
+          clutter_event_set_key_code (event, recorded->keycode);
+        }
+      else
+        {
+          device = clutter_device_manager_get_core_device (manager,
+                                                           CLUTTER_POINTER_DEVICE);
+          clutter_event_set_coords (event, recorded->x, recorded->y);
+
+          if (recorded->type != CLUTTER_MOTION)
+            clutter_event_set_button (event, recorded->button);
+        }
+
+      clutter_event_set_stage (event, stage);
+      clutter_event_set_device (event, device);
+      clutter_event_set_state (event, recorded->state);
+
+      /* use the frame as the timestamp, so that the replay does not
+       * depend on the real time
+       */
+      clutter_event_set_time (event, recorded->frame * 1000 / MAX (testvirtualfps, 1));
+
+      clutter_event_put (event);
+      clutter_event_free (event);
+    }
+}
+
 static void wrap (gfloat *value, gfloat min, gfloat max)
 {
   if (*value > max)